@@ -0,0 +1,58 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Stubs shared by the test and benchmark programs.
+ *
+ * The programs link a few gpredict sources without the rest of the
+ * application, so the logger is replaced by one printing to stderr.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "bench-stubs.h"
+#include "sat-log.h"
+
+
+gboolean        bench_verbose = FALSE;
+
+
+/* Print log messages to stderr; only errors unless bench_verbose is set */
+void sat_log_log(sat_log_level_t level, const char *fmt, ...)
+{
+    va_list         args;
+
+    if (!bench_verbose && level != SAT_LOG_LEVEL_ERROR)
+        return;
+
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
@@ -111,6 +111,8 @@
 #define MOD_CFG_MAP_TRACK_COL         "TRACK_COLOUR"
 #define MOD_CFG_MAP_TRACK_NUM         "TRACK_NUMBER"
 #define MOD_CFG_MAP_KEEP_RATIO        "KEEP_RATIO"
+#define MOD_CFG_MAP_DIRECT_RENDER     "DIRECT_RENDER"
+#define MOD_CFG_MAP_DECLUTTER         "DECLUTTER_LABELS"
 #define MOD_CFG_MAP_SHADOW_ALPHA      "SHADOW_ALPHA"
 #define MOD_CFG_MAP_SHOWTRACKS        "SHOWTRACKS"
 #define MOD_CFG_MAP_HIDECOVS          "HIDECOVS"
@@ -124,6 +126,7 @@
 #define MOD_CFG_POLAR_SHOW_CURS_TRACK  "CURSOR_TRACK"
 #define MOD_CFG_POLAR_SHOW_EXTRA_AZ_TICKS "EXTRA_AZ_TICKS"
 #define MOD_CFG_POLAR_SHOW_TRACK_AUTO  "SHOW_TRACK"
+#define MOD_CFG_POLAR_DECLUTTER        "DECLUTTER_LABELS"
 #define MOD_CFG_POLAR_BGD_COL          "BGD_COLOUR"
 #define MOD_CFG_POLAR_AXIS_COL         "AXIS_COLOUR"
 #define MOD_CFG_POLAR_TICK_COL         "TICK_COLOUR"
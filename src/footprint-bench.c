@@ -0,0 +1,217 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Benchmark for the range circle kernel.
+ *
+ * A set of satellites with random sub-satellite points and altitudes between
+ * LEO and GEO is given coverage circles, once with a copy of the per-point
+ * calculation that the map used before footprint_half_circle() and once with
+ * footprint_half_circle() itself. The time per map refresh is reported for
+ * both, together with the largest difference between the two results.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "footprint.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/* command line options */
+static gint     numsats = 1000;
+static gint     refreshes = 200;
+
+static GOptionEntry options[] = {
+    {"sats", 's', 0, G_OPTION_ARG_INT, &numsats,
+     "Number of satellites showing coverage", "N"},
+    {"refreshes", 'n', 0, G_OPTION_ARG_INT, &refreshes,
+     "Number of map refreshes to time", "N"},
+    {NULL, 0, 0, 0, NULL, NULL, NULL}
+};
+
+typedef struct {
+    gdouble         lat;
+    gdouble         lon;
+    gdouble         footprint;
+    gboolean        npole;
+} bench_sat_t;
+
+
+static gdouble arccos(gdouble x, gdouble y)
+{
+    if (x && y)
+    {
+        if (y > 0.0)
+            return acos(x / y);
+        else if (y < 0.0)
+            return pi + acos(x / y);
+    }
+
+    return 0.0;
+}
+
+/* The range circle loop of calculate_footprint() before the kernel */
+static void reference_half_circle(const bench_sat_t * sat, gdouble * lat,
+                                  gdouble * lon)
+{
+    guint           azi;
+    gdouble         ssplat, ssplon, beta, azimuth, num, dem;
+    gdouble         rangelon, rangelat;
+
+    ssplat = sat->lat * de2ra;
+    ssplon = sat->lon * de2ra;
+    beta = (0.5 * sat->footprint) / xkmper;
+
+    for (azi = 0; azi < FOOTPRINT_POINTS; azi++)
+    {
+        azimuth = de2ra * (double)azi;
+        rangelat = asin(sin(ssplat) * cos(beta) + cos(azimuth) *
+                        sin(beta) * cos(ssplat));
+        num = cos(beta) - (sin(ssplat) * sin(rangelat));
+        dem = cos(ssplat) * cos(rangelat);
+
+        if (azi == 0 && sat->npole)
+            rangelon = ssplon + pi;
+        else if (fabs(num / dem) > 1.0)
+            rangelon = ssplon;
+        else
+            rangelon = ssplon - arccos(num, dem);
+
+        while (rangelon < -pi)
+            rangelon += twopi;
+
+        while (rangelon > (pi))
+            rangelon -= twopi;
+
+        lat[azi] = rangelat / de2ra;
+        lon[azi] = rangelon / de2ra;
+    }
+}
+
+static bench_sat_t *create_sats(void)
+{
+    GRand          *rnd = g_rand_new_with_seed(4532);
+    bench_sat_t    *sats = g_new(bench_sat_t, numsats);
+    gdouble         alt;
+    gint            i;
+
+    for (i = 0; i < numsats; i++)
+    {
+        /* altitude from 300 km to GEO, mostly LEO */
+        alt = 300.0 * pow(120.0, pow(g_rand_double(rnd), 2.0));
+
+        sats[i].lat = g_rand_double_range(rnd, -90.0, 90.0);
+        sats[i].lon = g_rand_double_range(rnd, -180.0, 180.0);
+        sats[i].footprint = 2.0 * xkmper * acos(xkmper / (xkmper + alt));
+        sats[i].npole = ((90.0 - sats[i].lat) * de2ra * xkmper <=
+                         0.5 * sats[i].footprint);
+    }
+    g_rand_free(rnd);
+
+    return sats;
+}
+
+/* Time one implementation; returns microseconds per refresh */
+static gdouble run(const bench_sat_t * sats, gboolean reference,
+                   gdouble * lat, gdouble * lon)
+{
+    gint64          t;
+    gint            i, j;
+
+    t = g_get_monotonic_time();
+    for (i = 0; i < refreshes; i++)
+    {
+        for (j = 0; j < numsats; j++)
+        {
+            if (reference)
+                reference_half_circle(&sats[j], lat, lon);
+            else
+                footprint_half_circle(sats[j].lat, sats[j].lon,
+                                      sats[j].footprint, sats[j].npole,
+                                      lat, lon);
+        }
+    }
+
+    return (gdouble) (g_get_monotonic_time() - t) / refreshes;
+}
+
+int main(int argc, char *argv[])
+{
+    GOptionContext *context;
+    GError         *err = NULL;
+    bench_sat_t    *sats;
+    gdouble         lat1[FOOTPRINT_POINTS], lon1[FOOTPRINT_POINTS];
+    gdouble         lat2[FOOTPRINT_POINTS], lon2[FOOTPRINT_POINTS];
+    gdouble         dlat = 0.0, dlon = 0.0, d;
+    gdouble         tref, tnew;
+    gint            i, j;
+
+    context = g_option_context_new(NULL);
+    g_option_context_set_summary(context,
+                                 "Benchmark for the range circle kernel.");
+    g_option_context_add_main_entries(context, options, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &err))
+    {
+        g_printerr("%s\n", err->message);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(context);
+
+    numsats = MAX(numsats, 1);
+    refreshes = MAX(refreshes, 1);
+    sats = create_sats();
+
+    for (i = 0; i < numsats; i++)
+    {
+        reference_half_circle(&sats[i], lat1, lon1);
+        footprint_half_circle(sats[i].lat, sats[i].lon, sats[i].footprint,
+                              sats[i].npole, lat2, lon2);
+        for (j = 0; j < FOOTPRINT_POINTS; j++)
+        {
+            dlat = MAX(dlat, fabs(lat1[j] - lat2[j]));
+            d = fabs(lon1[j] - lon2[j]);
+            dlon = MAX(dlon, MIN(d, 360.0 - d));
+        }
+    }
+
+    tref = run(sats, TRUE, lat1, lon1);
+    tnew = run(sats, FALSE, lat2, lon2);
+
+    g_print("%d satellites, %d refreshes\n", numsats, refreshes);
+    g_print("reference %8.1f us/refresh\n", tref);
+    g_print("kernel    %8.1f us/refresh (%.1fx)\n", tnew,
+            tref / MAX(tnew, 1.0e-3));
+    g_print("largest difference: %.2e deg lat, %.2e deg lon\n", dlat, dlon);
+
+    g_free(sats);
+
+    /* the longitude is ill-conditioned where the circle is tangent to a
+       meridian, so allow for rounding there; 1e-4 deg is about 10 m */
+    return (dlat < 1.0e-4 && dlon < 1.0e-4) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Range circle kernel.
+ *
+ * The edge of the coverage area is computed for one degree azimuth steps
+ * from the sub-satellite point. The cosines of the azimuths are tabulated
+ * once, the trigonometry of the sub-satellite point and of the coverage
+ * radius is done once per circle, and sin/cos of each edge latitude follow
+ * from the sine that is computed anyway. This leaves one asin() and one
+ * acos() per point. The remaining arithmetic is done in separate loops
+ * over plain arrays, without calls or branches, which the compiler can
+ * vectorise.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <math.h>
+
+#include "footprint.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+static gdouble  cos_az[FOOTPRINT_POINTS];
+
+
+static void init_tables(void)
+{
+    static gsize    done = 0;
+    guint           i;
+
+    if (g_once_init_enter(&done))
+    {
+        for (i = 0; i < FOOTPRINT_POINTS; i++)
+            cos_az[i] = cos(de2ra * i);
+
+        g_once_init_leave(&done, 1);
+    }
+}
+
+/**
+ * Compute half a range circle.
+ *
+ * @param ssplat Latitude of the sub-satellite point in degrees.
+ * @param ssplon Longitude of the sub-satellite point in degrees.
+ * @param footprint Diameter of the coverage area in km.
+ * @param npole TRUE if the coverage area includes the North Pole.
+ * @param lat Receives FOOTPRINT_POINTS latitudes in degrees.
+ * @param lon Receives FOOTPRINT_POINTS longitudes in degrees, between -180
+ *            and 180.
+ *
+ * Point i is the edge of the coverage area at azimuth i degrees from the
+ * sub-satellite point, measured towards the West. The other half of the
+ * circle is its mirror image about the meridian of the sub-satellite point.
+ * When the North Pole is covered, the first point is moved to the opposite
+ * meridian so that the outline runs across the pole.
+ */
+void footprint_half_circle(gdouble ssplat, gdouble ssplon, gdouble footprint,
+                           gboolean npole, gdouble * lat, gdouble * lon)
+{
+    gdouble         s[FOOTPRINT_POINTS];        /* sine of the edge latitude */
+    gdouble         c[FOOTPRINT_POINTS];        /* cosine of the longitude offset */
+    gdouble         lat0, lon0, beta;
+    gdouble         sinlat, coslat, sinbeta, cosbeta;
+    gdouble         a, b, d;
+    guint           i;
+
+    init_tables();
+
+    lat0 = ssplat * de2ra;
+    lon0 = ssplon * de2ra;
+    beta = (0.5 * footprint) / xkmper;
+
+    sinlat = sin(lat0);
+    coslat = cos(lat0);
+    sinbeta = sin(beta);
+    cosbeta = cos(beta);
+    a = sinlat * cosbeta;
+    b = coslat * sinbeta;
+
+    for (i = 0; i < FOOTPRINT_POINTS; i++)
+        s[i] = CLAMP(a + b * cos_az[i], -1.0, 1.0);
+
+    /* a zero denominator gives inf or nan, which is handled below */
+    for (i = 0; i < FOOTPRINT_POINTS; i++)
+        c[i] = (cosbeta - sinlat * s[i]) / (coslat * sqrt(1.0 - s[i] * s[i]));
+
+    for (i = 0; i < FOOTPRINT_POINTS; i++)
+        lat[i] = asin(s[i]) / de2ra;
+
+    for (i = 0; i < FOOTPRINT_POINTS; i++)
+    {
+        d = (fabs(c[i]) <= 1.0) ? acos(c[i]) : 0.0;
+        lon[i] = lon0 - d;
+    }
+
+    if (npole)
+        lon[0] = lon0 + pi;
+
+    for (i = 0; i < FOOTPRINT_POINTS; i++)
+    {
+        if (lon[i] < -pi)
+            lon[i] += twopi;
+        else if (lon[i] > pi)
+            lon[i] -= twopi;
+        lon[i] /= de2ra;
+    }
+}
@@ -0,0 +1,512 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/**
+ * Tree model of the event list.
+ *
+ * The model has one row per satellite of the module and computes the value
+ * of a cell when the tree view asks for it, so the countdowns are only
+ * formatted for the rows that are drawn.
+ *
+ * The order of the rows depends on the time of the next AOS or LOS, which
+ * only changes when the event has passed. The shown rows are therefore also
+ * kept in a heap ordered by the time of their next event: a cycle takes the
+ * events that have passed off the top of the heap, puts them back with the
+ * new event time and moves the rows in the list. The other rows are left
+ * alone unless the list is sorted by Az or El. The rows themselves are kept
+ * and sorted by GtkSatRowModel.
+ *
+ * The events are checked against the satellites once a minute, or right
+ * away when the time has moved back or a satellite has been refreshed,
+ * because the module computes the events again now and then. Decayed
+ * satellites are hidden at the same time.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib/gi18n.h>
+#include <gtk/gtk.h>
+
+#include "gtk-event-list.h"
+#include "gtk-event-list-model.h"
+#include "orbit-tools.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/** Largest time between two checks of all events, in days. */
+#define RESYNC_INTERVAL (1.0 / 1440.0)
+
+/** A row of the event list. */
+typedef struct {
+    sat_row_t       base;       /*!< Common row data; must be first. */
+    guint           heap_index; /*!< Position in the event heap. */
+    gdouble         event;      /*!< Time of the next event; G_MAXDOUBLE if none. */
+} event_list_row_t;
+
+/** Column types indexed with column symb. refs. */
+static const GType COLUMN_TYPE[EVENT_LIST_COL_NUMBER] = {
+    G_TYPE_STRING,              // name
+    G_TYPE_INT,                 // catnum
+    G_TYPE_DOUBLE,              // az
+    G_TYPE_DOUBLE,              // el
+    G_TYPE_BOOLEAN,             // TRUE if LOS, FALSE if AOS
+    G_TYPE_DOUBLE,              // time
+    G_TYPE_BOOLEAN,             // decayed
+    G_TYPE_INT                  // weight/bold
+};
+
+static void     gtk_event_list_model_class_init(GtkEventListModelClass *
+                                                class, gpointer class_data);
+static void     gtk_event_list_model_init(GtkEventListModel * model,
+                                          gpointer g_class);
+static void     gtk_event_list_model_finalize(GObject * object);
+static void     get_value(GtkSatRowModel * base_model, sat_row_t * base_row,
+                          gint column, GValue * value);
+static void     prepare_keys(GtkSatRowModel * base_model);
+
+static GObjectClass *parent_class = NULL;
+
+
+GType gtk_event_list_model_get_type()
+{
+    static GType    gtk_event_list_model_type = 0;
+
+    if (!gtk_event_list_model_type)
+    {
+        static const GTypeInfo gtk_event_list_model_info = {
+            sizeof(GtkEventListModelClass),
+            NULL,               /* base_init */
+            NULL,               /* base_finalize */
+            (GClassInitFunc) gtk_event_list_model_class_init,
+            NULL,               /* class_finalize */
+            NULL,               /* class_data */
+            sizeof(GtkEventListModel),
+            0,                  /* n_preallocs */
+            (GInstanceInitFunc) gtk_event_list_model_init,
+            NULL
+        };
+
+        gtk_event_list_model_type = g_type_register_static(GTK_TYPE_SAT_ROW_MODEL,
+                                                           "GtkEventListModel",
+                                                           &gtk_event_list_model_info,
+                                                           0);
+    }
+
+    return gtk_event_list_model_type;
+}
+
+static void gtk_event_list_model_class_init(GtkEventListModelClass * class,
+                                            gpointer class_data)
+{
+    GObjectClass   *object_class = (GObjectClass *) class;
+    GtkSatRowModelClass *row_class = (GtkSatRowModelClass *) class;
+
+    (void)class_data;
+
+    object_class->finalize = gtk_event_list_model_finalize;
+
+    row_class->n_columns = EVENT_LIST_COL_NUMBER;
+    row_class->column_types = COLUMN_TYPE;
+    row_class->name_column = EVENT_LIST_COL_NAME;
+    row_class->get_value = get_value;
+    row_class->prepare_keys = prepare_keys;
+
+    parent_class = g_type_class_peek_parent(class);
+}
+
+static void gtk_event_list_model_init(GtkEventListModel * model,
+                                      gpointer g_class)
+{
+    (void)g_class;
+
+    model->events = g_ptr_array_new();
+    model->tstamp = 0.0;
+    model->synced = 0.0;
+    model->resync = FALSE;
+    model->parent.sort_column = EVENT_LIST_COL_TIME;
+}
+
+static void gtk_event_list_model_finalize(GObject * object)
+{
+    GtkEventListModel *model = GTK_EVENT_LIST_MODEL(object);
+
+    g_ptr_array_free(model->events, TRUE);
+
+    (*parent_class->finalize) (object);
+}
+
+/** Time of the next event, LOS if the satellite is up and AOS otherwise. */
+static gdouble next_event(sat_t * sat)
+{
+    gdouble         t = (sat->el > 0.0) ? sat->los : sat->aos;
+
+    return (t > 0.0) ? t : G_MAXDOUBLE;
+}
+
+static void get_value(GtkSatRowModel * base_model, sat_row_t * base_row,
+                      gint column, GValue * value)
+{
+    GtkEventListModel *model = GTK_EVENT_LIST_MODEL(base_model);
+    sat_t          *sat = base_row->sat;
+    gdouble         t;
+
+    switch (column)
+    {
+    case EVENT_LIST_COL_NAME:
+        g_value_set_string(value, sat->nickname);
+        break;
+    case EVENT_LIST_COL_CATNUM:
+        g_value_set_int(value, sat->tle.catnr);
+        break;
+    case EVENT_LIST_COL_AZ:
+        g_value_set_double(value, sat->az);
+        break;
+    case EVENT_LIST_COL_EL:
+        g_value_set_double(value, sat->el);
+        break;
+    case EVENT_LIST_COL_EVT:
+        g_value_set_boolean(value, sat->el >= 0.0);
+        break;
+    case EVENT_LIST_COL_TIME:
+        /* -1 if the satellite is stationary or has no event */
+        t = next_event(sat);
+        g_value_set_double(value, (t < G_MAXDOUBLE) ? t - model->tstamp : -1.0);
+        break;
+    case EVENT_LIST_COL_DECAY:
+        g_value_set_boolean(value, !decayed(sat));
+        break;
+    case EVENT_LIST_COL_BOLD:
+        g_value_set_int(value, (sat->el > 0.0) ?
+                        PANGO_WEIGHT_BOLD : PANGO_WEIGHT_NORMAL);
+        break;
+    default:
+        break;
+    }
+}
+
+/* Event heap; the row with the earliest event is on top */
+
+static void heap_set(GtkEventListModel * model, guint i, event_list_row_t * row)
+{
+    g_ptr_array_index(model->events, i) = row;
+    row->heap_index = i;
+}
+
+static void heap_sift_up(GtkEventListModel * model, guint i)
+{
+    event_list_row_t *row = g_ptr_array_index(model->events, i);
+    event_list_row_t *parent;
+
+    while (i > 0)
+    {
+        parent = g_ptr_array_index(model->events, (i - 1) / 2);
+        if (parent->event <= row->event)
+            break;
+        heap_set(model, i, parent);
+        i = (i - 1) / 2;
+    }
+    heap_set(model, i, row);
+}
+
+static void heap_sift_down(GtkEventListModel * model, guint i)
+{
+    event_list_row_t *row = g_ptr_array_index(model->events, i);
+    event_list_row_t *child;
+    guint           n = model->events->len;
+    guint           c;
+
+    while ((c = 2 * i + 1) < n)
+    {
+        child = g_ptr_array_index(model->events, c);
+        if (c + 1 < n &&
+            ((event_list_row_t *) g_ptr_array_index(model->events, c + 1))->
+            event < child->event)
+        {
+            c++;
+            child = g_ptr_array_index(model->events, c);
+        }
+        if (row->event <= child->event)
+            break;
+        heap_set(model, i, child);
+        i = c;
+    }
+    heap_set(model, i, row);
+}
+
+static void heap_push(GtkEventListModel * model, event_list_row_t * row)
+{
+    g_ptr_array_add(model->events, row);
+    heap_sift_up(model, model->events->len - 1);
+}
+
+static event_list_row_t *heap_pop(GtkEventListModel * model)
+{
+    event_list_row_t *top = g_ptr_array_index(model->events, 0);
+    guint           last = model->events->len - 1;
+
+    heap_set(model, 0, g_ptr_array_index(model->events, last));
+    g_ptr_array_set_size(model->events, last);
+    if (last > 0)
+        heap_sift_down(model, 0);
+
+    return top;
+}
+
+/** Build the heap from the shown rows. */
+static void heap_build(GtkEventListModel * model)
+{
+    GPtrArray      *rows = model->parent.rows;
+    guint           i;
+
+    g_ptr_array_set_size(model->events, rows->len);
+    for (i = 0; i < rows->len; i++)
+        heap_set(model, i, g_ptr_array_index(rows, i));
+    for (i = model->events->len / 2; i > 0; i--)
+        heap_sift_down(model, i - 1);
+}
+
+/* Sorting */
+
+/** Sort key of a row for all columns but the name. */
+static gdouble sort_key(GtkEventListModel * model, event_list_row_t * row)
+{
+    sat_t          *sat = row->base.sat;
+
+    switch (model->parent.sort_column)
+    {
+    case EVENT_LIST_COL_AZ:
+        return sat->az;
+    case EVENT_LIST_COL_EL:
+        return sat->el;
+    case EVENT_LIST_COL_EVT:
+        return sat->el >= 0.0;
+    case EVENT_LIST_COL_TIME:
+        /* sorting by event time is sorting by countdown, "never" first */
+        return (row->event < G_MAXDOUBLE) ? row->event : -1.0;
+    case EVENT_LIST_COL_BOLD:
+        return sat->el > 0.0;
+    default:
+        return row->base.catnum;
+    }
+}
+
+/** Compute the sort keys of the shown rows. */
+static void prepare_keys(GtkSatRowModel * base_model)
+{
+    GtkEventListModel *model = GTK_EVENT_LIST_MODEL(base_model);
+    event_list_row_t *row;
+    guint           i;
+
+    for (i = 0; i < base_model->rows->len; i++)
+    {
+        row = g_ptr_array_index(base_model->rows, i);
+        row->base.key = sort_key(model, row);
+    }
+}
+
+/* Rows */
+
+/** Bring the per row data of a satellite up to date. */
+static void refresh_row(event_list_row_t * row)
+{
+    gtk_sat_row_model_refresh_name(&row->base);
+
+    row->event = next_event(row->base.sat);
+}
+
+static void add_sat(gpointer key, gpointer value, gpointer data)
+{
+    event_list_row_t *row;
+
+    (void)key;
+
+    row = g_new0(event_list_row_t, 1);
+    row->base.sat = SAT(value);
+    row->event = next_event(row->base.sat);
+    gtk_sat_row_model_add(GTK_SAT_ROW_MODEL(data), &row->base);
+}
+
+/**
+ * Check all events against the satellites.
+ *
+ * Decayed satellites are hidden and shown again, the events are read from
+ * the satellites, the heap is rebuilt and the rows are sorted again. Rows
+ * with a new event are marked as changed so that the view can measure them
+ * again.
+ */
+static void resync_rows(GtkEventListModel * model)
+{
+    GtkSatRowModel *base = &model->parent;
+    event_list_row_t *row;
+    gdouble         event;
+    guint           i;
+
+    g_ptr_array_set_size(model->events, 0);
+
+    for (i = base->rows->len; i > 0; i--)
+    {
+        row = g_ptr_array_index(base->rows, i - 1);
+        if (decayed(row->base.sat))
+            g_ptr_array_add(base->hidden,
+                            gtk_sat_row_model_unshow(base, i - 1));
+    }
+
+    /* the time may have been moved back */
+    for (i = base->hidden->len; i > 0; i--)
+    {
+        row = g_ptr_array_index(base->hidden, i - 1);
+        if (!decayed(row->base.sat))
+        {
+            g_ptr_array_remove_index_fast(base->hidden, i - 1);
+            gtk_sat_row_model_show(base, &row->base);
+        }
+    }
+
+    for (i = 0; i < base->rows->len; i++)
+    {
+        row = g_ptr_array_index(base->rows, i);
+        event = row->event;
+        refresh_row(row);
+        if (row->event != event)
+            gtk_sat_row_model_row_changed(base, &row->base);
+    }
+
+    heap_build(model);
+    gtk_sat_row_model_sort(base, FALSE);
+
+    model->synced = model->tstamp;
+    model->resync = FALSE;
+}
+
+/**
+ * Replace the satellites of the model.
+ *
+ * @param model The event list model.
+ * @param sats The satellites of the module.
+ *
+ * This must be called when satellites have been added to or removed from
+ * the hash table, since the rows refer to the satellites directly.
+ */
+void gtk_event_list_model_set_sats(GtkEventListModel * model,
+                                   GHashTable * sats)
+{
+    g_return_if_fail(IS_GTK_EVENT_LIST_MODEL(model));
+
+    g_ptr_array_set_size(model->events, 0);
+    gtk_sat_row_model_clear(&model->parent);
+
+    model->parent.sats = sats;
+    g_hash_table_foreach(sats, add_sat, model);
+
+    heap_build(model);
+    gtk_sat_row_model_sort(&model->parent, TRUE);
+    model->synced = model->tstamp;
+}
+
+/**
+ * Create a new event list model.
+ *
+ * @param sats The satellites of the module.
+ * @return A new GtkTreeModel sorted by the time of the next event.
+ */
+GtkTreeModel   *gtk_event_list_model_new(GHashTable * sats)
+{
+    GtkEventListModel *model;
+
+    model =
+        GTK_EVENT_LIST_MODEL(g_object_new(GTK_TYPE_EVENT_LIST_MODEL, NULL));
+    gtk_event_list_model_set_sats(model, sats);
+
+    return GTK_TREE_MODEL(model);
+}
+
+/**
+ * Update the model after the satellites have been recalculated.
+ *
+ * @param model The event list model.
+ * @param tstamp The time of the calculations.
+ *
+ * The rows whose event has passed are moved to their new place and marked
+ * as changed. The countdowns of the other rows are picked up when the view
+ * is redrawn.
+ */
+void gtk_event_list_model_update(GtkEventListModel * model, gdouble tstamp)
+{
+    event_list_row_t *row;
+    GSList         *passed = NULL;
+    GSList         *node;
+
+    g_return_if_fail(IS_GTK_EVENT_LIST_MODEL(model));
+
+    if (model->resync || tstamp < model->tstamp ||
+        tstamp - model->synced > RESYNC_INTERVAL)
+    {
+        model->tstamp = tstamp;
+        resync_rows(model);
+        return;
+    }
+
+    model->tstamp = tstamp;
+
+    /* take all passed events off the heap before putting them back, so
+       that an event that is not updated yet is only looked at once */
+    while (model->events->len > 0 &&
+           ((event_list_row_t *) g_ptr_array_index(model->events, 0))->
+           event <= tstamp)
+    {
+        passed = g_slist_prepend(passed, heap_pop(model));
+    }
+
+    for (node = passed; node != NULL; node = node->next)
+    {
+        row = node->data;
+        refresh_row(row);
+        heap_push(model, row);
+        gtk_sat_row_model_row_changed(&model->parent, &row->base);
+    }
+
+    if (passed != NULL || model->parent.sort_column == EVENT_LIST_COL_AZ ||
+        model->parent.sort_column == EVENT_LIST_COL_EL)
+    {
+        gtk_sat_row_model_sort(&model->parent, FALSE);
+    }
+
+    g_slist_free(passed);
+}
+
+/**
+ * Check all events against the satellites in the next update.
+ *
+ * @param model The event list model.
+ *
+ * This is used when the events of a satellite may have changed before they
+ * have passed, e.g. when the satellite has been refreshed.
+ */
+void gtk_event_list_model_resync(GtkEventListModel * model)
+{
+    g_return_if_fail(IS_GTK_EVENT_LIST_MODEL(model));
+
+    model->resync = TRUE;
+}
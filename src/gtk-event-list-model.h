@@ -0,0 +1,86 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef __GTK_EVENT_LIST_MODEL_H__
+#define __GTK_EVENT_LIST_MODEL_H__ 1
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include "gtk-sat-data.h"
+#include "gtk-sat-row-model.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#define GTK_TYPE_EVENT_LIST_MODEL   (gtk_event_list_model_get_type ())
+#define GTK_EVENT_LIST_MODEL(obj)   G_TYPE_CHECK_INSTANCE_CAST (obj,\
+                                        gtk_event_list_model_get_type (),\
+                                        GtkEventListModel)
+#define IS_GTK_EVENT_LIST_MODEL(obj) G_TYPE_CHECK_INSTANCE_TYPE (obj, gtk_event_list_model_get_type ())
+
+typedef struct _GtkEventListModel GtkEventListModel;
+typedef struct _GtkEventListModelClass GtkEventListModelClass;
+
+/**
+ * Tree model of the event list.
+ *
+ * The rows refer to the satellites of the module and the column values are
+ * computed when the tree view asks for them. The upcoming events are kept
+ * in a heap ordered by time, so that a cycle only has to look at the
+ * satellites whose AOS or LOS has passed. The columns are the ones in
+ * event_list_col_t.
+ */
+struct _GtkEventListModel {
+    GtkSatRowModel  parent;
+
+    GPtrArray      *events;     /*!< Shown rows as a heap ordered by next event. */
+
+    gdouble         tstamp;     /*!< Time of the current cycle. */
+    gdouble         synced;     /*!< Time the events were last checked against the satellites. */
+    gboolean        resync;     /*!< Check all events in the next cycle. */
+};
+
+struct _GtkEventListModelClass {
+    GtkSatRowModelClass parent_class;
+};
+
+GType           gtk_event_list_model_get_type(void);
+GtkTreeModel   *gtk_event_list_model_new(GHashTable * sats);
+void            gtk_event_list_model_set_sats(GtkEventListModel * model,
+                                              GHashTable * sats);
+void            gtk_event_list_model_update(GtkEventListModel * model,
+                                            gdouble tstamp);
+void            gtk_event_list_model_resync(GtkEventListModel * model);
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+}
+#endif
+/* *INDENT-ON* */
+
+#endif
@@ -31,6 +31,7 @@
 #include "config-keys.h"
 #include "gpredict-utils.h"
 #include "gtk-event-list.h"
+#include "gtk-event-list-model.h"
 #include "gtk-event-list-popup.h"
 #include "gtk-sat-data.h"
 #include "mod-cfg-get-param.h"
@@ -92,12 +93,6 @@ static void     gtk_event_list_class_init(GtkEventListClass * class,
 static void     gtk_event_list_init(GtkEventList * list,
 				    gpointer g_class);
 static void     gtk_event_list_destroy(GtkWidget * widget);
-static GtkTreeModel *create_and_fill_model(GHashTable * sats);
-static void     event_list_add_satellites(gpointer key,
-                                          gpointer value, gpointer user_data);
-static gboolean event_list_update_sats(GtkTreeModel * model,
-                                       GtkTreePath * path,
-                                       GtkTreeIter * iter, gpointer data);
 
 /* cell rendering related functions */
 static void     check_and_set_cell_renderer(GtkTreeViewColumn * column,
@@ -115,10 +110,6 @@ static void     degree_cell_data_function(GtkTreeViewColumn * col,
                                           GtkCellRenderer * renderer,
                                           GtkTreeModel * model,
                                           GtkTreeIter * iter, gpointer column);
-static gint     event_cell_compare_function(GtkTreeModel * model,
-                                            GtkTreeIter * a,
-                                            GtkTreeIter * b,
-                                            gpointer user_data);
 
 static gboolean popup_menu_cb(GtkWidget * treeview, gpointer list);
 static gboolean button_press_cb(GtkWidget * treeview,
@@ -202,7 +193,6 @@ GtkWidget      *gtk_event_list_new(GKeyFile * cfgdata, GHashTable * sats,
 {
     GtkWidget      *widget;
     GtkEventList   *evlist;
-    GtkTreeModel   *model, *filter, *sortable;
     guint           i;
     GtkCellRenderer *renderer;
     GtkTreeViewColumn *column;
@@ -280,27 +270,14 @@ GtkWidget      *gtk_event_list_new(GKeyFile * cfgdata, GHashTable * sats,
         }
     }
 
-    /* create model and finalise treeview */
-    model = create_and_fill_model(evlist->satellites);
-    filter = gtk_tree_model_filter_new(model, NULL);
-    sortable = gtk_tree_model_sort_new_with_model(filter);
-    evlist->sortable = sortable;
-    gtk_tree_model_filter_set_visible_column(GTK_TREE_MODEL_FILTER(filter),
-                                             EVENT_LIST_COL_DECAY);
-    gtk_tree_view_set_model(GTK_TREE_VIEW(evlist->treeview), sortable);
-
-    /* The time sort function needs to be special */
-    gtk_tree_sortable_set_sort_func(GTK_TREE_SORTABLE(sortable),
-                                    EVENT_LIST_COL_TIME,
-                                    event_cell_compare_function, NULL, NULL);
-
-    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(sortable),
+    /* create model and finalise treeview; the model hides decayed
+       satellites and keeps the rows in order of their next event */
+    evlist->model = gtk_event_list_model_new(evlist->satellites);
+    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(evlist->model),
                                          evlist->sort_column,
                                          evlist->sort_order);
-
-    g_object_unref(model);
-    g_object_unref(filter);
-    g_object_unref(sortable);
+    gtk_tree_view_set_model(GTK_TREE_VIEW(evlist->treeview), evlist->model);
+    g_object_unref(evlist->model);
 
     g_signal_connect(evlist->treeview, "button-press-event",
                      G_CALLBACK(button_press_cb), widget);
@@ -321,58 +298,14 @@ GtkWidget      *gtk_event_list_new(GKeyFile * cfgdata, GHashTable * sats,
     return widget;
 }
 
-/** Create and file the tree model for the even list. */
-static GtkTreeModel *create_and_fill_model(GHashTable * sats)
-{
-    GtkListStore   *liststore;
-
-    liststore = gtk_list_store_new(EVENT_LIST_COL_NUMBER, G_TYPE_STRING,        // name
-                                   G_TYPE_INT,  // catnum
-                                   G_TYPE_DOUBLE,       // az
-                                   G_TYPE_DOUBLE,       // el
-                                   G_TYPE_BOOLEAN,      // TRUE if AOS, FALSE if LOS
-                                   G_TYPE_DOUBLE,       // time
-                                   G_TYPE_BOOLEAN,      // decayed 
-                                   G_TYPE_INT); // bold for storing weight
-
-    g_hash_table_foreach(sats, event_list_add_satellites, liststore);
-
-    return GTK_TREE_MODEL(liststore);
-}
-
 /**
- * Add satellites. This function is a g_hash_table_foreach() callback.
- * @param key The key of the satellite in the hash table.
- * @param value Pointer to the satellite (sat_t structure) that should be added.
- * @param user_data Pointer to the GtkListStore where the satellite should be added
+ * Update satellites.
  *
- * This function is called by by the create_and_fill_models() function for adding
- * the satellites to the internal liststore.
+ * Only the rows whose AOS or LOS has passed are touched by the model; the
+ * countdowns are picked up when the visible rows are redrawn.
  */
-static void event_list_add_satellites(gpointer key, gpointer value,
-                                      gpointer user_data)
-{
-    GtkListStore   *store = GTK_LIST_STORE(user_data);
-    GtkTreeIter     item;
-    sat_t          *sat = SAT(value);
-
-    (void)key;
-
-    gtk_list_store_append(store, &item);
-    gtk_list_store_set(store, &item,
-                       EVENT_LIST_COL_NAME, sat->nickname,
-                       EVENT_LIST_COL_CATNUM, sat->tle.catnr,
-                       EVENT_LIST_COL_AZ, sat->az,
-                       EVENT_LIST_COL_EL, sat->el,
-                       EVENT_LIST_COL_EVT, (sat->el >= 0) ? TRUE : FALSE,
-                       EVENT_LIST_COL_TIME, 0.0,
-                       EVENT_LIST_COL_DECAY, !decayed(sat), -1);
-}
-
-/** Update satellites */
 void gtk_event_list_update(GtkWidget * widget)
 {
-    GtkTreeModel   *model;
     GtkEventList   *evlist = GTK_EVENT_LIST(widget);
 
     /* first, do some sanity checks */
@@ -383,123 +316,14 @@ void gtk_event_list_update(GtkWidget * widget)
         return;
     }
 
-    /* get and tranverse the model */
-    model =
-        gtk_tree_model_filter_get_model(GTK_TREE_MODEL_FILTER
-                                        (gtk_tree_model_sort_get_model
-                                         (GTK_TREE_MODEL_SORT
-                                          (gtk_tree_view_get_model
-                                           (GTK_TREE_VIEW
-                                            (evlist->treeview))))));
-
     /* save the sort information */
-    gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE(evlist->sortable),
+    gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE(evlist->model),
                                          &(evlist->sort_column),
                                          &(evlist->sort_order));
 
-    /* update */
-    gtk_tree_model_foreach(model, event_list_update_sats, evlist);
-
-#if 0
-    /* check refresh rate */
-    if (evlist->counter < evlist->refresh)
-    {
-        evlist->counter++;
-    }
-    else
-    {
-        evlist->counter = 1;
-
-        /* get and tranverse the model */
-        model =
-            gtk_tree_model_filter_get_model(gtk_tree_view_get_model
-                                            (GTK_TREE_VIEW(evlist->treeview)));
-
-
-        /* update */
-        gtk_tree_model_foreach(model, event_list_update_sats, evlist);
-    }
-#endif
-}
-
-/** Update data in each column in a given row */
-static gboolean event_list_update_sats(GtkTreeModel * model,
-                                       GtkTreePath * path,
-                                       GtkTreeIter * iter, gpointer data)
-{
-    GtkEventList   *evlist = GTK_EVENT_LIST(data);
-    guint          *catnum;
-    sat_t          *sat;
-    gdouble         number, now;
-
-    (void)path;
-
-    /* get the catalogue number for this row
-       then look it up in the hash table
-     */
-    catnum = g_new0(guint, 1);
-    gtk_tree_model_get(model, iter, EVENT_LIST_COL_CATNUM, catnum, -1);
-    sat = SAT(g_hash_table_lookup(evlist->satellites, catnum));
-
-    if (sat == NULL)
-    {
-        /* satellite not tracked anymore => remove */
-        sat_log_log(SAT_LOG_LEVEL_INFO,
-                    _("%s: Failed to get data for #%d."), __func__, *catnum);
-
-        gtk_list_store_remove(GTK_LIST_STORE(model), iter);
-
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: Satellite #%d removed from list."),
-                    __func__, *catnum);
-    }
-    else
-    {
-        /* update data */
-        now = evlist->tstamp;
-
-        if (sat->el > 0.0)
-        {
-            if (sat->los > 0.0)
-            {
-                number = sat->los - now;
-            }
-            else
-            {
-                number = -1.0;  /* Sat is staionary or no event */
-            }
-        }
-        else
-        {
-            if (sat->aos > 0.0)
-            {
-                number = sat->aos - now;
-            }
-            else
-            {
-                number = -1.0;  /* Sat is staionary or no event */
-            }
-        }
-
-        /* store new data */
-        gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                           EVENT_LIST_COL_AZ, sat->az,
-                           EVENT_LIST_COL_EL, sat->el,
-                           EVENT_LIST_COL_EVT, (sat->el >= 0) ? TRUE : FALSE,
-                           EVENT_LIST_COL_TIME, number,
-                           EVENT_LIST_COL_DECAY, !decayed(sat),
-                           EVENT_LIST_COL_BOLD,
-                           (sat->el >
-                            0.0) ? PANGO_WEIGHT_BOLD : PANGO_WEIGHT_NORMAL,
-                           -1);
-    }
-
-    g_free(catnum);
-
-    /* Return value not documented what to return, but it seems that
-       FALSE continues to next row while TRUE breaks
-     */
-    return FALSE;
+    gtk_event_list_model_update(GTK_EVENT_LIST_MODEL(evlist->model),
+                                evlist->tstamp);
+    gtk_widget_queue_draw(evlist->treeview);
 }
 
 /** Set cell renderer function. */
@@ -645,54 +469,6 @@ static void degree_cell_data_function(GtkTreeViewColumn * col,
     g_free(buff);
 }
 
-/**
- * Function to compare to Event cells.
- * @param model Pointer to the GtkTreeModel.
- * @param a Pointer to the first element.
- * @param b Pointer to the second element.
- * @param user_data Always NULL (TBC).
- * @return See detailed description.
- *
- * This function is used by the SatList sort function to determine whether
- * AOS/LOS cell a is greater than b or not. The cells a and b contain the
- * time of the event in Julian days, thus the result can be computed by a
- * simple comparison between the two numbers contained in the cells.
- *
- * The function returns -1 if a < b; +1 if a > b; 0 otherwise.
- */
-static gint event_cell_compare_function(GtkTreeModel * model,
-                                        GtkTreeIter * a,
-                                        GtkTreeIter * b, gpointer user_data)
-{
-    gint            result;
-    gdouble         ta, tb;
-    gint            sort_col = EVENT_LIST_COL_TIME;     /* hard coded as it is the only option */
-
-    /* extracting from models was not working */
-    /* with filter and sorting */
-
-    (void)user_data;
-
-    /* get a and b */
-    gtk_tree_model_get(model, a, sort_col, &ta, -1);
-    gtk_tree_model_get(model, b, sort_col, &tb, -1);
-
-    if (ta < tb)
-    {
-        result = -1;
-    }
-    else if (ta > tb)
-    {
-        result = 1;
-    }
-    else
-    {
-        result = 0;
-    }
-
-    return result;
-}
-
 /** Reload configuration */
 void gtk_event_list_reconf(GtkWidget * widget, GKeyFile * cfgdat)
 {
@@ -844,6 +620,22 @@ static void view_popup_menu(GtkWidget * treeview, GdkEventButton * event,
 void gtk_event_list_reload_sats(GtkWidget * evlist, GHashTable * sats)
 {
     GTK_EVENT_LIST(evlist)->satellites = sats;
+    gtk_event_list_model_set_sats(GTK_EVENT_LIST_MODEL
+                                  (GTK_EVENT_LIST(evlist)->model), sats);
+}
+
+/**
+ * Pick up refreshed elements of a satellite.
+ *
+ * The events of the satellite have been computed again, so the model has
+ * to check them before they pass.
+ */
+void gtk_event_list_refresh_sat(GtkWidget * widget, gint catnum)
+{
+    (void)catnum;
+
+    gtk_event_list_model_resync(GTK_EVENT_LIST_MODEL
+                                (GTK_EVENT_LIST(widget)->model));
 }
 
 /** Select satellite. */
@@ -861,7 +653,7 @@ void gtk_event_list_select_sat(GtkWidget * widget, gint catnum)
     selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(list->treeview));
 
     /* iterate over the satellite list until a amtch is found */
-    n = g_hash_table_size(list->satellites);
+    n = gtk_tree_model_iter_n_children(model, NULL);
     for (i = 0; i < n; i++)
     {
 
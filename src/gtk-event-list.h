@@ -43,7 +43,7 @@ struct _gtk_event_list {
     GKeyFile       *cfgdata;
     gint            sort_column;
     GtkSortType     sort_order;
-    GtkTreeModel   *sortable;
+    GtkTreeModel   *model;      /*!< the event list model, see gtk-event-list-model.c */
 
     void            (*update) (GtkWidget * widget);     /*!< update function */
 
@@ -85,6 +85,7 @@ void            gtk_event_list_reconf(GtkWidget * widget, GKeyFile * cfgdat);
 
 void            gtk_event_list_reload_sats(GtkWidget * satlist,
                                            GHashTable * sats);
+void            gtk_event_list_refresh_sat(GtkWidget * widget, gint catnum);
 void            gtk_event_list_select_sat(GtkWidget * widget, gint catnum);
 
 /* *INDENT-OFF* */
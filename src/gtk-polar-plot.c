@@ -50,6 +50,7 @@
 #include "sat-cfg.h"
 #include "sat-log.h"
 #include "sgpsdp/sgp4sdp4.h"
+#include "sky-track.h"
 #include "time-tools.h"
 
 #define POLV_DEFAULT_SIZE 200
@@ -69,7 +70,7 @@ static void gtk_polar_plot_init(GtkPolarPlot * polview,
     (void)g_class;
 
     polview->qth = NULL;
-    polview->pass = NULL;
+    polview->sky = NULL;
     polview->size = 0;
     polview->r = 0;
     polview->cx = 0;
@@ -83,11 +84,8 @@ static void gtk_polar_plot_init(GtkPolarPlot * polview,
 
 static void gtk_polar_plot_destroy(GtkWidget * widget)
 {
-    if (GTK_POLAR_PLOT(widget)->pass != NULL)
-    {
-        free_pass(GTK_POLAR_PLOT(widget)->pass);
-        GTK_POLAR_PLOT(widget)->pass = NULL;
-    }
+    sky_track_unref(GTK_POLAR_PLOT(widget)->sky);
+    GTK_POLAR_PLOT(widget)->sky = NULL;
 
     (*GTK_WIDGET_CLASS(parent_class)->destroy) (widget);
 }
@@ -130,21 +128,31 @@ GType gtk_polar_plot_get_type()
     return gtk_polar_plot_type;
 }
 
-static GooCanvasItemModel *create_time_tick(GtkPolarPlot * pv, gdouble time,
-                                            gfloat x, gfloat y)
+static GooCanvasItemModel *create_time_tick(GtkPolarPlot * pv)
 {
-    GooCanvasItemModel *item;
-    GooCanvasAnchorType     anchor;
     GooCanvasItemModel *root;
     guint32         col;
-    gchar           buff[6];
 
     root = goo_canvas_get_root_item_model(GOO_CANVAS(pv->canvas));
 
     col = sat_cfg_get_int(SAT_CFG_INT_POLAR_TRACK_COL);
 
+    return goo_canvas_text_model_new(root, "", 0.0, 0.0, -1,
+                                     GOO_CANVAS_ANCHOR_WEST,
+                                     "font", "Sans 7",
+                                     "fill-color-rgba", col, NULL);
+}
+
+/* Put a time tick next to a point of the sky track */
+static void place_time_tick(GtkPolarPlot * pv, GooCanvasItemModel * item,
+                            gdouble time, gdouble x, gdouble y)
+{
+    gchar           buff[6];
+    GooCanvasAnchorType anchor;
+
     daynum_to_str(buff, 6, "%H:%M", time);
 
+    /* make room between text and track */
     if (x > pv->cx)
     {
         anchor = GOO_CANVAS_ANCHOR_EAST;
@@ -156,13 +164,8 @@ static GooCanvasItemModel *create_time_tick(GtkPolarPlot * pv, gdouble time,
         x += 5;
     }
 
-    item = goo_canvas_text_model_new(root, buff,
-                                     (gdouble) x, (gdouble) y,
-                                     -1, anchor,
-                                     "font", "Sans 7",
-                                     "fill-color-rgba", col, NULL);
-
-    return item;
+    g_object_set(item, "text", buff, "x", x, "y", y, "anchor", anchor,
+                 "visibility", GOO_CANVAS_ITEM_VISIBLE, NULL);
 }
 
 /** Convert Az/El to canvas based XY coordinates. */
@@ -258,71 +261,113 @@ static void xy_to_azel(GtkPolarPlot * p, gfloat x, gfloat y,
     }
 }
 
-static void create_track(GtkPolarPlot * pv)
+/* Scale of the unit disc of the sky track on the canvas */
+static void track_scale(GtkPolarPlot * pv, gdouble * rx, gdouble * ry)
 {
-    guint           i;
-    GooCanvasItemModel *root;
-    pass_detail_t  *detail;
-    guint           num;
-    GooCanvasPoints *points;
-    gfloat          x, y;
-    guint32         col;
-    guint           tres, ttidx;
+    *rx = pv->r;
+    *ry = pv->r;
 
-    root = goo_canvas_get_root_item_model(GOO_CANVAS(pv->canvas));
+    switch (pv->swap)
+    {
+    case POLAR_PLOT_NWSE:
+        *rx = -*rx;
+        break;
+
+    case POLAR_PLOT_SENW:
+        *ry = -*ry;
+        break;
 
-    /* create points */
-    num = g_slist_length(pv->pass->details);
+    case POLAR_PLOT_SWNE:
+        *rx = -*rx;
+        *ry = -*ry;
+        break;
 
-    /* time resolution for time ticks; we need
-       3 additional points to AOS and LOS ticks.
-     */
-    tres = (num - 2) / (TRACK_TICK_NUM - 1);
+    default:
+        break;
+    }
+}
 
-    points = goo_canvas_points_new(num);
+/**
+ * Map the sky track to its canvas items.
+ *
+ * This is all it takes to move the track items to a new pass or to a new
+ * size of the plot.
+ */
+static void project_track(GtkPolarPlot * pv)
+{
+    GooCanvasPoints *points;
+    guint           index[TRACK_TICK_NUM];
+    gdouble         rx, ry;
+    guint           i, n;
 
-    /* first point should be (aos_az,0.0) */
-    azel_to_xy(pv, pv->pass->aos_az, 0.0, &x, &y);
-    points->coords[0] = (double)x;
-    points->coords[1] = (double)y;
-    pv->trtick[0] = create_time_tick(pv, pv->pass->aos, x, y);
+    track_scale(pv, &rx, &ry);
 
-    ttidx = 1;
+    points = goo_canvas_points_new(pv->sky->num);
+    sky_track_project(pv->sky, pv->cx, pv->cy, rx, ry, points->coords);
+    g_object_set(pv->track, "points", points, NULL);
 
-    for (i = 1; i < num - 1; i++)
+    n = sky_track_ticks(pv->sky, TRACK_TICK_NUM, index);
+    for (i = 0; i < TRACK_TICK_NUM; i++)
     {
-        detail = PASS_DETAIL(g_slist_nth_data(pv->pass->details, i));
-        if (detail->el >= 0.0)
-            azel_to_xy(pv, detail->az, detail->el, &x, &y);
-        points->coords[2 * i] = (double)x;
-        points->coords[2 * i + 1] = (double)y;
-
-        if (!(i % tres))
-        {
-            if (ttidx < TRACK_TICK_NUM)
-                /* create a time tick */
-                pv->trtick[ttidx] = create_time_tick(pv, detail->time, x, y);
-            ttidx++;
-        }
+        if (i < n)
+            place_time_tick(pv, pv->trtick[i], pv->sky->time[index[i]],
+                            points->coords[2 * index[i]],
+                            points->coords[2 * index[i] + 1]);
+        else
+            g_object_set(pv->trtick[i],
+                         "visibility", GOO_CANVAS_ITEM_INVISIBLE, NULL);
     }
 
-    /* last point should be (los_az, 0.0)  */
-    azel_to_xy(pv, pv->pass->los_az, 0.0, &x, &y);
-    points->coords[2 * (num - 1)] = (double)x;
-    points->coords[2 * (num - 1) + 1] = (double)y;
+    goo_canvas_points_unref(points);
+}
+
+static void create_track(GtkPolarPlot * pv)
+{
+    guint           i;
+    GooCanvasItemModel *root;
+    guint32         col;
+
+    root = goo_canvas_get_root_item_model(GOO_CANVAS(pv->canvas));
 
     /* create poly-line */
     col = sat_cfg_get_int(SAT_CFG_INT_POLAR_TRACK_COL);
 
     pv->track = goo_canvas_polyline_model_new(root, FALSE, 0,
-                                              "points", points,
                                               "line-width", 1.0,
                                               "stroke-color-rgba", col,
                                               "line-cap",
                                               CAIRO_LINE_CAP_SQUARE,
                                               "line-join",
                                               CAIRO_LINE_JOIN_MITER, NULL);
-    goo_canvas_points_unref(points);
+
+    for (i = 0; i < TRACK_TICK_NUM; i++)
+        pv->trtick[i] = create_time_tick(pv);
+
+    project_track(pv);
+}
+
+/* Remove the sky track and its time ticks from the canvas */
+static void delete_track(GtkPolarPlot * pv)
+{
+    GooCanvasItemModel *root;
+    gint            idx, i;
+
+    if (pv->track == NULL)
+        return;
+
+    root = goo_canvas_get_root_item_model(GOO_CANVAS(pv->canvas));
+    idx = goo_canvas_item_model_find_child(root, pv->track);
+    if (idx != -1)
+        goo_canvas_item_model_remove_child(root, idx);
+    pv->track = NULL;
+
+    for (i = 0; i < TRACK_TICK_NUM; i++)
+    {
+        idx = goo_canvas_item_model_find_child(root, pv->trtick[i]);
+        if (idx != -1)
+            goo_canvas_item_model_remove_child(root, idx);
+        pv->trtick[i] = NULL;
+    }
 }
 
 /**
@@ -526,70 +571,6 @@ static GooCanvasItemModel *create_canvas_model(GtkPolarPlot * polv)
     return root;
 }
 
-/** Update sky track drawing after size allocate. */
-static void update_track(GtkPolarPlot * pv)
-{
-    guint           num, i;
-    GooCanvasPoints *points;
-    gfloat          x, y;
-    pass_detail_t  *detail;
-    guint           tres, ttidx;
-
-    /* create points */
-    num = g_slist_length(pv->pass->details);
-
-    points = goo_canvas_points_new(num);
-
-    /* first point should be (aos_az,0.0) */
-    azel_to_xy(pv, pv->pass->aos_az, 0.0, &x, &y);
-    points->coords[0] = (double)x;
-    points->coords[1] = (double)y;
-
-    /* time tick 0 */
-    g_object_set(pv->trtick[0], "x", (gdouble) x, "y", (gdouble) y, NULL);
-
-    /* time resolution for time ticks; we need
-       3 additional points to AOS and LOS ticks.
-     */
-    tres = (num - 2) / (TRACK_TICK_NUM - 1);
-    ttidx = 1;
-
-    for (i = 1; i < num - 1; i++)
-    {
-        detail = PASS_DETAIL(g_slist_nth_data(pv->pass->details, i));
-        if (detail->el >= 0.0)
-            azel_to_xy(pv, detail->az, detail->el, &x, &y);
-        points->coords[2 * i] = (double)x;
-        points->coords[2 * i + 1] = (double)y;
-
-        if (!(i % tres))
-        {
-            /* make room between text and track */
-            if (x > pv->cx)
-                x -= 5;
-            else
-                x += 5;
-
-            /* update time tick */
-            if (ttidx < TRACK_TICK_NUM)
-            {
-                g_object_set(pv->trtick[ttidx],
-                             "x", (gdouble) x, "y", (gdouble) y, NULL);
-            }
-            ttidx++;
-        }
-    }
-
-    /* last point should be (los_az, 0.0)  */
-    azel_to_xy(pv, pv->pass->los_az, 0.0, &x, &y);
-    points->coords[2 * (num - 1)] = (double)x;
-    points->coords[2 * (num - 1) + 1] = (double)y;
-
-    g_object_set(pv->track, "points", points, NULL);
-
-    goo_canvas_points_unref(points);
-}
-
 /**
  * Manage new size allocation.
  *
@@ -687,8 +668,8 @@ static void size_allocate_cb(GtkWidget * widget, GtkAllocation * allocation,
                      NULL);
 
         /* sky track */
-        if (polv->pass != NULL)
-            update_track(polv);
+        if (polv->track != NULL)
+            project_track(polv);
     }
 }
 
@@ -775,7 +756,7 @@ GtkWidget *gtk_polar_plot_new(qth_t * qth, pass_t * pass)
     polv->qth = qth;
 
     if (pass != NULL)
-        polv->pass = copy_pass(pass);
+        polv->sky = sky_track_new(pass);
 
     /* get settings */
     polv->swap = sat_cfg_get_int(SAT_CFG_INT_POLAR_ORIENTATION);
@@ -805,7 +786,7 @@ GtkWidget *gtk_polar_plot_new(qth_t * qth, pass_t * pass)
     goo_canvas_set_root_item_model(GOO_CANVAS(polv->canvas), root);
     g_object_unref(root);
 
-    if (polv->pass != NULL)
+    if (polv->sky != NULL)
         create_track(polv);
 
     gtk_box_pack_start(GTK_BOX(polv), polv->canvas, TRUE, TRUE, 0);
@@ -822,35 +803,16 @@ GtkWidget *gtk_polar_plot_new(qth_t * qth, pass_t * pass)
  */
 void gtk_polar_plot_set_pass(GtkPolarPlot * plot, pass_t * pass)
 {
-    GooCanvasItemModel *root;
-    gint            idx, i;
+    sky_track_unref(plot->sky);
+    plot->sky = (pass != NULL) ? sky_track_new(pass) : NULL;
 
-    /* remove sky track, time ticks and the pass itself */
-    if (plot->pass != NULL)
-    {
-        /* remove sat from canvas */
-        root = goo_canvas_get_root_item_model(GOO_CANVAS(plot->canvas));
-        idx = goo_canvas_item_model_find_child(root, plot->track);
-
-        if (idx != -1)
-            goo_canvas_item_model_remove_child(root, idx);
-
-        for (i = 0; i < TRACK_TICK_NUM; i++)
-        {
-            idx = goo_canvas_item_model_find_child(root, plot->trtick[i]);
-            if (idx != -1)
-                goo_canvas_item_model_remove_child(root, idx);
-        }
-
-        free_pass(plot->pass);
-        plot->pass = NULL;
-    }
-
-    if (pass != NULL)
-    {
-        plot->pass = copy_pass(pass);
+    /* move the sky track and time ticks to the new pass if there are any */
+    if (plot->sky == NULL)
+        delete_track(plot);
+    else if (plot->track == NULL)
         create_track(plot);
-    }
+    else
+        project_track(plot);
 }
 
 /**
@@ -33,6 +33,7 @@
 
 #include "gtk-sat-data.h"
 #include "predict-tools.h"
+#include "sky-track.h"
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -80,7 +81,7 @@ struct _GtkPolarPlot {
     GooCanvasItemModel *locnam; /*!< Location name */
     GooCanvasItemModel *curs;   /*!< cursor tracking text */
 
-    pass_t         *pass;
+    sky_track_t    *sky;        /*!< Sky track of the pass */
     GooCanvasItemModel *bgd;    /*!< Background */
     GooCanvasItemModel *track;  /*!< Sky track. */
     GooCanvasItemModel *target; /*!< Target object marker */
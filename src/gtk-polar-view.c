@@ -36,6 +36,8 @@
 #include "sat-info.h"
 #include "sat-log.h"
 #include "sgpsdp/sgp4sdp4.h"
+#include "sky-track.h"
+#include "station-ctrl.h"
 #include "time-tools.h"
 
 #define POLV_DEFAULT_SIZE 100
@@ -45,8 +47,21 @@
 /* extra size for line outside 0 deg circle (inside margin) */
 #define POLV_LINE_EXTRA 5
 
+/* largest distance of a click to a marker in pixels */
+#define HIT_RADIUS 4.0
+
+/* cell size of the marker and label grids in pixels */
+#define GRID_CELL 64.0
+
 static void     update_sat(gpointer key, gpointer value, gpointer data);
 static void     update_track(gpointer key, gpointer value, gpointer data);
+static void     project_track(GtkPolarView * pv, sat_obj_t * obj);
+static void     set_sky_track(GtkPolarView * pv, sat_obj_t * obj,
+                              sat_t * sat, gdouble t);
+static void     update_label(gpointer key, gpointer value, gpointer data);
+static gchar   *sat_tooltip(GtkPolarView * polv, sat_t * sat);
+static void     index_sats(GtkPolarView * polv);
+static sat_obj_t *find_sat(GtkPolarView * polv, gdouble x, gdouble y);
 
 static GtkVBoxClass *parent_class = NULL;
 
@@ -78,7 +93,14 @@ static void gtk_polar_view_load_showtracks(GtkPolarView * pv)
 
 static void gtk_polar_view_destroy(GtkWidget * widget)
 {
-    gtk_polar_view_store_showtracks(GTK_POLAR_VIEW(widget));
+    GtkPolarView   *polv = GTK_POLAR_VIEW(widget);
+
+    gtk_polar_view_store_showtracks(polv);
+
+    screen_grid_free(polv->markers);
+    polv->markers = NULL;
+    screen_grid_free(polv->labels);
+    polv->labels = NULL;
 
     (*GTK_WIDGET_CLASS(parent_class)->destroy) (widget);
 }
@@ -117,6 +139,9 @@ static void gtk_polar_view_init(GtkPolarView * polview,
     polview->cursinfo = FALSE;
     polview->extratick = FALSE;
     polview->resize = FALSE;
+    polview->declutter = FALSE;
+    polview->markers = NULL;
+    polview->labels = NULL;
 }
 
 GType gtk_polar_view_get_type()
@@ -185,19 +210,12 @@ static void on_canvas_realized(GtkWidget * canvas, gpointer data)
  * If the pressed button is #3 (right button) the satellite popup menu will be
  * created and executed.
  */
-static gboolean on_button_press(GooCanvasItem * item,
-                                GooCanvasItem * target,
-                                GdkEventButton * event, gpointer data)
+static void sat_button_press(GtkPolarView * polv, gint catnum,
+                             GdkEventButton * event)
 {
-    GooCanvasItemModel *model = goo_canvas_item_get_model(item);
-    GtkPolarView   *polv = GTK_POLAR_VIEW(data);
-    gint            catnum =
-        GPOINTER_TO_INT(g_object_get_data(G_OBJECT(model), "catnum"));
     gint           *catpoint = NULL;
     sat_t          *sat = NULL;
 
-    (void)target;
-
     switch (event->button)
     {
         /* double-left-click */
@@ -210,7 +228,7 @@ static gboolean on_button_press(GooCanvasItem * item,
             sat = SAT(g_hash_table_lookup(polv->sats, catpoint));
             if (sat != NULL)
             {
-                show_sat_info(sat, gtk_widget_get_toplevel(GTK_WIDGET(data)));
+                show_sat_info(sat, gtk_widget_get_toplevel(GTK_WIDGET(polv)));
             }
             else
             {
@@ -246,8 +264,6 @@ static gboolean on_button_press(GooCanvasItem * item,
     default:
         break;
     }
-
-    return TRUE;
 }
 
 /**
@@ -284,20 +300,13 @@ static void clear_selection(gpointer key, gpointer val, gpointer data)
  * button is the left one, the click will correspond to selecting or
  * deselecting a satellite
  */
-static gboolean on_button_release(GooCanvasItem * item,
-                                  GooCanvasItem * target,
-                                  GdkEventButton * event, gpointer data)
+static void sat_button_release(GtkPolarView * polv, gint catnum,
+                               GdkEventButton * event)
 {
-    GooCanvasItemModel *model = goo_canvas_item_get_model(item);
-    GtkPolarView   *polv = GTK_POLAR_VIEW(data);
-    gint            catnum =
-        GPOINTER_TO_INT(g_object_get_data(G_OBJECT(model), "catnum"));
     gint           *catpoint = NULL;
     sat_obj_t      *obj = NULL;
     guint32         color;
 
-    (void)target;
-
     catpoint = g_try_new0(gint, 1);
     *catpoint = catnum;
 
@@ -344,6 +353,7 @@ static gboolean on_button_release(GooCanvasItem * item,
 
             /* clear other selections */
             g_hash_table_foreach(polv->obj, clear_selection, catpoint);
+            index_sats(polv);
         }
         break;
 
@@ -352,6 +362,77 @@ static gboolean on_button_release(GooCanvasItem * item,
     }
 
     g_free(catpoint);
+}
+
+/**
+ * Manage button press events on the canvas.
+ *
+ * The satellite under the pointer is looked up in the marker and label
+ * grids before GooCanvas picks an item. Clicks elsewhere, e.g. on a sky
+ * track, go to the canvas.
+ */
+static gboolean on_canvas_button_press(GtkWidget * widget,
+                                       GdkEventButton * event, gpointer data)
+{
+    GtkPolarView   *polv = GTK_POLAR_VIEW(data);
+    sat_obj_t      *obj;
+
+    (void)widget;
+
+    obj = find_sat(polv, event->x, event->y);
+    if (obj == NULL)
+        return FALSE;
+
+    sat_button_press(polv, obj->catnum, event);
+
+    return TRUE;
+}
+
+/** Manage button release events on the canvas. */
+static gboolean on_canvas_button_release(GtkWidget * widget,
+                                         GdkEventButton * event,
+                                         gpointer data)
+{
+    GtkPolarView   *polv = GTK_POLAR_VIEW(data);
+    sat_obj_t      *obj;
+
+    (void)widget;
+
+    obj = find_sat(polv, event->x, event->y);
+    if (obj == NULL)
+        return FALSE;
+
+    sat_button_release(polv, obj->catnum, event);
+
+    return TRUE;
+}
+
+/** Show the tooltip of the satellite under the pointer. */
+static gboolean on_query_tooltip(GtkWidget * widget, gint x, gint y,
+                                 gboolean keyboard_mode, GtkTooltip * tooltip,
+                                 gpointer data)
+{
+    GtkPolarView   *polv = GTK_POLAR_VIEW(data);
+    sat_obj_t      *obj;
+    sat_t          *sat;
+    gchar          *text;
+
+    (void)widget;
+
+    if (keyboard_mode)
+        return FALSE;
+
+    obj = find_sat(polv, x, y);
+    if (obj == NULL)
+        return FALSE;
+
+    sat = SAT(g_hash_table_lookup(polv->sats, &obj->catnum));
+    if (sat == NULL)
+        return FALSE;
+
+    text = sat_tooltip(polv, sat);
+    gtk_tooltip_set_markup(tooltip, text);
+    g_free(text);
 
     return TRUE;
 }
@@ -494,7 +575,9 @@ static gboolean on_motion_notify(GooCanvasItem * item,
  * @param data Pointer to the GtkPolarView object.
  *
  * This function is called when a canvas item is created. Its purpose is to connect
- * the corresponding signals to the created items.
+ * the corresponding signals to the created items. Clicks and tooltips on
+ * satellites are handled by the canvas widget, see on_canvas_button_press()
+ * and on_query_tooltip().
  */
 static void on_item_created(GooCanvas * canvas,
                             GooCanvasItem * item,
@@ -508,14 +591,6 @@ static void on_item_created(GooCanvas * canvas,
         g_signal_connect(item, "motion_notify_event",
                          (GCallback) on_motion_notify, data);
     }
-
-    else if (!g_object_get_data(G_OBJECT(item), "skip-signal-connection"))
-    {
-        g_signal_connect(item, "button_press_event",
-                         (GCallback) on_button_press, data);
-        g_signal_connect(item, "button_release_event",
-                         (GCallback) on_button_release, data);
-    }
 }
 
 /**
@@ -808,6 +883,13 @@ GtkWidget      *gtk_polar_view_new(GKeyFile * cfgdata, GHashTable * sats,
     polv->extratick = mod_cfg_get_bool(cfgdata, MOD_CFG_POLAR_SECTION,
                                        MOD_CFG_POLAR_SHOW_EXTRA_AZ_TICKS,
                                        SAT_CFG_BOOL_POL_SHOW_EXTRA_AZ_TICKS);
+
+    polv->declutter = mod_cfg_get_bool(cfgdata, MOD_CFG_POLAR_SECTION,
+                                       MOD_CFG_POLAR_DECLUTTER,
+                                       SAT_CFG_BOOL_POL_DECLUTTER);
+    polv->markers = screen_grid_new(GRID_CELL);
+    polv->labels = screen_grid_new(GRID_CELL);
+
     gtk_polar_view_load_showtracks(polv);
 
     /* create the canvas */
@@ -822,6 +904,12 @@ GtkWidget      *gtk_polar_view_new(GKeyFile * cfgdata, GHashTable * sats,
                      G_CALLBACK(size_allocate_cb), polv);
     g_signal_connect(polv->canvas, "item_created",
                      (GCallback) on_item_created, polv);
+    g_signal_connect(polv->canvas, "button-press-event",
+                     G_CALLBACK(on_canvas_button_press), polv);
+    g_signal_connect(polv->canvas, "button-release-event",
+                     G_CALLBACK(on_canvas_button_release), polv);
+    g_signal_connect(polv->canvas, "query-tooltip",
+                     G_CALLBACK(on_query_tooltip), polv);
     g_signal_connect_after(polv->canvas, "realize",
                            (GCallback) on_canvas_realized, polv);
     gtk_widget_show(polv->canvas);
@@ -940,6 +1028,7 @@ static void update_polv_size(GtkPolarView * polv)
                      "y", (gfloat) polv->cy + polv->r + POLV_LINE_EXTRA, NULL);
 
         g_hash_table_foreach(polv->sats, update_sat, polv);
+        index_sats(polv);
 
         /* sky tracks */
         g_hash_table_foreach(polv->obj, update_track, polv);
@@ -976,6 +1065,7 @@ void gtk_polar_view_update(GtkWidget * widget)
 
         /* update sats */
         g_hash_table_foreach(polv->sats, update_sat, polv);
+        index_sats(polv);
 
         /* update countdown to NEXT AOS label */
         if (polv->eventinfo)
@@ -1039,13 +1129,20 @@ void gtk_polar_view_update(GtkWidget * widget)
     }
 }
 
-/** Convert LOS timestamp to human readable countdown string */
+/**
+ * Convert LOS timestamp to human readable countdown string.
+ *
+ * Satellites without LOS, e.g. geostationary ones, are always in range.
+ */
 static gchar   *los_time_to_str(GtkPolarView * polv, sat_t * sat)
 {
     guint           h, m, s;
     gdouble         number, now;
     gchar          *text = NULL;
 
+    if (sat->los <= 0.0)
+        return g_strdup_printf(_("%s\nAlways in range"), sat->nickname);
+
     now = polv->tstamp;         //get_current_daynum ();
     number = sat->los - now;
 
@@ -1072,6 +1169,171 @@ static gchar   *los_time_to_str(GtkPolarView * polv, sat_t * sat)
     return text;
 }
 
+/**
+ * Set the label of a satellite to its current nickname.
+ *
+ * The label text is not touched in the update cycle; it only changes when
+ * the satellite data is reloaded.
+ */
+static void update_label(gpointer key, gpointer value, gpointer data)
+{
+    sat_obj_t      *obj = SAT_OBJ(value);
+    GtkPolarView   *polv = GTK_POLAR_VIEW(data);
+    sat_t          *sat;
+
+    sat = SAT(g_hash_table_lookup(polv->sats, key));
+    if (sat != NULL)
+    {
+        g_object_set(obj->label, "text", sat->nickname, NULL);
+        obj->label_w = 0.0;
+    }
+}
+
+/**
+ * Create the tooltip of a satellite.
+ *
+ * @param polv The GtkPolarView widget.
+ * @param sat The satellite.
+ * @return A newly allocated markup string.
+ */
+static gchar   *sat_tooltip(GtkPolarView * polv, sat_t * sat)
+{
+    gchar          *losstr;
+    gchar          *tooltip;
+
+    losstr = los_time_to_str(polv, sat);
+    tooltip = g_markup_printf_escaped("<b>%s</b>\n"
+                                      "Az: %5.1f\302\260\n"
+                                      "El: %5.1f\302\260\n"
+                                      "%s",
+                                      sat->nickname,
+                                      sat->az, sat->el, losstr);
+    g_free(losstr);
+
+    return tooltip;
+}
+
+/**
+ * Get the area covered by the label of a satellite.
+ *
+ * The size of the label is taken from its canvas item when it is not
+ * known yet, e.g. after the label text has changed.
+ */
+static void label_box(GtkPolarView * polv, sat_obj_t * obj,
+                      gdouble * x, gdouble * y, gdouble * w, gdouble * h)
+{
+    GooCanvasItem  *item;
+    GooCanvasBounds bounds;
+
+    if (obj->label_w == 0.0)
+    {
+        item = goo_canvas_get_item(GOO_CANVAS(polv->canvas), obj->label);
+        if (item != NULL)
+        {
+            goo_canvas_item_get_bounds(item, &bounds);
+            obj->label_w = bounds.x2 - bounds.x1;
+            obj->label_h = bounds.y2 - bounds.y1;
+        }
+    }
+
+    /* anchored north, 2 pixels below the marker */
+    *x = obj->x - obj->label_w / 2.0;
+    *y = obj->y + 2.0;
+    *w = obj->label_w;
+    *h = obj->label_h;
+}
+
+/* Add the label of a satellite to the label grid, or hide it */
+static void place_label(GtkPolarView * polv, sat_obj_t * obj)
+{
+    gdouble         x, y, w, h;
+    gboolean        shown;
+
+    label_box(polv, obj, &x, &y, &w, &h);
+    shown = !polv->declutter || obj->selected ||
+        !screen_grid_overlaps(polv->labels, x, y, w, h);
+
+    if (shown)
+        screen_grid_add(polv->labels, x, y, w, h, obj);
+
+    if (shown != obj->label_shown)
+    {
+        obj->label_shown = shown;
+        g_object_set(obj->label, "visibility", shown ?
+                     GOO_CANVAS_ITEM_VISIBLE : GOO_CANVAS_ITEM_HIDDEN, NULL);
+    }
+}
+
+/**
+ * Rebuild the marker and label grids after the satellites have moved.
+ *
+ * The labels are placed in order, the selected satellite first, and with
+ * decluttering a label that would overlap one placed before is hidden.
+ * The labels that were shown in the previous cycle are placed before the
+ * hidden ones, so a label stays in place as long as it still fits instead
+ * of flickering with its neighbours.
+ */
+static void index_sats(GtkPolarView * polv)
+{
+    GtkAllocation   allocation;
+    GHashTableIter  iter;
+    gpointer        value;
+    GPtrArray      *hidden;
+    sat_obj_t      *obj;
+    guint           i;
+
+    gtk_widget_get_allocation(polv->canvas, &allocation);
+    screen_grid_reset(polv->markers, allocation.width, allocation.height);
+    screen_grid_reset(polv->labels, allocation.width, allocation.height);
+
+    g_hash_table_iter_init(&iter, polv->obj);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        obj = SAT_OBJ(value);
+        screen_grid_add(polv->markers, obj->x, obj->y, 0.0, 0.0, obj);
+        if (obj->selected)
+            place_label(polv, obj);
+    }
+
+    hidden = g_ptr_array_new();
+    g_hash_table_iter_init(&iter, polv->obj);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        obj = SAT_OBJ(value);
+        if (obj->selected)
+            continue;
+
+        if (obj->label_shown)
+            place_label(polv, obj);
+        else
+            g_ptr_array_add(hidden, obj);
+    }
+
+    for (i = 0; i < hidden->len; i++)
+        place_label(polv, g_ptr_array_index(hidden, i));
+    g_ptr_array_free(hidden, TRUE);
+}
+
+/**
+ * Find the satellite at a given position.
+ *
+ * @param polv The GtkPolarView widget.
+ * @param x The x coordinate in canvas units.
+ * @param y The y coordinate in canvas units.
+ * @return The satellite object whose marker is closest to x,y, or whose
+ *         label contains x,y, or NULL if there is none.
+ */
+static sat_obj_t *find_sat(GtkPolarView * polv, gdouble x, gdouble y)
+{
+    sat_obj_t      *obj;
+
+    obj = screen_grid_find(polv->markers, x, y, HIT_RADIUS);
+    if (obj == NULL)
+        obj = screen_grid_find(polv->labels, x, y, 0.0);
+
+    return obj;
+}
+
 static void update_sat(gpointer key, gpointer value, gpointer data)
 {
     gint           *catnum;
@@ -1080,11 +1342,10 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
     sat_obj_t      *obj = NULL;
     gfloat          x, y;
     GooCanvasItemModel *root;
-    gint            idx, i;
+    gint            idx;
     gdouble         now;        // = get_current_daynum ();
     gchar          *text;
     gchar          *losstr;
-    gchar          *tooltip;
     guint32         colour;
 
     (void)key;                  /* avoid unused parameter compiler warning */
@@ -1134,9 +1395,9 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
                 gtk_polar_view_delete_track(polv, obj, sat);
             }
 
-            /* free pass info */
-            free_pass(obj->pass);
-            obj->pass = NULL;
+            /* release the sky track */
+            sky_track_unref(obj->sky);
+            obj->sky = NULL;
 
             /* if this was the selected satellite we need to
                clear the info text
@@ -1166,56 +1427,38 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
         /* if sat is already on canvas */
         if (obj != NULL)
         {
-            /* update LOS count down */
-            if (sat->los > 0.0)
-            {
-                losstr = los_time_to_str(polv, sat);
-            }
-            else
-            {
-                losstr =
-                    g_strdup_printf(_("%s\nAlways in range"), sat->nickname);
-            }
-
-            /* update label */
-            g_object_set(obj->label, "text", sat->nickname, NULL);
-
-            /* update tooltip */
-            tooltip = g_markup_printf_escaped("<b>%s</b>\n"
-                                              "Az: %5.1f\302\260\n"
-                                              "El: %5.1f\302\260\n"
-                                              "%s",
-                                              sat->nickname,
-                                              sat->az, sat->el, losstr);
-
+            /* the label text is only changed by update_label() and the
+               tooltip is created when it is shown */
             g_object_set(obj->marker,
                          "x", x - MARKER_SIZE_HALF,
-                         "y", y - MARKER_SIZE_HALF, "tooltip", tooltip, NULL);
-            g_object_set(obj->label,
-                         "x", x, "y", y + 2, "tooltip", tooltip, NULL);
-
-            g_free(tooltip);
+                         "y", y - MARKER_SIZE_HALF, NULL);
+            g_object_set(obj->label, "x", x, "y", y + 2, NULL);
+            obj->x = x;
+            obj->y = y;
 
             /* update selection info if satellite is
                selected
              */
             if (obj->selected)
             {
+                losstr = los_time_to_str(polv, sat);
                 text = g_strdup_printf("%s\n%s", sat->nickname, losstr);
                 g_object_set(polv->sel, "text", text, NULL);
                 g_free(text);
+                g_free(losstr);
             }
 
             /* Current pass and sky track needs update if they were calculated at
-             * a different location or time (time controller)
+             * a different location or time (time controller); the track is
+             * moved to the new pass rather than created again
              */
-            if (obj->pass)
+            if (obj->sky)
             {
                 /** FIXME: threshold */
                 gboolean        qth_upd =
-                    qth_small_dist(polv->qth, (obj->pass->qth_comp)) > 1.0;
-                gboolean        time_upd = !((obj->pass->aos <= now) &&
-                                             (obj->pass->los >= now));
+                    qth_small_dist(polv->qth, (obj->sky->qth_comp)) > 1.0;
+                gboolean        time_upd = !((obj->sky->aos <= now) &&
+                                             (obj->sky->los >= now));
 
                 if (qth_upd || time_upd)
                 {
@@ -1225,48 +1468,15 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
                                 __FILE__, __func__, *catnum, qth_upd,
                                 time_upd);
 
-                    root =
-                        goo_canvas_get_root_item_model(GOO_CANVAS
-                                                       (polv->canvas));
-
-                    /* remove sky track */
-                    if (obj->showtrack)
-                    {
-                        idx =
-                            goo_canvas_item_model_find_child(root, obj->track);
-                        if (idx != -1)
-                            goo_canvas_item_model_remove_child(root, idx);
-
-                        for (i = 0; i < TRACK_TICK_NUM; i++)
-                        {
-                            idx =
-                                goo_canvas_item_model_find_child(root,
-                                                                 obj->trtick
-                                                                 [i]);
-                            if (idx != -1)
-                                goo_canvas_item_model_remove_child(root, idx);
-                        }
-                    }
-
-                    /* free pass info */
-                    free_pass(obj->pass);
-                    obj->pass = NULL;
-
-                    /*compute new pass */
-                    obj->pass = get_current_pass(sat, polv->qth, now);
-
-                    /* Finally, create the sky track if necessary */
-                    if (obj->showtrack)
-                        gtk_polar_view_create_track(polv, obj, sat);
+                    set_sky_track(polv, obj, sat, now);
                 }
             }
-            g_free(losstr);
             g_free(catnum);     // FIXME: why free here, what about else?
         }
         else
         {
             /* add sat to canvas */
-            obj = g_try_new(sat_obj_t, 1);
+            obj = g_try_new0(sat_obj_t, 1);
 
             if (obj != NULL)
             {
@@ -1288,6 +1498,12 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
                     obj->showtrack = polv->showtrack;
                 }
                 obj->istarget = FALSE;
+                obj->catnum = sat->tle.catnr;
+                obj->x = x;
+                obj->y = y;
+                obj->label_w = 0.0;
+                obj->label_h = 0.0;
+                obj->label_shown = TRUE;
 
                 root =
                     goo_canvas_get_root_item_model(GOO_CANVAS(polv->canvas));
@@ -1297,13 +1513,6 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
                                          MOD_CFG_POLAR_SAT_COL,
                                          SAT_CFG_INT_POLAR_SAT_COL);
 
-                /* create tooltip */
-                tooltip = g_markup_printf_escaped("<b>%s</b>\n"
-                                                  "Az: %5.1f\302\260\n"
-                                                  "El: %5.1f\302\260\n",
-                                                  sat->nickname,
-                                                  sat->az, sat->el);
-
                 obj->marker = goo_canvas_rect_model_new(root,
                                                         x - MARKER_SIZE_HALF,
                                                         y - MARKER_SIZE_HALF,
@@ -1312,16 +1521,14 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
                                                         "fill-color-rgba",
                                                         colour,
                                                         "stroke-color-rgba",
-                                                        colour, "tooltip",
-                                                        tooltip, NULL);
+                                                        colour, NULL);
                 obj->label =
                     goo_canvas_text_model_new(root, sat->nickname, x, y + 2,
                                               -1, GOO_CANVAS_ANCHOR_NORTH,
                                               "font", "Sans 8",
                                               "fill-color-rgba", colour,
-                                              "tooltip", tooltip, NULL);
+                                              NULL);
 
-                g_free(tooltip);
                 if (goo_canvas_item_model_find_child(root, obj->marker) != -1)
                     goo_canvas_item_model_raise(obj->marker, NULL);
                 else
@@ -1343,8 +1550,8 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
                 g_object_set_data(G_OBJECT(obj->label), "catnum",
                                   GINT_TO_POINTER(*catnum));
 
-                /* get info about the current pass */
-                obj->pass = get_current_pass(sat, polv->qth, now);
+                /* get the sky track of the current pass */
+                obj->sky = station_get_current_track(sat, polv->qth, now);
 
                 /* add sat to hash table */
                 g_hash_table_insert(polv->obj, catnum, obj);
@@ -1368,87 +1575,42 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
 /**  Update sky track drawing after size allocate. */
 static void update_track(gpointer key, gpointer value, gpointer data)
 {
-    sat_obj_t      *obj = SAT_OBJ(value);;
-    GtkPolarView   *pv = GTK_POLAR_VIEW(data);
-    guint           num, i;
-    GooCanvasPoints *points;
-    gfloat          x, y;
-    pass_detail_t  *detail;
-    guint           tres, ttidx;
+    sat_obj_t      *obj = SAT_OBJ(value);
 
     (void)key;
 
-    if (obj->showtrack)
-    {
-        if (obj->pass == NULL)
-        {
-            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _("%s:%d: Failed to get satellite pass."),
-                        __FILE__, __LINE__);
-            return;
-        }
-
-        /* create points */
-        num = g_slist_length(obj->pass->details);
-        if (num == 0)
-        {
-            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _("%s:%d: Pass had no points in it."),
-                        __FILE__, __LINE__);
-            return;
-        }
-
-        points = goo_canvas_points_new(num);
-
-        /* first point should be (aos_az,0.0) */
-        azel_to_xy(pv, obj->pass->aos_az, 0.0, &x, &y);
-        points->coords[0] = (double)x;
-        points->coords[1] = (double)y;
-
-        /* time tick 0 */
-        g_object_set(obj->trtick[0], "x", (gdouble) x, "y", (gdouble) y, NULL);
-
-        /* time resolution for time ticks; we need
-           3 additional points to AOS and LOS ticks.
-         */
-        tres = (num - 2) / (TRACK_TICK_NUM - 1);
-        ttidx = 1;
+    if (obj->showtrack && obj->track != NULL)
+        project_track(GTK_POLAR_VIEW(data), obj);
+}
 
-        for (i = 1; i < num - 1; i++)
-        {
-            detail = PASS_DETAIL(g_slist_nth_data(obj->pass->details, i));
-            if (detail->el >= 0)
-                azel_to_xy(pv, detail->az, detail->el, &x, &y);
-            points->coords[2 * i] = (double)x;
-            points->coords[2 * i + 1] = (double)y;
+/* Scale of the unit disc of the sky tracks on the canvas */
+static void track_scale(GtkPolarView * pv, gdouble * rx, gdouble * ry)
+{
+    *rx = pv->r;
+    *ry = pv->r;
 
-            if (!(i % tres))
-            {
-                /* update time tick */
-                if (ttidx < TRACK_TICK_NUM)
-                    g_object_set(obj->trtick[ttidx],
-                                 "x", (gdouble) x, "y", (gdouble) y, NULL);
-                ttidx++;
-            }
-        }
+    switch (pv->swap)
+    {
+    case POLAR_VIEW_NWSE:
+        *rx = -*rx;
+        break;
 
-        /* last point should be (los_az, 0.0)  */
-        azel_to_xy(pv, obj->pass->los_az, 0.0, &x, &y);
-        points->coords[2 * (num - 1)] = (double)x;
-        points->coords[2 * (num - 1) + 1] = (double)y;
+    case POLAR_VIEW_SENW:
+        *ry = -*ry;
+        break;
 
-        g_object_set(obj->track, "points", points, NULL);
+    case POLAR_VIEW_SWNE:
+        *rx = -*rx;
+        *ry = -*ry;
+        break;
 
-        goo_canvas_points_unref(points);
+    default:
+        break;
     }
 }
 
-static GooCanvasItemModel *create_time_tick(GtkPolarView * pv, gdouble time,
-                                            gfloat x, gfloat y)
+static GooCanvasItemModel *create_time_tick(GtkPolarView * pv)
 {
-    GooCanvasItemModel *item;
-    gchar           buff[6];
-    GooCanvasAnchorType anchor;
     GooCanvasItemModel *root;
     guint32         col;
 
@@ -1459,6 +1621,19 @@ static GooCanvasItemModel *create_time_tick(GtkPolarView * pv, gdouble time,
                           MOD_CFG_POLAR_TRACK_COL,
                           SAT_CFG_INT_POLAR_TRACK_COL);
 
+    return goo_canvas_text_model_new(root, "", 0.0, 0.0, -1,
+                                     GOO_CANVAS_ANCHOR_WEST,
+                                     "font", "Sans 7",
+                                     "fill-color-rgba", col, NULL);
+}
+
+/* Put a time tick next to a point of the sky track */
+static void place_time_tick(GtkPolarView * pv, GooCanvasItemModel * item,
+                            gdouble time, gdouble x, gdouble y)
+{
+    gchar           buff[6];
+    GooCanvasAnchorType anchor;
+
     daynum_to_str(buff, 6, "%H:%M", time);
 
     if (x > pv->cx)
@@ -1472,13 +1647,65 @@ static GooCanvasItemModel *create_time_tick(GtkPolarView * pv, gdouble time,
         x += 5;
     }
 
-    item = goo_canvas_text_model_new(root, buff,
-                                     (gdouble) x, (gdouble) y,
-                                     -1, anchor,
-                                     "font", "Sans 7",
-                                     "fill-color-rgba", col, NULL);
+    g_object_set(item, "text", buff, "x", x, "y", y, "anchor", anchor,
+                 "visibility", GOO_CANVAS_ITEM_VISIBLE, NULL);
+}
+
+/**
+ * Map the sky track of a satellite to its canvas items.
+ *
+ * This is all it takes to move the track items to a new pass or to a new
+ * size of the view.
+ */
+static void project_track(GtkPolarView * pv, sat_obj_t * obj)
+{
+    GooCanvasPoints *points;
+    guint           index[TRACK_TICK_NUM];
+    gdouble         rx, ry;
+    guint           i, n;
+
+    track_scale(pv, &rx, &ry);
 
-    return item;
+    points = goo_canvas_points_new(obj->sky->num);
+    sky_track_project(obj->sky, pv->cx, pv->cy, rx, ry, points->coords);
+    g_object_set(obj->track, "points", points, NULL);
+
+    n = sky_track_ticks(obj->sky, TRACK_TICK_NUM, index);
+    for (i = 0; i < TRACK_TICK_NUM; i++)
+    {
+        if (i < n)
+            place_time_tick(pv, obj->trtick[i], obj->sky->time[index[i]],
+                            points->coords[2 * index[i]],
+                            points->coords[2 * index[i] + 1]);
+        else
+            g_object_set(obj->trtick[i],
+                         "visibility", GOO_CANVAS_ITEM_INVISIBLE, NULL);
+    }
+
+    goo_canvas_points_unref(points);
+}
+
+/**
+ * Replace the sky track of a satellite with the one of the pass at time t.
+ *
+ * The track is taken from the pass cache shared with the radio and rotator
+ * controllers. Shown track items are moved to the new track.
+ */
+static void set_sky_track(GtkPolarView * pv, sat_obj_t * obj, sat_t * sat,
+                          gdouble t)
+{
+    sky_track_unref(obj->sky);
+    obj->sky = station_get_current_track(sat, pv->qth, t);
+
+    if (!obj->showtrack)
+        return;
+
+    if (obj->sky == NULL)
+        gtk_polar_view_delete_track(pv, obj, sat);
+    else if (obj->track == NULL)
+        gtk_polar_view_create_track(pv, obj, sat);
+    else
+        project_track(pv, obj);
 }
 
 /**
@@ -1496,20 +1723,10 @@ void gtk_polar_view_create_track(GtkPolarView * pv, sat_obj_t * obj,
 {
     guint           i;
     GooCanvasItemModel *root;
-    pass_detail_t  *detail;
-    guint           num;
-    GooCanvasPoints *points;
-    gfloat          x, y;
     guint32         col;
-    guint           tres, ttidx;
 
     (void)sat;
 
-    /* get satellite object */
-    /*obj = SAT_OBJ(g_object_get_data (G_OBJECT (item), "obj"));
-       sat = SAT(g_object_get_data (G_OBJECT (item), "sat"));
-       qth = (qth_t *)(g_object_get_data (G_OBJECT (item), "qth")); */
-
     if (obj == NULL)
     {
         sat_log_log(SAT_LOG_LEVEL_ERROR,
@@ -1518,7 +1735,7 @@ void gtk_polar_view_create_track(GtkPolarView * pv, sat_obj_t * obj,
         return;
     }
 
-    if (obj->pass == NULL)
+    if (obj->sky == NULL)
     {
         sat_log_log(SAT_LOG_LEVEL_ERROR,
                     _("%s:%d: Failed to get satellite pass."),
@@ -1526,57 +1743,10 @@ void gtk_polar_view_create_track(GtkPolarView * pv, sat_obj_t * obj,
         return;
     }
 
-    root = goo_canvas_get_root_item_model(GOO_CANVAS(pv->canvas));
-
-    /* add sky track */
-
-    /* create points */
-    num = g_slist_length(obj->pass->details);
-    if (num == 0)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s:%d: Pass had no points in it."), __FILE__, __LINE__);
+    if (obj->track != NULL)
         return;
-    }
-
-    /* time resolution for time ticks; we need
-       3 additional points to AOS and LOS ticks.
-     */
-    tres = (num - 2) / (TRACK_TICK_NUM - 1);
-
-    points = goo_canvas_points_new(num);
-
-
-
-    /* first point should be (aos_az,0.0) */
-    azel_to_xy(pv, obj->pass->aos_az, 0.0, &x, &y);
-    points->coords[0] = (double)x;
-    points->coords[1] = (double)y;
-    obj->trtick[0] = create_time_tick(pv, obj->pass->aos, x, y);
-
-    ttidx = 1;
-
-    for (i = 1; i < num - 1; i++)
-    {
-        detail = PASS_DETAIL(g_slist_nth_data(obj->pass->details, i));
-        if (detail->el >= 0.0)
-            azel_to_xy(pv, detail->az, detail->el, &x, &y);
-        points->coords[2 * i] = (double)x;
-        points->coords[2 * i + 1] = (double)y;
 
-        if (tres != 0 && !(i % tres))
-        {
-            /* create a time tick */
-            if (ttidx < TRACK_TICK_NUM)
-                obj->trtick[ttidx] = create_time_tick(pv, detail->time, x, y);
-            ttidx++;
-        }
-    }
-
-    /* last point should be (los_az, 0.0)  */
-    azel_to_xy(pv, obj->pass->los_az, 0.0, &x, &y);
-    points->coords[2 * (num - 1)] = (double)x;
-    points->coords[2 * (num - 1) + 1] = (double)y;
+    root = goo_canvas_get_root_item_model(GOO_CANVAS(pv->canvas));
 
     /* create poly-line */
     col = mod_cfg_get_int(pv->cfgdata,
@@ -1585,14 +1755,17 @@ void gtk_polar_view_create_track(GtkPolarView * pv, sat_obj_t * obj,
                           SAT_CFG_INT_POLAR_TRACK_COL);
 
     obj->track = goo_canvas_polyline_model_new(root, FALSE, 0,
-                                               "points", points,
                                                "line-width", 1.0,
                                                "stroke-color-rgba", col,
                                                "line-cap",
                                                CAIRO_LINE_CAP_SQUARE,
                                                "line-join",
                                                CAIRO_LINE_JOIN_MITER, NULL);
-    goo_canvas_points_unref(points);
+
+    for (i = 0; i < TRACK_TICK_NUM; i++)
+        obj->trtick[i] = create_time_tick(pv);
+
+    project_track(pv, obj);
 }
 
 void gtk_polar_view_delete_track(GtkPolarView * pv, sat_obj_t * obj,
@@ -1603,6 +1776,9 @@ void gtk_polar_view_delete_track(GtkPolarView * pv, sat_obj_t * obj,
 
     (void)sat;
 
+    if (obj->track == NULL)
+        return;
+
     root = goo_canvas_get_root_item_model(GOO_CANVAS(pv->canvas));
     idx = goo_canvas_item_model_find_child(root, obj->track);
 
@@ -1610,6 +1786,7 @@ void gtk_polar_view_delete_track(GtkPolarView * pv, sat_obj_t * obj,
     {
         goo_canvas_item_model_remove_child(root, idx);
     }
+    obj->track = NULL;
 
     for (i = 0; i < TRACK_TICK_NUM; i++)
     {
@@ -1619,6 +1796,7 @@ void gtk_polar_view_delete_track(GtkPolarView * pv, sat_obj_t * obj,
         {
             goo_canvas_item_model_remove_child(root, idx);
         }
+        obj->trtick[i] = NULL;
     }
 }
 
@@ -1629,6 +1807,45 @@ void gtk_polar_view_reload_sats(GtkWidget * polv, GHashTable * sats)
 
     GTK_POLAR_VIEW(polv)->naos = 0.0;
     GTK_POLAR_VIEW(polv)->ncat = 0;
+
+    /* the nicknames may have changed */
+    g_hash_table_foreach(GTK_POLAR_VIEW(polv)->obj, update_label, polv);
+}
+
+/**
+ * Refresh a satellite whose elements have been replaced.
+ *
+ * @param widget The GtkPolarView widget.
+ * @param catnum Catalog number of the satellite.
+ *
+ * The current pass and sky track of the satellite are recalculated; the
+ * other satellites are not affected.
+ */
+void gtk_polar_view_refresh_sat(GtkWidget * widget, gint catnum)
+{
+    GtkPolarView   *polv = GTK_POLAR_VIEW(widget);
+    sat_obj_t      *obj;
+    sat_t          *sat;
+
+    /* next AOS will be found in the next cycle */
+    if (polv->ncat == catnum)
+    {
+        polv->naos = 0.0;
+        polv->ncat = 0;
+    }
+
+    obj = SAT_OBJ(g_hash_table_lookup(polv->obj, &catnum));
+    sat = SAT(g_hash_table_lookup(polv->sats, &catnum));
+    if ((obj == NULL) || (sat == NULL))
+        return;
+
+    g_object_set(obj->label, "text", sat->nickname, NULL);
+    obj->label_w = 0.0;
+
+    if (obj->sky == NULL)
+        return;
+
+    set_sky_track(polv, obj, sat, polv->tstamp);
 }
 
 /** Select a satellite */
@@ -1669,6 +1886,7 @@ void gtk_polar_view_select_sat(GtkWidget * widget, gint catnum)
 
     /* clear previous selection, if any */
     g_hash_table_foreach(polv->obj, clear_selection, catpoint);
+    index_sats(polv);
 
     g_free(catpoint);
 }
@@ -9,6 +9,8 @@
 
 #include "gtk-sat-data.h"
 #include "predict-tools.h"
+#include "screen-grid.h"
+#include "sky-track.h"
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -35,11 +37,17 @@ typedef struct {
     gboolean        selected;   /*!< Satellite is selected. */
     gboolean        showtrack;  /*!< Show ground track. */
     gboolean        istarget;   /*!< Is this object the target. */
-    pass_t         *pass;       /*!< Details of the current pass. */
+    gint            catnum;     /*!< Catalogue number of satellite. */
+    sky_track_t    *sky;        /*!< Sky track of the current pass. */
     GooCanvasItemModel *marker; /*!< Item showing position of satellite. */
     GooCanvasItemModel *label;  /*!< Item showing the satellite name. */
     GooCanvasItemModel *track;  /*!< Sky track. */
     GooCanvasItemModel *trtick[TRACK_TICK_NUM]; /*!< Time ticks along the sky track */
+    gdouble         x;          /*!< X coordinate of the marker. */
+    gdouble         y;          /*!< Y coordinate of the marker. */
+    gdouble         label_w;    /*!< Width of the label; 0 if not known yet. */
+    gdouble         label_h;    /*!< Height of the label. */
+    gboolean        label_shown;        /*!< FALSE if the label is hidden to avoid overlapping. */
 } sat_obj_t;
 
 #define SAT_OBJ(obj) ((sat_obj_t *)obj)
@@ -108,6 +116,9 @@ struct _GtkPolarView {
     gboolean        extratick;  /*!< Show extra ticks */
     gboolean        showtrack;  /*!< Automatically show sky tracks. */
     gboolean        resize;     /*!< Flag indicating that the view has been resized. */
+    gboolean        declutter;  /*!< Hide labels that overlap other labels. */
+    screen_grid_t  *markers;    /*!< Satellite markers for hit-testing. */
+    screen_grid_t  *labels;     /*!< Shown labels for hit-testing and decluttering. */
 };
 
 struct _GtkPolarViewClass {
@@ -123,6 +134,7 @@ void            gtk_polar_view_update(GtkWidget * widget);
 void            gtk_polar_view_reconf(GtkWidget * widget, GKeyFile * cfgdat);
 void            gtk_polar_view_reload_sats(GtkWidget * polv,
                                            GHashTable * sats);
+void            gtk_polar_view_refresh_sat(GtkWidget * widget, gint catnum);
 void            gtk_polar_view_select_sat(GtkWidget * widget, gint catnum);
 void            gtk_polar_view_create_track(GtkPolarView * pv, sat_obj_t * obj,
                                             sat_t * sat);
@@ -40,31 +40,33 @@
 #include <glib/gi18n.h>
 #include <gtk/gtk.h>
 #include <math.h>
+#include <stdarg.h>
+#include <string.h>
 
 /* NETWORK */
-#ifndef WIN32
-#include <arpa/inet.h>          /* htons() */
-#include <netdb.h>              /* gethostbyname() */
-#include <netinet/in.h>         /* struct sockaddr_in */
-#include <sys/socket.h>         /* socket(), connect(), send() */
-#else
-#include <winsock2.h>
-#endif
 
 #include "compat.h"
 #include "gpredict-utils.h"
 #include "gtk-freq-knob.h"
 #include "gtk-rig-ctrl.h"
+#include "hamlib-client.h"
 #include "predict-tools.h"
 #include "radio-conf.h"
+#include "rig-tuning.h"
 #include "sat-log.h"
 #include "sat-cfg.h"
+#include "station-ctrl.h"
+#include "time-tools.h"
 #include "trsp-conf.h"
+#include "trsp-db.h"
 
 
 #define AZEL_FMTSTR "%7.2f\302\260"
 #define MAX_ERROR_COUNT 5
-#define WR_DEL 5000             /* delay in usec to wait between write and read commands */
+#define RIG_BATCH_MAX 4         /* max number of commands pipelined in one write */
+#define RIG_CMD_TIMEOUT 2000    /* deadline of a rigctld command in msec */
+#define RIG_MAX_TRATE 1000.0    /* max module time rate used for prediction */
+#define DOPPLER_DT 1.0          /* time step in seconds for the Doppler rate */
 
 /* radio control functions */
 static void     exec_rx_cycle(GtkRigCtrl * ctrl);
@@ -76,22 +78,31 @@ static void     exec_duplex_cycle(GtkRigCtrl * ctrl);
 static void     exec_duplex_tx_cycle(GtkRigCtrl * ctrl);
 static void     exec_dual_rig_cycle(GtkRigCtrl * ctrl);
 static gboolean check_aos_los(GtkRigCtrl * ctrl);
-static gboolean set_freq_simplex(GtkRigCtrl * ctrl, gint sock, gdouble freq);
-static gboolean get_freq_simplex(GtkRigCtrl * ctrl, gint sock, gdouble * freq);
-static gboolean set_freq_toggle(GtkRigCtrl * ctrl, gint sock, gdouble freq);
-static gboolean set_toggle(GtkRigCtrl * ctrl, gint sock);
-static gboolean unset_toggle(GtkRigCtrl * ctrl, gint sock);
-static gboolean get_freq_toggle(GtkRigCtrl * ctrl, gint sock, gdouble * freq);
-static gboolean get_ptt(GtkRigCtrl * ctrl, gint sock);
-static gboolean set_ptt(GtkRigCtrl * ctrl, gint sock, gboolean ptt);
+static gboolean set_get_freq(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gboolean toggle,
+                             gdouble freq, gdouble * readback);
+static gboolean get_set_get_freq(GtkRigCtrl * ctrl, hamlib_conn_t * conn,
+                                 gdouble * before, gboolean * beforeok,
+                                 gdouble freq, gdouble * readback);
+static gboolean set_freq_toggle(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gdouble freq);
+static gboolean set_toggle(GtkRigCtrl * ctrl, hamlib_conn_t * conn);
+static gboolean unset_toggle(GtkRigCtrl * ctrl, hamlib_conn_t * conn);
+static gboolean get_freq_toggle(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gdouble * freq);
+static gboolean get_ptt_freq(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gboolean * ptt,
+                             gdouble * freq);
+static gboolean get_ptt(GtkRigCtrl * ctrl, hamlib_conn_t * conn);
+static gboolean set_ptt(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gboolean ptt);
 
 /*  add thread for hamlib communication */
-gpointer        rigctl_run(gpointer data);
+static gint64   rig_ctrl_cycle(gpointer data);
 static void     rigctrl_open(GtkRigCtrl * data);
 static void     rigctrl_close(GtkRigCtrl * data);
 static void     setconfig(gpointer data);
-static void     remove_timer(GtkRigCtrl * data);
-static void     start_timer(GtkRigCtrl * data);
+
+/* state handoff between the UI and the control thread */
+static void     publish_ui_state(GtkRigCtrl * ctrl);
+static void     merge_ui_state(GtkRigCtrl * ctrl);
+static void     publish_ctrl_state(GtkRigCtrl * ctrl);
+static rig_ctrl_state_t *take_state(rig_ctrl_state_t ** box);
 
 static GtkBoxClass *parent_class = NULL;
 
@@ -100,19 +111,21 @@ static void gtk_rig_ctrl_destroy(GtkWidget * widget)
 {
     GtkRigCtrl     *ctrl = GTK_RIG_CTRL(widget);
 
-    if (ctrl->rigctl_thread != NULL)
+    if (ctrl->chain != NULL)
     {
-        g_mutex_lock(&ctrl->widgetsync);
-
         ctrl->engaged = 0;
         setconfig(ctrl);
 
-        /* synchronization */
-        g_cond_wait(&ctrl->widgetready, &ctrl->widgetsync);
-        g_mutex_unlock(&ctrl->widgetsync);
-        ctrl->rigctl_thread = NULL;
+        /* wait until the last cycle has closed the connections */
+        station_chain_join(ctrl->chain);
+        ctrl->chain = NULL;
     }
 
+    /* drop pending state updates */
+    g_idle_remove_by_data(ctrl);
+    g_free(take_state(&ctrl->uistate));
+    g_free(take_state(&ctrl->ctrlstate));
+
     if (ctrl->conf != NULL)
     {
         radio_conf_save(ctrl->conf);
@@ -166,18 +179,36 @@ static void gtk_rig_ctrl_init(GtkRigCtrl * ctrl,
     ctrl->trsplock = FALSE;
     ctrl->tracking = FALSE;
     ctrl->prev_ele = 0.0;
-    ctrl->sock = 0;
-    ctrl->sock2 = 0;
+    ctrl->conn = NULL;
+    ctrl->conn2 = NULL;
     g_mutex_init(&(ctrl->busy));
     ctrl->engaged = FALSE;
     ctrl->delay = 1000;
-    ctrl->timerid = 0;
     ctrl->errcnt = 0;
     ctrl->lastrxptt = FALSE;
     ctrl->lasttxptt = TRUE;
     ctrl->lastrxf = 0.0;
     ctrl->lasttxf = 0.0;
+    ctrl->lastrxreq = 0.0;
+    ctrl->lasttxreq = 0.0;
+    ctrl->cycleptt = -1;
+    ctrl->cyclefreq = 0.0;
+    ctrl->ddrate = 0.0;
+    ctrl->durate = 0.0;
+    ctrl->pdd = 0.0;
+    ctrl->pdu = 0.0;
+    ctrl->trate = 1.0;
+    ctrl->tupd = 0.0;
+    ctrl->dtime = 0;
+    ctrl->latency = 0.0;
     ctrl->last_toggle_tx = -1;
+    memset(&ctrl->state, 0, sizeof(rig_ctrl_state_t));
+    ctrl->state.trate = 1.0;
+    ctrl->uistate = NULL;
+    ctrl->ctrlstate = NULL;
+    ctrl->idlepending = 0;
+    ctrl->resync = 0;
+    ctrl->dialgen = 0;
 }
 
 GType gtk_rig_ctrl_get_type()
@@ -258,6 +289,22 @@ static void update_count_down(GtkRigCtrl * ctrl, gdouble t)
     g_free(aoslos);
 }
 
+/*
+ * Compute the rate of change of the target range rate in km/s^2.
+ *
+ * The target is propagated DOPPLER_DT seconds ahead on a working copy so
+ * that the satellite owned by the module is not modified.
+ */
+static gdouble range_rate_slope(GtkRigCtrl * ctrl, gdouble t)
+{
+    sat_t           sat_working, *sat;
+
+    sat = memcpy(&sat_working, ctrl->target, sizeof(sat_t));
+    predict_calc(sat, ctrl->qth, t + DOPPLER_DT / 86400.0);
+
+    return (sat->range_rate - ctrl->target->range_rate) / DOPPLER_DT;
+}
+
 /*
  * Update rig control state.
  *
@@ -268,6 +315,8 @@ static void update_count_down(GtkRigCtrl * ctrl, gdouble t)
 void gtk_rig_ctrl_update(GtkRigCtrl * ctrl, gdouble t)
 {
     gdouble         satfreq;
+    gdouble         rrdot;
+    gint64          now;
     gchar          *buff;
 
     g_mutex_lock(&ctrl->rig_ctrl_updatelock);
@@ -306,9 +355,20 @@ void gtk_rig_ctrl_update(GtkRigCtrl * ctrl, gdouble t)
         gtk_label_set_text(GTK_LABEL(ctrl->SatRngRate), buff);
         g_free(buff);
 
+        /* Keep track of how fast the module time runs compared to real time,
+           so that the Doppler prediction also works with time throttling */
+        now = g_get_monotonic_time();
+        if (ctrl->dtime > 0 && now > ctrl->dtime)
+            ctrl->trate = CLAMP((t - ctrl->tupd) * 86400.0e6 /
+                                (now - ctrl->dtime), 0.0, RIG_MAX_TRATE);
+        ctrl->tupd = t;
+        ctrl->dtime = now;
+        rrdot = range_rate_slope(ctrl, t);
+
         /* Doppler shift down */
         satfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
         ctrl->dd = -satfreq * (ctrl->target->range_rate / 299792.4580); // Hz
+        ctrl->ddrate = -satfreq * (rrdot / 299792.4580);        // Hz/s
         buff = g_strdup_printf("%.0f Hz", ctrl->dd);
         gtk_label_set_text(GTK_LABEL(ctrl->SatDopDown), buff);
         g_free(buff);
@@ -316,6 +376,7 @@ void gtk_rig_ctrl_update(GtkRigCtrl * ctrl, gdouble t)
         /* Doppler shift up */
         satfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
         ctrl->du = satfreq * (ctrl->target->range_rate / 299792.4580);  // Hz
+        ctrl->durate = satfreq * (rrdot / 299792.4580); // Hz/s
         buff = g_strdup_printf("%.0f Hz", ctrl->du);
         gtk_label_set_text(GTK_LABEL(ctrl->SatDopUp), buff);
         g_free(buff);
@@ -326,17 +387,22 @@ void gtk_rig_ctrl_update(GtkRigCtrl * ctrl, gdouble t)
             if (ctrl->target->aos > ctrl->pass->aos)
             {
                 free_pass(ctrl->pass);
-                ctrl->pass = get_next_pass(ctrl->target, ctrl->qth, 3.0);
+                ctrl->pass = station_get_pass(ctrl->target, ctrl->qth,
+                                              get_current_daynum(), 3.0);
             }
         }
         else
         {
             /* we don't have any current pass; store the current one */
-            ctrl->pass = get_next_pass(ctrl->target, ctrl->qth, 3.0);
+            ctrl->pass = station_get_pass(ctrl->target, ctrl->qth,
+                                          get_current_daynum(), 3.0);
         }
     }
 
     g_mutex_unlock(&ctrl->rig_ctrl_updatelock);
+
+    if (ctrl->target)
+        publish_ui_state(ctrl);
 }
 
 
@@ -344,25 +410,19 @@ void gtk_rig_ctrl_update(GtkRigCtrl * ctrl, gdouble t)
  * Track the downlink frequency by setting the uplink frequency
  * according to the lower limit of the downlink passband.
  */
-static void track_downlink(GtkRigCtrl * ctrl)
+static void track_downlink(rig_ctrl_state_t * state)
 {
-    gdouble         delta, down, up;
-
-    if (ctrl->trsp == NULL)
-        return;
+    gdouble         delta;
 
     /* ensure that we have a useable transponder config */
-    if ((ctrl->trsp->downlow > 0) && (ctrl->trsp->uplow > 0))
+    if ((state->downlow > 0) && (state->uplow > 0))
     {
-        down = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
-        delta = down - ctrl->trsp->downlow;
+        delta = state->satfreqd - state->downlow;
 
-        if (ctrl->trsp->invert)
-            up = ctrl->trsp->uphigh - delta;
+        if (state->invert)
+            state->satfrequ = state->uphigh - delta;
         else
-            up = ctrl->trsp->uplow + delta;
-
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqUp), up);
+            state->satfrequ = state->uplow + delta;
     }
 }
 
@@ -370,26 +430,212 @@ static void track_downlink(GtkRigCtrl * ctrl)
  * Track the uplink frequency by setting the downlink frequency
  * according to the offset from the lower limit on the uplink passband.
  */
-static void track_uplink(GtkRigCtrl * ctrl)
+static void track_uplink(rig_ctrl_state_t * state)
 {
-    gdouble         delta, down, up;
-
-    if (ctrl->trsp == NULL)
-        return;
+    gdouble         delta;
 
     /* ensure that we have a useable transponder config */
-    if ((ctrl->trsp->downlow > 0) && (ctrl->trsp->uplow > 0))
+    if ((state->downlow > 0) && (state->uplow > 0))
     {
-        up = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
-        delta = up - ctrl->trsp->uplow;
+        delta = state->satfrequ - state->uplow;
 
-        if (ctrl->trsp->invert)
-            down = ctrl->trsp->downhigh - delta;
+        if (state->invert)
+            state->satfreqd = state->downhigh - delta;
         else
-            down = ctrl->trsp->downlow + delta;
+            state->satfreqd = state->downlow + delta;
+    }
+}
+
+/*
+ * Collect the UI side of the controller state.
+ *
+ * Must be called from the main loop since it reads the widgets.
+ */
+static void get_ui_state(GtkRigCtrl * ctrl, rig_ctrl_state_t * state)
+{
+    memset(state, 0, sizeof(rig_ctrl_state_t));
+
+    state->satfreqd = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
+    state->satfrequ = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
+    state->rigfreqd = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqDown));
+    state->rigfrequ = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqUp));
+
+    g_mutex_lock(&ctrl->rig_ctrl_updatelock);
+    state->dd = ctrl->dd;
+    state->du = ctrl->du;
+    state->ddrate = ctrl->ddrate;
+    state->durate = ctrl->durate;
+    state->dtime = ctrl->dtime;
+    state->trate = ctrl->trate;
+    g_mutex_unlock(&ctrl->rig_ctrl_updatelock);
+
+    if (ctrl->target != NULL)
+    {
+        state->el = ctrl->target->el;
+        state->catnum = ctrl->target->tle.catnr;
+    }
+    state->tracking = ctrl->tracking;
+    state->trsplock = ctrl->trsplock;
+
+    if (ctrl->trsp != NULL)
+    {
+        state->downlow = ctrl->trsp->downlow;
+        state->downhigh = ctrl->trsp->downhigh;
+        state->uplow = ctrl->trsp->uplow;
+        state->uphigh = ctrl->trsp->uphigh;
+        state->invert = ctrl->trsp->invert;
+    }
+
+    state->resync = ctrl->resync;
+    state->dialgen = ctrl->dialgen;
+}
+
+/*
+ * Put a copy of state into a mailbox.
+ *
+ * A mailbox holds the latest state published by one side until the other
+ * side takes it. Only the latest state is of interest, so a state that has
+ * not been taken yet is simply replaced.
+ */
+static void publish_state(rig_ctrl_state_t ** box,
+                          const rig_ctrl_state_t * state)
+{
+    rig_ctrl_state_t *new, *old;
+
+    new = g_new(rig_ctrl_state_t, 1);
+    *new = *state;
+
+    do
+    {
+        old = g_atomic_pointer_get(box);
+    }
+    while (!g_atomic_pointer_compare_and_exchange(box, old, new));
+
+    g_free(old);
+}
+
+/*
+ * Take the state out of a mailbox.
+ *
+ * @return The state, which must be freed by the caller, or NULL if nothing
+ *         has been published since the last call.
+ */
+static rig_ctrl_state_t *take_state(rig_ctrl_state_t ** box)
+{
+    rig_ctrl_state_t *state;
+
+    do
+    {
+        state = g_atomic_pointer_get(box);
+    }
+    while (state != NULL &&
+           !g_atomic_pointer_compare_and_exchange(box, state, NULL));
+
+    return state;
+}
 
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqDown), down);
+/* Publish the current UI state to the control thread. */
+static void publish_ui_state(GtkRigCtrl * ctrl)
+{
+    rig_ctrl_state_t state;
+
+    get_ui_state(ctrl, &state);
+    publish_state(&ctrl->uistate, &state);
+}
+
+/*
+ * Merge the latest UI state into the state of the control thread.
+ *
+ * The radio frequencies are owned by the control thread. The satellite
+ * frequencies are taken from the UI unless the UI has not yet seen the
+ * latest dial feedback from the radio, in which case the UI values are
+ * outdated.
+ */
+static void merge_ui_state(GtkRigCtrl * ctrl)
+{
+    rig_ctrl_state_t *ui;
+    rig_ctrl_state_t old = ctrl->state;
+
+    ui = take_state(&ctrl->uistate);
+    if (ui == NULL)
+        return;
+
+    ctrl->state = *ui;
+    g_free(ui);
+
+    if (ctrl->state.resync != old.resync)
+    {
+        /* invalidate sync with radio */
+        ctrl->lastrxf = 0.0;
+        ctrl->lasttxf = 0.0;
+    }
+
+    /* new target; avoid false AOS/LOS */
+    if (ctrl->state.catnum != old.catnum)
+        ctrl->prev_ele = ctrl->state.el;
+
+    if (ctrl->state.dialgen != old.dialgen)
+    {
+        ctrl->state.satfreqd = old.satfreqd;
+        ctrl->state.satfrequ = old.satfrequ;
+        ctrl->state.dialgen = old.dialgen;
+    }
+
+    /* keep our radio frequencies once we have them */
+    if (old.rigfreqd > 0.0)
+        ctrl->state.rigfreqd = old.rigfreqd;
+    if (old.rigfrequ > 0.0)
+        ctrl->state.rigfrequ = old.rigfrequ;
+
+    ctrl->state.engaged = old.engaged;
+}
+
+/* Apply the latest state of the control thread to the widgets. */
+static gboolean ctrl_state_idle_cb(gpointer data)
+{
+    GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
+    rig_ctrl_state_t *state;
+
+    g_atomic_int_set(&ctrl->idlepending, 0);
+
+    state = take_state(&ctrl->ctrlstate);
+    if (state == NULL || ctrl->conf == NULL)
+    {
+        /* nothing new or the controller has been destroyed */
+        g_free(state);
+        return FALSE;
     }
+
+    ctrl->dialgen = state->dialgen;
+    gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqDown), state->satfreqd);
+    gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqUp), state->satfrequ);
+    gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown), state->rigfreqd);
+    gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp), state->rigfrequ);
+
+    /* the control thread gave up on the radio */
+    if (!state->engaged &&
+        gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(ctrl->LockBut)))
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(ctrl->LockBut), FALSE);
+
+    g_free(state);
+
+    return FALSE;
+}
+
+/*
+ * Publish the state of the control thread to the UI.
+ *
+ * At most one idle callback is scheduled at a time; it always applies the
+ * latest state, so the UI can not fall behind a fast control loop.
+ */
+static void publish_ctrl_state(GtkRigCtrl * ctrl)
+{
+    ctrl->state.engaged = ctrl->engaged;
+    publish_state(&ctrl->ctrlstate, &ctrl->state);
+
+    if (g_atomic_int_compare_and_exchange(&ctrl->idlepending, 0, 1))
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, ctrl_state_idle_cb,
+                        g_object_ref(ctrl), g_object_unref);
 }
 
 void gtk_rig_ctrl_select_sat(GtkRigCtrl * ctrl, gint catnum)
@@ -414,24 +660,63 @@ void gtk_rig_ctrl_select_sat(GtkRigCtrl * ctrl, gint catnum)
     }
 }
 
+/*
+ * Recalculate the next pass after the elements of a satellite changed.
+ *
+ * Called by the parent GtkSatModule when new elements have been swapped
+ * into a satellite. Nothing happens unless it is the current target.
+ */
+void gtk_rig_ctrl_refresh_sat(GtkRigCtrl * ctrl, gint catnum)
+{
+    if (ctrl->target == NULL || ctrl->target->tle.catnr != catnum)
+        return;
+
+    g_mutex_lock(&ctrl->rig_ctrl_updatelock);
+    if (ctrl->pass != NULL)
+        free_pass(ctrl->pass);
+    ctrl->pass = station_get_pass(ctrl->target, ctrl->qth,
+                                  get_current_daynum(), 3.0);
+    g_mutex_unlock(&ctrl->rig_ctrl_updatelock);
+}
+
 static void downlink_changed_cb(GtkFreqKnob * knob, gpointer data)
 {
     GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
 
+    rig_ctrl_state_t state;
+
     (void)knob;
 
+    get_ui_state(ctrl, &state);
     if (ctrl->trsplock)
-        track_downlink(ctrl);
+    {
+        track_downlink(&state);
+        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqUp),
+                                state.satfrequ);
+        state.satfrequ =
+            gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
+    }
+    publish_state(&ctrl->uistate, &state);
 }
 
 static void uplink_changed_cb(GtkFreqKnob * knob, gpointer data)
 {
     GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
 
+    rig_ctrl_state_t state;
+
     (void)knob;
 
+    get_ui_state(ctrl, &state);
     if (ctrl->trsplock)
-        track_uplink(ctrl);
+    {
+        track_uplink(&state);
+        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqDown),
+                                state.satfreqd);
+        state.satfreqd =
+            gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
+    }
+    publish_state(&ctrl->uistate, &state);
 }
 
 /*
@@ -595,7 +880,7 @@ static void load_trsp_list(GtkRigCtrl * ctrl)
     }
 
     /* read transponders for new target */
-    ctrl->trsplist = read_transponders(ctrl->target->tle.catnr);
+    ctrl->trsplist = trsp_db_get(ctrl->target->tle.catnr);
     n = g_slist_length(ctrl->trsplist);
     sat_log_log(SAT_LOG_LEVEL_DEBUG,
                 _("%s:%s: Satellite %d has %d transponder modes."),
@@ -665,15 +950,15 @@ static void sat_selected_cb(GtkComboBox * satsel, gpointer data)
     {
         ctrl->target = SAT(g_slist_nth_data(ctrl->sats, i));
 
-        ctrl->prev_ele = ctrl->target->el;
-
         /* update next pass */
         if (ctrl->pass != NULL)
             free_pass(ctrl->pass);
-        ctrl->pass = get_next_pass(ctrl->target, ctrl->qth, 3.0);
+        ctrl->pass = station_get_pass(ctrl->target, ctrl->qth,
+                                      get_current_daynum(), 3.0);
 
         /* read transponders for new target */
         load_trsp_list(ctrl);
+        publish_ui_state(ctrl);
     }
     else
     {
@@ -719,9 +1004,6 @@ static void trsp_tune_cb(GtkButton * button, gpointer data)
         freq = ctrl->trsp->downlow +
             abs(ctrl->trsp->downhigh - ctrl->trsp->downlow) / 2;
         gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqDown), freq);
-
-        /* invalidate RIG<->GPREDICT sync */
-        ctrl->lastrxf = 0.0;
     }
 
     /* tune uplink */
@@ -730,16 +1012,67 @@ static void trsp_tune_cb(GtkButton * button, gpointer data)
         freq = ctrl->trsp->uplow +
             abs(ctrl->trsp->uphigh - ctrl->trsp->uplow) / 2;
         gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqUp), freq);
-
-        /* invalidate RIG<->GPREDICT sync */
-        ctrl->lasttxf = 0.0;
     }
+
+    /* invalidate RIG<->GPREDICT sync */
+    ctrl->resync++;
+    publish_ui_state(ctrl);
 }
 
 /*
  * Called when a new transponder is selected.
  * It updates ctrl->trsp with the new selection and issues a "tune" event.
  */
+/*
+ * Update the tooltip of the transponder selector.
+ *
+ * The tooltip lists the other satellites of the module with a downlink
+ * overlapping the selected transponder, which are looked up in the
+ * frequency index of the transponder database.
+ */
+static void update_trsp_tooltip(GtkRigCtrl * ctrl)
+{
+    GArray         *found;
+    GString        *text;
+    GSList         *node;
+    sat_t          *sat;
+    guint           i, num = 0;
+
+    text = g_string_new(_("Select a transponder"));
+
+    if (ctrl->trsp != NULL && ctrl->trsp->downlow > 0)
+    {
+        found = trsp_db_find(ctrl->trsp->downlow,
+                             MAX(ctrl->trsp->downlow, ctrl->trsp->downhigh),
+                             FALSE, NULL);
+
+        for (node = ctrl->sats; node != NULL; node = node->next)
+        {
+            sat = SAT(node->data);
+            if (sat == NULL || sat == ctrl->target)
+                continue;
+
+            for (i = 0; i < found->len; i++)
+                if (g_array_index(found, guint, i) == (guint) sat->tle.catnr)
+                    break;
+            if (i == found->len)
+                continue;
+
+            if (num++ == 0)
+                g_string_append(text, _("\n\nOther satellites in this module "
+                                        "with a downlink in this range: "));
+            else
+                g_string_append(text, ", ");
+            g_string_append(text, sat->nickname);
+        }
+
+        g_array_free(found, TRUE);
+    }
+
+    gtk_widget_set_tooltip_text(ctrl->TrspSel, text->str);
+    g_string_free(text, TRUE);
+}
+
 static void trsp_selected_cb(GtkComboBox * box, gpointer data)
 {
     GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
@@ -752,11 +1085,14 @@ static void trsp_selected_cb(GtkComboBox * box, gpointer data)
     {
         /* clear transponder data */
         ctrl->trsp = NULL;
+        publish_ui_state(ctrl);
+        update_trsp_tooltip(ctrl);
     }
     else if (i < n)
     {
         ctrl->trsp = (trsp_t *) g_slist_nth_data(ctrl->trsplist, i);
         trsp_tune_cb(NULL, data);
+        update_trsp_tooltip(ctrl);
     }
     else
     {
@@ -784,8 +1120,7 @@ static void trsp_lock_cb(GtkToggleButton * button, gpointer data)
     ctrl->trsplock = gtk_toggle_button_get_active(button);
 
     /* set uplink according to downlink */
-    if (ctrl->trsplock)
-        track_downlink(ctrl);
+    downlink_changed_cb(GTK_FREQ_KNOB(ctrl->SatFreqDown), ctrl);
 }
 
 static void track_toggle_cb(GtkToggleButton * button, gpointer data)
@@ -795,8 +1130,8 @@ static void track_toggle_cb(GtkToggleButton * button, gpointer data)
     ctrl->tracking = gtk_toggle_button_get_active(button);
 
     /* invalidate sync with radio */
-    ctrl->lastrxf = 0.0;
-    ctrl->lasttxf = 0.0;
+    ctrl->resync++;
+    publish_ui_state(ctrl);
 }
 
 /* Called when the user changes the value of the cycle delay */
@@ -808,8 +1143,9 @@ static void delay_changed_cb(GtkSpinButton * spin, gpointer data)
     if (ctrl->conf)
         ctrl->conf->cycle = ctrl->delay;
 
+    /* wake up the controller so that the new period takes effect */
     if (ctrl->engaged)
-        start_timer(ctrl);
+        setconfig(ctrl);
 }
 
 static void primary_rig_selected_cb(GtkComboBox * box, gpointer data)
@@ -989,20 +1325,22 @@ static void rig_engaged_cb(GtkToggleButton * button, gpointer data)
         gtk_widget_set_sensitive(ctrl->DevSel2, TRUE);
         ctrl->engaged = FALSE;
 
-        /*  stop worker thread... */
+        /* the next cycle closes the connections and stops the chain */
         setconfig(ctrl);
-        ctrl->rigctl_thread = NULL;
     }
     else
     {
         gtk_widget_set_sensitive(ctrl->DevSel, FALSE);
         gtk_widget_set_sensitive(ctrl->DevSel2, FALSE);
         ctrl->engaged = TRUE;
+        publish_ui_state(ctrl);
 
-        /*  start worker thread... */
-        ctrl->rigctlq = g_async_queue_new();
-        ctrl->rigctl_thread = g_thread_new("rigctl_run", rigctl_run, ctrl);
-        setconfig(ctrl);
+        /* release the chain of a previous engagement */
+        if (ctrl->chain != NULL)
+            station_chain_join(ctrl->chain);
+
+        ctrl->chain = station_chain_start(ctrl->conf->name, rig_ctrl_cycle,
+                                          ctrl);
     }
 }
 
@@ -1331,8 +1669,11 @@ static GtkWidget *create_conf_widgets(GtkRigCtrl * ctrl)
     ctrl->cycle_spin = gtk_spin_button_new_with_range(10, 10000, 10);
     gtk_spin_button_set_digits(GTK_SPIN_BUTTON(ctrl->cycle_spin), 0);
     gtk_widget_set_tooltip_text(ctrl->cycle_spin,
-                                _("This parameter controls the delay between "
-                                  "commands sent to the rig."));
+                                _("This parameter controls the longest delay "
+                                  "between commands sent to the rig. While "
+                                  "tracking, commands are sent more often "
+                                  "when the Doppler shift changes faster than "
+                                  "one tuning step per cycle."));
     g_signal_connect(ctrl->cycle_spin, "value-changed",
                      G_CALLBACK(delay_changed_cb), ctrl);
     gtk_grid_attach(GTK_GRID(table), ctrl->cycle_spin, 1, 3, 1, 1);
@@ -1386,180 +1727,382 @@ static void store_sats(gpointer key, gpointer value, gpointer user_data)
                                        (GCompareFunc) sat_name_compare);
 }
 
-static gboolean _send_rigctld_command(GtkRigCtrl * ctrl, gint sock,
-                                      gchar * buff, gchar * buffout,
-                                      gint sizeout)
+static gboolean send_rigctld_command(GtkRigCtrl * ctrl, hamlib_conn_t * conn,
+                                     gchar * buff, gchar * buffout,
+                                     gint sizeout)
 {
-    gint            written;
-    gint            size;
-
-    size = strlen(buff);
+    GString        *reply;
+    gboolean        retval;
 
     sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                _("%s:%s: sending %d bytes to rigctld as \"%s\""),
-                __FILE__, __func__, size, buff);
-    /* send command */
-    written = send(sock, buff, strlen(buff), 0);
-    if (written != size)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: SIZE ERROR %d / %d"), __func__, written, size);
-    }
-    if (written == -1)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: rigctld port closed"), __func__);
-        return FALSE;
-    }
-    /* try to read answer */
-    size = recv(sock, buffout, sizeout - 1, 0);
-    if (size == -1)
-    {
+                _("%s:%s: sending \"%s\" to rigctld"),
+                __FILE__, __func__, buff);
+
+    reply = g_string_sized_new(64);
+    retval = hamlib_conn_exec(conn, buff, HAMLIB_REPLY_PLAIN, 1,
+                              RIG_CMD_TIMEOUT, reply);
+    if (retval)
+        g_strlcpy(buffout, reply->str, sizeout);
+    else
         sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: rigctld port closed"), __func__);
-        return FALSE;
-    }
+                    _("%s: rigctld command failed"), __func__);
+    g_string_free(reply, TRUE);
 
-    buffout[size] = '\0';
-    if (size == 0)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s:%s: Got 0 bytes from rigctld"), __FILE__, __func__);
-    }
-    else
+    return retval;
+}
+
+/*
+ * Pipelined rigctld commands.
+ *
+ * Commands are queued with the '+' prefix that selects the extended response
+ * protocol of rigctld and are sent to the daemon in a single write. In
+ * extended mode every reply starts with a header line echoing the command
+ * and ends with a "RPRT n" line, so the replies to several commands can be
+ * framed in the received stream instead of assuming that a single recv()
+ * returns exactly one complete reply.
+ */
+typedef struct {
+    GString        *cmds;       /*!< Queued commands */
+    gint            num;        /*!< Number of queued commands */
+    gint            rprt[RIG_BATCH_MAX];        /*!< RPRT code of each reply */
+    gchar          *value[RIG_BATCH_MAX];       /*!< First value of each reply */
+} rig_batch_t;
+
+static void rig_batch_init(rig_batch_t * batch)
+{
+    gint            i;
+
+    batch->cmds = g_string_sized_new(64);
+    batch->num = 0;
+    for (i = 0; i < RIG_BATCH_MAX; i++)
     {
-        sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                    _("%s:%s: Read %d bytes from rigctld"),
-                    __FILE__, __func__, size);
+        batch->rprt[i] = -1;
+        batch->value[i] = NULL;
     }
-    ctrl->wrops++;
-
-    return TRUE;
 }
 
-static gboolean send_rigctld_command(GtkRigCtrl * ctrl, gint sock,
-                                     gchar * buff, gchar * buffout,
-                                     gint sizeout)
+static void rig_batch_free(rig_batch_t * batch)
 {
-    gboolean        retval;
-
-    /* Enter critical section! */
-    g_mutex_lock(&ctrl->writelock);
+    gint            i;
 
-    retval = _send_rigctld_command(ctrl, sock, buff, buffout, sizeout);
+    for (i = 0; i < RIG_BATCH_MAX; i++)
+        g_free(batch->value[i]);
 
-    /* Leave critical section! */
-    g_mutex_unlock(&ctrl->writelock);
-    return (retval);
+    g_string_free(batch->cmds, TRUE);
 }
 
-static inline gboolean check_set_response(gchar * buffback, gboolean retcode,
-                                          const gchar * function)
+/*
+ * Queue a command.
+ *
+ * @param batch The command batch.
+ * @param fmt printf style format of the command without prefix and newline.
+ * @return The index of the reply to this command or -1 if the batch is full.
+ */
+static gint rig_batch_add(rig_batch_t * batch, const gchar * fmt, ...)
 {
-    if (retcode == TRUE)
-    {
-        if (strncmp(buffback, "RPRT 0", 6) != 0)
-        {
-            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _("%s:%s: %s rigctld returned error (%s)"),
-                        __FILE__, __func__, function, buffback);
+    va_list         args;
 
-            retcode = FALSE;
-        }
+    if (batch->num == RIG_BATCH_MAX)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Too many commands in batch"), __func__);
+        return -1;
     }
 
-    return retcode;
+    g_string_append_c(batch->cmds, '+');
+    va_start(args, fmt);
+    g_string_append_vprintf(batch->cmds, fmt, args);
+    va_end(args);
+    g_string_append_c(batch->cmds, '\n');
+
+    return batch->num++;
 }
 
-static inline gboolean check_get_response(gchar * buffback, gboolean retcode,
-                                          const gchar * function)
+/* Process one line of extended response; idx and header track the framing */
+static void rig_batch_parse_line(rig_batch_t * batch, const gchar * line,
+                                 gint * idx, gboolean * header)
 {
-    if (retcode == TRUE)
-    {
-        if (strncmp(buffback, "RPRT", 4) == 0)
-        {
-            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _("%s:%s: %s rigctld returned error (%s)"),
-                        __FILE__, __func__, function, buffback);
+    const gchar    *sep;
 
-            retcode = FALSE;
-        }
+    if (*idx >= batch->num)
+    {
+        sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                    _("%s: Ignoring unexpected line \"%s\""), __func__, line);
+        return;
     }
 
-    return retcode;
+    if (g_str_has_prefix(line, "RPRT "))
+    {
+        /* end of this reply */
+        batch->rprt[*idx] = (gint) g_ascii_strtoll(line + 5, NULL, 10);
+        (*idx)++;
+        *header = TRUE;
+    }
+    else if (*header)
+    {
+        /* echo of the command name and its arguments */
+        *header = FALSE;
+    }
+    else if (batch->value[*idx] == NULL &&
+             (sep = strstr(line, ": ")) != NULL)
+    {
+        batch->value[*idx] = g_strdup(sep + 2);
+    }
 }
 
-/* Setup VFOs for split operation (simplex or duplex) */
-static gboolean setup_split(GtkRigCtrl * ctrl)
+/*
+ * Send the queued commands in one write and wait for all replies.
+ *
+ * @param ctrl Pointer to the GtkRigCtrl handle.
+ * @param conn The connection to rigctld.
+ * @param batch The command batch.
+ * @return TRUE if all replies have been received, FALSE if a connection
+ *         error occurred. The result of each command is in batch->rprt.
+ */
+static gboolean rig_batch_exec(GtkRigCtrl * ctrl, hamlib_conn_t * conn,
+                               rig_batch_t * batch)
 {
-    gchar          *buff;
-    gchar           buffback[256];
+    GString        *reply;
+    gchar         **lines;
+    gint            i;
+    gint            idx = 0;
+    gint64          tsent;
+    gboolean        header = TRUE;
     gboolean        retcode;
 
-    switch (ctrl->conf->vfoUp)
-    {
-    case VFO_A:
-        buff = g_strdup("S 1 VFOA\x0a");
-        break;
-
-    case VFO_B:
-        buff = g_strdup("S 1 VFOB\x0a");
-        break;
-
-    case VFO_MAIN:
-        buff = g_strdup("S 1 Main\x0a");
-        break;
+    if (batch->num == 0)
+        return TRUE;
 
-    case VFO_SUB:
-        buff = g_strdup("S 1 Sub\x0a");
-        break;
+    sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                _("%s:%s: sending %d commands to rigctld as \"%s\""),
+                __FILE__, __func__, batch->num, batch->cmds->str);
+
+    /* wait until every command has been answered by a RPRT line */
+    reply = g_string_sized_new(128);
+    tsent = g_get_monotonic_time();
+    retcode = hamlib_conn_exec(conn, batch->cmds->str, HAMLIB_REPLY_EXTENDED,
+                               batch->num, RIG_CMD_TIMEOUT, reply);
+    if (retcode)
+    {
+        lines = g_strsplit(reply->str, "\n", -1);
+        for (i = 0; lines[i] != NULL && idx < batch->num; i++)
+            rig_batch_parse_line(batch, lines[i], &idx, &header);
+        g_strfreev(lines);
 
-    default:
+        /* smoothed round trip time used for the Doppler prediction */
+        if (ctrl->latency > 0.0)
+            ctrl->latency = 0.8 * ctrl->latency +
+                0.2 * (g_get_monotonic_time() - tsent);
+        else
+            ctrl->latency = g_get_monotonic_time() - tsent;
+    }
+    else
+    {
         sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s called but TX VFO is %d."), __func__,
-                    ctrl->conf->vfoUp);
-        return FALSE;
+                    _("%s: rigctld did not answer %d commands"),
+                    __func__, batch->num);
     }
+    g_string_free(reply, TRUE);
 
-    retcode = send_rigctld_command(ctrl, ctrl->sock, buff, buffback, 128);
-    g_free(buff);
-
-    return (check_set_response(buffback, retcode, __func__));
+    return retcode;
 }
 
-static gboolean rig_ctrl_timeout_cb(gpointer data)
+/* Check the RPRT code of a reply and log an error if it is not zero */
+static gboolean rig_batch_ok(rig_batch_t * batch, gint idx,
+                             const gchar * function)
 {
-    GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
+    if (idx < 0)
+        return FALSE;
 
-    if (ctrl->conf == NULL)
+    if (batch->rprt[idx] != 0)
     {
         sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: Controller does not have a valid configuration"),
-                    __func__);
+                    _("%s:%s: %s rigctld returned error (RPRT %d)"),
+                    __FILE__, __func__, function, batch->rprt[idx]);
         return FALSE;
     }
 
-    if (g_mutex_trylock(&(ctrl->busy)) == FALSE)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR, _("%s missed the deadline"),
-                    __func__);
-        return TRUE;
-    }
+    return TRUE;
+}
+
+/* Get the frequency value of a reply */
+static gboolean rig_batch_get_freq(rig_batch_t * batch, gint idx,
+                                   const gchar * function, gdouble * freq)
+{
+    if (!rig_batch_ok(batch, idx, function) || batch->value[idx] == NULL)
+        return FALSE;
 
-    setconfig(ctrl);
-    g_mutex_unlock(&(ctrl->busy));
+    *freq = g_ascii_strtod(batch->value[idx], NULL);
 
     return TRUE;
 }
 
+/*
+ * Send a single set command.
+ *
+ * Returns TRUE if rigctld acknowledged the command, FALSE otherwise
+ */
+static gboolean send_set_command(GtkRigCtrl * ctrl, hamlib_conn_t * conn,
+                                 const gchar * cmd, const gchar * function)
+{
+    rig_batch_t     batch;
+    gint            idx;
+    gboolean        retcode;
+
+    rig_batch_init(&batch);
+    idx = rig_batch_add(&batch, "%s", cmd);
+    retcode = rig_batch_exec(ctrl, conn, &batch) &&
+        rig_batch_ok(&batch, idx, function);
+    rig_batch_free(&batch);
+
+    return retcode;
+}
+
+/*
+ * Reset the state cached during a controller cycle.
+ *
+ * The PTT status and the frequency of the primary radio are read at most once
+ * per cycle so that the RX and TX parts of a cycle can share them.
+ */
+static void reset_cycle_state(GtkRigCtrl * ctrl)
+{
+    ctrl->cycleptt = -1;
+    ctrl->cyclefreq = 0.0;
+}
+
+/*
+ * Predict the Doppler shifts for the current cycle.
+ *
+ * The shifts computed in gtk_rig_ctrl_update() refer to the time of the last
+ * module update, while a frequency sent now reaches the radio about half a
+ * rigctld round trip later. The shifts are therefore extrapolated to that
+ * moment using their rate of change.
+ */
+static void predict_doppler(GtkRigCtrl * ctrl)
+{
+    rig_ctrl_state_t *state = &ctrl->state;
+    gdouble         dt;
+
+    dt = rig_tuning_horizon(state->dtime, state->trate, ctrl->latency,
+                            g_get_monotonic_time());
+
+    ctrl->pdd = state->dd + state->ddrate * dt;
+    ctrl->pdu = state->du + state->durate * dt;
+}
+
+/*
+ * Compute the delay in usec until the next cycle.
+ *
+ * While tracking, the command rate follows the Doppler slope of the pass;
+ * see rig_tuning_delay().
+ */
+static gint64 next_cycle_delay(GtkRigCtrl * ctrl)
+{
+    gdouble         rate = 0.0, step = 1.0;
+
+    if (ctrl->state.tracking && ctrl->conf != NULL)
+    {
+        rate = MAX(fabs(ctrl->state.ddrate), fabs(ctrl->state.durate)) *
+            ctrl->state.trate;
+        step = ctrl->conf->step;
+        if (ctrl->conf2 != NULL)
+            step = MIN(step, ctrl->conf2->step);
+    }
+
+    return rig_tuning_delay(ctrl->delay * 1000.0, rate, step, ctrl->latency);
+}
+
+/* Setup VFOs for split operation (simplex or duplex) */
+static gboolean setup_split(GtkRigCtrl * ctrl)
+{
+    const gchar    *buff;
+
+    switch (ctrl->conf->vfoUp)
+    {
+    case VFO_A:
+        buff = "S 1 VFOA";
+        break;
+
+    case VFO_B:
+        buff = "S 1 VFOB";
+        break;
+
+    case VFO_MAIN:
+        buff = "S 1 Main";
+        break;
+
+    case VFO_SUB:
+        buff = "S 1 Sub";
+        break;
+
+    default:
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s called but TX VFO is %d."), __func__,
+                    ctrl->conf->vfoUp);
+        return FALSE;
+    }
+
+    return send_set_command(ctrl, ctrl->conn, buff, __func__);
+}
+
+/*
+ * RX cycle.
+ *
+ * Without PTT monitoring, the frequency read for the dial feedback, the
+ * new frequency and the read back are sent in one write. The new frequency
+ * does not depend on the read. If the dial has moved, the radio is tuned
+ * back to the dial frequency in a second round trip. With PTT monitoring,
+ * the frequency may only be set once the PTT is known to be off. rigctld
+ * cannot make a command depend on an earlier reply, so the set waits for
+ * the PTT status.
+ */
 static void exec_rx_cycle(GtkRigCtrl * ctrl)
 {
     gdouble         readfreq = 0.0, tmpfreq, satfreqd, satfrequ;
+    gdouble         rigfreqd, rigfrequ;
     gboolean        ptt = FALSE;
+    gboolean        readok = FALSE;
+    gboolean        setdone = FALSE;
+    gboolean        setok = FALSE;
 
-    /* get PTT status */
-    if (ctrl->engaged && ctrl->conf->ptt)
-        ptt = get_ptt(ctrl, ctrl->sock);
+    /* frequency for forward tracking */
+
+    /* If we are tracking, calculate the radio freq by applying both dopper shift
+       and tranverter LO frequency. If we are not tracking, apply only LO frequency.
+     */
+    satfreqd = ctrl->state.satfreqd;
+    satfrequ = ctrl->state.satfrequ;
+    if (ctrl->state.tracking)
+    {
+        /* downlink */
+        rigfreqd = satfreqd + ctrl->pdd - ctrl->conf->lo;
+        /* uplink */
+        rigfrequ = satfrequ + ctrl->pdu - ctrl->conf->loup;
+    }
+    else
+    {
+        rigfreqd = satfreqd - ctrl->conf->lo;
+        rigfrequ = satfrequ - ctrl->conf->loup;
+    }
+
+    if (ctrl->engaged && ctrl->conf->ptt == PTT_TYPE_NONE &&
+        rig_tuning_needs_update(rigfreqd, ctrl->lastrxf, ctrl->lastrxreq,
+                                ctrl->conf->step))
+    {
+        /* read, set and read back in one go */
+        ctrl->lastrxreq = rigfreqd;
+        setok = get_set_get_freq(ctrl, ctrl->conn,
+                                 (ctrl->lastrxf > 0.0) ? &readfreq : NULL,
+                                 &readok, rigfreqd, &tmpfreq);
+        setdone = TRUE;
+    }
+    else if (ctrl->engaged)
+    {
+        /* get PTT status and frequency in one go */
+        readok = get_ptt_freq(ctrl, ctrl->conn,
+                              ctrl->conf->ptt ? &ptt : NULL,
+                              (ctrl->lastrxf > 0.0) ? &readfreq : NULL);
+    }
 
     /* Dial feedback:
        If radio device is engaged read frequency from radio and compare it to the
@@ -1571,34 +2114,39 @@ static void exec_rx_cycle(GtkRigCtrl * ctrl)
      */
     if ((ctrl->engaged) && (ctrl->lastrxf > 0.0) && (ptt == FALSE))
     {
-        if (!get_freq_simplex(ctrl, ctrl->sock, &readfreq))
+        if (!readok)
         {
             /* error => use a passive value */
             ctrl->errcnt++;
         }
         else if (fabs(readfreq - ctrl->lastrxf) >= 1.0)
         {
+            /* the frequency set in the same write replaced the one on the
+               dial; tune back to it */
+            if (setdone)
+                set_get_freq(ctrl, ctrl->conn, FALSE, readfreq, &tmpfreq);
+
             /* user might have altered radio frequency => update transponder knob */
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                    readfreq);
+            ctrl->state.rigfreqd = readfreq;
             ctrl->lastrxf = readfreq;
+            ctrl->lastrxreq = 0.0;
 
             /* doppler shift; only if we are tracking */
-            if (ctrl->tracking)
+            if (ctrl->state.tracking)
             {
-                satfreqd = (readfreq - ctrl->dd + ctrl->conf->lo);
+                satfreqd = (readfreq - ctrl->pdd + ctrl->conf->lo);
             }
             else
             {
                 satfreqd = readfreq + ctrl->conf->lo;
             }
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqDown),
-                                    satfreqd);
+            ctrl->state.satfreqd = satfreqd;
+            ctrl->state.dialgen++;
 
             /* Update uplink if locked to downlink */
-            if (ctrl->trsplock)
+            if (ctrl->state.trsplock)
             {
-                track_downlink(ctrl);
+                track_downlink(&ctrl->state);
             }
 
             /* no need to forward track */
@@ -1606,56 +2154,32 @@ static void exec_rx_cycle(GtkRigCtrl * ctrl)
         }
     }
 
-    /* now, forward tracking */
+    ctrl->state.rigfreqd = rigfreqd;
+    ctrl->state.rigfrequ = rigfrequ;
 
-    /* If we are tracking, calculate the radio freq by applying both dopper shift
-       and tranverter LO frequency. If we are not tracking, apply only LO frequency.
-     */
-    satfreqd = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
-    satfrequ = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
-    if (ctrl->tracking)
-    {
-        /* downlink */
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                satfreqd + ctrl->dd - ctrl->conf->lo);
-        /* uplink */
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                satfrequ + ctrl->du - ctrl->conf->loup);
-    }
-    else
+    /* if device is engaged, send freq command to radio */
+    if (!setdone && (ctrl->engaged) && (ptt == FALSE) &&
+        rig_tuning_needs_update(rigfreqd, ctrl->lastrxf, ctrl->lastrxreq,
+                                ctrl->conf->step))
     {
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                satfreqd - ctrl->conf->lo);
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                satfrequ - ctrl->conf->loup);
+        ctrl->lastrxreq = rigfreqd;
+        setok = set_get_freq(ctrl, ctrl->conn, FALSE, rigfreqd, &tmpfreq);
+        setdone = TRUE;
     }
 
-    tmpfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqDown));
-
-    /* if device is engaged, send freq command to radio */
-    if ((ctrl->engaged) && (ptt == FALSE) &&
-        (fabs(ctrl->lastrxf - tmpfreq) >= 1.0))
+    if (setdone)
     {
-        if (set_freq_simplex(ctrl, ctrl->sock, tmpfreq))
+        if (setok)
         {
             /* reset error counter */
             ctrl->errcnt = 0;
-
-            /* give radio a chance to set frequency */
-            g_usleep(WR_DEL);
-
-            /* The actual frequency might be different from what we have set because
-               the tuning step is larger than what we work with (e.g. FT-817 has a
-               smallest tuning step of 10 Hz). Therefore we read back the actual
-               frequency from the rig. */
-            get_freq_simplex(ctrl, ctrl->sock, &tmpfreq);
             ctrl->lastrxf = tmpfreq;
 
             /* This is only effective in RIG_TYPE_TRX mode.
                Invalidate ctrl->lasttxf for two reasons.
 
                1. Prevent dial feedback from changing the uplink frequency.
-               In the first TX cycle get_freq_simplex() returns the downlink
+               In the first TX cycle the frequency read back is the downlink
                frequency instead of uplink. The mismatch would thus trigger
                an uplink update as long as the VFO has not been updated.
                2. Force updating the VFO in the first TX cycle.
@@ -1665,6 +2189,7 @@ static void exec_rx_cycle(GtkRigCtrl * ctrl)
         }
         else
         {
+            ctrl->lastrxreq = 0.0;
             ctrl->errcnt++;
         }
     }
@@ -1679,12 +2204,13 @@ static void exec_tx_cycle(GtkRigCtrl * ctrl)
 {
     gdouble         readfreq = 0.0, tmpfreq, satfreqd, satfrequ;
     gboolean        ptt = TRUE;
+    gboolean        readok = FALSE;
 
-    /* get PTT status */
-    if (ctrl->engaged && ctrl->conf->ptt)
-    {
-        ptt = get_ptt(ctrl, ctrl->sock);
-    }
+    /* get PTT status and frequency in one go */
+    if (ctrl->engaged)
+        readok = get_ptt_freq(ctrl, ctrl->conn,
+                              ctrl->conf->ptt ? &ptt : NULL,
+                              (ctrl->lasttxf > 0.0) ? &readfreq : NULL);
 
     /* Dial feedback:
        If radio device is engaged read frequency from radio and compare it to the
@@ -1696,7 +2222,7 @@ static void exec_tx_cycle(GtkRigCtrl * ctrl)
      */
     if ((ctrl->engaged) && (ctrl->lasttxf > 0.0) && (ptt == TRUE))
     {
-        if (!get_freq_simplex(ctrl, ctrl->sock, &readfreq))
+        if (!readok)
         {
             /* error => use a passive value */
             ctrl->errcnt++;
@@ -1704,24 +2230,26 @@ static void exec_tx_cycle(GtkRigCtrl * ctrl)
         else if (fabs(readfreq - ctrl->lasttxf) >= 1.0)
         {
             /* user might have altered radio frequency => update transponder knob */
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp), readfreq);
+            ctrl->state.rigfrequ = readfreq;
             ctrl->lasttxf = readfreq;
+            ctrl->lasttxreq = 0.0;
 
             /* doppler shift; only if we are tracking */
-            if (ctrl->tracking)
+            if (ctrl->state.tracking)
             {
-                satfrequ = readfreq - ctrl->du + ctrl->conf->loup;
+                satfrequ = readfreq - ctrl->pdu + ctrl->conf->loup;
             }
             else
             {
                 satfrequ = readfreq + ctrl->conf->loup;
             }
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqUp), satfrequ);
+            ctrl->state.satfrequ = satfrequ;
+            ctrl->state.dialgen++;
 
             /* Follow with downlink if transponder is locked */
-            if (ctrl->trsplock)
+            if (ctrl->state.trsplock)
             {
-                track_uplink(ctrl);
+                track_uplink(&ctrl->state);
             }
 
             /* no need to forward track */
@@ -1734,51 +2262,40 @@ static void exec_tx_cycle(GtkRigCtrl * ctrl)
     /* If we are tracking, calculate the radio freq by applying both dopper shift
        and tranverter LO frequency. If we are not tracking, apply only LO frequency.
      */
-    satfreqd = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
-    satfrequ = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
-    if (ctrl->tracking)
+    satfreqd = ctrl->state.satfreqd;
+    satfrequ = ctrl->state.satfrequ;
+    if (ctrl->state.tracking)
     {
         /* downlink */
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                satfreqd + ctrl->dd - ctrl->conf->lo);
+        ctrl->state.rigfreqd = satfreqd + ctrl->pdd - ctrl->conf->lo;
         /* uplink */
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                satfrequ + ctrl->du - ctrl->conf->loup);
+        ctrl->state.rigfrequ = satfrequ + ctrl->pdu - ctrl->conf->loup;
     }
     else
     {
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                satfreqd - ctrl->conf->lo);
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                satfrequ - ctrl->conf->loup);
+        ctrl->state.rigfreqd = satfreqd - ctrl->conf->lo;
+        ctrl->state.rigfrequ = satfrequ - ctrl->conf->loup;
     }
 
-    tmpfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqUp));
+    tmpfreq = ctrl->state.rigfrequ;
 
     /* if device is engaged, send freq command to radio */
     if ((ctrl->engaged) && (ptt == TRUE) &&
-        (fabs(ctrl->lasttxf - tmpfreq) >= 1.0))
+        rig_tuning_needs_update(tmpfreq, ctrl->lasttxf, ctrl->lasttxreq,
+                                ctrl->conf->step))
     {
-        if (set_freq_simplex(ctrl, ctrl->sock, tmpfreq))
+        ctrl->lasttxreq = tmpfreq;
+        if (set_get_freq(ctrl, ctrl->conn, FALSE, tmpfreq, &readfreq))
         {
             /* reset error counter */
             ctrl->errcnt = 0;
-
-            /* give radio a chance to set frequency */
-            g_usleep(WR_DEL);
-
-            /* The actual frequency migh be different from what we have set because
-               the tuning step is larger than what we work with (e.g. FT-817 has a
-               smallest tuning step of 10 Hz). Therefore we read back the actual
-               frequency from the rig. */
-            get_freq_simplex(ctrl, ctrl->sock, &tmpfreq);
-            ctrl->lasttxf = tmpfreq;
+            ctrl->lasttxf = readfreq;
 
             /* This is only effective in RIG_TYPE_TRX mode.
                Invalidate ctrl->lastrxf for two reasons.
 
                1. Prevent dial feedback from changing the downlink frequency.
-               In the first RX cycle get_freq_simplex() returns the uplink
+               In the first RX cycle the frequency read back is the uplink
                frequency instead of downlink. The mismatch would thus
                trigger a downlink update as long as the VFO has not been
                updated.
@@ -1789,6 +2306,7 @@ static void exec_tx_cycle(GtkRigCtrl * ctrl)
         }
         else
         {
+            ctrl->lasttxreq = 0.0;
             ctrl->errcnt++;
         }
     }
@@ -1856,7 +2374,7 @@ static void exec_toggle_tx_cycle(GtkRigCtrl * ctrl)
 
     if (ctrl->engaged && ctrl->conf->ptt)
     {
-        ptt = get_ptt(ctrl, ctrl->sock);
+        ptt = get_ptt(ctrl, ctrl->conn);
     }
 
     /* if we are in TX mode do nothing */
@@ -1866,12 +2384,12 @@ static void exec_toggle_tx_cycle(GtkRigCtrl * ctrl)
     }
 
     /* Get the desired uplink frequency from controller */
-    tmpfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqUp));
+    tmpfreq = ctrl->state.rigfrequ;
 
     /* if device is engaged, send freq command to radio */
     if ((ctrl->engaged) && (fabs(ctrl->lasttxf - tmpfreq) >= 10.0))
     {
-        if (set_freq_toggle(ctrl, ctrl->sock, tmpfreq))
+        if (set_freq_toggle(ctrl, ctrl->conn, tmpfreq))
         {
             /* reset error counter */
             ctrl->errcnt = 0;
@@ -1902,7 +2420,7 @@ static void exec_duplex_tx_cycle(GtkRigCtrl * ctrl)
      */
     if ((ctrl->engaged) && (ctrl->lasttxf > 0.0))
     {
-        if (!get_freq_toggle(ctrl, ctrl->sock, &readfreq))
+        if (!get_freq_toggle(ctrl, ctrl->conn, &readfreq))
         {
             /* error => use a passive value */
             readfreq = ctrl->lasttxf;
@@ -1914,24 +2432,26 @@ static void exec_duplex_tx_cycle(GtkRigCtrl * ctrl)
             dialchanged = TRUE;
 
             /* user might have altered radio frequency => update transponder knob */
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp), readfreq);
+            ctrl->state.rigfrequ = readfreq;
             ctrl->lasttxf = readfreq;
+            ctrl->lasttxreq = 0.0;
 
             /* doppler shift; only if we are tracking */
-            if (ctrl->tracking)
+            if (ctrl->state.tracking)
             {
-                satfrequ = readfreq - ctrl->du + ctrl->conf->loup;
+                satfrequ = readfreq - ctrl->pdu + ctrl->conf->loup;
             }
             else
             {
                 satfrequ = readfreq + ctrl->conf->loup;
             }
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqUp), satfrequ);
+            ctrl->state.satfrequ = satfrequ;
+            ctrl->state.dialgen++;
 
             /* Follow with downlink if transponder is locked */
-            if (ctrl->trsplock)
+            if (ctrl->state.trsplock)
             {
-                track_uplink(ctrl);
+                track_uplink(&ctrl->state);
             }
         }
     }
@@ -1946,47 +2466,38 @@ static void exec_duplex_tx_cycle(GtkRigCtrl * ctrl)
     /* If we are tracking, calculate the radio freq by applying both dopper shift
        and tranverter LO frequency. If we are not tracking, apply only LO frequency.
      */
-    satfreqd = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
-    satfrequ = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
-    if (ctrl->tracking)
+    satfreqd = ctrl->state.satfreqd;
+    satfrequ = ctrl->state.satfrequ;
+    if (ctrl->state.tracking)
     {
         /* downlink */
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                satfreqd + ctrl->dd - ctrl->conf->lo);
+        ctrl->state.rigfreqd = satfreqd + ctrl->pdd - ctrl->conf->lo;
         /* uplink */
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                satfrequ + ctrl->du - ctrl->conf->loup);
+        ctrl->state.rigfrequ = satfrequ + ctrl->pdu - ctrl->conf->loup;
     }
     else
     {
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                satfreqd - ctrl->conf->lo);
-        gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                satfrequ - ctrl->conf->loup);
+        ctrl->state.rigfreqd = satfreqd - ctrl->conf->lo;
+        ctrl->state.rigfrequ = satfrequ - ctrl->conf->loup;
     }
 
-    tmpfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqUp));
+    tmpfreq = ctrl->state.rigfrequ;
 
     /* if device is engaged, send freq command to radio */
-    if ((ctrl->engaged) && (fabs(ctrl->lasttxf - tmpfreq) >= 1.0))
+    if ((ctrl->engaged) &&
+        rig_tuning_needs_update(tmpfreq, ctrl->lasttxf, ctrl->lasttxreq,
+                                ctrl->conf->step))
     {
-        if (set_freq_toggle(ctrl, ctrl->sock, tmpfreq))
+        ctrl->lasttxreq = tmpfreq;
+        if (set_get_freq(ctrl, ctrl->conn, TRUE, tmpfreq, &readfreq))
         {
             /* reset error counter */
             ctrl->errcnt = 0;
-
-            /* give radio a chance to set frequency */
-            g_usleep(WR_DEL);
-
-            /* The actual frequency migh be different from what we have set because
-               the tuning step is larger than what we work with (e.g. FT-817 has a
-               smallest tuning step of 10 Hz). Therefore we read back the actual
-               frequency from the rig. */
-            get_freq_toggle(ctrl, ctrl->sock, &tmpfreq);
-            ctrl->lasttxf = tmpfreq;
+            ctrl->lasttxf = readfreq;
         }
         else
         {
+            ctrl->lasttxreq = 0.0;
             ctrl->errcnt++;
         }
     }
@@ -2007,7 +2518,7 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
     if (ctrl->engaged && (ctrl->lastrxf > 0.0))
     {
         /* get frequency from receiver */
-        if (!get_freq_simplex(ctrl, ctrl->sock, &readfreq))
+        if (!get_ptt_freq(ctrl, ctrl->conn, NULL, &readfreq))
         {
             /* error => use a passive value */
             readfreq = ctrl->lastrxf;
@@ -2019,26 +2530,26 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
             dialchanged = TRUE;
 
             /* user might have altered radio frequency => update transponder knob */
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                    readfreq);
+            ctrl->state.rigfreqd = readfreq;
             ctrl->lastrxf = readfreq;
+            ctrl->lastrxreq = 0.0;
 
             /* doppler shift; only if we are tracking */
-            if (ctrl->tracking)
+            if (ctrl->state.tracking)
             {
-                satfreqd = readfreq - ctrl->dd + ctrl->conf->lo;
+                satfreqd = readfreq - ctrl->pdd + ctrl->conf->lo;
             }
             else
             {
                 satfreqd = readfreq + ctrl->conf->lo;
             }
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqDown),
-                                    satfreqd);
+            ctrl->state.satfreqd = satfreqd;
+            ctrl->state.dialgen++;
 
             /* Update uplink if locked to downlink */
-            if (ctrl->trsplock)
+            if (ctrl->state.trsplock)
             {
-                track_downlink(ctrl);
+                track_downlink(&ctrl->state);
             }
         }
     }
@@ -2046,37 +2557,33 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
     if (dialchanged)
     {
         /* update uplink */
-        satfrequ = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
-        if (ctrl->tracking)
+        satfrequ = ctrl->state.satfrequ;
+        if (ctrl->state.tracking)
         {
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                    satfrequ + ctrl->du - ctrl->conf2->loup);
+            ctrl->state.rigfrequ = satfrequ + ctrl->pdu - ctrl->conf2->loup;
         }
         else
         {
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                    satfrequ - ctrl->conf2->loup);
+            ctrl->state.rigfrequ = satfrequ - ctrl->conf2->loup;
         }
 
-        tmpfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqUp));
+        tmpfreq = ctrl->state.rigfrequ;
 
         /* if device is engaged, send freq command to radio */
-        if ((ctrl->engaged) && (fabs(ctrl->lasttxf - tmpfreq) >= 1.0))
+        if ((ctrl->engaged) &&
+            rig_tuning_needs_update(tmpfreq, ctrl->lasttxf, ctrl->lasttxreq,
+                                    ctrl->conf2->step))
         {
-            if (set_freq_simplex(ctrl, ctrl->sock2, tmpfreq))
+            ctrl->lasttxreq = tmpfreq;
+            if (set_get_freq(ctrl, ctrl->conn2, FALSE, tmpfreq, &readfreq))
             {
                 /* reset error counter */
                 ctrl->errcnt = 0;
-
-                /* give radio a chance to set frequency */
-                g_usleep(WR_DEL);
-
-                /* The actual frequency migh be different from what we have set */
-                get_freq_simplex(ctrl, ctrl->sock2, &tmpfreq);
-                ctrl->lasttxf = tmpfreq;
+                ctrl->lasttxf = readfreq;
             }
             else
             {
+                ctrl->lasttxreq = 0.0;
                 ctrl->errcnt++;
             }
         }
@@ -2085,38 +2592,34 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
     {
         /* if no dial change on downlink perform forward tracking on downlink
            and execute uplink controller too */
-        satfreqd = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
-        if (ctrl->tracking)
+        satfreqd = ctrl->state.satfreqd;
+        if (ctrl->state.tracking)
         {
             /* downlink */
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                    satfreqd + ctrl->dd - ctrl->conf->lo);
+            ctrl->state.rigfreqd = satfreqd + ctrl->pdd - ctrl->conf->lo;
         }
         else
         {
-            gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                    satfreqd - ctrl->conf->lo);
+            ctrl->state.rigfreqd = satfreqd - ctrl->conf->lo;
         }
 
-        tmpfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqDown));
+        tmpfreq = ctrl->state.rigfreqd;
 
         /* if device is engaged, send freq command to radio */
-        if ((ctrl->engaged) && (fabs(ctrl->lastrxf - tmpfreq) >= 1.0))
+        if ((ctrl->engaged) &&
+            rig_tuning_needs_update(tmpfreq, ctrl->lastrxf, ctrl->lastrxreq,
+                                    ctrl->conf->step))
         {
-            if (set_freq_simplex(ctrl, ctrl->sock, tmpfreq))
+            ctrl->lastrxreq = tmpfreq;
+            if (set_get_freq(ctrl, ctrl->conn, FALSE, tmpfreq, &readfreq))
             {
                 /* reset error counter */
                 ctrl->errcnt = 0;
-
-                /* give radio a chance to set frequency */
-                g_usleep(WR_DEL);
-
-                /* The actual frequency migh be different from what we have set */
-                get_freq_simplex(ctrl, ctrl->sock, &tmpfreq);
-                ctrl->lastrxf = tmpfreq;
+                ctrl->lastrxf = readfreq;
             }
             else
             {
+                ctrl->lastrxreq = 0.0;
                 ctrl->errcnt++;
             }
         }
@@ -2126,7 +2629,7 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
         /* check if uplink dial has changed */
         if ((ctrl->engaged) && (ctrl->lasttxf > 0.0))
         {
-            if (!get_freq_simplex(ctrl, ctrl->sock2, &readfreq))
+            if (!get_ptt_freq(ctrl, ctrl->conn2, NULL, &readfreq))
             {
                 /* error => use a passive value */
                 readfreq = ctrl->lasttxf;
@@ -2137,26 +2640,26 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
             {
                 dialchanged = TRUE;
 
-                gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                        readfreq);
+                ctrl->state.rigfrequ = readfreq;
                 ctrl->lasttxf = readfreq;
+                ctrl->lasttxreq = 0.0;
 
                 /* doppler shift; only if we are tracking */
-                if (ctrl->tracking)
+                if (ctrl->state.tracking)
                 {
-                    satfrequ = readfreq - ctrl->du + ctrl->conf2->loup;
+                    satfrequ = readfreq - ctrl->pdu + ctrl->conf2->loup;
                 }
                 else
                 {
                     satfrequ = readfreq + ctrl->conf2->loup;
                 }
-                gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->SatFreqUp),
-                                        satfrequ);
+                ctrl->state.satfrequ = satfrequ;
+                ctrl->state.dialgen++;
 
                 /* Follow with downlink if transponder is locked */
-                if (ctrl->trsplock)
+                if (ctrl->state.trsplock)
                 {
-                    track_uplink(ctrl);
+                    track_uplink(&ctrl->state);
                 }
             }
         }
@@ -2164,39 +2667,33 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
         if (dialchanged)
         {                       /* on uplink */
             /* update downlink */
-            satfreqd =
-                gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqDown));
-            if (ctrl->tracking)
+            satfreqd = ctrl->state.satfreqd;
+            if (ctrl->state.tracking)
             {
-                gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                        satfreqd + ctrl->dd - ctrl->conf->lo);
+                ctrl->state.rigfreqd = satfreqd + ctrl->pdd - ctrl->conf->lo;
             }
             else
             {
-                gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqDown),
-                                        satfreqd - ctrl->conf->lo);
+                ctrl->state.rigfreqd = satfreqd - ctrl->conf->lo;
             }
 
-            tmpfreq =
-                gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqDown));
+            tmpfreq = ctrl->state.rigfreqd;
 
             /* if device is engaged, send freq command to radio */
-            if ((ctrl->engaged) && (fabs(ctrl->lastrxf - tmpfreq) >= 1.0))
+            if ((ctrl->engaged) &&
+                rig_tuning_needs_update(tmpfreq, ctrl->lastrxf, ctrl->lastrxreq,
+                                        ctrl->conf->step))
             {
-                if (set_freq_simplex(ctrl, ctrl->sock, tmpfreq))
+                ctrl->lastrxreq = tmpfreq;
+                if (set_get_freq(ctrl, ctrl->conn, FALSE, tmpfreq, &readfreq))
                 {
                     /* reset error counter */
                     ctrl->errcnt = 0;
-
-                    /* give radio a chance to set frequency */
-                    g_usleep(WR_DEL);
-
-                    /* The actual frequency migh be different from what we have set */
-                    get_freq_simplex(ctrl, ctrl->sock, &tmpfreq);
-                    ctrl->lastrxf = tmpfreq;
+                    ctrl->lastrxf = readfreq;
                 }
                 else
                 {
+                    ctrl->lastrxreq = 0.0;
                     ctrl->errcnt++;
                 }
             }
@@ -2204,38 +2701,33 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
         else
         {
             /* perform forward tracking on uplink */
-            satfrequ = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->SatFreqUp));
-            if (ctrl->tracking)
+            satfrequ = ctrl->state.satfrequ;
+            if (ctrl->state.tracking)
             {
-                gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                        satfrequ + ctrl->du -
-                                        ctrl->conf2->loup);
+                ctrl->state.rigfrequ = satfrequ + ctrl->pdu - ctrl->conf2->loup;
             }
             else
             {
-                gtk_freq_knob_set_value(GTK_FREQ_KNOB(ctrl->RigFreqUp),
-                                        satfrequ - ctrl->conf2->loup);
+                ctrl->state.rigfrequ = satfrequ - ctrl->conf2->loup;
             }
 
-            tmpfreq = gtk_freq_knob_get_value(GTK_FREQ_KNOB(ctrl->RigFreqUp));
+            tmpfreq = ctrl->state.rigfrequ;
 
             /* if device is engaged, send freq command to radio */
-            if ((ctrl->engaged) && (fabs(ctrl->lasttxf - tmpfreq) >= 1.0))
+            if ((ctrl->engaged) &&
+                rig_tuning_needs_update(tmpfreq, ctrl->lasttxf, ctrl->lasttxreq,
+                                        ctrl->conf2->step))
             {
-                if (set_freq_simplex(ctrl, ctrl->sock2, tmpfreq))
+                ctrl->lasttxreq = tmpfreq;
+                if (set_get_freq(ctrl, ctrl->conn2, FALSE, tmpfreq, &readfreq))
                 {
                     /* reset error counter */
                     ctrl->errcnt = 0;
-
-                    /* give radio a chance to set frequency */
-                    g_usleep(WR_DEL);
-
-                    /* The actual frequency might be different from what we have set. */
-                    get_freq_simplex(ctrl, ctrl->sock2, &tmpfreq);
-                    ctrl->lasttxf = tmpfreq;
+                    ctrl->lasttxf = readfreq;
                 }
                 else
                 {
+                    ctrl->lasttxreq = 0.0;
                     ctrl->errcnt++;
                 }
             }
@@ -2243,55 +2735,106 @@ static void exec_dual_rig_cycle(GtkRigCtrl * ctrl)
     }                           /* else dialchange on downlink */
 }
 
-static gboolean get_ptt(GtkRigCtrl * ctrl, gint sock)
+/*
+ * Read PTT status and frequency of the current VFO in one round trip.
+ *
+ * @param ctrl Pointer to the GtkRigCtrl handle.
+ * @param conn The connection to rigctld.
+ * @param ptt Location for the PTT status or NULL if not needed.
+ * @param freq Location for the frequency or NULL if not needed.
+ * @return FALSE if a connection error occurred or the frequency could not be
+ *         read, TRUE otherwise.
+ *
+ * Values read from the primary radio are cached until reset_cycle_state() is
+ * called, so they are only queried once per cycle. If the PTT status can not
+ * be read, it is reported as FALSE.
+ */
+static gboolean get_ptt_freq(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gboolean * ptt,
+                             gdouble * freq)
 {
-    gchar          *buff, **vbuff;
-    gchar           buffback[128];
+    rig_batch_t     batch;
+    gint            pttidx = -1;
+    gint            freqidx = -1;
+    gboolean        cache = (conn == ctrl->conn);
     gboolean        retcode;
-    guint64         pttstat = 0;
 
-    if (ctrl->conf->ptt == PTT_TYPE_CAT)
+    if (ptt != NULL && cache && ctrl->cycleptt >= 0)
     {
-        /* send command get_ptt (t) */
-        buff = g_strdup_printf("t\x0a");
+        *ptt = ctrl->cycleptt;
+        ptt = NULL;
     }
-    else
+    if (freq != NULL && cache && ctrl->cyclefreq > 0.0)
     {
-        /* send command \get_dcd */
-        buff = g_strdup_printf("%c\x0a", 0x8b);
+        *freq = ctrl->cyclefreq;
+        freq = NULL;
     }
+    if (ptt == NULL && freq == NULL)
+        return TRUE;
 
-    retcode = send_rigctld_command(ctrl, sock, buff, buffback, 128);
-    if (retcode)
+    rig_batch_init(&batch);
+    if (ptt != NULL)
     {
-        vbuff = g_strsplit(buffback, "\n", 3);
-        if (vbuff[0])
-            pttstat = g_ascii_strtoull(vbuff[0], NULL, 0);      //FIXME base = 0 ok?
-        g_strfreev(vbuff);
+        if (ctrl->conf->ptt == PTT_TYPE_CAT)
+            pttidx = rig_batch_add(&batch, "t");        /* get_ptt */
+        else
+            pttidx = rig_batch_add(&batch, "%c", 0x8b); /* \get_dcd */
     }
+    if (freq != NULL)
+        freqidx = rig_batch_add(&batch, "f");
 
-    g_free(buff);
+    retcode = rig_batch_exec(ctrl, conn, &batch);
+
+    if (ptt != NULL)
+    {
+        *ptt = FALSE;
+        if (retcode && rig_batch_ok(&batch, pttidx, __func__) &&
+            batch.value[pttidx] != NULL)
+        {
+            *ptt = (g_ascii_strtoull(batch.value[pttidx], NULL, 10) == 1);
+            if (cache)
+                ctrl->cycleptt = *ptt;
+        }
+    }
+
+    if (freq != NULL)
+    {
+        retcode = retcode &&
+            rig_batch_get_freq(&batch, freqidx, __func__, freq);
+        if (retcode && cache)
+            ctrl->cyclefreq = *freq;
+    }
+
+    rig_batch_free(&batch);
+
+    return retcode;
+}
+
+static gboolean get_ptt(GtkRigCtrl * ctrl, hamlib_conn_t * conn)
+{
+    gboolean        ptt = FALSE;
+
+    get_ptt_freq(ctrl, conn, &ptt, NULL);
 
-    return (pttstat == 1) ? TRUE : FALSE;
+    return ptt;
 }
 
-static gboolean set_ptt(GtkRigCtrl * ctrl, gint sock, gboolean ptt)
+static gboolean set_ptt(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gboolean ptt)
 {
     gchar          *buff;
-    gchar           buffback[128];
     gboolean        retcode;
 
-    /* send command */
-    if (ptt == TRUE)
-        buff = g_strdup_printf("T 1\x0aq\x0a");
-    else
-        buff = g_strdup_printf("T 0\x0aq\x0a");
+    /* nothing to do if we have just read the same state */
+    if (conn == ctrl->conn && ctrl->cycleptt == ptt)
+        return TRUE;
 
-    retcode = send_rigctld_command(ctrl, sock, buff, buffback, 128);
+    buff = g_strdup_printf("T %d", ptt ? 1 : 0);
+    retcode = send_set_command(ctrl, conn, buff, __func__);
     g_free(buff);
 
-    return (check_set_response(buffback, retcode, __func__));
+    if (conn == ctrl->conn)
+        ctrl->cycleptt = retcode ? ptt : -1;
 
+    return retcode;
 }
 
 /*
@@ -2309,156 +2852,195 @@ static gboolean check_aos_los(GtkRigCtrl * ctrl)
     gboolean        retcode = TRUE;
     gchar           retbuf[10];
 
-    if (ctrl->engaged && ctrl->tracking)
+    if (ctrl->engaged && ctrl->state.tracking)
     {
-        if (ctrl->prev_ele < 0.0 && ctrl->target->el >= 0.0)
+        if (ctrl->prev_ele < 0.0 && ctrl->state.el >= 0.0)
         {
             /* AOS has occurred */
             if (ctrl->conf->signal_aos)
             {
-                retcode &= send_rigctld_command(ctrl, ctrl->sock, "AOS\n",
+                retcode &= send_rigctld_command(ctrl, ctrl->conn, "AOS\n",
                                                 retbuf, 10);
             }
             if (ctrl->conf2 != NULL)
             {
                 if (ctrl->conf2->signal_aos)
                 {
-                    retcode &= send_rigctld_command(ctrl, ctrl->sock2, "AOS\n",
+                    retcode &= send_rigctld_command(ctrl, ctrl->conn2, "AOS\n",
                                                     retbuf, 10);
                 }
             }
         }
-        else if (ctrl->prev_ele >= 0.0 && ctrl->target->el < 0.0)
+        else if (ctrl->prev_ele >= 0.0 && ctrl->state.el < 0.0)
         {
             /* LOS has occurred */
             if (ctrl->conf->signal_los)
             {
-                retcode &= send_rigctld_command(ctrl, ctrl->sock, "LOS\n",
+                retcode &= send_rigctld_command(ctrl, ctrl->conn, "LOS\n",
                                                 retbuf, 10);
             }
             if (ctrl->conf2 != NULL)
             {
                 if (ctrl->conf2->signal_los)
                 {
-                    retcode &= send_rigctld_command(ctrl, ctrl->sock2, "LOS\n",
+                    retcode &= send_rigctld_command(ctrl, ctrl->conn2, "LOS\n",
                                                     retbuf, 10);
                 }
             }
         }
     }
 
-    ctrl->prev_ele = ctrl->target->el;
+    ctrl->prev_ele = ctrl->state.el;
 
     return retcode;
 }
 
 /*
- * Set frequency in simplex mode
+ * Set frequency and read back the frequency the radio has been tuned to.
  *
- * Returns TRUE if the operation was successful, FALSE otherwise
+ * @param ctrl Pointer to the GtkRigCtrl handle.
+ * @param conn The connection to rigctld.
+ * @param toggle Use the split TX VFO (I/i) instead of the current VFO (F/f).
+ * @param freq The frequency to set.
+ * @param readback Location for the frequency read back from the radio.
+ * @return TRUE if the radio acknowledged the new frequency, FALSE otherwise.
+ *
+ * The set and get commands are pipelined in one round trip. The actual
+ * frequency might be different from what we have set because the tuning step
+ * is larger than what we work with (e.g. FT-817 has a smallest tuning step
+ * of 10 Hz). If the read back fails, *readback is set to freq.
  */
-static gboolean set_freq_simplex(GtkRigCtrl * ctrl, gint sock, gdouble freq)
+static gboolean set_get_freq(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gboolean toggle,
+                             gdouble freq, gdouble * readback)
 {
-    gchar          *buff;
-    gchar           buffback[128];
+    rig_batch_t     batch;
+    gint            setidx, getidx;
     gboolean        retcode;
 
-    buff = g_strdup_printf("F %10.0f\x0a", freq);
-    retcode = send_rigctld_command(ctrl, sock, buff, buffback, 128);
-    g_free(buff);
+    rig_batch_init(&batch);
+    setidx = rig_batch_add(&batch, toggle ? "I %10.0f" : "F %10.0f", freq);
+    getidx = rig_batch_add(&batch, toggle ? "i" : "f");
 
-    return (check_set_response(buffback, retcode, __func__));
-}
+    retcode = rig_batch_exec(ctrl, conn, &batch) &&
+        rig_batch_ok(&batch, setidx, __func__);
 
+    if (!retcode || !rig_batch_get_freq(&batch, getidx, __func__, readback))
+        *readback = freq;
+
+    rig_batch_free(&batch);
+
+    if (!toggle && conn == ctrl->conn)
+        ctrl->cyclefreq = retcode ? *readback : 0.0;
+
+    return retcode;
+}
 
 /*
- * Set frequency in toggle mode
+ * Read the frequency, set a new one and read it back in one round trip.
  *
- * Returns TRUE if the operation was successful, FALSE otherwise
+ * @param ctrl Pointer to the GtkRigCtrl handle.
+ * @param conn The connection to rigctld.
+ * @param before Location for the frequency before the set or NULL if not
+ *               needed.
+ * @param beforeok Location for whether the frequency before the set has been
+ *                 read.
+ * @param freq The frequency to set.
+ * @param readback Location for the frequency read back from the radio.
+ * @return TRUE if the radio acknowledged the new frequency, FALSE otherwise.
+ *
+ * Like set_get_freq() with a get command in front, on the current VFO. A
+ * frequency read earlier in the cycle is used instead of reading it again.
  */
-static gboolean set_freq_toggle(GtkRigCtrl * ctrl, gint sock, gdouble freq)
+static gboolean get_set_get_freq(GtkRigCtrl * ctrl, hamlib_conn_t * conn,
+                                 gdouble * before, gboolean * beforeok,
+                                 gdouble freq, gdouble * readback)
 {
-    gchar          *buff;
-    gchar           buffback[128];
+    rig_batch_t     batch;
+    gint            getidx = -1;
+    gint            setidx, backidx;
     gboolean        retcode;
 
-    /* send command */
-    buff = g_strdup_printf("I %10.0f\x0a", freq);
-    retcode = send_rigctld_command(ctrl, sock, buff, buffback, 128);
-    g_free(buff);
+    *beforeok = FALSE;
+    if (before != NULL && conn == ctrl->conn && ctrl->cyclefreq > 0.0)
+    {
+        *before = ctrl->cyclefreq;
+        *beforeok = TRUE;
+        before = NULL;
+    }
+
+    rig_batch_init(&batch);
+    if (before != NULL)
+        getidx = rig_batch_add(&batch, "f");
+    setidx = rig_batch_add(&batch, "F %10.0f", freq);
+    backidx = rig_batch_add(&batch, "f");
+
+    retcode = rig_batch_exec(ctrl, conn, &batch);
 
-    return (check_set_response(buffback, retcode, __func__));
+    if (before != NULL)
+        *beforeok = retcode &&
+            rig_batch_get_freq(&batch, getidx, __func__, before);
 
+    retcode = retcode && rig_batch_ok(&batch, setidx, __func__);
+    if (!retcode || !rig_batch_get_freq(&batch, backidx, __func__, readback))
+        *readback = freq;
+
+    rig_batch_free(&batch);
+
+    if (conn == ctrl->conn)
+        ctrl->cyclefreq = retcode ? *readback : 0.0;
+
+    return retcode;
 }
 
 /*
- * Turn on the radios toggle mode
+ * Set frequency in toggle mode
  *
- * Returns TRUE if the operation was successful
+ * Returns TRUE if the operation was successful, FALSE otherwise
  */
-static gboolean set_toggle(GtkRigCtrl * ctrl, gint sock)
+static gboolean set_freq_toggle(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gdouble freq)
 {
     gchar          *buff;
-    gchar           buffback[128];
     gboolean        retcode;
 
-    buff = g_strdup_printf("S 1 %d\x0a", ctrl->conf->vfoDown);
-    retcode = send_rigctld_command(ctrl, sock, buff, buffback, 128);
+    buff = g_strdup_printf("I %10.0f", freq);
+    retcode = send_set_command(ctrl, conn, buff, __func__);
     g_free(buff);
 
-    return (check_set_response(buffback, retcode, __func__));
+    return retcode;
 }
 
 /*
- * Turn off the radios toggle mode
+ * Turn on the radios toggle mode
  *
  * Returns TRUE if the operation was successful
  */
-static gboolean unset_toggle(GtkRigCtrl * ctrl, gint sock)
+static gboolean set_toggle(GtkRigCtrl * ctrl, hamlib_conn_t * conn)
 {
     gchar          *buff;
-    gchar           buffback[128];
     gboolean        retcode;
 
-    /* send command */
-    buff = g_strdup_printf("S 0 %d\x0a", ctrl->conf->vfoDown);
-    retcode = send_rigctld_command(ctrl, sock, buff, buffback, 128);
+    buff = g_strdup_printf("S 1 %d", ctrl->conf->vfoDown);
+    retcode = send_set_command(ctrl, conn, buff, __func__);
     g_free(buff);
 
-    return (check_set_response(buffback, retcode, __func__));
+    return retcode;
 }
 
 /*
- * Get frequency
+ * Turn off the radios toggle mode
  *
- * Returns TRUE if the operation was successful, FALSE otherwise
+ * Returns TRUE if the operation was successful
  */
-static gboolean get_freq_simplex(GtkRigCtrl * ctrl, gint sock, gdouble * freq)
+static gboolean unset_toggle(GtkRigCtrl * ctrl, hamlib_conn_t * conn)
 {
-    gchar          *buff, **vbuff;
-    gchar           buffback[128];
+    gchar          *buff;
     gboolean        retcode;
-    gboolean        retval = TRUE;
-
-    buff = g_strdup_printf("f\x0a");
-    retcode = send_rigctld_command(ctrl, sock, buff, buffback, 128);
-    retcode = check_get_response(buffback, retcode, __func__);
-    if (retcode)
-    {
-        vbuff = g_strsplit(buffback, "\n", 3);
-        if (vbuff[0])
-            *freq = g_ascii_strtod(vbuff[0], NULL);
-        else
-            retval = FALSE;
-        g_strfreev(vbuff);
-    }
-    else
-    {
-        retval = FALSE;
-    }
 
+    buff = g_strdup_printf("S 0 %d", ctrl->conf->vfoDown);
+    retcode = send_set_command(ctrl, conn, buff, __func__);
     g_free(buff);
-    return retval;
+
+    return retcode;
 }
 
 /*
@@ -2466,12 +3048,11 @@ static gboolean get_freq_simplex(GtkRigCtrl * ctrl, gint sock, gdouble * freq)
  *
  * Returns TRUE if the operation was successful, FALSE otherwise
  */
-static gboolean get_freq_toggle(GtkRigCtrl * ctrl, gint sock, gdouble * freq)
+static gboolean get_freq_toggle(GtkRigCtrl * ctrl, hamlib_conn_t * conn, gdouble * freq)
 {
-    gchar          *buff, **vbuff;
-    gchar           buffback[128];
+    rig_batch_t     batch;
+    gint            idx;
     gboolean        retcode;
-    gboolean        retval = TRUE;
 
     if (freq == NULL)
     {
@@ -2480,27 +3061,13 @@ static gboolean get_freq_toggle(GtkRigCtrl * ctrl, gint sock, gdouble * freq)
         return FALSE;
     }
 
-    /* send command */
-    buff = g_strdup_printf("i\x0a");
-    retcode = send_rigctld_command(ctrl, sock, buff, buffback, 128);
-    retcode = check_get_response(buffback, retcode, __func__);
-    if (retcode)
-    {
-        vbuff = g_strsplit(buffback, "\n", 3);
-        if (vbuff[0])
-            *freq = g_ascii_strtod(vbuff[0], NULL);
-        else
-            retval = FALSE;
-
-        g_strfreev(vbuff);
-    }
-    else
-    {
-        retval = FALSE;
-    }
+    rig_batch_init(&batch);
+    idx = rig_batch_add(&batch, "i");
+    retcode = rig_batch_exec(ctrl, conn, &batch) &&
+        rig_batch_get_freq(&batch, idx, __func__, freq);
+    rig_batch_free(&batch);
 
-    g_free(buff);
-    return retval;
+    return retcode;
 }
 
 /*
@@ -2551,7 +3118,9 @@ static void manage_ptt_event(GtkRigCtrl * ctrl)
         }
         else
         {
-            ptt = get_ptt(ctrl, ctrl->sock);
+            merge_ui_state(ctrl);
+            reset_cycle_state(ctrl);
+            ptt = get_ptt(ctrl, ctrl->conn);
 
             if (ptt == FALSE)
             {
@@ -2561,7 +3130,7 @@ static void manage_ptt_event(GtkRigCtrl * ctrl)
                             __func__);
 
                 exec_toggle_tx_cycle(ctrl);
-                set_ptt(ctrl, ctrl->sock, TRUE);
+                set_ptt(ctrl, ctrl->conn, TRUE);
             }
             else
             {
@@ -2569,8 +3138,10 @@ static void manage_ptt_event(GtkRigCtrl * ctrl)
                 sat_log_log(SAT_LOG_LEVEL_DEBUG,
                             _("%s: PTT is ON = Set PTT=OFF"), __func__);
 
-                set_ptt(ctrl, ctrl->sock, FALSE);
+                set_ptt(ctrl, ctrl->conn, FALSE);
             }
+
+            publish_ctrl_state(ctrl);
         }
 
         g_mutex_unlock(&(ctrl->busy));
@@ -2626,76 +3197,6 @@ static gboolean key_press_cb(GtkWidget * widget, GdkEventKey * pKey,
     return event_managed;
 }
 
-static gboolean open_rigctld_socket(radio_conf_t * conf, gint * sock)
-{
-    struct sockaddr_in ServAddr;
-    struct hostent *h;
-    gint            status;
-
-    *sock = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (*sock < 0)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: Failed to create socket"), __func__);
-        *sock = 0;
-        return FALSE;
-    }
-    else
-    {
-        sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                    _("%s: Network socket created successfully"), __func__);
-    }
-
-    memset(&ServAddr, 0, sizeof(ServAddr));     /* Zero out structure */
-    ServAddr.sin_family = AF_INET;      /* Internet address family */
-    h = gethostbyname(conf->host);
-    memcpy((char *)&ServAddr.sin_addr.s_addr, h->h_addr_list[0], h->h_length);
-    ServAddr.sin_port = htons(conf->port);      /* Server port */
-
-    /* establish connection */
-    status = connect(*sock, (struct sockaddr *)&ServAddr, sizeof(ServAddr));
-    if (status < 0)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: Failed to connect to %s:%d"),
-                    __func__, conf->host, conf->port);
-        *sock = 0;
-        return FALSE;
-    }
-    else
-    {
-        sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                    _("%s: Connection opened to %s:%d"),
-                    __func__, conf->host, conf->port);
-    }
-
-    return TRUE;
-}
-
-static gboolean close_rigctld_socket(gint * sock)
-{
-    gint            written;
-
-    written = send(*sock, "q\x0a", 2, 0);
-    if (written != 2)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s:%s: Sent 2 bytes but sent %d."),
-                    __FILE__, __func__, written);
-    }
-#ifndef WIN32
-    shutdown(*sock, SHUT_RDWR);
-    close(*sock);
-#else
-    shutdown(*sock, SD_BOTH);
-    closesocket(*sock);
-#endif
-
-    *sock = 0;
-
-    return TRUE;
-}
-
 static void rigctrl_close(GtkRigCtrl * data)
 {
     GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
@@ -2704,36 +3205,33 @@ static void rigctrl_close(GtkRigCtrl * data)
     ctrl->lasttxptt = TRUE;
     ctrl->lasttxf = 0.0;
     ctrl->lastrxf = 0.0;
-
-    remove_timer(ctrl);
+    ctrl->lasttxreq = 0.0;
+    ctrl->lastrxreq = 0.0;
 
     if ((ctrl->conf->type == RIG_TYPE_TOGGLE_AUTO) ||
         (ctrl->conf->type == RIG_TYPE_TOGGLE_MAN))
     {
-        unset_toggle(ctrl, ctrl->sock);
+        unset_toggle(ctrl, ctrl->conn);
     }
 
-    if (ctrl->conf2 != NULL)
-    {
-        close_rigctld_socket(&(ctrl->sock2));
-    }
-    close_rigctld_socket(&(ctrl->sock));
+    hamlib_conn_close(ctrl->conn2);
+    hamlib_conn_close(ctrl->conn);
+    ctrl->conn2 = NULL;
+    ctrl->conn = NULL;
 }
 
 static void rigctrl_open(GtkRigCtrl * data)
 {
     GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
 
-    ctrl->wrops = 0;
-
-    start_timer(ctrl);
-
-    open_rigctld_socket(ctrl->conf, &(ctrl->sock));
+    ctrl->conn = hamlib_conn_open(ctrl->conf->host, ctrl->conf->port);
+    reset_cycle_state(ctrl);
+    predict_doppler(ctrl);
 
     /* set initial frequency */
     if (ctrl->conf2 != NULL)
     {
-        open_rigctld_socket(ctrl->conf2, &(ctrl->sock2));
+        ctrl->conn2 = hamlib_conn_open(ctrl->conf2->host, ctrl->conf2->port);
         /* set initial dual mode */
         exec_dual_rig_cycle(ctrl);
     }
@@ -2762,7 +3260,7 @@ static void rigctrl_open(GtkRigCtrl * data)
 
         case RIG_TYPE_TOGGLE_AUTO:
         case RIG_TYPE_TOGGLE_MAN:
-            set_toggle(ctrl, ctrl->sock);
+            set_toggle(ctrl, ctrl->conn);
             ctrl->last_toggle_tx = -1;
             exec_toggle_cycle(ctrl);
             break;
@@ -2776,140 +3274,89 @@ static void rigctrl_open(GtkRigCtrl * data)
     }
 }
 
-/* Communication thread for hamlib rigctld */
-gpointer rigctl_run(gpointer data)
+/*
+ * Controller cycle for hamlib rigctld, executed by the station controller.
+ * Returns the delay until the next cycle or -1 once disengaged.
+ */
+static gint64 rig_ctrl_cycle(gpointer data)
 {
     GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
-    GtkRigCtrl     *t_ctrl = GTK_RIG_CTRL(data);
 
-    while (1)
+    if (!ctrl->engaged)
     {
-        t_ctrl = GTK_RIG_CTRL(g_async_queue_pop(ctrl->rigctlq));
-        ctrl = t_ctrl;
-        while (g_main_context_iteration(NULL, FALSE));
-
-        if (t_ctrl == NULL)
-        {
-            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _("%s:%s: ERROR: NO VALID ctrl-struct"), __FILE__,
-                        __func__);
-            continue;
-        }
-
-        if (t_ctrl->engaged)
-        {
-            if (!t_ctrl->sock)
-                rigctrl_open(t_ctrl);
-
-            if (!t_ctrl->timerid)
-                start_timer(t_ctrl);
-        }
-        else
-        {
-            g_mutex_lock(&t_ctrl->widgetsync);
+        if (ctrl->conn != NULL)
+            rigctrl_close(ctrl);
 
-            if (t_ctrl->sock > 0)
-                rigctrl_close(t_ctrl);
+        return -1;
+    }
 
-            if (t_ctrl->timerid)
-                remove_timer(t_ctrl);
+    g_mutex_lock(&ctrl->busy);
 
-            g_cond_signal(&t_ctrl->widgetready);
-            g_mutex_unlock(&t_ctrl->widgetsync);
-            break;
-        }
+    merge_ui_state(ctrl);
+    if (ctrl->conn == NULL)
+        rigctrl_open(ctrl);
 
-        check_aos_los(t_ctrl);
+    check_aos_los(ctrl);
+    reset_cycle_state(ctrl);
+    predict_doppler(ctrl);
 
-        if (t_ctrl->conf2 != NULL)
-        {
-            exec_dual_rig_cycle(t_ctrl);
-        }
-        else
+    if (ctrl->conf2 != NULL)
+    {
+        exec_dual_rig_cycle(ctrl);
+    }
+    else
+    {
+        /* Execute controller cycle depending on primary radio type */
+        switch (ctrl->conf->type)
         {
-            /* Execute controller cycle depending on primary radio type */
-            switch (t_ctrl->conf->type)
-            {
 
-            case RIG_TYPE_RX:
-                exec_rx_cycle(t_ctrl);
-                break;
-
-            case RIG_TYPE_TX:
-                exec_tx_cycle(t_ctrl);
-                break;
+        case RIG_TYPE_RX:
+            exec_rx_cycle(ctrl);
+            break;
 
-            case RIG_TYPE_TRX:
-                exec_trx_cycle(t_ctrl);
-                break;
+        case RIG_TYPE_TX:
+            exec_tx_cycle(ctrl);
+            break;
 
-            case RIG_TYPE_DUPLEX:
-                exec_duplex_cycle(t_ctrl);
-                break;
+        case RIG_TYPE_TRX:
+            exec_trx_cycle(ctrl);
+            break;
 
-            case RIG_TYPE_TOGGLE_AUTO:
-            case RIG_TYPE_TOGGLE_MAN:
-                exec_toggle_cycle(t_ctrl);
-                break;
+        case RIG_TYPE_DUPLEX:
+            exec_duplex_cycle(ctrl);
+            break;
 
-            default:
-                /* invalid mode */
-                sat_log_log(SAT_LOG_LEVEL_ERROR,
-                            _("%s:%s: Invalid radio type %d. Setting type to "
-                              "RIG_TYPE_RX"), __FILE__, __func__,
-                            t_ctrl->conf->type);
-                t_ctrl->conf->type = RIG_TYPE_RX;
-            }
-        }
+        case RIG_TYPE_TOGGLE_AUTO:
+        case RIG_TYPE_TOGGLE_MAN:
+            exec_toggle_cycle(ctrl);
+            break;
 
-        /* perform error count checking */
-        if (t_ctrl->errcnt >= MAX_ERROR_COUNT)
-        {
-            /* disengage device */
-            gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(t_ctrl->LockBut),
-                                         FALSE);
-            t_ctrl->engaged = FALSE;
-            t_ctrl->errcnt = 0;
+        default:
+            /* invalid mode */
             sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _
-                        ("%s:%s: MAX_ERROR_COUNT (%d) reached. Disengaging device!"),
-                        __FILE__, __func__, MAX_ERROR_COUNT);
-
-            //g_print ("ERROR. WROPS = %d\n", ctrl->wrops);
+                        _("%s:%s: Invalid radio type %d. Setting type to "
+                          "RIG_TYPE_RX"), __FILE__, __func__,
+                        ctrl->conf->type);
+            ctrl->conf->type = RIG_TYPE_RX;
         }
-
-        //g_print ("       WROPS = %d\n", ctrl->wrops);
     }
 
-    if (t_ctrl->sock > 0)
-        rigctrl_close(t_ctrl);
-
-    if (t_ctrl->timerid)
-        remove_timer(t_ctrl);
-
-    return NULL;
-}
-
-void start_timer(GtkRigCtrl * data)
-{
-    GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
-
-    /*  start timeout timer here ("Cycle")! */
-    if (ctrl->timerid > 0)
-        g_source_remove(ctrl->timerid);
-
-    ctrl->timerid =
-        gdk_threads_add_timeout(ctrl->delay, rig_ctrl_timeout_cb, ctrl);
-}
+    /* perform error count checking */
+    if (ctrl->errcnt >= MAX_ERROR_COUNT)
+    {
+        /* disengage device; the UI follows via publish_ctrl_state() */
+        ctrl->engaged = FALSE;
+        ctrl->errcnt = 0;
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _
+                    ("%s:%s: MAX_ERROR_COUNT (%d) reached. Disengaging device!"),
+                    __FILE__, __func__, MAX_ERROR_COUNT);
+    }
 
-void remove_timer(GtkRigCtrl * data)
-{
-    GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
+    publish_ctrl_state(ctrl);
+    g_mutex_unlock(&ctrl->busy);
 
-    /* stop timer */
-    if (ctrl->timerid > 0)
-        g_source_remove(ctrl->timerid);
-    ctrl->timerid = 0;
+    return next_cycle_delay(ctrl);
 }
 
 void setconfig(gpointer data)
@@ -2917,9 +3364,9 @@ void setconfig(gpointer data)
     /* something has changed... */
     GtkRigCtrl     *ctrl = GTK_RIG_CTRL(data);
 
-    if (ctrl != NULL)
+    if (ctrl != NULL && ctrl->chain != NULL)
     {
-        g_async_queue_push(ctrl->rigctlq, ctrl);
+        station_chain_wake(ctrl->chain);
     }
 }
 
@@ -2947,8 +3394,10 @@ GtkWidget      *gtk_rig_ctrl_new(GtkSatModule * module)
     if (rigctrl->target != NULL)
     {
         /* get next pass for target satellite */
-        GTK_RIG_CTRL(widget)->pass = get_next_pass(rigctrl->target,
-                                                   rigctrl->qth, 3.0);
+        GTK_RIG_CTRL(widget)->pass = station_get_pass(rigctrl->target,
+                                                      rigctrl->qth,
+                                                      get_current_daynum(),
+                                                      3.0);
     }
 
     /* create contents */
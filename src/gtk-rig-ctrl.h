@@ -6,9 +6,11 @@
 #include <gtk/gtk.h>
 
 #include "gtk-sat-module.h"
+#include "hamlib-client.h"
 #include "predict-tools.h"
 #include "radio-conf.h"
 #include "sgpsdp/sgp4sdp4.h"
+#include "station-ctrl.h"
 #include "trsp-conf.h"
 
 
@@ -24,6 +26,35 @@
 #define IS_GTK_RIG_CTRL(obj)       G_TYPE_CHECK_INSTANCE_TYPE (obj, gtk_rig_ctrl_get_type ())
 
 typedef struct _gtk_rig_ctrl GtkRigCtrl;
+
+/**
+ * Controller state shared between the UI and the control thread.
+ *
+ * The control thread never touches the widgets. The UI publishes a snapshot
+ * of the knobs and settings whenever they change, and the control thread
+ * publishes the frequencies it computed or read back from the radio after
+ * each cycle. The snapshots are handed over through lock-free mailboxes.
+ */
+typedef struct {
+    gdouble         satfreqd;   /*!< Downlink frequency at the satellite */
+    gdouble         satfrequ;   /*!< Uplink frequency at the satellite */
+    gdouble         rigfreqd;   /*!< Downlink frequency at the radio */
+    gdouble         rigfrequ;   /*!< Uplink frequency at the radio */
+    gdouble         du, dd;     /*!< Up/down Doppler shift */
+    gdouble         durate, ddrate;     /*!< Rate of change of du and dd in Hz/s */
+    gint64          dtime;      /*!< Monotonic time of du and dd in usec */
+    gdouble         trate;      /*!< Rate of module time relative to real time */
+    gdouble         el;         /*!< Elevation of the target */
+    gint            catnum;     /*!< Catalogue number of the target */
+    gboolean        tracking;   /*!< Doppler tracking is enabled */
+    gboolean        trsplock;   /*!< Uplink and downlink are locked */
+    gboolean        engaged;    /*!< Radio is engaged; only set by the control thread */
+    gdouble         downlow, downhigh;  /*!< Downlink passband; 0 if unknown */
+    gdouble         uplow, uphigh;      /*!< Uplink passband; 0 if unknown */
+    gboolean        invert;     /*!< Transponder is inverting */
+    guint           resync;     /*!< Changed by the UI to force a resend of the frequencies */
+    guint           dialgen;    /*!< Changed by the control thread on dial feedback */
+} rig_ctrl_state_t;
 typedef struct _GtkRigCtrlClass GtkRigCtrlClass;
 
 struct _gtk_rig_ctrl {
@@ -63,8 +94,7 @@ struct _gtk_rig_ctrl {
 
     double          prev_ele;   /*!< Previous elevation (used for AOS/LOS signalling) */
 
-    guint           delay;      /*!< Timeout delay. */
-    guint           timerid;    /*!< Timer ID */
+    guint           delay;      /*!< Longest delay between cycles in msec. */
 
     gboolean        tracking;   /*!< Flag set when we are tracking a target. */
     GMutex          busy;       /*!< Flag set when control algorithm is busy. */
@@ -76,26 +106,32 @@ struct _gtk_rig_ctrl {
 
     gdouble         lastrxf;    /*!< Last frequency sent to receiver. */
     gdouble         lasttxf;    /*!< Last frequency sent to tranmitter. */
+    gdouble         lastrxreq;  /*!< Last frequency acknowledged by receiver. */
+    gdouble         lasttxreq;  /*!< Last frequency acknowledged by transmitter. */
+    gint            cycleptt;   /*!< PTT read in this cycle; -1 if not read yet. */
+    gdouble         cyclefreq;  /*!< Frequency read in this cycle; 0.0 if not read yet. */
     gdouble         du, dd;     /*!< Last computed up/down Doppler shift; computed in update() */
+    gdouble         durate, ddrate;     /*!< Rate of change of du and dd in Hz/s; computed in update() */
+    gdouble         pdu, pdd;   /*!< Up/down Doppler shift predicted for the current cycle; control thread only */
+    gdouble         tupd;       /*!< Module time of the last update() */
+    gint64          dtime;      /*!< Monotonic time of the last update() in usec */
+    gdouble         trate;      /*!< Rate of module time relative to real time */
+    gdouble         latency;    /*!< Smoothed rigctld round trip time in usec; control thread only */
 
     gint64          last_toggle_tx;     /*!< Last time when exec_toggle_tx_cycle() was executed (seconds)
                                            -1 indicates that an update should be performed ASAP */
 
-    gint            sock, sock2;        /*!< Sockets for controlling the radio(s). */
-
-    /* debug related */
-    guint           wrops;
-    guint           rdops;
-
-    /* DL4PD */
-    /* threads related stuff */
-    /* add mutexes etc, to make threads reentrant! */
-    GMutex          writelock;  /*!< Mutex for blocking write operation */
-    GMutex          rig_ctrl_updatelock;        /*!< Mutex wile updating widgets etc */
-    GMutex          widgetsync; /*!< Mutex used while leaving (sync stuff) */
-    GCond           widgetready;        /*!< Condition when work is done (sync stuff) */
-    GAsyncQueue    *rigctlq;    /*!< Message queue to indicate something has changed */
-    GThread        *rigctl_thread;      /*!< Pointer to current rigctl-thread */
+    hamlib_conn_t  *conn, *conn2;       /*!< Connections to rigctld for the radio(s). */
+
+    GMutex          rig_ctrl_updatelock;        /*!< Mutex while updating widgets etc */
+    station_chain_t *chain;     /*!< Chain in the station controller */
+
+    rig_ctrl_state_t state;     /*!< State used by the control thread; protected by busy */
+    rig_ctrl_state_t *uistate;  /*!< Latest state published by the UI; atomic */
+    rig_ctrl_state_t *ctrlstate;        /*!< Latest state published by the control thread; atomic */
+    gint            idlepending;        /*!< UI update from ctrlstate is pending; atomic */
+    guint           resync;     /*!< UI copy of state.resync */
+    guint           dialgen;    /*!< Last state.dialgen seen by the UI */
 };
 
 struct _GtkRigCtrlClass {
@@ -106,5 +142,6 @@ GType           gtk_rig_ctrl_get_type(void);
 GtkWidget      *gtk_rig_ctrl_new(GtkSatModule * module);
 void            gtk_rig_ctrl_update(GtkRigCtrl * ctrl, gdouble t);
 void            gtk_rig_ctrl_select_sat(GtkRigCtrl * ctrl, gint catnum);
+void            gtk_rig_ctrl_refresh_sat(GtkRigCtrl * ctrl, gint catnum);
 
 #endif /* __GTK_RIG_CTRL_H__ */
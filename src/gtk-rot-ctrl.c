@@ -32,257 +32,180 @@
 #include <build-config.h>
 #endif
 
-/* NETWORK */
-#ifndef WIN32
-#include <arpa/inet.h>          /* htons() */
-#include <netdb.h>              /* gethostbyname() */
-#include <netinet/in.h>         /* struct sockaddr_in */
-#include <sys/socket.h>         /* socket(), connect(), send() */
-#else
-#include <winsock2.h>
-#endif
-
-#include <errno.h>
 #include <glib.h>
 #include <glib/gi18n.h>
 #include <gtk/gtk.h>
 #include <math.h>
-#include <string.h>             /* strerror() */
+#include <string.h>
 
 #include "compat.h"
 #include "gpredict-utils.h"
 #include "gtk-polar-plot.h"
 #include "gtk-rot-knob.h"
 #include "gtk-rot-ctrl.h"
+#include "hamlib-client.h"
 #include "predict-tools.h"
+#include "rot-planner.h"
 #include "sat-log.h"
+#include "station-ctrl.h"
+#include "time-tools.h"
 
 
 #define FMTSTR "%7.2f\302\260"
 #define MAX_ERROR_COUNT 5
+#define ROT_CMD_TIMEOUT 3000    /* deadline of a rotctld command in msec */
+#define ROT_MAX_LAG     10.0    /* longest lead for rotator lag in sec */
+#define ROT_PLAN_STEP   1.0     /* sampling interval of the planned pass in sec */
+#define ROT_PLAN_MAX_SAMPLES 86400      /* longest pass sampled; one day */
+
+/* rotctld polling intervals in usec */
+#define ROT_MIN_DELAY     100000        /* fastest polling near TCA */
+#define ROT_SETTLE_DELAY  250000        /* while the rotator is moving */
+#define ROT_MANUAL_DELAY  700000        /* not following a plan */
+#define ROT_PASS_DELAY   5000000        /* slowest polling during a pass */
+#define ROT_IDLE_DELAY  30000000        /* between passes */
 
 static GtkVBoxClass *parent_class = NULL;
 
 
-/* Open the rotcld socket. Returns file descriptor or -1 if an error occurs */
-static gint rotctld_socket_open(const gchar * host, gint port)
+/*
+ * Send a command to rotctld and read the response.
+ *
+ * Inputs are the connection, a string command, the number of lines in the
+ * response, and a buffer and length for returning the output from rotctld.
+ */
+static gboolean rotctld_socket_rw(hamlib_conn_t * conn, gchar * buff,
+                                  gint lines, gchar * buffout, gint sizeout)
 {
-    struct sockaddr_in ServAddr;
-    struct hostent *h;
-    gint            sock;
-    gint            status;
-
-    sock = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (sock == -1)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("Failed to create rotctl socket: %s"), strerror(errno));
-        return sock;
-    }
-
-    sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                _("%s: Network socket created successfully"), __func__);
-
-    memset(&ServAddr, 0, sizeof(ServAddr));
-    ServAddr.sin_family = AF_INET;      /* Internet address family */
-    h = gethostbyname(host);
-    if (h == NULL)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("Name resolution of rotctld server %s failed."), host);
-#ifdef WIN32
-        closesocket(sock);
-#else
-        close(sock);
-#endif
-        return -1;
-    }
-
-    memcpy((char *)&ServAddr.sin_addr.s_addr, h->h_addr_list[0], h->h_length);
-    ServAddr.sin_port = htons(port);    /* Server port */
+    GString        *reply;
+    gboolean        retcode;
 
-    /* establish connection */
-    status = connect(sock, (struct sockaddr *)&ServAddr, sizeof(ServAddr));
-    if (status == -1)
-    {
+    reply = g_string_sized_new(64);
+    retcode = hamlib_conn_exec(conn, buff, HAMLIB_REPLY_PLAIN, lines,
+                               ROT_CMD_TIMEOUT, reply);
+    if (retcode)
+        g_strlcpy(buffout, reply->str, sizeout);
+    else
         sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("Connection to rotctld server at %s:%d failed: %s"),
-                    host, port, strerror(errno));
+                    _("%s: rotctld command failed"), __func__);
+    g_string_free(reply, TRUE);
 
-#ifdef WIN32
-        closesocket(sock);
-#else
-        close(sock);
-#endif
-        return -1;
-    }
-
-    sat_log_log(SAT_LOG_LEVEL_DEBUG, _("%s: Connection opened to %s:%d"),
-                __func__, host, port);
+    return retcode;
+}
 
-    return sock;
+static gint sat_name_compare(sat_t * a, sat_t * b)
+{
+    return (gpredict_strcmp(a->nickname, b->nickname));
 }
 
-/* Close a rotcld socket. First send a q command to cleanly shut down rotctld */
-static void rotctld_socket_close(gint * sock)
+static gint rot_name_compare(const gchar * a, const gchar * b)
 {
-    gint            written;
+    return (gpredict_strcmp(a, b));
+}
 
-    /*shutdown the rotctld connect */
-    written = send(*sock, "q\x0a", 2, 0);
-    if (written != 2)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s:%s: Sent 2 bytes but sent %d."),
-                    __FILE__, __func__, written);
-    }
+/* Angle between two directions in degrees */
+static gdouble angle_between(gdouble az1, gdouble el1, gdouble az2,
+                             gdouble el2)
+{
+    gdouble         c;
 
-#ifndef WIN32
-    shutdown(*sock, SHUT_RDWR);
-    close(*sock);
-#else
-    shutdown(*sock, SD_BOTH);
-    closesocket(*sock);
-#endif
+    c = sin(el1 * de2ra) * sin(el2 * de2ra) +
+        cos(el1 * de2ra) * cos(el2 * de2ra) * cos((az1 - az2) * de2ra);
 
-    *sock = -1;
+    return acos(CLAMP(c, -1.0, 1.0)) / de2ra;
 }
 
 /*
- * Send a command to rotctld and read the response.
+ * Log the command rate and pointing error since the last report.
  *
- * Inputs are the socket, a string command, and a buffer and length for
- * returning the output from rotctld.
+ * Called when the plan changes, i.e. usually at the end of a pass, and
+ * when the rotator is disengaged.
  */
-static gboolean rotctld_socket_rw(gint sock, gchar * buff, gchar * buffout,
-                                  gint sizeout)
+static void report_stats(GtkRotCtrl * ctrl)
 {
-    gint            written;
-    gint            size;
-
-    size = strlen(buff);
-
-    /* send command */
-    written = send(sock, buff, size, 0);
-    if (written != size)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: SIZE ERROR %d / %d"), __func__, written, size);
-    }
-    if (written == -1)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: rotctld Socket Down"), __func__);
-        return FALSE;
-    }
-
-    /* try to read answer */
-    size = recv(sock, buffout, sizeout, 0);
+    guint           commands, polls;
+    gdouble         minutes;
+    gint64          now = g_get_monotonic_time();
+
+    g_mutex_lock(&ctrl->client.mutex);
+    commands = ctrl->client.commands;
+    polls = ctrl->client.polls;
+    ctrl->client.commands = 0;
+    ctrl->client.polls = 0;
+    g_mutex_unlock(&ctrl->client.mutex);
+
+    minutes = MAX((now - ctrl->stats_start) / 60.0e6, 1.0 / 60.0);
+    if (ctrl->conf != NULL && (commands > 0 || ctrl->err_num > 0))
+        sat_log_log(SAT_LOG_LEVEL_INFO,
+                    _("%s: %s: %u commands (%.1f/min), %u polls (%.1f/min), "
+                      "pointing error %.2f/%.2f\302\260 (rms/max)"),
+                    __func__, ctrl->conf->name, commands, commands / minutes,
+                    polls, polls / minutes,
+                    ctrl->err_num ? sqrt(ctrl->err_sum / ctrl->err_num) : 0.0,
+                    ctrl->err_max);
+
+    ctrl->stats_start = now;
+    ctrl->err_sum = 0.0;
+    ctrl->err_max = 0.0;
+    ctrl->err_num = 0;
+}
 
-    if (size == -1)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: rotctld Socket Down"), __func__);
-        return FALSE;
-    }
+/* Sample the track of the target from AOS to LOS of the current pass */
+static GArray  *sample_pass(GtkRotCtrl * ctrl)
+{
+    GArray         *track;
+    rot_setpoint_t  point;
+    sat_t           sat_working;
+    guint           i, n;
 
-    buffout[size] = '\0';
-    if (size == 0)
+    n = (guint) MIN((ctrl->pass->los - ctrl->pass->aos) * secday /
+                    ROT_PLAN_STEP, ROT_PLAN_MAX_SAMPLES) + 1;
+    track = g_array_sized_new(FALSE, FALSE, sizeof(rot_setpoint_t), n + 1);
+    memcpy(&sat_working, ctrl->target, sizeof(sat_t));
+    for (i = 0; i <= n; i++)
     {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s:%s: Got 0 bytes from rotctld"), __FILE__, __func__);
+        point.t = MIN(ctrl->pass->aos + i * ROT_PLAN_STEP / secday,
+                      ctrl->pass->los);
+        predict_calc(&sat_working, ctrl->qth, point.t);
+        point.az = sat_working.az;
+        point.el = sat_working.el;
+        g_array_append_val(track, point);
     }
 
-    return TRUE;
-}
-
-static gint sat_name_compare(sat_t * a, sat_t * b)
-{
-    return (gpredict_strcmp(a->nickname, b->nickname));
+    return track;
 }
 
-static gint rot_name_compare(const gchar * a, const gchar * b)
+/*
+ * Plan the rotator trajectory for the current pass.
+ *
+ * Called whenever the pass, the target, the rotator or the threshold
+ * changes. The client picks up the new plan on its next cycle.
+ */
+static void update_plan(GtkRotCtrl * ctrl)
 {
-    return (gpredict_strcmp(a, b));
-}
+    rot_plan_t     *plan = NULL, *old;
+    GArray         *track;
 
-static gboolean is_flipped_pass(pass_t * pass, rot_az_type_t type,
-                                gdouble azstoppos)
-{
-    gdouble         max_az = 0, min_az = 0, offset = 0;
-    gdouble         caz, last_az = pass->aos_az;
-    guint           num, i;
-    pass_detail_t  *detail;
-    gboolean        retval = FALSE;
-
-    num = g_slist_length(pass->details);
-    if (type == ROT_AZ_TYPE_360)
-    {
-        min_az = 0;
-        max_az = 360;
-    }
-    else if (type == ROT_AZ_TYPE_180)
-    {
-        min_az = -180;
-        max_az = 180;
-    }
+    report_stats(ctrl);
 
-    /* Offset by (azstoppos-min_az) to handle
-     * rotators with non-default positions.
-     * Note that the default positions of the rotator stops
-     * (eg. -180 for ROT_AZ_TYPE_180, and 0 for 
-     * ROT_AZ_TYPE_360) will create an offset of 0, which
-     * seems like a pretty sane default. */
-    offset = azstoppos - min_az;
-    min_az += offset;
-    max_az += offset;
-
-    /* Assume that min_az and max_az are atleat 360 degrees apart
-       get the azimuth that is in a settable range */
-    while (last_az > max_az)
-        last_az -= 360;
-
-    while (last_az < min_az)
-        last_az += 360;
-
-    if (num > 1)
+    if (ctrl->conf && ctrl->pass && ctrl->target &&
+        ctrl->pass->los > ctrl->pass->aos)
     {
-        for (i = 1; i < num - 1; i++)
-        {
-            detail = PASS_DETAIL(g_slist_nth_data(pass->details, i));
-            caz = detail->az;
-
-            while (caz > max_az)
-                caz -= 360;
-
-            while (caz < min_az)
-                caz += 360;
-
-
-            if (fabs(caz - last_az) > 180)
-                retval = TRUE;
-
-            last_az = caz;
-        }
+        track = sample_pass(ctrl);
+        plan = rot_plan_new(track, ctrl->conf, ctrl->threshold);
+        g_array_free(track, TRUE);
     }
-    caz = pass->los_az;
-    while (caz > max_az)
-        caz -= 360;
 
-    while (caz < min_az)
-        caz += 360;
+    g_mutex_lock(&ctrl->client.mutex);
+    old = ctrl->plan;
+    ctrl->plan = plan;
+    ctrl->client.planidx = G_MAXUINT;
+    g_mutex_unlock(&ctrl->client.mutex);
 
-    if (fabs(caz - last_az) > 180)
-        retval = TRUE;
+    rot_plan_free(old);
 
-    return retval;
-}
-
-static inline void set_flipped_pass(GtkRotCtrl * ctrl)
-{
-    if (ctrl->conf && ctrl->pass)
-        ctrl->flipped = is_flipped_pass(ctrl->pass, ctrl->conf->aztype,
-                                        ctrl->conf->azstoppos);
+    if (ctrl->client.chain != NULL)
+        station_chain_wake(ctrl->client.chain);
 }
 
 /**
@@ -309,7 +232,7 @@ static gboolean get_pos(GtkRotCtrl * ctrl, gdouble * az, gdouble * el)
 
     /* send command */
     buff = g_strdup_printf("p\x0a");
-    retcode = rotctld_socket_rw(ctrl->client.socket, buff, buffback, 128);
+    retcode = rotctld_socket_rw(ctrl->client.conn, buff, 2, buffback, 128);
 
     /* try to parse answer */
     if (retcode)
@@ -369,7 +292,7 @@ static gboolean set_pos(GtkRotCtrl * ctrl, gdouble az, gdouble el)
 
     /* send command */
     buff = g_strdup_printf("P %.2f %.2f\x0a", az, el);
-    retcode = rotctld_socket_rw(ctrl->client.socket, buff, buffback, 128);
+    retcode = rotctld_socket_rw(ctrl->client.conn, buff, 1, buffback, 128);
     g_free(buff);
 
     if (retcode == TRUE)
@@ -390,72 +313,144 @@ static gboolean set_pos(GtkRotCtrl * ctrl, gdouble az, gdouble el)
     return (retcode);
 }
 
-/* Rotctl client thread */
-static gpointer rotctld_client_thread(gpointer data)
+/*
+ * Rotctl client cycle, executed by the station controller.
+ * Returns the delay until the next cycle or -1 once stopped.
+ *
+ * While tracking a planned pass, the set-point for the current time plus
+ * the measured rotator lag is sent whenever it changes. The lag is the
+ * time the rotator needed to come within half the threshold of the last
+ * target, smoothed over several targets.
+ *
+ * The next cycle is due when the plan reaches its next set-point, so the
+ * polling rate follows the angular velocity of the track: slow at low
+ * elevations and fast near TCA of an overhead pass. It is faster while
+ * the rotator is moving, to measure its lag, and near idle between
+ * passes. The duty cycle of rotctld is kept below 50%.
+ */
+static gint64 rot_ctrl_cycle(gpointer data)
 {
-    gdouble         elapsed_time;
-    gdouble         azi = 0.0;
-    gdouble         ele = 0.0;
-    gboolean        new_trg = FALSE;
-    gboolean        io_error = FALSE;
     GtkRotCtrl     *ctrl = GTK_ROT_CTRL(data);
+    gint64          start = g_get_monotonic_time();
+    rot_setpoint_t *point;
+    gdouble         azi, ele, setazi = 0.0, setele = 0.0, t;
+    gboolean        new_trg, settled;
+    gboolean        io_error = FALSE;
+    guint           idx, sent = 0;
+    gint64          delay = ROT_MANUAL_DELAY, exec;
 
-    g_print("Starting rotctld client thread\n");
-
-    ctrl->client.socket = rotctld_socket_open(ctrl->conf->host,
-                                              ctrl->conf->port);
-    if (ctrl->client.socket == -1)
-        return GINT_TO_POINTER(-1);
-
-    ctrl->client.timer = g_timer_new();
+    g_mutex_lock(&ctrl->client.mutex);
+    if (!ctrl->client.running)
+    {
+        g_mutex_unlock(&ctrl->client.mutex);
+        hamlib_conn_close(ctrl->client.conn);
+        ctrl->client.conn = NULL;
 
-    ctrl->client.new_trg = FALSE;
-    ctrl->client.running = TRUE;
+        return -1;
+    }
 
-    while (ctrl->client.running)
+    if (ctrl->tracking && ctrl->plan != NULL)
     {
-        g_timer_start(ctrl->client.timer);
-        io_error = FALSE;
+        t = ctrl->client.tref + ((start - ctrl->client.mref) / 1.0e6 +
+                                 ctrl->client.lag) / secday;
+        idx = rot_plan_find(ctrl->plan, t);
 
-        g_mutex_lock(&ctrl->client.mutex);
-        if (ctrl->client.new_trg)
+        /* time until the next set-point is due */
+        if (idx + 1 < ctrl->plan->points->len)
         {
-            azi = ctrl->client.azi_out;
-            ele = ctrl->client.ele_out;
-            new_trg = ctrl->client.new_trg;
+            point = &g_array_index(ctrl->plan->points, rot_setpoint_t,
+                                   idx + 1);
+            delay = (gint64) MIN((point->t - t) * secday * 1.0e6,
+                                 idx > 0 ? ROT_PASS_DELAY : ROT_IDLE_DELAY);
         }
-        g_mutex_unlock(&ctrl->client.mutex);
+        else
+            delay = ROT_IDLE_DELAY;
 
-        if (new_trg && !ctrl->monitor)
+        if (idx != ctrl->client.planidx)
         {
-            if (set_pos(ctrl, azi, ele))
-                new_trg = FALSE;
-            else
-                io_error = TRUE;
+            point = &g_array_index(ctrl->plan->points, rot_setpoint_t, idx);
+            ctrl->client.azi_out = point->az;
+            ctrl->client.ele_out = point->el;
+            ctrl->client.new_trg = TRUE;
+            ctrl->client.planidx = idx;
         }
+    }
 
-        /* wait 100 ms before sending new command */
-        g_usleep(100000);
-        if (!get_pos(ctrl, &azi, &ele))
-            io_error = TRUE;
+    new_trg = ctrl->client.new_trg;
+    settled = ctrl->client.settled;
+    setazi = ctrl->client.azi_out;
+    setele = ctrl->client.ele_out;
+    azi = ctrl->client.azi_in;
+    ele = ctrl->client.ele_in;
+    g_mutex_unlock(&ctrl->client.mutex);
 
-        g_mutex_lock(&ctrl->client.mutex);
-        ctrl->client.azi_in = azi;
-        ctrl->client.ele_in = ele;
-        ctrl->client.new_trg = new_trg;
-        ctrl->client.io_error = io_error;
-        g_mutex_unlock(&ctrl->client.mutex);
+    if (new_trg && !ctrl->monitor)
+    {
+        sent = 1;
+        if (set_pos(ctrl, setazi, setele))
+        {
+            new_trg = FALSE;
+            settled = FALSE;
+            ctrl->client.sent = start;
+        }
+        else
+            io_error = TRUE;
+    }
 
-        /* ensure rotctl duty cycle stays below 50%, but wait at least 700 ms (TBC) */
-        elapsed_time = MAX(g_timer_elapsed(ctrl->client.timer, NULL), 0.7);
-        g_usleep(elapsed_time * 1e6);
+    if (!get_pos(ctrl, &azi, &ele))
+        io_error = TRUE;
+    else if (!settled && fabs(azi - setazi) <= ctrl->threshold / 2.0 &&
+             fabs(ele - setele) <= ctrl->threshold / 2.0)
+    {
+        settled = TRUE;
+        t = (g_get_monotonic_time() - ctrl->client.sent) / 1.0e6;
+        ctrl->client.lag = 0.75 * ctrl->client.lag +
+            0.25 * MIN(t, ROT_MAX_LAG);
     }
 
-    g_print("Stopping rotctld client thread\n");
-    g_timer_destroy(ctrl->client.timer);
-    rotctld_socket_close(&ctrl->client.socket);
+    g_mutex_lock(&ctrl->client.mutex);
+    ctrl->client.azi_in = azi;
+    ctrl->client.ele_in = ele;
+    ctrl->client.new_trg = new_trg;
+    ctrl->client.settled = settled;
+    ctrl->client.io_error = io_error;
+    ctrl->client.commands += sent;
+    ctrl->client.polls++;
+    g_mutex_unlock(&ctrl->client.mutex);
+
+    if (!settled)
+        delay = MIN(delay, ROT_SETTLE_DELAY);
+
+    /* ensure rotctl duty cycle stays below 50% */
+    exec = g_get_monotonic_time() - start;
+
+    return MAX(delay, MAX(exec, ROT_MIN_DELAY));
+}
+
+/* Start the rotctld client in the station controller */
+static void start_client(GtkRotCtrl * ctrl)
+{
+    ctrl->client.conn = hamlib_conn_open(ctrl->conf->host, ctrl->conf->port);
+    ctrl->client.new_trg = FALSE;
+    ctrl->client.settled = TRUE;
+    ctrl->client.planidx = G_MAXUINT;
+    ctrl->client.running = TRUE;
+    ctrl->client.chain = station_chain_start(ctrl->conf->name,
+                                             rot_ctrl_cycle, ctrl);
+}
+
+/* Stop the rotctld client and wait until it has closed the connection */
+static void stop_client(GtkRotCtrl * ctrl)
+{
+    g_mutex_lock(&ctrl->client.mutex);
+    ctrl->client.running = FALSE;
+    g_mutex_unlock(&ctrl->client.mutex);
 
-    return GINT_TO_POINTER(0);
+    station_chain_wake(ctrl->client.chain);
+    station_chain_join(ctrl->client.chain);
+    ctrl->client.chain = NULL;
+
+    report_stats(ctrl);
 }
 
 /**
@@ -516,6 +511,12 @@ void gtk_rot_ctrl_update(GtkRotCtrl * ctrl, gdouble t)
 
     ctrl->t = t;
 
+    /* time base used by the client to follow the plan */
+    g_mutex_lock(&ctrl->client.mutex);
+    ctrl->client.tref = t;
+    ctrl->client.mref = g_get_monotonic_time();
+    g_mutex_unlock(&ctrl->client.mutex);
+
     if (ctrl->target)
     {
         /* update target displays */
@@ -534,10 +535,10 @@ void gtk_rot_ctrl_update(GtkRotCtrl * ctrl, gdouble t)
             {
                 free_pass(ctrl->pass);
                 ctrl->pass = NULL;
-                ctrl->pass = get_pass(ctrl->target, ctrl->qth, t, 3.0);
+                ctrl->pass = station_get_pass(ctrl->target, ctrl->qth, t, 3.0);
                 if (ctrl->pass)
                 {
-                    set_flipped_pass(ctrl);
+                    update_plan(ctrl);
                     /* update polar plot */
                     gtk_polar_plot_set_pass(GTK_POLAR_PLOT(ctrl->plot),
                                             ctrl->pass);
@@ -557,8 +558,9 @@ void gtk_rot_ctrl_update(GtkRotCtrl * ctrl, gdouble t)
                     /* inside an unexpected/unpredicted pass */
                     free_pass(ctrl->pass);
                     ctrl->pass = NULL;
-                    ctrl->pass = get_current_pass(ctrl->target, ctrl->qth, t);
-                    set_flipped_pass(ctrl);
+                    ctrl->pass = station_get_current_pass(ctrl->target,
+                                                          ctrl->qth, t);
+                    update_plan(ctrl);
                     gtk_polar_plot_set_pass(GTK_POLAR_PLOT(ctrl->plot),
                                             ctrl->pass);
                 }
@@ -574,8 +576,9 @@ void gtk_rot_ctrl_update(GtkRotCtrl * ctrl, gdouble t)
                     /* if the next pass is not the one for the target */
                     free_pass(ctrl->pass);
                     ctrl->pass = NULL;
-                    ctrl->pass = get_pass(ctrl->target, ctrl->qth, t, 3.0);
-                    set_flipped_pass(ctrl);
+                    ctrl->pass = station_get_pass(ctrl->target, ctrl->qth, t,
+                                                  3.0);
+                    update_plan(ctrl);
                     /* update polar plot */
                     gtk_polar_plot_set_pass(GTK_POLAR_PLOT(ctrl->plot),
                                             ctrl->pass);
@@ -589,8 +592,9 @@ void gtk_rot_ctrl_update(GtkRotCtrl * ctrl, gdouble t)
                 {
                     free_pass(ctrl->pass);
                     ctrl->pass = NULL;
-                    ctrl->pass = get_pass(ctrl->target, ctrl->qth, t, 3.0);
-                    set_flipped_pass(ctrl);
+                    ctrl->pass = station_get_pass(ctrl->target, ctrl->qth, t,
+                                                  3.0);
+                    update_plan(ctrl);
                     /* update polar plot */
                     gtk_polar_plot_set_pass(GTK_POLAR_PLOT(ctrl->plot),
                                             ctrl->pass);
@@ -601,11 +605,12 @@ void gtk_rot_ctrl_update(GtkRotCtrl * ctrl, gdouble t)
         {
             /* we don't have any current pass; store the current one */
             if (ctrl->target->el > 0.0)
-                ctrl->pass = get_current_pass(ctrl->target, ctrl->qth, t);
+                ctrl->pass = station_get_current_pass(ctrl->target,
+                                                      ctrl->qth, t);
             else
-                ctrl->pass = get_pass(ctrl->target, ctrl->qth, t, 3.0);
+                ctrl->pass = station_get_pass(ctrl->target, ctrl->qth, t, 3.0);
 
-            set_flipped_pass(ctrl);
+            update_plan(ctrl);
             /* update polar plot */
             gtk_polar_plot_set_pass(GTK_POLAR_PLOT(ctrl->plot), ctrl->pass);
         }
@@ -632,6 +637,32 @@ void gtk_rot_ctrl_select_sat(GtkRotCtrl * ctrl, gint catnum)
     }
 }
 
+/*
+ * Recalculate the pass and the rotator plan after the elements of a
+ * satellite changed.
+ *
+ * Called by the parent GtkSatModule when new elements have been swapped
+ * into a satellite. Nothing happens unless it is the current target.
+ */
+void gtk_rot_ctrl_refresh_sat(GtkRotCtrl * ctrl, gint catnum)
+{
+    if (ctrl->target == NULL || ctrl->target->tle.catnr != catnum)
+        return;
+
+    if (ctrl->pass != NULL)
+        free_pass(ctrl->pass);
+
+    if (ctrl->target->el > 0.0)
+        ctrl->pass = station_get_current_pass(ctrl->target, ctrl->qth,
+                                              ctrl->t);
+    else
+        ctrl->pass = station_get_pass(ctrl->target, ctrl->qth, ctrl->t, 3.0);
+
+    update_plan(ctrl);
+    if (ctrl->plot != NULL)
+        gtk_polar_plot_set_pass(GTK_POLAR_PLOT(ctrl->plot), ctrl->pass);
+}
+
 /*
  * Create azimuth control widgets.
  * 
@@ -719,6 +750,13 @@ static void track_toggle_cb(GtkToggleButton * button, gpointer data)
                              !(ctrl->tracking || locked));
     gtk_widget_set_sensitive(ctrl->AzSet, !ctrl->tracking);
     gtk_widget_set_sensitive(ctrl->ElSet, !ctrl->tracking);
+
+    /* let the client pick up the new mode */
+    g_mutex_lock(&ctrl->client.mutex);
+    ctrl->client.planidx = G_MAXUINT;
+    g_mutex_unlock(&ctrl->client.mutex);
+    if (ctrl->client.chain != NULL)
+        station_chain_wake(ctrl->client.chain);
 }
 
 /**
@@ -734,63 +772,31 @@ static gboolean rot_ctrl_timeout_cb(gpointer data)
     gdouble         setaz = 0.0, setel = 45.0;
     gchar          *text;
     gboolean        error = FALSE;
-    sat_t           sat_working, *sat;
-
-    /* parameters for path predictions */
-    gdouble         time_delta;
-    gdouble         step_size;
 
 #define SAFE_AZI(azi) CLAMP(azi, ctrl->conf->minaz, ctrl->conf->maxaz)
 #define SAFE_ELE(ele) CLAMP(ele, ctrl->conf->minel, ctrl->conf->maxel)
 
-    /* If we are tracking and the target satellite is within
-       range, set the rotor position controller knob values to
-       the target values. If the target satellite is out of range
-       set the rotor controller to 0 deg El and to the Az where the
-       target sat is expected to come up or where it last went down
+    /* If we are tracking, follow the trajectory planned for the pass.
+       Before AOS and after LOS the plan keeps the rotator at the first
+       and last set-point. Without a plan, point directly at the target
+       while it is within range.
      */
     if (ctrl->tracking && ctrl->target)
     {
-        if (ctrl->target->el < 0.0)
+        if (ctrl->plan != NULL)
         {
-            if (ctrl->pass != NULL)
-            {
-                if (ctrl->t < ctrl->pass->aos)
-                {
-                    setaz = SAFE_AZI(ctrl->pass->aos_az);
-                    setel = SAFE_ELE(0.0);
-                }
-                else if (ctrl->t > ctrl->pass->los)
-                {
-                    setaz = SAFE_AZI(ctrl->pass->los_az);
-                    setel = SAFE_ELE(0.0);
-                }
-            }
+            rot_plan_get(ctrl->plan, ctrl->t, &setaz, &setel);
         }
-        else
+        else if (ctrl->target->el >= 0.0)
         {
-            setaz = SAFE_AZI(ctrl->target->az);
+            setaz = ctrl->target->az;
             setel = SAFE_ELE(ctrl->target->el);
-        }
-        /* if this is a flipped pass and the rotor supports it */
-        if ((ctrl->flipped) && (ctrl->conf->maxel >= 180.0))
-        {
-            setel = 180 - setel;
-            if (setaz > 180)
-                setaz -= 180;
-            else
-                setaz += 180;
 
-            while (setaz > ctrl->conf->maxaz)
-                setaz -= 360;
-
-            while (setaz < ctrl->conf->minaz)
-                setaz += 360;
+            if ((ctrl->conf->aztype == ROT_AZ_TYPE_180) && (setaz > 180.0))
+                setaz = setaz - 360.0;
+            setaz = SAFE_AZI(setaz);
         }
 
-        if ((ctrl->conf->aztype == ROT_AZ_TYPE_180) && (setaz > 180.0))
-            setaz = setaz - 360.0;
-
         if (!(ctrl->engaged))
         {
             gtk_rot_knob_set_value(GTK_ROT_KNOB(ctrl->AzSet), setaz);
@@ -848,91 +854,36 @@ static gboolean rot_ctrl_timeout_cb(gpointer data)
                     gtk_polar_plot_set_rotor_pos(GTK_POLAR_PLOT(ctrl->plot),
                                                  rotaz, rotel);
                 }
-            }
-        }
 
-        /* if tolerance exceeded */
-        if ((fabs(setaz - rotaz) > ctrl->threshold) ||
-            (fabs(setel - rotel) > ctrl->threshold))
-        {
-            if (ctrl->tracking)
-            {
-                /* if we are in a pass try to lead the satellite 
-                   some so we are not always chasing it */
-                if (ctrl->target && ctrl->target->el > 0.0)
+                /* pointing error while tracking the satellite */
+                if (ctrl->tracking && ctrl->target &&
+                    ctrl->target->el >= 0.0)
                 {
-                    /* starting the rotator moving while we do some computation
-                     * can lead to errors later */
-                    /* compute a time in the future when the position is 
-                       within tolerance so and send the rotor there.
-                     */
-
-                    /* use a working copy so data does not get corrupted */
-                    sat = memcpy(&(sat_working), ctrl->target, sizeof(sat_t));
-
-                    /* compute az/el in the future that is past end of pass 
-                       or exceeds tolerance
-                     */
-                    if (ctrl->pass)
-                    {
-                        /* the next point is before the end of the pass 
-                           if there is one. */
-                        time_delta = ctrl->pass->los - ctrl->t;
-                    }
+                    gdouble         err;
+
+                    if (rotel > 90.0)
+                        err = angle_between(ctrl->target->az, ctrl->target->el,
+                                            rotaz + 180.0, 180.0 - rotel);
                     else
-                    {
-                        /* otherwise look 20 minutes into the future */
-                        time_delta = 1.0 / 72.0;
-                    }
-
-                    /* have a minimum time delta */
-                    step_size = time_delta / 2.0;
-                    if (step_size < ctrl->delay / 1000.0 / (secday))
-                    {
-                        step_size = ctrl->delay / 1000.0 / (secday);
-                    }
-                    /* find a time when satellite is above horizon and at the 
-                       edge of tolerance. the final step size needs to be smaller
-                       than delay. otherwise the az/el could be further away than
-                       tolerance the next time we enter the loop and we end up 
-                       pushing ourselves away from the satellite.
-                     */
-                    while (step_size > (ctrl->delay / 1000.0 / 4.0 / (secday)))
-                    {
-                        predict_calc(sat, ctrl->qth, ctrl->t + time_delta);
-                        /*update sat->az and sat->el to account for flips and az range */
-                        if ((ctrl->flipped) && (ctrl->conf->maxel >= 180.0))
-                        {
-                            sat->el = 180.0 - sat->el;
-                            if (sat->az > 180.0)
-                                sat->az -= 180.0;
-                            else
-                                sat->az += 180.0;
-                        }
-                        if ((ctrl->conf->aztype == ROT_AZ_TYPE_180) &&
-                            (sat->az > 180.0))
-                        {
-                            sat->az = sat->az - 360.0;
-                        }
-                        if ((sat->el < 0.0) || (sat->el > 180.0) ||
-                            (fabs(setaz - sat->az) > (ctrl->threshold)) ||
-                            (fabs(setel - sat->el) > (ctrl->threshold)))
-                        {
-                            time_delta -= step_size;
-                        }
-                        else
-                        {
-                            time_delta += step_size;
-                        }
-                        step_size /= 2.0;
-                    }
-                    setel = SAFE_ELE(sat->el);
-                    setaz = SAFE_AZI(sat->az);
+                        err = angle_between(ctrl->target->az, ctrl->target->el,
+                                            rotaz, rotel);
+                    ctrl->err_sum += err * err;
+                    ctrl->err_max = MAX(ctrl->err_max, err);
+                    ctrl->err_num++;
                 }
             }
+        }
 
+        if (ctrl->tracking && ctrl->plan != NULL)
+        {
+            /* the client streams the planned set-points by itself */
+            gtk_rot_knob_set_value(GTK_ROT_KNOB(ctrl->AzSet), setaz);
+            gtk_rot_knob_set_value(GTK_ROT_KNOB(ctrl->ElSet), setel);
+        }
+        else if ((fabs(setaz - rotaz) > ctrl->threshold) ||
+                 (fabs(setel - rotel) > ctrl->threshold))
+        {
             /* send controller values to rotator device */
-            /* this is the newly computed value which should be ahead of the current position */
             gtk_rot_knob_set_value(GTK_ROT_KNOB(ctrl->AzSet), setaz);
             gtk_rot_knob_set_value(GTK_ROT_KNOB(ctrl->ElSet), setel);
             if (g_mutex_trylock(&ctrl->client.mutex))
@@ -941,8 +892,10 @@ static gboolean rot_ctrl_timeout_cb(gpointer data)
                 ctrl->client.ele_out = setel;
                 ctrl->client.new_trg = TRUE;
                 g_mutex_unlock(&ctrl->client.mutex);
-            }
 
+                if (ctrl->client.chain != NULL)
+                    station_chain_wake(ctrl->client.chain);
+            }
         }
 
         /* check error status */
@@ -1051,6 +1004,8 @@ static void threshold_changed_cb(GtkSpinButton * spin, gpointer data)
     ctrl->threshold = gtk_spin_button_get_value(spin);
     if (ctrl->conf)
         ctrl->conf->threshold = ctrl->threshold;
+
+    update_plan(ctrl);
 }
 
 /**
@@ -1103,8 +1058,8 @@ static void rot_selected_cb(GtkComboBox * box, gpointer data)
         gtk_rot_knob_set_range(GTK_ROT_KNOB(ctrl->ElSet), ctrl->conf->minel,
                                ctrl->conf->maxel);
 
-        /* Update flipped when changing rotor if there is a plot */
-        set_flipped_pass(ctrl);
+        /* plan the current pass for the new rotator */
+        update_plan(ctrl);
     }
     else
     {
@@ -1159,13 +1114,13 @@ static void rot_locked_cb(GtkToggleButton * button, gpointer data)
         gtk_label_set_text(GTK_LABEL(ctrl->ElRead), "---");
 
         if (!ctrl->client.running)
-            /* client thread is not running; nothing to do */
+            /* client is not running; nothing to do */
             return;
 
         /* stop moving rotor */
         /** FIXME: should use high level func */
         buff = g_strdup_printf("S\x0a");
-        retcode = rotctld_socket_rw(ctrl->client.socket, buff, buffback, 128);
+        retcode = rotctld_socket_rw(ctrl->client.conn, buff, 1, buffback, 128);
         g_free(buff);
         if (retcode == TRUE)
         {
@@ -1181,8 +1136,7 @@ static void rot_locked_cb(GtkToggleButton * button, gpointer data)
             }
         }
 
-        ctrl->client.running = FALSE;
-        g_thread_join(ctrl->client.thread);
+        stop_client(ctrl);
     }
     else
     {
@@ -1196,8 +1150,7 @@ static void rot_locked_cb(GtkToggleButton * button, gpointer data)
             return;
         }
 
-        ctrl->client.thread =
-            g_thread_new("gpredict_rotctl", rotctld_client_thread, ctrl);
+        start_client(ctrl);
 
         gtk_widget_set_sensitive(ctrl->DevSel, FALSE);
         ctrl->engaged = TRUE;
@@ -1228,11 +1181,13 @@ static void sat_selected_cb(GtkComboBox * satsel, gpointer data)
             free_pass(ctrl->pass);
 
         if (ctrl->target->el > 0.0)
-            ctrl->pass = get_current_pass(ctrl->target, ctrl->qth, ctrl->t);
+            ctrl->pass = station_get_current_pass(ctrl->target, ctrl->qth,
+                                                  ctrl->t);
         else
-            ctrl->pass = get_pass(ctrl->target, ctrl->qth, ctrl->t, 3.0);
+            ctrl->pass = station_get_pass(ctrl->target, ctrl->qth, ctrl->t,
+                                          3.0);
 
-        set_flipped_pass(ctrl);
+        update_plan(ctrl);
     }
     else
     {
@@ -1246,6 +1201,7 @@ static void sat_selected_cb(GtkComboBox * satsel, gpointer data)
             free_pass(ctrl->pass);
             ctrl->pass = NULL;
         }
+        update_plan(ctrl);
     }
 
     /* in either case, we set the new pass (even if NULL) on the polar plot */
@@ -1541,6 +1497,7 @@ static void gtk_rot_ctrl_init(GtkRotCtrl * ctrl,
     ctrl->sats = NULL;
     ctrl->target = NULL;
     ctrl->pass = NULL;
+    ctrl->plan = NULL;
     ctrl->qth = NULL;
     ctrl->plot = NULL;
 
@@ -1552,9 +1509,17 @@ static void gtk_rot_ctrl_init(GtkRotCtrl * ctrl,
     ctrl->errcnt = 0;
 
     g_mutex_init(&ctrl->client.mutex);
-    ctrl->client.thread = NULL;
-    ctrl->client.socket = -1;
+    ctrl->client.chain = NULL;
+    ctrl->client.conn = NULL;
     ctrl->client.running = FALSE;
+    ctrl->client.lag = 0.0;
+    ctrl->client.commands = 0;
+    ctrl->client.polls = 0;
+
+    ctrl->stats_start = g_get_monotonic_time();
+    ctrl->err_sum = 0.0;
+    ctrl->err_max = 0.0;
+    ctrl->err_num = 0;
 }
 
 static void gtk_rot_ctrl_destroy(GtkWidget * widget)
@@ -1565,6 +1530,10 @@ static void gtk_rot_ctrl_destroy(GtkWidget * widget)
     if (ctrl->timerid > 0)
         g_source_remove(ctrl->timerid);
 
+    /* stop client */
+    if (ctrl->client.running)
+        stop_client(ctrl);
+
     /* free configuration */
     if (ctrl->conf != NULL)
     {
@@ -1575,12 +1544,8 @@ static void gtk_rot_ctrl_destroy(GtkWidget * widget)
         ctrl->conf = NULL;
     }
 
-    /* stop client thread */
-    if (ctrl->client.running)
-    {
-        ctrl->client.running = FALSE;
-        g_thread_join(ctrl->client.thread);
-    }
+    rot_plan_free(ctrl->plan);
+    ctrl->plan = NULL;
 
     g_mutex_clear(&ctrl->client.mutex);
 
@@ -1652,13 +1617,14 @@ GtkWidget      *gtk_rot_ctrl_new(GtkSatModule * module)
     {
         if (rot_ctrl->target->el > 0.0)
         {
-            rot_ctrl->pass = get_current_pass(rot_ctrl->target,
-                                              rot_ctrl->qth, 0.0);
+            rot_ctrl->pass = station_get_current_pass(rot_ctrl->target,
+                                                      rot_ctrl->qth, 0.0);
         }
         else
         {
-            rot_ctrl->pass = get_next_pass(rot_ctrl->target,
-                                           rot_ctrl->qth, 3.0);
+            rot_ctrl->pass = station_get_pass(rot_ctrl->target,
+                                              rot_ctrl->qth,
+                                              get_current_daynum(), 3.0);
         }
     }
 
@@ -6,9 +6,12 @@
 #include <gtk/gtk.h>
 
 #include "gtk-sat-module.h"
+#include "hamlib-client.h"
 #include "predict-tools.h"
+#include "rot-planner.h"
 #include "rotor-conf.h"
 #include "sgpsdp/sgp4sdp4.h"
+#include "station-ctrl.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -56,7 +59,7 @@ struct _gtk_rot_ctrl {
     sat_t          *target;     /*!< Target satellite */
     pass_t         *pass;       /*!< Next pass of target satellite */
     qth_t          *qth;        /*!< The QTH for this module */
-    gboolean        flipped;    /*!< Whether the current pass loaded is a flip pass or not */
+    rot_plan_t     *plan;       /*!< Trajectory of the pass; changed under client.mutex */
 
     guint           delay;      /*!< Timeout delay. */
     guint           timerid;    /*!< Timer ID */
@@ -68,17 +71,30 @@ struct _gtk_rot_ctrl {
 
     gint            errcnt;     /*!< Error counter. */
 
+    /* tracking statistics since the last report */
+    gint64          stats_start;        /*!< Start of the statistics */
+    gdouble         err_sum;    /*!< Sum of squared pointing errors */
+    gdouble         err_max;    /*!< Largest pointing error */
+    guint           err_num;    /*!< Number of pointing error samples */
+
     /* TCP client to rotctld */
     struct {
-        GThread    *thread;
-        GTimer     *timer;
+        station_chain_t *chain; /* chain in the station controller */
         GMutex      mutex;
-        gint        socket;     /* network socket to rotctld */
+        hamlib_conn_t *conn;    /* connection to rotctld */
         gfloat      azi_in;     /* last AZI angle read from rotctld */
         gfloat      ele_in;     /* last ELE angle read from rotctld */
         gfloat      azi_out;    /* AZI target */
         gfloat      ele_out;    /* ELE target */
         gboolean    new_trg;    /* new target position set */
+        gdouble     tref;       /* module time at mref */
+        gint64      mref;       /* monotonic time of the last update */
+        guint       planidx;    /* plan set-point last sent */
+        gint64      sent;       /* monotonic time the target was sent */
+        gboolean    settled;    /* rotator has reached the target */
+        gdouble     lag;        /* smoothed rotator lag in sec */
+        guint       commands;   /* set-points sent */
+        guint       polls;      /* position reads */
         gboolean    running;
         gboolean    io_error;
     } client;
@@ -92,6 +108,7 @@ GType           gtk_rot_ctrl_get_type(void);
 GtkWidget      *gtk_rot_ctrl_new(GtkSatModule * module);
 void            gtk_rot_ctrl_update(GtkRotCtrl * ctrl, gdouble t);
 void            gtk_rot_ctrl_select_sat(GtkRotCtrl * ctrl, gint catnum);
+void            gtk_rot_ctrl_refresh_sat(GtkRotCtrl * ctrl, gint catnum);
 
 #ifdef __cplusplus
 }
@@ -49,6 +49,24 @@
  *
  */
 gint gtk_sat_data_read_sat(gint catnum, sat_t * sat)
+{
+    return gtk_sat_data_read_sat_qth(catnum, sat, NULL);
+}
+
+/**
+ * Read TLE data for a given satellite and initialise it for a QTH.
+ *
+ * @param catnum The catalog number of the satellite.
+ * @param sat Pointer to a valid sat_t structure.
+ * @param qth Optional QTH info passed to gtk_sat_data_init_sat.
+ * @return See gtk_sat_data_read_sat.
+ *
+ * This is equivalent to gtk_sat_data_read_sat followed by
+ * gtk_sat_data_init_sat but propagates the satellite only once. The function
+ * does not touch any shared state and may be called from worker threads as
+ * long as qth is not modified concurrently.
+ */
+gint gtk_sat_data_read_sat_qth(gint catnum, sat_t * sat, qth_t * qth)
 {
     guint           errorcode = 0;
     GError         *error = NULL;
@@ -173,7 +191,7 @@ gint gtk_sat_data_read_sat(gint catnum, sat_t * sat)
         sat->los = 0.0;
 
         /* calculate satellite data at epoch */
-        gtk_sat_data_init_sat(sat, NULL);
+        gtk_sat_data_init_sat(sat, qth);
     }
 
     g_free(filename);
@@ -0,0 +1,613 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/**
+ * Tree model of the satellite list.
+ *
+ * The model has one row per satellite of the module and computes the value
+ * of a cell when the tree view asks for it, i.e. when the cell is drawn. The
+ * update cycle therefore does not touch the values of the rows; it only
+ * hides decayed satellites, keeps the rows sorted and tells the view about
+ * the rows that moved or changed weight. The view is then redrawn, which
+ * formats the visible cells only.
+ *
+ * The rows are kept and sorted by GtkSatRowModel. The SSP locator is sorted
+ * by a numeric key made of its characters, which orders the locators like
+ * strcmp() does.
+ *
+ * RA/Dec is computed at most once per row and cycle and only for rows that
+ * are drawn, or for all rows in one batch when the list is sorted by it.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib/gi18n.h>
+#include <gtk/gtk.h>
+#include <math.h>
+
+#include "gtk-sat-list.h"
+#include "gtk-sat-list-model.h"
+#include "locator.h"
+#include "orbit-tools.h"
+#include "radec-tools.h"
+#include "sat-cfg.h"
+#include "sat-vis.h"
+#include "sgpsdp/sgp4sdp4.h"
+#include "time-tools.h"
+
+
+/** A row of the satellite list. */
+typedef struct {
+    sat_row_t       base;       /*!< Common row data; must be first. */
+    gdouble         rate;       /*!< Range rate in this cycle. */
+    gdouble         oldrate;    /*!< Range rate in the previous cycle. */
+    gboolean        bold;       /*!< Satellite is above the horizon. */
+    gdouble         ra;         /*!< Right ascension in degrees. */
+    gdouble         dec;        /*!< Declination in degrees. */
+    guint           radec_serial;       /*!< Frame that ra and dec were computed in; 0 if none. */
+} sat_list_row_t;
+
+/** Column types indexed with column symb. refs. */
+static const GType COLUMN_TYPE[SAT_LIST_COL_NUMBER] = {
+    G_TYPE_STRING,              // name
+    G_TYPE_INT,                 // catnum
+    G_TYPE_DOUBLE,              // az
+    G_TYPE_DOUBLE,              // el
+    G_TYPE_STRING,              // direction
+    G_TYPE_DOUBLE,              // RA
+    G_TYPE_DOUBLE,              // Dec
+    G_TYPE_DOUBLE,              // range
+    G_TYPE_DOUBLE,              // range rate
+    G_TYPE_STRING,              // next event
+    G_TYPE_DOUBLE,              // next AOS
+    G_TYPE_DOUBLE,              // next LOS
+    G_TYPE_DOUBLE,              // ssp lat
+    G_TYPE_DOUBLE,              // ssp lon
+    G_TYPE_STRING,              // ssp qra
+    G_TYPE_DOUBLE,              // footprint
+    G_TYPE_DOUBLE,              // alt
+    G_TYPE_DOUBLE,              // vel
+    G_TYPE_DOUBLE,              // doppler
+    G_TYPE_DOUBLE,              // path loss
+    G_TYPE_DOUBLE,              // delay
+    G_TYPE_DOUBLE,              // mean anomaly
+    G_TYPE_DOUBLE,              // phase
+    G_TYPE_LONG,                // orbit
+    G_TYPE_STRING,              // visibility
+    G_TYPE_BOOLEAN,             // decay
+    G_TYPE_INT,                 // Operational Status
+    G_TYPE_INT                  // weight/bold
+};
+
+static void     gtk_sat_list_model_class_init(GtkSatListModelClass * class,
+                                              gpointer class_data);
+static void     gtk_sat_list_model_init(GtkSatListModel * model,
+                                        gpointer g_class);
+static void     get_value(GtkSatRowModel * base_model, sat_row_t * base_row,
+                          gint column, GValue * value);
+static void     prepare_keys(GtkSatRowModel * base_model);
+
+
+GType gtk_sat_list_model_get_type()
+{
+    static GType    gtk_sat_list_model_type = 0;
+
+    if (!gtk_sat_list_model_type)
+    {
+        static const GTypeInfo gtk_sat_list_model_info = {
+            sizeof(GtkSatListModelClass),
+            NULL,               /* base_init */
+            NULL,               /* base_finalize */
+            (GClassInitFunc) gtk_sat_list_model_class_init,
+            NULL,               /* class_finalize */
+            NULL,               /* class_data */
+            sizeof(GtkSatListModel),
+            0,                  /* n_preallocs */
+            (GInstanceInitFunc) gtk_sat_list_model_init,
+            NULL
+        };
+
+        gtk_sat_list_model_type = g_type_register_static(GTK_TYPE_SAT_ROW_MODEL,
+                                                         "GtkSatListModel",
+                                                         &gtk_sat_list_model_info,
+                                                         0);
+    }
+
+    return gtk_sat_list_model_type;
+}
+
+static void gtk_sat_list_model_class_init(GtkSatListModelClass * class,
+                                          gpointer class_data)
+{
+    GtkSatRowModelClass *row_class = (GtkSatRowModelClass *) class;
+
+    (void)class_data;
+
+    row_class->n_columns = SAT_LIST_COL_NUMBER;
+    row_class->column_types = COLUMN_TYPE;
+    row_class->name_column = SAT_LIST_COL_NAME;
+    row_class->get_value = get_value;
+    row_class->prepare_keys = prepare_keys;
+}
+
+static void gtk_sat_list_model_init(GtkSatListModel * model,
+                                    gpointer g_class)
+{
+    (void)g_class;
+
+    model->qth = NULL;
+}
+
+/** Direction of a satellite, i.e. on its way up or down. */
+static const gchar *direction_str(sat_list_row_t * row)
+{
+    sat_t          *sat = row->base.sat;
+
+    if (sat->otype == ORBIT_TYPE_GEO)
+        return "G";
+    else if (decayed(sat))
+        return "D";
+    else if (sat->range_rate > 0.001)
+        return "\342\206\223";  /* going down */
+    else if (sat->range_rate < -0.001)
+        return "\342\206\221";  /* coming up */
+    else if (sat->range_rate < row->oldrate)
+        return "\342\206\272";  /* turning around, starting to approach */
+    else
+        return "\342\206\267";  /* turning around, to recede */
+}
+
+/** Time of the next event, AOS or LOS depending on El. */
+static gdouble next_event(sat_t * sat)
+{
+    return (sat->aos > sat->los) ? sat->los : sat->aos;
+}
+
+static gchar   *next_event_str(sat_t * sat)
+{
+    gchar           buff[TIME_FORMAT_MAX_LENGTH];
+    gchar          *tfstr;
+    gchar          *fmtstr;
+
+    if (next_event(sat) == 0.0)
+        return g_strdup("--- N/A ---");
+
+    tfstr = sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT);
+    fmtstr = g_strconcat(tfstr, (sat->aos > sat->los) ? " (LOS)" : " (AOS)",
+                         NULL);
+    daynum_to_str(buff, TIME_FORMAT_MAX_LENGTH, fmtstr, next_event(sat));
+    g_free(tfstr);
+    g_free(fmtstr);
+
+    return g_strdup(buff);
+}
+
+/* SSP locator; buff must have room for 7 chars */
+static void ssp_str(sat_t * sat, gchar * buff)
+{
+    if (longlat2locator(sat->ssplon, sat->ssplat, buff, 3) == RIG_OK)
+        buff[6] = '\0';
+    else
+        buff[0] = '\0';
+}
+
+/*
+ * Sort key of the SSP locator. The six characters fit in the mantissa of a
+ * double, so the keys compare like the strings.
+ */
+static gdouble ssp_key(sat_t * sat)
+{
+    gchar           buff[7];
+    gdouble         key = 0.0;
+    guint           i;
+
+    ssp_str(sat, buff);
+    if (buff[0] == '\0')
+        return 0.0;
+
+    for (i = 0; i < 6; i++)
+        key = key * 256.0 + (guchar) buff[i];
+
+    return key;
+}
+
+/** Compute RA/Dec of a row unless it is known for this cycle. */
+static void row_radec(GtkSatListModel * model, sat_list_row_t * row)
+{
+    sat_t          *sat = row->base.sat;
+
+    radec_frame_set(&model->frame, model->qth, sat->jul_utc);
+    if (row->radec_serial == model->frame.serial)
+        return;
+
+    radec_from_azel(&model->frame, 1, &sat->az, &sat->el,
+                    &row->ra, &row->dec, NULL);
+    row->radec_serial = model->frame.serial;
+}
+
+static void get_value(GtkSatRowModel * base_model, sat_row_t * base_row,
+                      gint column, GValue * value)
+{
+    GtkSatListModel *model = GTK_SAT_LIST_MODEL(base_model);
+    sat_list_row_t *row = (sat_list_row_t *) base_row;
+    sat_t          *sat = base_row->sat;
+    gchar           buff[7];
+
+    switch (column)
+    {
+    case SAT_LIST_COL_NAME:
+        g_value_set_string(value, sat->nickname);
+        break;
+    case SAT_LIST_COL_CATNUM:
+        g_value_set_int(value, sat->tle.catnr);
+        break;
+    case SAT_LIST_COL_AZ:
+        g_value_set_double(value, sat->az);
+        break;
+    case SAT_LIST_COL_EL:
+        g_value_set_double(value, sat->el);
+        break;
+    case SAT_LIST_COL_DIR:
+        g_value_set_static_string(value, direction_str(row));
+        break;
+    case SAT_LIST_COL_RA:
+        row_radec(model, row);
+        g_value_set_double(value, row->ra);
+        break;
+    case SAT_LIST_COL_DEC:
+        row_radec(model, row);
+        g_value_set_double(value, row->dec);
+        break;
+    case SAT_LIST_COL_RANGE:
+        g_value_set_double(value, sat->range);
+        break;
+    case SAT_LIST_COL_RANGE_RATE:
+        g_value_set_double(value, sat->range_rate);
+        break;
+    case SAT_LIST_COL_NEXT_EVENT:
+        g_value_take_string(value, next_event_str(sat));
+        break;
+    case SAT_LIST_COL_AOS:
+        g_value_set_double(value, sat->aos);
+        break;
+    case SAT_LIST_COL_LOS:
+        g_value_set_double(value, sat->los);
+        break;
+    case SAT_LIST_COL_LAT:
+        g_value_set_double(value, sat->ssplat);
+        break;
+    case SAT_LIST_COL_LON:
+        g_value_set_double(value, sat->ssplon);
+        break;
+    case SAT_LIST_COL_SSP:
+        ssp_str(sat, buff);
+        g_value_set_string(value, buff);
+        break;
+    case SAT_LIST_COL_FOOTPRINT:
+        g_value_set_double(value, sat->footprint);
+        break;
+    case SAT_LIST_COL_ALT:
+        g_value_set_double(value, sat->alt);
+        break;
+    case SAT_LIST_COL_VEL:
+        g_value_set_double(value, sat->velo);
+        break;
+    case SAT_LIST_COL_DOPPLER:
+        /* doppler shift @ 100 MHz */
+        g_value_set_double(value, -100.0e06 * (sat->range_rate / 299792.4580));
+        break;
+    case SAT_LIST_COL_LOSS:
+        /* path loss @ 100 MHz in dB */
+        g_value_set_double(value, 72.4 + 20.0 * log10(sat->range));
+        break;
+    case SAT_LIST_COL_DELAY:
+        /* delay in msec */
+        g_value_set_double(value, sat->range / 299.7924580);
+        break;
+    case SAT_LIST_COL_MA:
+        g_value_set_double(value, sat->ma);
+        break;
+    case SAT_LIST_COL_PHASE:
+        g_value_set_double(value, sat->phase);
+        break;
+    case SAT_LIST_COL_ORBIT:
+        g_value_set_long(value, sat->orbit);
+        break;
+    case SAT_LIST_COL_VISIBILITY:
+        buff[0] = vis_to_chr(get_sat_vis(sat, model->qth, sat->jul_utc));
+        buff[1] = '\0';
+        g_value_set_string(value, buff);
+        break;
+    case SAT_LIST_COL_DECAY:
+        g_value_set_boolean(value, !decayed(sat));
+        break;
+    case SAT_LIST_COL_STAT_OPERATIONAL:
+        g_value_set_int(value, sat->tle.status);
+        break;
+    case SAT_LIST_COL_BOLD:
+        g_value_set_int(value, row->bold ?
+                        PANGO_WEIGHT_BOLD : PANGO_WEIGHT_NORMAL);
+        break;
+    default:
+        break;
+    }
+}
+
+/* Sorting */
+
+/** Sort key of a row for all columns but the name. */
+static gdouble sort_key(GtkSatListModel * model, sat_list_row_t * row)
+{
+    sat_t          *sat = row->base.sat;
+
+    switch (model->parent.sort_column)
+    {
+    case SAT_LIST_COL_AZ:
+        return sat->az;
+    case SAT_LIST_COL_EL:
+    case SAT_LIST_COL_BOLD:
+        return sat->el;
+    case SAT_LIST_COL_DIR:
+    case SAT_LIST_COL_RANGE_RATE:
+    case SAT_LIST_COL_DOPPLER:
+        return (model->parent.sort_column == SAT_LIST_COL_DOPPLER) ?
+            -sat->range_rate : sat->range_rate;
+    case SAT_LIST_COL_RA:
+        return row->ra;
+    case SAT_LIST_COL_DEC:
+        return row->dec;
+    case SAT_LIST_COL_RANGE:
+    case SAT_LIST_COL_LOSS:
+    case SAT_LIST_COL_DELAY:
+        return sat->range;
+    case SAT_LIST_COL_NEXT_EVENT:
+        return next_event(sat);
+    case SAT_LIST_COL_AOS:
+        return sat->aos;
+    case SAT_LIST_COL_LOS:
+        return sat->los;
+    case SAT_LIST_COL_LAT:
+        return sat->ssplat;
+    case SAT_LIST_COL_LON:
+        return sat->ssplon;
+    case SAT_LIST_COL_SSP:
+        return ssp_key(sat);
+    case SAT_LIST_COL_FOOTPRINT:
+        return sat->footprint;
+    case SAT_LIST_COL_ALT:
+        return sat->alt;
+    case SAT_LIST_COL_VEL:
+        return sat->velo;
+    case SAT_LIST_COL_MA:
+        return sat->ma;
+    case SAT_LIST_COL_PHASE:
+        return sat->phase;
+    case SAT_LIST_COL_ORBIT:
+        return sat->orbit;
+    case SAT_LIST_COL_VISIBILITY:
+        return vis_to_chr(get_sat_vis(sat, model->qth, sat->jul_utc));
+    case SAT_LIST_COL_DECAY:
+        return !decayed(sat);
+    case SAT_LIST_COL_STAT_OPERATIONAL:
+        return sat->tle.status;
+    default:
+        return row->base.catnum;
+    }
+}
+
+/**
+ * Compute RA/Dec of all shown rows in one batch.
+ *
+ * The satellites are computed at the same time in a cycle, so they share
+ * the sidereal time; the rare satellite at another time is done on its own.
+ */
+static void batch_radec(GtkSatListModel * model)
+{
+    GPtrArray      *rows = model->parent.rows;
+    sat_list_row_t *row;
+    gdouble        *az, *el, *ra, *dec;
+    guint           i, n = 0;
+
+    if (rows->len == 0)
+        return;
+
+    row = g_ptr_array_index(rows, 0);
+    radec_frame_set(&model->frame, model->qth, row->base.sat->jul_utc);
+
+    az = g_new(gdouble, 4 * rows->len);
+    el = az + rows->len;
+    ra = el + rows->len;
+    dec = ra + rows->len;
+
+    for (i = 0; i < rows->len; i++)
+    {
+        row = g_ptr_array_index(rows, i);
+        if (row->base.sat->jul_utc == model->frame.jul_utc)
+        {
+            az[n] = row->base.sat->az;
+            el[n] = row->base.sat->el;
+            n++;
+        }
+    }
+
+    radec_from_azel(&model->frame, n, az, el, ra, dec, NULL);
+
+    for (i = 0, n = 0; i < rows->len; i++)
+    {
+        row = g_ptr_array_index(rows, i);
+        if (row->base.sat->jul_utc == model->frame.jul_utc)
+        {
+            row->ra = ra[n];
+            row->dec = dec[n];
+            row->radec_serial = model->frame.serial;
+            n++;
+        }
+    }
+
+    for (i = 0; i < rows->len; i++)
+        row_radec(model, g_ptr_array_index(rows, i));
+
+    g_free(az);
+}
+
+/** Compute the sort keys of the shown rows for this cycle. */
+static void prepare_keys(GtkSatRowModel * base_model)
+{
+    GtkSatListModel *model = GTK_SAT_LIST_MODEL(base_model);
+    sat_list_row_t *row;
+    guint           i;
+
+    if (base_model->sort_column == SAT_LIST_COL_RA ||
+        base_model->sort_column == SAT_LIST_COL_DEC)
+        batch_radec(model);
+
+    for (i = 0; i < base_model->rows->len; i++)
+    {
+        row = g_ptr_array_index(base_model->rows, i);
+        row->base.key = sort_key(model, row);
+    }
+}
+
+/* Rows */
+
+/** Bring the per row data of a satellite up to date. */
+static void refresh_row(sat_list_row_t * row)
+{
+    gtk_sat_row_model_refresh_name(&row->base);
+
+    row->oldrate = row->rate;
+    row->rate = row->base.sat->range_rate;
+}
+
+static void add_sat(gpointer key, gpointer value, gpointer data)
+{
+    sat_list_row_t *row;
+
+    (void)key;
+
+    row = g_new0(sat_list_row_t, 1);
+    row->base.sat = SAT(value);
+    row->rate = row->base.sat->range_rate;
+    row->oldrate = row->rate;
+    row->bold = (row->base.sat->el > 0.0);
+    gtk_sat_row_model_add(GTK_SAT_ROW_MODEL(data), &row->base);
+}
+
+/**
+ * Replace the satellites of the model.
+ *
+ * @param model The satellite list model.
+ * @param sats The satellites of the module.
+ *
+ * This must be called when satellites have been added to or removed from
+ * the hash table, since the rows refer to the satellites directly.
+ */
+void gtk_sat_list_model_set_sats(GtkSatListModel * model, GHashTable * sats)
+{
+    g_return_if_fail(IS_GTK_SAT_LIST_MODEL(model));
+
+    gtk_sat_row_model_clear(&model->parent);
+
+    model->parent.sats = sats;
+    g_hash_table_foreach(sats, add_sat, model);
+
+    gtk_sat_row_model_sort(&model->parent, TRUE);
+}
+
+
+/**
+ * Create a new satellite list model.
+ *
+ * @param sats The satellites of the module.
+ * @param qth Pointer to the ground station data.
+ * @return A new GtkTreeModel, not sorted.
+ */
+GtkTreeModel   *gtk_sat_list_model_new(GHashTable * sats, qth_t * qth)
+{
+    GtkSatListModel *model;
+
+    model = GTK_SAT_LIST_MODEL(g_object_new(GTK_TYPE_SAT_LIST_MODEL, NULL));
+    model->qth = qth;
+    gtk_sat_list_model_set_sats(model, sats);
+
+    return GTK_TREE_MODEL(model);
+}
+
+/**
+ * Update the model after the satellites have been recalculated.
+ *
+ * @param model The satellite list model.
+ *
+ * Decayed satellites are hidden, the rows are sorted again, and the rows
+ * of satellites that have risen or set are marked as changed so that the
+ * view can measure them again. The values of the other cells are picked up
+ * when the view is redrawn.
+ */
+void gtk_sat_list_model_update(GtkSatListModel * model)
+{
+    GtkSatRowModel *base;
+    sat_list_row_t *row;
+    gboolean        bold;
+    guint           i;
+
+    g_return_if_fail(IS_GTK_SAT_LIST_MODEL(model));
+
+    base = &model->parent;
+
+    /* hide satellites that have decayed */
+    for (i = base->rows->len; i > 0; i--)
+    {
+        row = g_ptr_array_index(base->rows, i - 1);
+        refresh_row(row);
+        if (decayed(row->base.sat))
+            g_ptr_array_add(base->hidden,
+                            gtk_sat_row_model_unshow(base, i - 1));
+    }
+
+    /* and show them again if the time has been moved back */
+    for (i = base->hidden->len; i > 0; i--)
+    {
+        row = g_ptr_array_index(base->hidden, i - 1);
+        if (!decayed(row->base.sat))
+        {
+            g_ptr_array_remove_index_fast(base->hidden, i - 1);
+            refresh_row(row);
+            gtk_sat_row_model_show(base, &row->base);
+        }
+    }
+
+    gtk_sat_row_model_sort(base, FALSE);
+
+    for (i = 0; i < base->rows->len; i++)
+    {
+        row = g_ptr_array_index(base->rows, i);
+        bold = (row->base.sat->el > 0.0);
+        if (bold != row->bold)
+        {
+            row->bold = bold;
+            gtk_sat_row_model_row_changed(base, &row->base);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef __GTK_SAT_LIST_MODEL_H__
+#define __GTK_SAT_LIST_MODEL_H__ 1
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include "gtk-sat-data.h"
+#include "gtk-sat-row-model.h"
+#include "radec-tools.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#define GTK_TYPE_SAT_LIST_MODEL   (gtk_sat_list_model_get_type ())
+#define GTK_SAT_LIST_MODEL(obj)   G_TYPE_CHECK_INSTANCE_CAST (obj,\
+                                      gtk_sat_list_model_get_type (),\
+                                      GtkSatListModel)
+#define IS_GTK_SAT_LIST_MODEL(obj) G_TYPE_CHECK_INSTANCE_TYPE (obj, gtk_sat_list_model_get_type ())
+
+typedef struct _GtkSatListModel GtkSatListModel;
+typedef struct _GtkSatListModelClass GtkSatListModelClass;
+
+/**
+ * Tree model of the satellite list.
+ *
+ * The rows refer to the satellites of the module and the column values are
+ * computed when the tree view asks for them, so only the visible cells are
+ * formatted. The columns are the ones in sat_list_col_t.
+ */
+struct _GtkSatListModel {
+    GtkSatRowModel  parent;
+
+    qth_t          *qth;        /*!< Pointer to current location. */
+    radec_frame_t   frame;      /*!< Observer frame for RA/Dec. */
+};
+
+struct _GtkSatListModelClass {
+    GtkSatRowModelClass parent_class;
+};
+
+GType           gtk_sat_list_model_get_type(void);
+GtkTreeModel   *gtk_sat_list_model_new(GHashTable * sats, qth_t * qth);
+void            gtk_sat_list_model_set_sats(GtkSatListModel * model,
+                                            GHashTable * sats);
+void            gtk_sat_list_model_update(GtkSatListModel * model);
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+}
+#endif
+/* *INDENT-ON* */
+
+#endif
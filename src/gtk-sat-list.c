@@ -34,14 +34,13 @@
 #include "gpredict-utils.h"
 #include "gtk-sat-data.h"
 #include "gtk-sat-list.h"
+#include "gtk-sat-list-model.h"
 #include "gtk-sat-list-popup.h"
-#include "locator.h"
 #include "mod-cfg-get-param.h"
 #include "orbit-tools.h"
 #include "sat-cfg.h"
 #include "sat-info.h"
 #include "sat-log.h"
-#include "sat-vis.h"
 #include "sgpsdp/sgp4sdp4.h"
 #include "time-tools.h"
 
@@ -144,11 +143,6 @@ static void     gtk_sat_list_class_init(GtkSatListClass * class,
 static void     gtk_sat_list_init(GtkSatList * list,
 				  gpointer g_class);
 static void     gtk_sat_list_destroy(GtkWidget * widget);
-static GtkTreeModel *create_and_fill_model(GHashTable * sats);
-static void     sat_list_add_satellites(gpointer key, gpointer value,
-                                        gpointer user_data);
-static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
-                                     GtkTreeIter * iter, gpointer data);
 
 /* cell rendering related functions */
 static void     check_and_set_cell_renderer(GtkTreeViewColumn * column,
@@ -203,10 +197,6 @@ static void     event_cell_data_function(GtkTreeViewColumn * col,
                                          GtkTreeIter * iter, gpointer column);
 
 
-static gint     event_cell_compare_function(GtkTreeModel * model,
-                                            GtkTreeIter * a, GtkTreeIter * b,
-                                            gpointer user_data);
-
 static gboolean popup_menu_cb(GtkWidget * treeview, gpointer list);
 static gboolean button_press_cb(GtkWidget * treeview, GdkEventButton * event,
                                 gpointer list);
@@ -215,8 +205,6 @@ static void     row_activated_cb(GtkTreeView * tree_view, GtkTreePath * path,
 
 static void     view_popup_menu(GtkWidget * treeview, GdkEventButton * event,
                                 gpointer list);
-static void     Calculate_RADec(sat_t * sat, qth_t * qth,
-                                obs_astro_t * obs_set);
 
 static GtkVBoxClass *parent_class = NULL;
 
@@ -285,7 +273,6 @@ GtkWidget      *gtk_sat_list_new(GKeyFile * cfgdata, GHashTable * sats,
 {
 //    GtkWidget      *widget;
     GtkSatList     *satlist;
-    GtkTreeModel   *model, *filter, *sortable;
     guint           i;
 
     GtkCellRenderer *renderer;
@@ -384,33 +371,15 @@ GtkWidget      *gtk_sat_list_new(GKeyFile * cfgdata, GHashTable * sats,
             gtk_tree_view_column_set_visible(column, FALSE);
     }
 
-    /* create model and finalise treeview */
-    model = create_and_fill_model(satlist->satellites);
-    filter = gtk_tree_model_filter_new(model, NULL);
-    sortable = gtk_tree_model_sort_new_with_model(filter);
-    satlist->sortable = sortable;
-    gtk_tree_model_filter_set_visible_column(GTK_TREE_MODEL_FILTER(filter),
-                                             SAT_LIST_COL_DECAY);
-    gtk_tree_view_set_model(GTK_TREE_VIEW(satlist->treeview), sortable);
-
-    /* We need a special sort function for AOS/LOS events that works
-       with all date and time formats (see bug #1861323)
-     */
-    gtk_tree_sortable_set_sort_func(GTK_TREE_SORTABLE(model), SAT_LIST_COL_AOS,
-                                    event_cell_compare_function,
-                                    GTK_WIDGET(satlist), NULL);
-    gtk_tree_sortable_set_sort_func(GTK_TREE_SORTABLE(model), SAT_LIST_COL_LOS,
-                                    event_cell_compare_function,
-                                    GTK_WIDGET(satlist), NULL);
-
-    /* satellite name should be initial sorting criteria */
-    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(sortable),
+    /* create model and finalise treeview; the model hides decayed
+       satellites and sorts the rows itself, and AOS/LOS are sorted by
+       time regardless of the date and time format (see bug #1861323) */
+    satlist->model = gtk_sat_list_model_new(satlist->satellites, satlist->qth);
+    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(satlist->model),
                                          satlist->sort_column,
                                          satlist->sort_order);
-
-    g_object_unref(model);
-    g_object_unref(filter);
-    g_object_unref(sortable);
+    gtk_tree_view_set_model(GTK_TREE_VIEW(satlist->treeview), satlist->model);
+    g_object_unref(satlist->model);
 
     g_signal_connect(satlist->treeview, "button-press-event",
                      G_CALLBACK(button_press_cb), satlist);
@@ -430,91 +399,14 @@ GtkWidget      *gtk_sat_list_new(GKeyFile * cfgdata, GHashTable * sats,
     return GTK_WIDGET(satlist);
 }
 
-static GtkTreeModel *create_and_fill_model(GHashTable * sats)
-{
-    GtkListStore   *liststore;
-
-    liststore = gtk_list_store_new(SAT_LIST_COL_NUMBER, G_TYPE_STRING,  // name
-                                   G_TYPE_INT,  // catnum
-                                   G_TYPE_DOUBLE,       // az
-                                   G_TYPE_DOUBLE,       // el
-                                   G_TYPE_STRING,       // direction
-                                   G_TYPE_DOUBLE,       // RA
-                                   G_TYPE_DOUBLE,       // Dec
-                                   G_TYPE_DOUBLE,       // range
-                                   G_TYPE_DOUBLE,       // range rate
-                                   G_TYPE_STRING,       // next event
-                                   G_TYPE_DOUBLE,       // next AOS
-                                   G_TYPE_DOUBLE,       // next LOS
-                                   G_TYPE_DOUBLE,       // ssp lat
-                                   G_TYPE_DOUBLE,       // ssp lon
-                                   G_TYPE_STRING,       // ssp qra
-                                   G_TYPE_DOUBLE,       // footprint
-                                   G_TYPE_DOUBLE,       // alt
-                                   G_TYPE_DOUBLE,       // vel
-                                   G_TYPE_DOUBLE,       // doppler
-                                   G_TYPE_DOUBLE,       // path loss
-                                   G_TYPE_DOUBLE,       // delay
-                                   G_TYPE_DOUBLE,       // mean anomaly
-                                   G_TYPE_DOUBLE,       // phase
-                                   G_TYPE_LONG, // orbit
-                                   G_TYPE_STRING,       // visibility
-                                   G_TYPE_BOOLEAN,      // decay
-                                   G_TYPE_INT,       // Operational Status
-                                   G_TYPE_INT   // weight/bold
-        );
-
-
-    g_hash_table_foreach(sats, sat_list_add_satellites, liststore);
-
-    return GTK_TREE_MODEL(liststore);
-}
-
-
-static void sat_list_add_satellites(gpointer key, gpointer value,
-                                    gpointer user_data)
-{
-    GtkListStore   *store = GTK_LIST_STORE(user_data);
-    GtkTreeIter     item;
-    sat_t          *sat = SAT(value);
-
-    (void)key;
-
-    gtk_list_store_append(store, &item);
-    gtk_list_store_set(store, &item,
-                       SAT_LIST_COL_NAME, sat->nickname,
-                       SAT_LIST_COL_CATNUM, sat->tle.catnr,
-                       SAT_LIST_COL_AZ, sat->az,
-                       SAT_LIST_COL_EL, sat->el,
-                       SAT_LIST_COL_VISIBILITY, "-",
-                       SAT_LIST_COL_RA, sat->ra,
-                       SAT_LIST_COL_DEC, sat->dec,
-                       SAT_LIST_COL_RANGE, sat->range,
-                       SAT_LIST_COL_RANGE_RATE, sat->range_rate,
-                       SAT_LIST_COL_DIR, "-",
-                       SAT_LIST_COL_NEXT_EVENT, "--- N/A ---",
-                       SAT_LIST_COL_AOS, sat->aos,
-                       SAT_LIST_COL_LOS, sat->los,
-                       SAT_LIST_COL_LAT, sat->ssplat,
-                       SAT_LIST_COL_LON, sat->ssplon,
-                       SAT_LIST_COL_SSP, "",
-                       SAT_LIST_COL_FOOTPRINT, sat->footprint,
-                       SAT_LIST_COL_ALT, sat->alt,
-                       SAT_LIST_COL_VEL, sat->velo,
-                       SAT_LIST_COL_DOPPLER, 0.0,
-                       SAT_LIST_COL_LOSS, 0.0,
-                       SAT_LIST_COL_DELAY, 0.0,
-                       SAT_LIST_COL_MA, sat->ma,
-                       SAT_LIST_COL_PHASE, sat->phase,
-                       SAT_LIST_COL_ORBIT, sat->orbit, 
-                       SAT_LIST_COL_STAT_OPERATIONAL, (char *) sat->tle.status,
-                       SAT_LIST_COL_DECAY, !decayed(sat), -1);
-}
-
-/** Update satellites */
+/**
+ * Update satellites.
+ *
+ * The model picks up the new satellite data when the visible rows are
+ * redrawn, so only the rows that are shown are formatted.
+ */
 void gtk_sat_list_update(GtkWidget * widget)
 {
-    GtkTreeModel   *model;
     GtkSatList     *satlist = GTK_SAT_LIST(widget);
 
     /* first, do some sanity checks */
@@ -534,280 +426,17 @@ void gtk_sat_list_update(GtkWidget * widget)
     {
         satlist->counter = 1;
 
-        /* get and tranverse the model */
-        model =
-            gtk_tree_model_filter_get_model(GTK_TREE_MODEL_FILTER
-                                            (gtk_tree_model_sort_get_model
-                                             (GTK_TREE_MODEL_SORT
-                                              (gtk_tree_view_get_model
-                                               (GTK_TREE_VIEW
-                                                (satlist->treeview))))));
-
         /*save the sort information */
         gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE
-                                             (satlist->sortable),
+                                             (satlist->model),
                                              &(satlist->sort_column),
                                              &(satlist->sort_order));
 
-        /* optimisation: detach model from view while updating */
-        /* No, we do not do it, because it makes selections and scrolling
-           impossible
-         */
-        /*         g_object_ref (model); */
-        /*         gtk_tree_view_set_model (GTK_TREE_VIEW (satlist->treeview), NULL); */
-
-        /* update */
-        gtk_tree_model_foreach(model, sat_list_update_sats, satlist);
-
-        /* re-attach model to view */
-        /*         gtk_tree_view_set_model (GTK_TREE_VIEW (satlist->treeview), model); */
-
-        /*         g_object_unref (model); */
+        gtk_sat_list_model_update(GTK_SAT_LIST_MODEL(satlist->model));
+        gtk_widget_queue_draw(satlist->treeview);
     }
 }
 
-/** Update data in each column in a given row */
-static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
-                                     GtkTreeIter * iter, gpointer data)
-{
-    GtkSatList     *satlist = GTK_SAT_LIST(data);
-    guint          *catnum;
-    sat_t          *sat;
-    gchar          *buff;
-    gdouble         doppler;
-    gdouble         delay;
-    gdouble         loss;
-    gdouble         oldrate;
-    gint            retcode;
-
-    (void)path;
-
-    /* get the catalogue number for this row
-       then look it up in the hash table
-     */
-    catnum = g_new0(guint, 1);
-    gtk_tree_model_get(model, iter, SAT_LIST_COL_CATNUM, catnum, -1);
-    sat = SAT(g_hash_table_lookup(satlist->satellites, catnum));
-
-    if (sat == NULL)
-    {
-        /* satellite not tracked anymore => remove */
-        sat_log_log(SAT_LOG_LEVEL_INFO,
-                    _("%s: Failed to get data for #%d."), __func__, *catnum);
-
-        gtk_list_store_remove(GTK_LIST_STORE(model), iter);
-
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: Satellite #%d removed from list."), __func__,
-                    *catnum);
-    }
-    else
-    {
-        /* store new data */
-        gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                           SAT_LIST_COL_AZ, sat->az,
-                           SAT_LIST_COL_EL, sat->el,
-                           SAT_LIST_COL_RANGE, sat->range,
-                           SAT_LIST_COL_RANGE_RATE, sat->range_rate,
-                           SAT_LIST_COL_LAT, sat->ssplat,
-                           SAT_LIST_COL_LON, sat->ssplon,
-                           SAT_LIST_COL_FOOTPRINT, sat->footprint,
-                           SAT_LIST_COL_ALT, sat->alt,
-                           SAT_LIST_COL_VEL, sat->velo,
-                           SAT_LIST_COL_MA, sat->ma,
-                           SAT_LIST_COL_PHASE, sat->phase,
-                           SAT_LIST_COL_ORBIT, sat->orbit,
-                           SAT_LIST_COL_DECAY, !decayed(sat),
-                           SAT_LIST_COL_BOLD,
-                           (sat->el >
-                            0.0) ? PANGO_WEIGHT_BOLD : PANGO_WEIGHT_NORMAL,
-                           -1);
-
-        /* doppler shift @ 100 MHz */
-        if (satlist->flags & SAT_LIST_FLAG_DOPPLER)
-        {
-            doppler = -100.0e06 * (sat->range_rate / 299792.4580);      // Hz
-            gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                               SAT_LIST_COL_DOPPLER, doppler, -1);
-        }
-
-        /* delay */
-        if (satlist->flags & SAT_LIST_FLAG_DELAY)
-        {
-            delay = sat->range / 299.7924580;   // msec 
-            gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_DELAY,
-                               delay, -1);
-        }
-
-        /* path loss */
-        if (satlist->flags & SAT_LIST_FLAG_LOSS)
-        {
-            loss = 72.4 + 20.0 * log10(sat->range);     // dB
-            gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_LOSS,
-                               loss, -1);
-        }
-
-        /* calculate direction */
-        if (satlist->flags & SAT_LIST_FLAG_DIR)
-        {
-            if (sat->otype == ORBIT_TYPE_GEO)
-            {
-                buff = g_strdup("G");
-            }
-            else if (decayed(sat))
-            {
-                buff = g_strdup("D");
-            }
-            else if (sat->range_rate > 0.001)
-            {
-                /* going down */
-                buff = g_strdup("\342\206\223");
-            }
-            else if ((sat->range_rate <= 0.001) && (sat->range_rate >= -0.001))
-            {
-                gtk_tree_model_get(model, iter, SAT_LIST_COL_RANGE_RATE,
-                                   &oldrate, -1);
-                /* turning around; don't know which way ? */
-                if (sat->range_rate < oldrate)
-                {
-                    /* starting to approach */
-                    buff = g_strdup("\342\206\272");
-                }
-                else
-                {
-                    /* to receed */
-                    buff = g_strdup("\342\206\267");
-                }
-            }
-            else if (sat->range_rate < -0.001)
-            {
-                /* coming up */
-                buff = g_strdup("\342\206\221");
-            }
-            else
-            {
-                buff = g_strdup("-");
-            }
-
-            gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_DIR,
-                               buff, -1);
-
-            /* free memory */
-            g_free(buff);
-
-        }
-
-        /* SSP locator */
-        if (satlist->flags & SAT_LIST_FLAG_SSP)
-        {
-
-            buff = g_try_malloc(7);
-
-            retcode = longlat2locator(sat->ssplon, sat->ssplat, buff, 3);
-            if (retcode == RIG_OK)
-            {
-                buff[6] = '\0';
-                gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                                   SAT_LIST_COL_SSP, buff, -1);
-            }
-            g_free(buff);
-        }
-
-        /* Ra and Dec */
-        if (satlist->flags & (SAT_LIST_FLAG_RA | SAT_LIST_FLAG_DEC))
-        {
-            obs_astro_t     astro;
-
-            Calculate_RADec(sat, satlist->qth, &astro);
-
-            sat->ra = Degrees(astro.ra);
-            sat->dec = Degrees(astro.dec);
-
-            gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                               SAT_LIST_COL_RA, sat->ra, SAT_LIST_COL_DEC,
-                               sat->dec, -1);
-        }
-
-        /* upcoming events */
-        /*** FIXME: not necessary to update every time */
-        if (satlist->flags & SAT_LIST_FLAG_AOS)
-        {
-            gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_AOS,
-                               sat->aos, -1);
-        }
-        if (satlist->flags & SAT_LIST_FLAG_LOS)
-        {
-            gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_LOS,
-                               sat->los, -1);
-
-        }
-        if (satlist->flags & SAT_LIST_FLAG_NEXT_EVENT)
-        {
-            gdouble         number;
-            gchar           buff[TIME_FORMAT_MAX_LENGTH];
-            gchar          *tfstr;
-            gchar          *fmtstr;
-            gchar          *alstr;
-
-
-            if (sat->aos > sat->los)
-            {
-                /* next event is LOS */
-                number = sat->los;
-                alstr = g_strdup(" (LOS)");
-            }
-            else
-            {
-                /* next event is AOS */
-                number = sat->aos;
-                alstr = g_strdup(" (AOS)");
-            }
-
-            if (number == 0.0)
-            {
-                gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                                   SAT_LIST_COL_NEXT_EVENT, "--- N/A ---", -1);
-            }
-            else
-            {
-
-                /* format the number */
-                tfstr = sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT);
-                fmtstr = g_strconcat(tfstr, alstr, NULL);
-                g_free(tfstr);
-
-                daynum_to_str(buff, TIME_FORMAT_MAX_LENGTH, fmtstr, number);
-
-                gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                                   SAT_LIST_COL_NEXT_EVENT, buff, -1);
-
-
-                g_free(fmtstr);
-            }
-
-            g_free(alstr);
-        }
-
-        if (satlist->flags & SAT_LIST_FLAG_VISIBILITY)
-        {
-            sat_vis_t       vis;
-
-            vis = get_sat_vis(sat, satlist->qth, sat->jul_utc);
-            buff = g_strdup_printf("%c", vis_to_chr(vis));
-            gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                               SAT_LIST_COL_VISIBILITY, buff, -1);
-            g_free(buff);
-        }
-    }
-
-    g_free(catnum);
-
-    /* Return value not documented what to return, but it seems that
-       FALSE continues to next row while TRUE breaks
-     */
-    return FALSE;
-}
-
 /** Set cell renderer function. */
 static void check_and_set_cell_renderer(GtkTreeViewColumn * column,
                                         GtkCellRenderer * renderer, gint i)
@@ -947,7 +576,7 @@ static void     operational_status_cell_data_function(GtkTreeViewColumn * col,
    fancy way, including degree sign and NWSE suffixes.
 
    Please note that this function only affects how the numbers are
-   displayed (rendered), the tree_store will still contain the
+   displayed (rendered), the model will still contain the
    original flaoting point numbers. Very cool!
 */
 static void latlon_cell_data_function(GtkTreeViewColumn * col,
@@ -1157,57 +786,6 @@ static void event_cell_data_function(GtkTreeViewColumn * col,
 
 }
 
-/**
- * Function to compare to Event cells.
- *
- * @param model Pointer to the GtkTreeModel.
- * @param a Pointer to the first element.
- * @param b Pointer to the second element.
- * @param user_data Always NULL (TBC).
- * 2return See detailed description.
- *
- * This function is used by the SatList sort function to determine whether
- * AOS/LOS cell a is greater than b or not. The cells a and b contain the
- * time of the event in Julian days, thus the result can be computed by a
- * simple comparison between the two numbers contained in the cells.
- *
- * The function returns -1 if a < b; +1 if a > b; 0 otherwise.
- */
-static gint event_cell_compare_function(GtkTreeModel * model,
-                                        GtkTreeIter * a,
-                                        GtkTreeIter * b, gpointer user_data)
-{
-    gint            result;
-    gdouble         ta, tb;
-    gint            sort_col;
-    GtkSortType     sort_type;
-    GtkSatList     *satlist = GTK_SAT_LIST(user_data);
-
-    /* Since this function is used for both AOS and LOS columns,
-       we need to get the sort column */
-    gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE(satlist->sortable),
-                                         &sort_col, &sort_type);
-
-    /* get a and b */
-    gtk_tree_model_get(model, a, sort_col, &ta, -1);
-    gtk_tree_model_get(model, b, sort_col, &tb, -1);
-
-    if (ta < tb)
-    {
-        result = -1;
-    }
-    else if (ta > tb)
-    {
-        result = 1;
-    }
-    else
-    {
-        result = 0;
-    }
-
-    return result;
-}
-
 /** Reload configuration */
 void gtk_sat_list_reconf(GtkWidget * widget, GKeyFile * cfgdat)
 {
@@ -1361,57 +939,12 @@ static void view_popup_menu(GtkWidget * treeview, GdkEventButton * event,
     g_free(catnum);
 }
 
-/*** FIXME: formalise with other copies, only need az,el and jul_utc */
-static void Calculate_RADec(sat_t * sat, qth_t * qth, obs_astro_t * obs_set)
-{
-    /* Reference:  Methods of Orbit Determination by  */
-    /*                Pedro Ramon Escobal, pp. 401-402 */
-
-    double          phi, theta, sin_theta, cos_theta, sin_phi, cos_phi,
-        az, el, Lxh, Lyh, Lzh, Sx, Ex, Zx, Sy, Ey, Zy, Sz, Ez, Zz,
-        Lx, Ly, Lz, cos_delta, sin_alpha, cos_alpha;
-    geodetic_t      geodetic;
-
-    geodetic.lon = qth->lon * de2ra;
-    geodetic.lat = qth->lat * de2ra;
-    geodetic.alt = qth->alt / 1000.0;
-    geodetic.theta = 0;
-
-    az = sat->az * de2ra;
-    el = sat->el * de2ra;
-    phi = geodetic.lat;
-    theta = FMod2p(ThetaG_JD(sat->jul_utc) + geodetic.lon);
-    sin_theta = sin(theta);
-    cos_theta = cos(theta);
-    sin_phi = sin(phi);
-    cos_phi = cos(phi);
-    Lxh = -cos(az) * cos(el);
-    Lyh = sin(az) * cos(el);
-    Lzh = sin(el);
-    Sx = sin_phi * cos_theta;
-    Ex = -sin_theta;
-    Zx = cos_theta * cos_phi;
-    Sy = sin_phi * sin_theta;
-    Ey = cos_theta;
-    Zy = sin_theta * cos_phi;
-    Sz = -cos_phi;
-    Ez = 0;
-    Zz = sin_phi;
-    Lx = Sx * Lxh + Ex * Lyh + Zx * Lzh;
-    Ly = Sy * Lxh + Ey * Lyh + Zy * Lzh;
-    Lz = Sz * Lxh + Ez * Lyh + Zz * Lzh;
-    obs_set->dec = ArcSin(Lz);  /* Declination (radians) */
-    cos_delta = sqrt(1 - Sqr(Lz));
-    sin_alpha = Ly / cos_delta;
-    cos_alpha = Lx / cos_delta;
-    obs_set->ra = AcTan(sin_alpha, cos_alpha);  /* Right Ascension (radians) */
-    obs_set->ra = FMod2p(obs_set->ra);
-}
-
 /** Reload reference to satellites (e.g. after TLE update). */
 void gtk_sat_list_reload_sats(GtkWidget * satlist, GHashTable * sats)
 {
     GTK_SAT_LIST(satlist)->satellites = sats;
+    gtk_sat_list_model_set_sats(GTK_SAT_LIST_MODEL
+                                (GTK_SAT_LIST(satlist)->model), sats);
 }
 
 /** Select a satellite */
@@ -1430,7 +963,7 @@ void gtk_sat_list_select_sat(GtkWidget * satlist, gint catnum)
     selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(slist->treeview));
 
     /* iterate over the satellite list until a amtch is found */
-    n = g_hash_table_size(slist->satellites);
+    n = gtk_tree_model_iter_n_children(model, NULL);
     for (i = 0; i < n; i++)
     {
 
@@ -66,7 +66,7 @@ struct _gtk_sat_list {
     GKeyFile       *cfgdata;
     gint            sort_column;
     GtkSortType     sort_order;
-    GtkTreeModel   *sortable;   /*!< a sortable version of the tree model for filtering */
+    GtkTreeModel   *model;      /*!< the satellite list model, see gtk-sat-list-model.c */
 
     void            (*update) (GtkWidget * widget);     /*!< update function */
 };
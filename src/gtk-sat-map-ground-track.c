@@ -34,10 +34,13 @@
 #endif
 #include <gtk/gtk.h>
 #include <glib/gi18n.h>
+#include <string.h>
 
 #include "config-keys.h"
 #include "gtk-sat-map.h"
 #include "gtk-sat-map-ground-track.h"
+#include "gtk-sat-map-render.h"
+#include "map-tools.h"
 #include "mod-cfg-get-param.h"
 #include "orbit-tools.h"
 #include "predict-tools.h"
@@ -49,9 +52,124 @@
 static void     create_polylines(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
                                  sat_map_obj_t * obj);
 static gboolean ssp_wrap_detected(GtkSatMap * satmap, gdouble x1, gdouble x2);
-static void     free_ssp(gpointer ssp, gpointer data);
 
 
+/* Time step between SSPs: 30 sec. The polylines are simplified to the
+   pixel scale of the map, so a finer step only costs computation time */
+#define TRACK_STEP 0.00035
+
+/** Get the i-th oldest SSP of a ground track. */
+static ssp_t   *track_ssp(ground_track_t * track, guint i)
+{
+    return &track->ssp[(track->head + i) % track->size];
+}
+
+/** Append an SSP to a ground track, growing the ring buffer if it is full. */
+static void track_push(ground_track_t * track, gdouble lat, gdouble lon)
+{
+    ssp_t          *ssp;
+    guint           size, i;
+
+    if (track->num == track->size)
+    {
+        /* unwrap the contents into the new buffer */
+        size = MAX(2 * track->size, 512);
+        ssp = g_new(ssp_t, size);
+        for (i = 0; i < track->num; i++)
+            ssp[i] = *track_ssp(track, i);
+
+        g_free(track->ssp);
+        track->ssp = ssp;
+        track->size = size;
+        track->head = 0;
+    }
+
+    ssp = &track->ssp[(track->head + track->num) % track->size];
+    ssp->lat = lat;
+    ssp->lon = lon;
+    track->num++;
+}
+
+/** Drop the oldest orbit of a ground track. */
+static void track_drop_orbit(ground_track_t * track)
+{
+    guint           n = GPOINTER_TO_UINT(g_queue_pop_head(&track->orbits));
+
+    track->head = (track->head + n) % MAX(track->size, 1);
+    track->num -= n;
+}
+
+/**
+ * Append one orbit to a ground track.
+ *
+ * @return FALSE if the orbit could not be computed.
+ *
+ * This leaves the satellite at a time within the orbit; the caller must
+ * restore it with predict_calc().
+ */
+static gboolean track_add_orbit(ground_track_t * track, sat_t * sat,
+                                qth_t * qth, long orbit)
+{
+    gdouble         t, t0, t1;
+    guint           n = 0;
+
+    t0 = find_orbit_start(sat, orbit);
+    t1 = find_orbit_start(sat, orbit + 1);
+    if (t0 == 0.0 || t1 <= t0)
+        return FALSE;
+
+    for (t = t0; t < t1; t += TRACK_STEP)
+    {
+        predict_calc(sat, qth, t);
+        if (decayed(sat))
+            break;
+
+        track_push(track, sat->ssplat, sat->ssplon);
+        n++;
+    }
+
+    g_queue_push_tail(&track->orbits, GUINT_TO_POINTER(n));
+
+    return TRUE;
+}
+
+/**
+ * Move a ground track on to the current orbit of the satellite.
+ *
+ * @return FALSE if the track can not be extended and must be recomputed.
+ *
+ * The orbits that have passed are dropped and only the orbits that have
+ * come into range are computed.
+ */
+static gboolean track_extend(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
+                             sat_map_obj_t * obj)
+{
+    ground_track_t *track = &obj->track_data;
+    long            this_orbit = sat->orbit;
+    guint           num;
+    gboolean        ok = TRUE;
+
+    num = mod_cfg_get_int(satmap->cfgdata, MOD_CFG_MAP_SECTION,
+                          MOD_CFG_MAP_TRACK_NUM, SAT_CFG_INT_MAP_TRACK_NUM);
+
+    if (obj->track_orbit == 0 || this_orbit < obj->track_orbit ||
+        this_orbit - obj->track_orbit >= (long)num ||
+        g_queue_get_length(&track->orbits) != num)
+        return FALSE;
+
+    while (ok && obj->track_orbit < this_orbit)
+    {
+        track_drop_orbit(track);
+        ok = track_add_orbit(track, sat, qth, obj->track_orbit + num);
+        obj->track_orbit++;
+    }
+
+    /* restore the satellite to the current time */
+    predict_calc(sat, qth, satmap->tstamp);
+
+    return ok;
+}
+
 /**
  * Create and show ground track for a satellite.
  *
@@ -70,16 +188,16 @@ void ground_track_create(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
 {
     long            this_orbit; /* current orbit number */
     long            max_orbit;  /* target orbit number, ie. this + num - 1 */
-    double          t0;         /* time when this_orbit starts */
-    double          t;
-    ssp_t          *this_ssp;
+    long            orbit;
 
     sat_log_log(SAT_LOG_LEVEL_DEBUG,
                 _("%s: Creating ground track for %s"),
                 __func__, sat->nickname);
 
-    /* just to be safe... if empty GSList is not NULL => segfault */
-    obj->track_data.latlon = NULL;
+    /* start from an empty track but keep the buffer */
+    obj->track_data.head = 0;
+    obj->track_data.num = 0;
+    g_queue_clear(&obj->track_data.orbits);
 
     /* get configuration parameters */
     this_orbit = sat->orbit;
@@ -93,75 +211,22 @@ void ground_track_create(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
     sat_log_log(SAT_LOG_LEVEL_DEBUG,
                 _("%s: End orbit %d"), __func__, max_orbit);
 
-    /* find the time when the current orbit started */
-
-    /* Iterate backwards in time until we reach sat->orbit < this_orbit.
-       Use predict_calc from predict-tools.c as SGP/SDP driver.
-       As a built-in safety, we stop iteration if the orbit crossing is
-       more than 24 hours back in time.
-     */
-    t0 = satmap->tstamp;        //get_current_daynum ();
-    /* use == instead of >= as it is more robust */
-    for (t = t0; (sat->orbit == this_orbit) && ((t + 1.0) > t0); t -= 0.0007)
-        predict_calc(sat, qth, t);
-
-    /* set it so that we are in the same orbit as this_orbit
-       and not a different one */
-    t += 2 * 0.0007;
-    t0 = t;
-    predict_calc(sat, qth, t0);
-
-    sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                _("%s: T0: %f (%d)"), __func__, t0, sat->orbit);
-
     /* calculate (lat,lon) for the required orbits */
-    while ((sat->orbit <= max_orbit) &&
-           (sat->orbit >= this_orbit) && (!decayed(sat)))
+    for (orbit = this_orbit; orbit <= max_orbit && !decayed(sat); orbit++)
     {
-        /* We use 30 sec time steps. If resolution is too fine, the
-           line drawing routine will filter out unnecessary points
-         */
-        t += 0.00035;
-        predict_calc(sat, qth, t);
-
-        /* store this SSP */
-
-        /* Note: g_slist_append() has to traverse the entire list to find the end, which
-           is inefficient when adding multiple elements. Therefore, we use g_slist_prepend()
-           and reverse the entire list when we are done.
-         */
-        this_ssp = g_try_new(ssp_t, 1);
-
-        if (this_ssp == NULL)
+        if (!track_add_orbit(&obj->track_data, sat, qth, orbit))
         {
             sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _("%s: MAYDAY: Insufficient memory for ground track!"),
-                        __func__);
-            return;
+                        _("%s: Problem computing ground track for %s"),
+                        __func__, sat->nickname);
+            break;
         }
-
-        this_ssp->lat = sat->ssplat;
-        this_ssp->lon = sat->ssplon;
-        obj->track_data.latlon =
-            g_slist_prepend(obj->track_data.latlon, this_ssp);
-
-    }
-    /* log if there is a problem with the orbit calculation */
-    if (sat->orbit != (max_orbit + 1))
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: Problem computing ground track for %s"),
-                    __func__, sat->nickname);
-        return;
     }
 
     /* Reset satellite structure to eliminate glitches in single sat 
        view and other places when new ground track is layed out */
     predict_calc(sat, qth, satmap->tstamp);
 
-    /* reverse GSList */
-    obj->track_data.latlon = g_slist_reverse(obj->track_data.latlon);
-
     /* split points into polylines */
     create_polylines(satmap, sat, qth, obj);
 
@@ -179,12 +244,13 @@ void ground_track_create(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
  * @param recalc Flag indicating whether ground track should be recalculated.
  *
  *    If (recalc=TRUE)
- *       call ground_track_delete (clear_ssp=TRUE)
- *       call ground_track_create
+ *       call ground_track_delete (clear_ssp=FALSE)
+ *       move the SSPs on to the current orbit, or call
+ *       ground_track_create if that is not possible
  *    Else
  *       call ground_track_delete (clear_ssp=FALSE)
- *       call create_polylines
  *
+ *    and call create_polylines.
  *
  * The purpose with the recalc flag is to allow updates of ground track look without having
  * to recalculate the whole ground track (recalc=FALSE). 
@@ -202,16 +268,12 @@ void ground_track_update(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
         return;
     }
 
-    if (recalc == TRUE)
-    {
-        ground_track_delete(satmap, sat, qth, obj, TRUE);
+    ground_track_delete(satmap, sat, qth, obj, FALSE);
+
+    if (recalc == TRUE && !track_extend(satmap, sat, qth, obj))
         ground_track_create(satmap, sat, qth, obj);
-    }
     else
-    {
-        ground_track_delete(satmap, sat, qth, obj, FALSE);
         create_polylines(satmap, sat, qth, obj);
-    }
 }
 
 /**
@@ -240,7 +302,12 @@ void ground_track_delete(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
     root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
 
     /* remove plylines */
-    if (obj->track_data.lines != NULL)
+    if (satmap->direct)
+    {
+        gtk_sat_map_render_clear_track(satmap, obj);
+        obj->track_vertices = 0;
+    }
+    else if (obj->track_data.lines != NULL)
     {
         n = g_slist_length(obj->track_data.lines);
 
@@ -267,172 +334,59 @@ void ground_track_delete(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
 
         g_slist_free(obj->track_data.lines);
         obj->track_data.lines = NULL;
+        obj->track_vertices = 0;
     }
 
     /* clear SSP too? */
     if (clear_ssp == TRUE)
     {
-        if (obj->track_data.latlon != NULL)
-        {
-            /* free allocated ssp_t */
-            g_slist_foreach(obj->track_data.latlon, free_ssp, NULL);
-
-            /* free the SList itself */
-            g_slist_free(obj->track_data.latlon);
-            obj->track_data.latlon = NULL;
-
-        }
+        g_free(obj->track_data.ssp);
+        obj->track_data.ssp = NULL;
+        obj->track_data.size = 0;
+        obj->track_data.head = 0;
+        obj->track_data.num = 0;
+        g_queue_clear(&obj->track_data.orbits);
 
         obj->track_orbit = 0;
     }
 }
 
 /**
- * Free an ssp_t structure.
+ * Add a polyline for a part of the ground track.
+ *
+ * @param coords The x,y map coordinates of the part; simplified in place.
  *
- * The ssp_t items in the obj->track_data.latlon GSList are dunamically allocated
- * hence they need to be freed when the cround track is deleted. This function
- * is intended to be called from a g_slist_foreach() iterator.
+ * The points are simplified to the pixel scale of the map before they are
+ * passed to the canvas, or kept for gtk-sat-map-render.c with direct
+ * rendering.
  */
-static void free_ssp(gpointer ssp, gpointer data)
-{
-    (void)data;
-    g_free(ssp);
-}
-
-/** Create polylines. */
-static void create_polylines(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
-                             sat_map_obj_t * obj)
+static void add_polyline(GtkSatMap * satmap, sat_map_obj_t * obj,
+                         GArray * coords, guint32 col)
 {
-    ssp_t          *ssp, *buff; /* map coordinates */
-    double          lastx, lasty;
-    GSList         *points = NULL;
     GooCanvasItemModel *root;
     GooCanvasItemModel *line;
     GooCanvasPoints *gpoints;
-    guint           start;
-    guint           i, j, n, num_points;
-    guint32         col;
-
-    (void)sat;
-    (void)qth;
+    guint           num;
 
-    /* initialise parameters */
-    lastx = -50.0;
-    lasty = -50.0;
-    start = 0;
-    num_points = 0;
-    n = g_slist_length(obj->track_data.latlon);
-    col = mod_cfg_get_int(satmap->cfgdata,
-                          MOD_CFG_MAP_SECTION,
-                          MOD_CFG_MAP_TRACK_COL, SAT_CFG_INT_MAP_TRACK_COL);
+    num = map_tools_simplify((gdouble *) coords->data, coords->len / 2,
+                             SAT_MAP_LOD_TOLERANCE);
 
-    /* loop over each SSP */
-    for (i = 0; i < n; i++)
+    /* we need at least 2 points to draw a line */
+    if (num > 1)
     {
-        buff = (ssp_t *) g_slist_nth_data(obj->track_data.latlon, i);
-        ssp = g_try_new(ssp_t, 1);
-        gtk_sat_map_lonlat_to_xy(satmap, buff->lon, buff->lat, &ssp->lon,
-                                 &ssp->lat);
-
-        /* if this is the first point, just add it to the list */
-        if (i == start)
-        {
-            points = g_slist_prepend(points, ssp);
-            lastx = ssp->lon;
-            lasty = ssp->lat;
-        }
-        else
-        {
-            /* if SSP is on the other side of the map */
-            if (ssp_wrap_detected(satmap, lastx, ssp->lon))
-            {
-                points = g_slist_reverse(points);
-                num_points = g_slist_length(points);
-
-                /* we need at least 2 points to draw a line */
-                if (num_points > 1)
-                {
-                    /* convert SSPs to GooCanvasPoints */
-                    gpoints = goo_canvas_points_new(num_points);
-                    for (j = 0; j < num_points; j++)
-                    {
-                        buff = (ssp_t *) g_slist_nth_data(points, j);
-                        gpoints->coords[2 * j] = buff->lon;
-                        gpoints->coords[2 * j + 1] = buff->lat;
-                    }
-
-                    /* create a new polyline using the current set of points */
-                    root =
-                        goo_canvas_get_root_item_model(GOO_CANVAS
-                                                       (satmap->canvas));
-
-                    line = goo_canvas_polyline_model_new(root, FALSE, 0,
-                                                         "points", gpoints,
-                                                         "line-width", 1.0,
-                                                         "stroke-color-rgba",
-                                                         col, "line-cap",
-                                                         CAIRO_LINE_CAP_SQUARE,
-                                                         "line-join",
-                                                         CAIRO_LINE_JOIN_MITER,
-                                                         NULL);
-                    goo_canvas_points_unref(gpoints);
-                    goo_canvas_item_model_lower(line, obj->marker);
-
-                    /* store line in sat object */
-                    obj->track_data.lines =
-                        g_slist_append(obj->track_data.lines, line);
-
-                }
-
-                /* reset parameters and continue with a new set */
-                g_slist_foreach(points, free_ssp, NULL);
-                g_slist_free(points);
-                points = NULL;
-                start = i;
-                lastx = ssp->lon;
-                lasty = ssp->lat;
-                num_points = 0;
-
-                /* Add current SSP to the new list */
-                points = g_slist_prepend(points, ssp);
-                lastx = ssp->lon;
-                lasty = ssp->lat;
-            }
+        gpoints = goo_canvas_points_new(num);
+        memcpy(gpoints->coords, coords->data, 2 * num * sizeof(gdouble));
+        obj->track_vertices += num;
 
-            /* else if this SSP is separable from the previous */
-            else if ((fabs(lastx - ssp->lon) > 1.0) ||
-                     (fabs(lasty - ssp->lat) > 1.0))
-            {
-
-                /* add SSP to list */
-                points = g_slist_prepend(points, ssp);
-                lastx = ssp->lon;
-                lasty = ssp->lon;
-            }
-            /* else do nothing */
-            else g_free(ssp);
-        }
-    }
-
-    /* create (last) line if we have at least two points */
-    points = g_slist_reverse(points);
-    num_points = g_slist_length(points);
-
-    if (num_points > 1)
-    {
-        /* convert SSPs to GooCanvasPoints */
-        gpoints = goo_canvas_points_new(num_points);
-        for (j = 0; j < num_points; j++)
+        if (satmap->direct)
         {
-            buff = (ssp_t *) g_slist_nth_data(points, j);
-            gpoints->coords[2 * j] = buff->lon;
-            gpoints->coords[2 * j + 1] = buff->lat;
+            gtk_sat_map_render_add_track(satmap, obj, gpoints);
+            goo_canvas_points_unref(gpoints);
+            g_array_set_size(coords, 0);
+            return;
         }
 
-        /* create a new polyline using the current set of points */
         root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
-
         line = goo_canvas_polyline_model_new(root, FALSE, 0,
                                              "points", gpoints,
                                              "line-width", 1.0,
@@ -444,12 +398,53 @@ static void create_polylines(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
         goo_canvas_item_model_lower(line, obj->marker);
 
         /* store line in sat object */
-        obj->track_data.lines = g_slist_append(obj->track_data.lines, line);
+        obj->track_data.lines = g_slist_prepend(obj->track_data.lines, line);
+    }
+
+    g_array_set_size(coords, 0);
+}
+
+/** Create polylines. */
+static void create_polylines(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
+                             sat_map_obj_t * obj)
+{
+    ssp_t          *ssp;
+    GArray         *coords;     /* map coordinates of the current part */
+    gdouble         xy[2];
+    gdouble         lastx = 0.0;
+    guint           i;
+    guint32         col;
+
+    (void)sat;
+    (void)qth;
+
+    col = mod_cfg_get_int(satmap->cfgdata,
+                          MOD_CFG_MAP_SECTION,
+                          MOD_CFG_MAP_TRACK_COL, SAT_CFG_INT_MAP_TRACK_COL);
+    coords = g_array_sized_new(FALSE, FALSE, sizeof(gdouble),
+                               2 * obj->track_data.num);
+    obj->track_vertices = 0;
+
+    /* loop over each SSP */
+    for (i = 0; i < obj->track_data.num; i++)
+    {
+        ssp = track_ssp(&obj->track_data, i);
+        gtk_sat_map_lonlat_to_xy(satmap, ssp->lon, ssp->lat, &xy[0], &xy[1]);
+
+        /* if SSP is on the other side of the map, start a new line */
+        if (i > 0 && ssp_wrap_detected(satmap, lastx, xy[0]))
+            add_polyline(satmap, obj, coords, col);
 
-        /* reset parameters and continue with a new set */
-        g_slist_foreach(points, free_ssp, NULL);
-        g_slist_free(points);
+        g_array_append_vals(coords, xy, 2);
+        lastx = xy[0];
     }
+
+    /* create (last) line */
+    add_polyline(satmap, obj, coords, col);
+    g_array_free(coords, TRUE);
+
+    obj->track_data.lines = g_slist_reverse(obj->track_data.lines);
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_TRACK);
 }
 
 /** Check whether ground track wraps around map borders */
@@ -37,6 +37,7 @@
 #include "gtk-sat-map.h"
 #include "gtk-sat-map-popup.h"
 #include "gtk-sat-map-ground-track.h"
+#include "gtk-sat-map-render.h"
 #include "gtk-sat-popup-common.h"
 #include "mod-cfg-get-param.h"
 #include "orbit-tools.h"
@@ -192,6 +193,13 @@ static void coverage_toggled(GtkCheckMenuItem * item, gpointer data)
                             &(sat->tle.catnr), (gpointer) 0x1);
     }
 
+    if (satmap->direct)
+    {
+        gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_COVERAGE);
+        gtk_sat_map_render_flush(satmap);
+        return;
+    }
+
     /* set or clear coverage colour */
     if (obj->showcov)
     {
@@ -262,6 +270,8 @@ static void track_toggled(GtkCheckMenuItem * item, gpointer data)
         /* remove it from the storage structure */
         g_hash_table_remove(satmap->showtracks, &(sat->tle.catnr));
     }
+
+    gtk_sat_map_render_flush(satmap);
 }
 
 #if 0
@@ -0,0 +1,385 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Benchmark for the direct map renderer.
+ *
+ * A map with a catalog of satellites at random positions is drawn offscreen
+ * into an image surface by gtk_sat_map_render_frame(), without a widget.
+ * First whole frames are timed, then refresh cycles in which some of the
+ * satellites move and only the queued dirty region is repainted.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <cairo.h>
+#include <glib.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "footprint.h"
+#include "gtk-sat-map-render.h"
+#include "map-tools.h"
+#include "mod-cfg-get-param.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/* command line options */
+static gint     numsats = 5000;
+static gint     moving = 100;
+static gint     tracks = 3;
+static gint     frames = 20;
+static gint     width = 1600;
+static gint     height = 800;
+
+static GOptionEntry options[] = {
+    {"sats", 's', 0, G_OPTION_ARG_INT, &numsats,
+     "Number of satellites on the map", "N"},
+    {"moving", 'm', 0, G_OPTION_ARG_INT, &moving,
+     "Number of satellites that move in each refresh", "N"},
+    {"tracks", 't', 0, G_OPTION_ARG_INT, &tracks,
+     "Number of satellites showing a ground track", "N"},
+    {"frames", 'n', 0, G_OPTION_ARG_INT, &frames,
+     "Number of frames to time", "N"},
+    {"width", 'W', 0, G_OPTION_ARG_INT, &width, "Map width", "PIXELS"},
+    {"height", 'H', 0, G_OPTION_ARG_INT, &height, "Map height", "PIXELS"},
+    {NULL, 0, 0, 0, NULL, NULL, NULL}
+};
+
+
+/* The benchmark has no module configuration; use the global defaults. */
+gint mod_cfg_get_int(GKeyFile * f, const gchar * sec, const gchar * key,
+                     sat_cfg_int_e p)
+{
+    (void)f;
+    (void)sec;
+    (void)key;
+
+    switch (p)
+    {
+    case SAT_CFG_INT_MAP_SAT_COL:
+        return 0xF0F000FF;
+    case SAT_CFG_INT_MAP_SAT_SEL_COL:
+        return 0xFFFFFFFF;
+    case SAT_CFG_INT_MAP_SAT_COV_COL:
+        return 0xFFFFFF1F;
+    case SAT_CFG_INT_MAP_TRACK_COL:
+        return 0xFF1200BB;
+    case SAT_CFG_INT_MAP_SHADOW_ALPHA:
+        return 0xDD;
+    default:
+        return 0;
+    }
+}
+
+static void lonlat_to_xy(gdouble lon, gdouble lat, gdouble * x, gdouble * y)
+{
+    *x = (lon + 180.0) * width / 360.0;
+    *y = (90.0 - lat) * height / 180.0;
+}
+
+/*
+ * Create the range circle of a satellite, simplified like on the map.
+ * Circles crossing the edge of the map, which the map splits in two,
+ * are left out.
+ */
+static GooCanvasPoints *create_circle(gdouble lat, gdouble lon,
+                                      gdouble footprint)
+{
+    GooCanvasPoints *points;
+    gdouble         clat[FOOTPRINT_POINTS], clon[FOOTPRINT_POINTS];
+    gdouble         coords[4 * FOOTPRINT_POINTS];
+    gdouble         xmin = G_MAXDOUBLE, xmax = -G_MAXDOUBLE;
+    gdouble         mlon;
+    guint           i, num;
+
+    footprint_half_circle(lat, lon, footprint, FALSE, clat, clon);
+
+    for (i = 0; i < FOOTPRINT_POINTS; i++)
+    {
+        /* second half mirrored on the meridian of the SSP */
+        mlon = 2.0 * lon - clon[i];
+        mlon -= 360.0 * floor((mlon + 180.0) / 360.0);
+        lonlat_to_xy(clon[i], clat[i], &coords[2 * i], &coords[2 * i + 1]);
+        lonlat_to_xy(mlon, clat[i],
+                     &coords[4 * FOOTPRINT_POINTS - 2 * i - 2],
+                     &coords[4 * FOOTPRINT_POINTS - 2 * i - 1]);
+    }
+
+    for (i = 0; i < 2 * FOOTPRINT_POINTS; i++)
+    {
+        xmin = MIN(xmin, coords[2 * i]);
+        xmax = MAX(xmax, coords[2 * i]);
+    }
+    if (xmax - xmin > width / 2)
+        return NULL;
+
+    num = map_tools_simplify(coords, 2 * FOOTPRINT_POINTS,
+                             SAT_MAP_LOD_TOLERANCE);
+    points = goo_canvas_points_new(num);
+    memcpy(points->coords, coords, 2 * num * sizeof(gdouble));
+
+    return points;
+}
+
+/* A sine shaped ground track over three orbits, split at the map edge. */
+static void create_track(GtkSatMap * satmap, sat_map_obj_t * obj, GRand * rnd)
+{
+    GooCanvasPoints *points;
+    gdouble         incl = g_rand_double_range(rnd, 20.0, 98.0);
+    gdouble         lon0 = g_rand_double_range(rnd, -180.0, 180.0);
+    gdouble         lon, lat;
+    gint            orbit, i;
+
+    for (orbit = 0; orbit < 3; orbit++)
+    {
+        points = goo_canvas_points_new(361);
+        for (i = 0; i <= 360; i++)
+        {
+            lon = -180.0 + i;
+            lat = incl * sin((lon - lon0 - 25.0 * orbit) * de2ra);
+            lonlat_to_xy(lon, CLAMP(lat, -90.0, 90.0), &points->coords[2 * i],
+                         &points->coords[2 * i + 1]);
+        }
+        points->num_points = map_tools_simplify(points->coords, 361,
+                                                SAT_MAP_LOD_TOLERANCE);
+        gtk_sat_map_render_add_track(satmap, obj, points);
+        goo_canvas_points_unref(points);
+    }
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_TRACK);
+}
+
+static GtkSatMap *create_map(void)
+{
+    GtkSatMap      *satmap = g_new0(GtkSatMap, 1);
+    GRand          *rnd = g_rand_new_with_seed(4532);
+    GooCanvasPoints *circle;
+    sat_map_obj_t  *obj;
+    sat_t          *sat;
+    gdouble         lat, lon, alt;
+    gint            i;
+
+    satmap->direct = TRUE;
+    satmap->dirty = cairo_region_create();
+    satmap->width = width;
+    satmap->height = height;
+    satmap->sats = g_hash_table_new_full(g_int_hash, g_int_equal, NULL,
+                                         g_free);
+    satmap->obj = g_hash_table_new_full(g_int_hash, g_int_equal, NULL,
+                                        g_free);
+
+    for (i = 0; i < numsats; i++)
+    {
+        sat = g_new0(sat_t, 1);
+        sat->tle.catnr = 10000 + i;
+        sat->nickname = g_strdup_printf("SAT-%d", sat->tle.catnr);
+        g_hash_table_insert(satmap->sats, &sat->tle.catnr, sat);
+
+        obj = g_new0(sat_map_obj_t, 1);
+        obj->catnum = sat->tle.catnr;
+        obj->showcov = TRUE;
+        obj->selected = (i == 0);
+        obj->label_shown = TRUE;
+        gtk_sat_map_render_init_obj(obj);
+        g_hash_table_insert(satmap->obj, &obj->catnum, obj);
+
+        /* altitude from 300 km to GEO, mostly LEO */
+        alt = 300.0 * pow(120.0, pow(g_rand_double(rnd), 2.0));
+        lat = g_rand_double_range(rnd, -80.0, 80.0);
+        lon = g_rand_double_range(rnd, -180.0, 180.0);
+        lonlat_to_xy(lon, lat, &obj->x, &obj->y);
+
+        circle = create_circle(lat, lon,
+                               2.0 * xkmper * acos(xkmper / (xkmper + alt)));
+        if (circle != NULL)
+        {
+            gtk_sat_map_render_set_coverage(satmap, obj, circle, NULL);
+            goo_canvas_points_unref(circle);
+        }
+
+        if (i < tracks)
+            create_track(satmap, obj, rnd);
+    }
+    g_rand_free(rnd);
+
+    return satmap;
+}
+
+static void free_map(GtkSatMap * satmap)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+
+    g_hash_table_iter_init(&iter, satmap->obj);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        gtk_sat_map_render_free_obj(SAT_MAP_OBJ(value));
+        gtk_sat_map_render_clear_track(satmap, SAT_MAP_OBJ(value));
+    }
+    g_hash_table_destroy(satmap->obj);
+
+    g_hash_table_iter_init(&iter, satmap->sats);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+        g_free(SAT(value)->nickname);
+    g_hash_table_destroy(satmap->sats);
+
+    cairo_region_destroy(satmap->dirty);
+    g_free(satmap);
+}
+
+/* Move a satellite and its range circle by dx,dy pixels */
+static void move_sat(GtkSatMap * satmap, sat_map_obj_t * obj,
+                     gdouble dx, gdouble dy)
+{
+    GooCanvasPoints *circle;
+    gint            i;
+
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER);
+    obj->x = fmod(obj->x + dx + width, width);
+    obj->y = CLAMP(obj->y + dy, 0.0, height);
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER);
+
+    if (obj->cov[0] == NULL)
+        return;
+
+    /* the map creates new points for each update of a range circle */
+    circle = goo_canvas_points_new(obj->cov[0]->num_points);
+    for (i = 0; i < circle->num_points; i++)
+    {
+        circle->coords[2 * i] = obj->cov[0]->coords[2 * i] + dx;
+        circle->coords[2 * i + 1] = obj->cov[0]->coords[2 * i + 1] + dy;
+    }
+    gtk_sat_map_render_set_coverage(satmap, obj, circle, NULL);
+    goo_canvas_points_unref(circle);
+}
+
+/* Repaint the dirty region; returns the repainted area in pixels */
+static gdouble repaint(GtkSatMap * satmap, cairo_t * cr)
+{
+    cairo_rectangle_int_t rect;
+    gdouble         area = 0.0;
+    gint            i, n;
+
+    n = cairo_region_num_rectangles(satmap->dirty);
+    if (n == 0)
+        return 0.0;
+
+    cairo_save(cr);
+    for (i = 0; i < n; i++)
+    {
+        cairo_region_get_rectangle(satmap->dirty, i, &rect);
+        cairo_rectangle(cr, rect.x, rect.y, rect.width, rect.height);
+        area += (gdouble) rect.width * rect.height;
+    }
+    cairo_clip(cr);
+
+    /* stands in for the map drawn by the canvas */
+    cairo_set_source_rgb(cr, 0.1, 0.2, 0.4);
+    cairo_paint(cr);
+    gtk_sat_map_render_frame(satmap, cr);
+    cairo_restore(cr);
+
+    cairo_region_destroy(satmap->dirty);
+    satmap->dirty = cairo_region_create();
+
+    return area;
+}
+
+int main(int argc, char *argv[])
+{
+    GOptionContext *context;
+    GError         *err = NULL;
+    GtkSatMap      *satmap;
+    GList          *objs, *o;
+    cairo_surface_t *surface;
+    cairo_t        *cr;
+    cairo_status_t  status;
+    GRand          *rnd;
+    gint64          t;
+    gdouble         tfull, ttick, area = 0.0;
+    gint            i, j;
+
+    context = g_option_context_new(NULL);
+    g_option_context_set_summary(context,
+                                 "Benchmark for the direct map renderer.");
+    g_option_context_add_main_entries(context, options, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &err))
+    {
+        g_printerr("%s\n", err->message);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(context);
+
+    numsats = MAX(numsats, 1);
+    moving = CLAMP(moving, 0, numsats);
+    frames = MAX(frames, 1);
+    width = MAX(width, 100);
+    height = MAX(height, 50);
+
+    satmap = create_map();
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cr = cairo_create(surface);
+
+    /* the first frame measures the labels */
+    gtk_sat_map_render_queue_all(satmap);
+    repaint(satmap, cr);
+
+    t = g_get_monotonic_time();
+    for (i = 0; i < frames; i++)
+    {
+        gtk_sat_map_render_queue_all(satmap);
+        repaint(satmap, cr);
+    }
+    tfull = (gdouble) (g_get_monotonic_time() - t) / frames / 1000.0;
+
+    rnd = g_rand_new_with_seed(2017);
+    objs = g_hash_table_get_values(satmap->obj);
+    t = g_get_monotonic_time();
+    for (i = 0; i < frames; i++)
+    {
+        for (j = 0, o = objs; j < moving && o != NULL; j++, o = o->next)
+            move_sat(satmap, SAT_MAP_OBJ(o->data),
+                     g_rand_double_range(rnd, -3.0, 3.0),
+                     g_rand_double_range(rnd, -1.0, 1.0));
+        area += repaint(satmap, cr);
+    }
+    ttick = (gdouble) (g_get_monotonic_time() - t) / frames / 1000.0;
+    g_list_free(objs);
+    g_rand_free(rnd);
+
+    g_print("%d satellites on a %dx%d map, %d moving\n",
+            numsats, width, height, moving);
+    g_print("full frame %8.2f ms\n", tfull);
+    g_print("refresh    %8.2f ms, %.1f%% of the map repainted\n", ttick,
+            100.0 * area / frames / ((gdouble) width * height));
+
+    status = cairo_status(cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    free_map(satmap);
+
+    return (status == CAIRO_STATUS_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,574 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/**
+ * Direct rendering of the satellites on the map.
+ *
+ * With a few thousand satellites the canvas items of the map become the
+ * bottleneck: every satellite owns up to six item models, and every property
+ * change of one of them invalidates the scene graph. When direct rendering
+ * is enabled the canvas only holds the static background (map, grid,
+ * terminator, QTH and info texts). Markers, labels, range circles and ground
+ * tracks are painted with Cairo in one pass over the satellite objects,
+ * after the canvas has drawn the background.
+ *
+ * Changes are collected as rectangles in satmap->dirty and handed to GTK
+ * in one go by gtk_sat_map_render_flush(), so that a refresh only repaints
+ * the parts of the map where something has moved.
+ *
+ * @note These functions should only be called from gtk-sat-map.c,
+ *       gtk-sat-map-ground-track.c and gtk-sat-map-popup.c.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "config-keys.h"
+#include "gtk-sat-map-render.h"
+#include "mod-cfg-get-param.h"
+#include "sat-cfg.h"
+
+
+#define RENDER_FONT_SIZE   10.7 /* "Sans 8" used by the canvas labels */
+#define RENDER_LABEL_WIDTH 100  /* guess until a label has been drawn */
+#define RENDER_MARGIN      3    /* line width and shadow around a box */
+#define RENDER_MAX_RECTS   128  /* redraw the whole map beyond this */
+
+/** Colours and clip area of the frame being drawn. */
+typedef struct {
+    guint32         col;        /*!< Satellite colour */
+    guint32         selcol;     /*!< Colour of the selected satellite */
+    guint32         covcol;     /*!< Coverage area colour */
+    guint32         trackcol;   /*!< Ground track colour */
+    guint32         shadowcol;  /*!< Shadow colour */
+    cairo_font_extents_t font;  /*!< Label font metrics */
+    GdkRectangle    clip;       /*!< Area to redraw */
+} frame_t;
+
+
+static void set_colour(cairo_t * cr, guint32 col)
+{
+    cairo_set_source_rgba(cr,
+                          ((col >> 24) & 0xFF) / 255.0,
+                          ((col >> 16) & 0xFF) / 255.0,
+                          ((col >> 8) & 0xFF) / 255.0,
+                          (col & 0xFF) / 255.0);
+}
+
+/* Set box to the integer bounding box of a set of points, plus margin. */
+static void points_box(GooCanvasPoints ** points, guint n, GdkRectangle * box)
+{
+    gdouble         xmin = G_MAXDOUBLE, ymin = G_MAXDOUBLE;
+    gdouble         xmax = -G_MAXDOUBLE, ymax = -G_MAXDOUBLE;
+    gdouble        *c;
+    guint           i;
+    gint            j;
+
+    for (i = 0; i < n; i++)
+    {
+        if (points[i] == NULL)
+            continue;
+
+        c = points[i]->coords;
+        for (j = 0; j < points[i]->num_points; j++)
+        {
+            xmin = MIN(xmin, c[2 * j]);
+            xmax = MAX(xmax, c[2 * j]);
+            ymin = MIN(ymin, c[2 * j + 1]);
+            ymax = MAX(ymax, c[2 * j + 1]);
+        }
+    }
+
+    if (xmin > xmax)
+    {
+        box->x = box->y = box->width = box->height = 0;
+        return;
+    }
+
+    box->x = (gint) floor(xmin) - RENDER_MARGIN;
+    box->y = (gint) floor(ymin) - RENDER_MARGIN;
+    box->width = (gint) ceil(xmax) + RENDER_MARGIN - box->x;
+    box->height = (gint) ceil(ymax) + RENDER_MARGIN - box->y;
+}
+
+/**
+ * Get the position of a label.
+ *
+ * @param w Width of the label.
+ * @param h Height of the label.
+ * @param lx Returns the left edge of the label.
+ * @param ly Returns the top edge of the label.
+ *
+ * The label is placed like the canvas label in update_sat(): below the
+ * marker, or beside or above it near the edges of the map.
+ */
+static void label_pos(GtkSatMap * satmap, sat_map_obj_t * obj,
+                      gdouble w, gdouble h, gdouble * lx, gdouble * ly)
+{
+    if (obj->x < 50)
+    {
+        *lx = obj->x + 3;
+        *ly = obj->y - h / 2;
+    }
+    else if ((satmap->width - obj->x) < 50)
+    {
+        *lx = obj->x - 3 - w;
+        *ly = obj->y - h / 2;
+    }
+    else if ((satmap->height - obj->y) < 25)
+    {
+        *lx = obj->x - w / 2;
+        *ly = obj->y - 2 - h;
+    }
+    else
+    {
+        *lx = obj->x - w / 2;
+        *ly = obj->y + 2;
+    }
+}
+
+/* Get the box covered by the marker and the label of a satellite. */
+static void marker_box(GtkSatMap * satmap, sat_map_obj_t * obj,
+                       gdouble w, gdouble h, GdkRectangle * box)
+{
+    GdkRectangle    label;
+    gdouble         lx, ly;
+
+    box->x = (gint) floor(obj->x) - RENDER_MARGIN;
+    box->y = (gint) floor(obj->y) - RENDER_MARGIN;
+    box->width = box->height = 2 * RENDER_MARGIN + 1;
+
+    label_pos(satmap, obj, w, h, &lx, &ly);
+    label.x = (gint) floor(lx) - 1;
+    label.y = (gint) floor(ly) - 1;
+    label.width = (gint) ceil(w) + RENDER_MARGIN;
+    label.height = (gint) ceil(h) + RENDER_MARGIN;
+
+    gdk_rectangle_union(box, &label, box);
+}
+
+/*
+ * Get the width of a label, measuring it if it is not known yet.
+ *
+ * The text is measured on a context of its own, so that labels can be
+ * placed before they are drawn and whether they are drawn or not.
+ */
+static gdouble label_width(GtkSatMap * satmap, sat_map_obj_t * obj)
+{
+    static cairo_t *measure = NULL;
+    cairo_surface_t *surface;
+    cairo_text_extents_t ext;
+    sat_t          *sat;
+
+    if (obj->label_w > 0.0)
+        return obj->label_w;
+
+    sat = g_hash_table_lookup(satmap->sats, &obj->catnum);
+    if (sat == NULL)
+        return RENDER_LABEL_WIDTH;
+
+    if (measure == NULL)
+    {
+        surface = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+        measure = cairo_create(surface);
+        cairo_surface_destroy(surface);
+        cairo_select_font_face(measure, "Sans", CAIRO_FONT_SLANT_NORMAL,
+                               CAIRO_FONT_WEIGHT_NORMAL);
+        cairo_set_font_size(measure, RENDER_FONT_SIZE);
+    }
+
+    cairo_text_extents(measure, sat->nickname, &ext);
+    obj->label_w = MAX(ext.x_advance, 1.0);
+
+    return obj->label_w;
+}
+
+/* Height of a label; a bit more than the ascent and descent of the font. */
+static gdouble label_height(void)
+{
+    return ceil(1.2 * RENDER_FONT_SIZE);
+}
+
+static void queue_rect(GtkSatMap * satmap, const GdkRectangle * rect)
+{
+    cairo_rectangle_int_t map;
+
+    if (rect->width <= 0 || rect->height <= 0)
+        return;
+
+    if (cairo_region_num_rectangles(satmap->dirty) < RENDER_MAX_RECTS)
+    {
+        cairo_region_union_rectangle(satmap->dirty, rect);
+    }
+    else
+    {
+        /* merging more rectangles costs more than it saves */
+        map.x = 0;
+        map.y = 0;
+        map.width = satmap->x0 + satmap->width + RENDER_MARGIN;
+        map.height = satmap->y0 + satmap->height + RENDER_MARGIN;
+        cairo_region_union_rectangle(satmap->dirty, &map);
+    }
+}
+
+/** Initialise the direct rendering fields of a new satellite object. */
+void gtk_sat_map_render_init_obj(sat_map_obj_t * obj)
+{
+    obj->cov[0] = NULL;
+    obj->cov[1] = NULL;
+    memset(&obj->cov_box, 0, sizeof(GdkRectangle));
+    memset(&obj->track_box, 0, sizeof(GdkRectangle));
+}
+
+/**
+ * Free the range circle of a satellite object.
+ *
+ * The ground track is freed by ground_track_delete().
+ */
+void gtk_sat_map_render_free_obj(sat_map_obj_t * obj)
+{
+    if (obj->cov[0] != NULL)
+        goo_canvas_points_unref(obj->cov[0]);
+    if (obj->cov[1] != NULL)
+        goo_canvas_points_unref(obj->cov[1]);
+
+    obj->cov[0] = NULL;
+    obj->cov[1] = NULL;
+}
+
+/**
+ * Replace the range circle of a satellite.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param obj The satellite object.
+ * @param points1 The first part of the range circle.
+ * @param points2 The second part of the range circle or NULL.
+ *
+ * The points are referenced, not copied. Both the old and the new range
+ * circle are queued for redrawing.
+ */
+void gtk_sat_map_render_set_coverage(GtkSatMap * satmap, sat_map_obj_t * obj,
+                                     GooCanvasPoints * points1,
+                                     GooCanvasPoints * points2)
+{
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_COVERAGE);
+    gtk_sat_map_render_free_obj(obj);
+
+    obj->cov[0] = goo_canvas_points_ref(points1);
+    obj->cov[1] = (points2 != NULL) ? goo_canvas_points_ref(points2) : NULL;
+    points_box(obj->cov, 2, &obj->cov_box);
+
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_COVERAGE);
+}
+
+/**
+ * Add a part of the ground track of a satellite.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param obj The satellite object.
+ * @param points The map coordinates of the part; referenced, not copied.
+ *
+ * The parts are stored in obj->track_data.lines. The caller queues the
+ * track for redrawing once all parts have been added.
+ */
+void gtk_sat_map_render_add_track(GtkSatMap * satmap, sat_map_obj_t * obj,
+                                  GooCanvasPoints * points)
+{
+    GdkRectangle    box;
+
+    (void)satmap;
+
+    obj->track_data.lines = g_slist_prepend(obj->track_data.lines,
+                                            goo_canvas_points_ref(points));
+    points_box(&points, 1, &box);
+
+    if (obj->track_box.width > 0)
+        gdk_rectangle_union(&obj->track_box, &box, &obj->track_box);
+    else
+        obj->track_box = box;
+}
+
+/** Remove the ground track of a satellite and queue its area for redrawing. */
+void gtk_sat_map_render_clear_track(GtkSatMap * satmap, sat_map_obj_t * obj)
+{
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_TRACK);
+
+    g_slist_free_full(obj->track_data.lines,
+                      (GDestroyNotify) goo_canvas_points_unref);
+    obj->track_data.lines = NULL;
+    memset(&obj->track_box, 0, sizeof(GdkRectangle));
+}
+
+/**
+ * Queue parts of a satellite object for redrawing.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param obj The satellite object.
+ * @param parts Bitwise or of SAT_MAP_RENDER_MARKER, SAT_MAP_RENDER_COVERAGE
+ *              and SAT_MAP_RENDER_TRACK.
+ *
+ * The area that the parts currently cover is added to the dirty region. To
+ * move or change a part it must be queued both before and after the change.
+ */
+void gtk_sat_map_render_queue(GtkSatMap * satmap, sat_map_obj_t * obj,
+                              guint parts)
+{
+    GdkRectangle    box;
+
+    if (!satmap->direct)
+        return;
+
+    if (parts & SAT_MAP_RENDER_MARKER)
+    {
+        marker_box(satmap, obj, label_width(satmap, obj), label_height(),
+                   &box);
+        queue_rect(satmap, &box);
+    }
+
+    if ((parts & SAT_MAP_RENDER_COVERAGE) && obj->cov[0] != NULL)
+        queue_rect(satmap, &obj->cov_box);
+
+    if ((parts & SAT_MAP_RENDER_TRACK) && obj->track_data.lines != NULL)
+        queue_rect(satmap, &obj->track_box);
+}
+
+/** Queue the whole map for redrawing. */
+void gtk_sat_map_render_queue_all(GtkSatMap * satmap)
+{
+    cairo_rectangle_int_t map;
+
+    if (!satmap->direct)
+        return;
+
+    map.x = 0;
+    map.y = 0;
+    map.width = satmap->x0 + satmap->width + RENDER_MARGIN;
+    map.height = satmap->y0 + satmap->height + RENDER_MARGIN;
+    cairo_region_union_rectangle(satmap->dirty, &map);
+}
+
+/** Ask GTK to redraw the queued area of the map. */
+void gtk_sat_map_render_flush(GtkSatMap * satmap)
+{
+    if (!satmap->direct || cairo_region_is_empty(satmap->dirty))
+        return;
+
+    gtk_widget_queue_draw_region(satmap->canvas, satmap->dirty);
+    cairo_region_destroy(satmap->dirty);
+    satmap->dirty = cairo_region_create();
+}
+
+static void add_polyline(cairo_t * cr, GooCanvasPoints * points)
+{
+    gint            i;
+
+    cairo_move_to(cr, points->coords[0], points->coords[1]);
+    for (i = 1; i < points->num_points; i++)
+        cairo_line_to(cr, points->coords[2 * i], points->coords[2 * i + 1]);
+}
+
+static void draw_coverage(cairo_t * cr, const frame_t * f,
+                          sat_map_obj_t * obj)
+{
+    guint           i;
+
+    if (obj->cov[0] == NULL ||
+        !gdk_rectangle_intersect(&obj->cov_box, &f->clip, NULL))
+        return;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (obj->cov[i] == NULL || obj->cov[i]->num_points < 2)
+            continue;
+
+        add_polyline(cr, obj->cov[i]);
+        if (obj->showcov && (f->covcol & 0xFF))
+        {
+            set_colour(cr, f->covcol);
+            cairo_fill_preserve(cr);
+        }
+        set_colour(cr, obj->selected ? f->selcol : f->col);
+        cairo_stroke(cr);
+    }
+}
+
+static void draw_track(cairo_t * cr, const frame_t * f, sat_map_obj_t * obj)
+{
+    GSList         *part;
+
+    if (obj->track_data.lines == NULL ||
+        !gdk_rectangle_intersect(&obj->track_box, &f->clip, NULL))
+        return;
+
+    for (part = obj->track_data.lines; part != NULL; part = part->next)
+        add_polyline(cr, (GooCanvasPoints *) part->data);
+
+    set_colour(cr, f->trackcol);
+    cairo_stroke(cr);
+}
+
+static void draw_marker(GtkSatMap * satmap, cairo_t * cr, const frame_t * f,
+                        sat_map_obj_t * obj)
+{
+    GdkRectangle    box;
+    sat_t          *sat;
+    gdouble         w = label_width(satmap, obj);
+    gdouble         h = label_height();
+    gdouble         lx, ly;
+    guint32         col = obj->selected ? f->selcol : f->col;
+
+    marker_box(satmap, obj, w, h, &box);
+    if (!gdk_rectangle_intersect(&box, &f->clip, NULL))
+        return;
+
+    /* marker and its shadow; the canvas draws them with 2 px lines */
+    cairo_set_line_width(cr, 2.0);
+    cairo_rectangle(cr, obj->x, obj->y, 2.0, 2.0);
+    set_colour(cr, f->shadowcol);
+    cairo_stroke(cr);
+    cairo_rectangle(cr, obj->x - 1.0, obj->y - 1.0, 2.0, 2.0);
+    set_colour(cr, col);
+    cairo_fill_preserve(cr);
+    cairo_stroke(cr);
+    cairo_set_line_width(cr, 1.0);
+
+    sat = g_hash_table_lookup(satmap->sats, &obj->catnum);
+    if (sat == NULL || !obj->label_shown)
+        return;
+
+    label_pos(satmap, obj, w, h, &lx, &ly);
+
+    set_colour(cr, f->shadowcol);
+    cairo_move_to(cr, lx + 1.0, ly + 1.0 + f->font.ascent);
+    cairo_show_text(cr, sat->nickname);
+    set_colour(cr, col);
+    cairo_move_to(cr, lx, ly + f->font.ascent);
+    cairo_show_text(cr, sat->nickname);
+}
+
+/**
+ * Draw the satellites.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param cr The Cairo context in canvas coordinates, clipped to the area
+ *           that needs to be redrawn.
+ *
+ * Range circles and ground tracks are drawn first, so that they never hide
+ * a marker or a label. Objects outside the clip area are skipped.
+ */
+void gtk_sat_map_render_frame(GtkSatMap * satmap, cairo_t * cr)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+    frame_t         f;
+
+    if (!gdk_cairo_get_clip_rectangle(cr, &f.clip))
+        return;
+
+    f.col = mod_cfg_get_int(satmap->cfgdata, MOD_CFG_MAP_SECTION,
+                            MOD_CFG_MAP_SAT_COL, SAT_CFG_INT_MAP_SAT_COL);
+    f.selcol = mod_cfg_get_int(satmap->cfgdata, MOD_CFG_MAP_SECTION,
+                               MOD_CFG_MAP_SAT_SEL_COL,
+                               SAT_CFG_INT_MAP_SAT_SEL_COL);
+    f.covcol = mod_cfg_get_int(satmap->cfgdata, MOD_CFG_MAP_SECTION,
+                               MOD_CFG_MAP_SAT_COV_COL,
+                               SAT_CFG_INT_MAP_SAT_COV_COL);
+    f.trackcol = mod_cfg_get_int(satmap->cfgdata, MOD_CFG_MAP_SECTION,
+                                 MOD_CFG_MAP_TRACK_COL,
+                                 SAT_CFG_INT_MAP_TRACK_COL);
+    f.shadowcol = mod_cfg_get_int(satmap->cfgdata, MOD_CFG_MAP_SECTION,
+                                  MOD_CFG_MAP_SHADOW_ALPHA,
+                                  SAT_CFG_INT_MAP_SHADOW_ALPHA);
+
+    cairo_save(cr);
+    cairo_set_line_width(cr, 1.0);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+    cairo_set_line_join(cr, CAIRO_LINE_JOIN_MITER);
+
+    g_hash_table_iter_init(&iter, satmap->obj);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        draw_coverage(cr, &f, SAT_MAP_OBJ(value));
+        draw_track(cr, &f, SAT_MAP_OBJ(value));
+    }
+
+    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
+                           CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, RENDER_FONT_SIZE);
+    cairo_font_extents(cr, &f.font);
+
+    g_hash_table_iter_init(&iter, satmap->obj);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+        draw_marker(satmap, cr, &f, SAT_MAP_OBJ(value));
+
+    cairo_restore(cr);
+}
+
+/**
+ * Draw signal handler of the canvas, connected after the canvas handler.
+ *
+ * The satellites are drawn on the canvas window, on top of the background
+ * that the canvas has just drawn there. The map is never scrolled or zoomed,
+ * so canvas units are pixels of the canvas window.
+ */
+gboolean gtk_sat_map_render_draw(GtkWidget * widget, cairo_t * cr,
+                                 gpointer data)
+{
+    GdkWindow      *window = GOO_CANVAS(widget)->canvas_window;
+
+    if (!gtk_cairo_should_draw_window(cr, window))
+        return FALSE;
+
+    cairo_save(cr);
+    gtk_cairo_transform_to_window(cr, widget, window);
+    gtk_sat_map_render_frame((GtkSatMap *) data, cr);
+    cairo_restore(cr);
+
+    return FALSE;
+}
+
+/**
+ * Get the box of a satellite label.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param obj The satellite object.
+ * @param x Returns the left edge of the label.
+ * @param y Returns the top edge of the label.
+ * @param w Returns the width of the label.
+ * @param h Returns the height of the label.
+ *
+ * The box is the same for canvas labels and for labels drawn here, so it
+ * can be used to declutter both.
+ */
+void gtk_sat_map_render_label_box(GtkSatMap * satmap, sat_map_obj_t * obj,
+                                  gdouble * x, gdouble * y,
+                                  gdouble * w, gdouble * h)
+{
+    *w = label_width(satmap, obj);
+    *h = label_height();
+    label_pos(satmap, obj, *w, *h, x, y);
+}
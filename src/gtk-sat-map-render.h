@@ -0,0 +1,65 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef GTK_SAT_MAP_RENDER_H
+#define GTK_SAT_MAP_RENDER_H 1
+
+#include <cairo.h>
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include "gtk-sat-map.h"
+
+/* Parts of a satellite object that can be invalidated */
+#define SAT_MAP_RENDER_MARKER     (1 << 0)      /*!< Marker and label */
+#define SAT_MAP_RENDER_COVERAGE   (1 << 1)      /*!< Range circle */
+#define SAT_MAP_RENDER_TRACK      (1 << 2)      /*!< Ground track */
+#define SAT_MAP_RENDER_ALL        0x07
+
+void            gtk_sat_map_render_init_obj(sat_map_obj_t * obj);
+void            gtk_sat_map_render_free_obj(sat_map_obj_t * obj);
+void            gtk_sat_map_render_set_coverage(GtkSatMap * satmap,
+                                                sat_map_obj_t * obj,
+                                                GooCanvasPoints * points1,
+                                                GooCanvasPoints * points2);
+void            gtk_sat_map_render_add_track(GtkSatMap * satmap,
+                                             sat_map_obj_t * obj,
+                                             GooCanvasPoints * points);
+void            gtk_sat_map_render_clear_track(GtkSatMap * satmap,
+                                               sat_map_obj_t * obj);
+
+void            gtk_sat_map_render_queue(GtkSatMap * satmap,
+                                         sat_map_obj_t * obj, guint parts);
+void            gtk_sat_map_render_queue_all(GtkSatMap * satmap);
+void            gtk_sat_map_render_flush(GtkSatMap * satmap);
+
+void            gtk_sat_map_render_frame(GtkSatMap * satmap, cairo_t * cr);
+gboolean        gtk_sat_map_render_draw(GtkWidget * widget, cairo_t * cr,
+                                        gpointer data);
+void            gtk_sat_map_render_label_box(GtkSatMap * satmap,
+                                             sat_map_obj_t * obj,
+                                             gdouble * x, gdouble * y,
+                                             gdouble * w, gdouble * h);
+
+#endif
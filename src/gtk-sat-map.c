@@ -30,9 +30,11 @@
 
 #include "compat.h"
 #include "config-keys.h"
+#include "footprint.h"
 #include "gpredict-utils.h"
 #include "gtk-sat-data.h"
 #include "gtk-sat-map-popup.h"
+#include "gtk-sat-map-render.h"
 #include "gtk-sat-map-ground-track.h"
 #include "gtk-sat-map.h"
 #include "locator.h"
@@ -48,6 +50,15 @@
 
 #define MARKER_SIZE_HALF    1
 
+/* Smallest change of a range circle in pixels that triggers a redraw */
+#define FOOTPRINT_MIN_MOVE  (2 * MARKER_SIZE_HALF)
+
+/* Largest distance of a click to a marker in pixels */
+#define HIT_RADIUS          4.0
+
+/* Cell size of the marker and label grids in pixels */
+#define GRID_CELL           64.0
+
 /* Update terminator every 30 seconds */
 #define TERMINATOR_UPDATE_INTERVAL (15.0/86400.0)
 
@@ -59,8 +70,13 @@ static void     gtk_sat_map_destroy(GtkWidget * widget);
 static void     size_allocate_cb(GtkWidget * widget,
                                  GtkAllocation * allocation, gpointer data);
 static void     update_map_size(GtkSatMap * satmap);
+static void     count_vertices(gpointer key, gpointer value, gpointer data);
 static void     update_sat(gpointer key, gpointer value, gpointer data);
+static void     update_range_items(GtkSatMap * satmap, sat_map_obj_t * obj);
 static void     plot_sat(gpointer key, gpointer value, gpointer data);
+static void     create_marker_items(GtkSatMap * satmap, sat_map_obj_t * obj,
+                                    sat_t * sat, gfloat x, gfloat y);
+static void     create_range_items(GtkSatMap * satmap, sat_map_obj_t * obj);
 static void     free_sat_obj(gpointer key, gpointer value, gpointer data);
 static void     lonlat_to_xy(GtkSatMap * m, gdouble lon, gdouble lat,
                              gfloat * x, gfloat * y);
@@ -71,22 +87,33 @@ static gboolean on_motion_notify(GooCanvasItem * item, GooCanvasItem * target,
 static void     on_item_created(GooCanvas * canvas, GooCanvasItem * item,
                                 GooCanvasItemModel * model, gpointer data);
 static void     on_canvas_realized(GtkWidget * canvas, gpointer data);
-static gboolean on_button_press(GooCanvasItem * item,
-                                GooCanvasItem * target,
-                                GdkEventButton * event, gpointer data);
-static gboolean on_button_release(GooCanvasItem * item,
-                                  GooCanvasItem * target,
-                                  GdkEventButton * event, gpointer data);
+static gboolean on_canvas_button_press(GtkWidget * widget,
+                                       GdkEventButton * event, gpointer data);
+static gboolean on_canvas_button_release(GtkWidget * widget,
+                                         GdkEventButton * event,
+                                         gpointer data);
+static gboolean on_query_tooltip(GtkWidget * widget, gint x, gint y,
+                                 gboolean keyboard_mode, GtkTooltip * tooltip,
+                                 gpointer data);
+static void     sat_button_press(GtkSatMap * satmap, gint catnum,
+                                 GdkEventButton * event);
+static void     sat_button_release(GtkSatMap * satmap, gint catnum,
+                                   GdkEventButton * event);
+static void     set_sat_colour(sat_map_obj_t * obj, guint32 col);
+static void     index_sats(GtkSatMap * satmap);
+static void     place_label(GtkSatMap * satmap, sat_map_obj_t * obj);
+static sat_map_obj_t *find_sat(GtkSatMap * satmap, gdouble x, gdouble y);
 static void     clear_selection(gpointer key, gpointer val, gpointer data);
 static void     load_map_file(GtkSatMap * satmap, float clon);
 static GooCanvasItemModel *create_canvas_model(GtkSatMap * satmap);
-static gdouble  arccos(gdouble, gdouble);
-static gboolean pole_is_covered(sat_t * sat);
 static gboolean north_pole_is_covered(sat_t * sat);
 static gboolean south_pole_is_covered(sat_t * sat);
 static gboolean mirror_lon(sat_t * sat, gdouble rangelon, gdouble * mlon,
                            gdouble mapbreak);
 static guint    calculate_footprint(GtkSatMap * satmap, sat_t * sat);
+static void     simplify_footprint(sat_map_obj_t * obj);
+static gboolean footprint_moved(GtkSatMap * satmap, sat_map_obj_t * obj,
+                                sat_t * sat);
 static void     split_points(GtkSatMap * satmap, sat_t * sat, gdouble sspx);
 static void     sort_points_x(GtkSatMap * satmap, sat_t * sat,
                               GooCanvasPoints * points, gint num);
@@ -102,12 +129,22 @@ static void     redraw_grid_lines(GtkSatMap * satmap);
 static void     draw_terminator(GtkSatMap * satmap, GooCanvasItemModel * root);
 static void     redraw_terminator(GtkSatMap * satmap);
 static gchar   *aoslos_time_to_str(GtkSatMap * satmap, sat_t * sat);
+static gchar   *sat_tooltip(GtkSatMap * satmap, sat_t * sat);
 static void     gtk_sat_map_load_showtracks(GtkSatMap * map);
 static void     gtk_sat_map_store_showtracks(GtkSatMap * satmap);
 static void     gtk_sat_map_load_hide_coverages(GtkSatMap * map);
 static void     gtk_sat_map_store_hidecovs(GtkSatMap * satmap);
 static void     reset_ground_track(gpointer key, gpointer value,
                                    gpointer user_data);
+static void     update_label(gpointer key, gpointer value, gpointer data);
+
+/* Points of the map objects on the canvas, and before simplification */
+typedef struct {
+    guint           track;
+    guint           track_raw;
+    guint           cov;
+    guint           cov_raw;
+} vertex_count_t;
 
 static GtkVBoxClass *parent_class = NULL;
 static GooCanvasPoints *points1;
@@ -181,6 +218,11 @@ static void gtk_sat_map_init(GtkSatMap * satmap,
     satmap->showgrid = FALSE;
     satmap->keepratio = FALSE;
     satmap->resize = FALSE;
+    satmap->direct = FALSE;
+    satmap->dirty = NULL;
+    satmap->declutter = FALSE;
+    satmap->markers = NULL;
+    satmap->labels = NULL;
 }
 
 static void gtk_sat_map_destroy(GtkWidget * widget)
@@ -201,6 +243,17 @@ static void gtk_sat_map_destroy(GtkWidget * widget)
         g_hash_table_destroy(satmap->obj);
         satmap->obj = NULL;
 
+        if (satmap->dirty != NULL)
+        {
+            cairo_region_destroy(satmap->dirty);
+            satmap->dirty = NULL;
+        }
+
+        screen_grid_free(satmap->markers);
+        satmap->markers = NULL;
+        screen_grid_free(satmap->labels);
+        satmap->labels = NULL;
+
         /* these objects destruct themselves cleanly */
         g_object_unref(satmap->origmap);
         satmap->origmap = NULL;
@@ -330,6 +383,17 @@ GtkWidget      *gtk_sat_map_new(GKeyFile * cfgdata, GHashTable * sats,
                                          MOD_CFG_MAP_SECTION,
                                          MOD_CFG_MAP_KEEP_RATIO,
                                          SAT_CFG_BOOL_MAP_KEEP_RATIO);
+
+    satmap->direct = mod_cfg_get_bool(cfgdata,
+                                      MOD_CFG_MAP_SECTION,
+                                      MOD_CFG_MAP_DIRECT_RENDER,
+                                      SAT_CFG_BOOL_MAP_DIRECT_RENDER);
+    satmap->declutter = mod_cfg_get_bool(cfgdata,
+                                         MOD_CFG_MAP_SECTION,
+                                         MOD_CFG_MAP_DECLUTTER,
+                                         SAT_CFG_BOOL_MAP_DECLUTTER);
+    satmap->markers = screen_grid_new(GRID_CELL);
+    satmap->labels = screen_grid_new(GRID_CELL);
     col = mod_cfg_get_int(cfgdata,
                           MOD_CFG_MAP_SECTION,
                           MOD_CFG_MAP_INFO_BGD_COL,
@@ -367,6 +431,22 @@ GtkWidget      *gtk_sat_map_new(GKeyFile * cfgdata, GHashTable * sats,
     g_signal_connect_after(satmap->canvas, "realize",
                            (GCallback) on_canvas_realized, satmap);
 
+    /* satellites are picked by position before the canvas picks items */
+    g_signal_connect(satmap->canvas, "button-press-event",
+                     G_CALLBACK(on_canvas_button_press), satmap);
+    g_signal_connect(satmap->canvas, "button-release-event",
+                     G_CALLBACK(on_canvas_button_release), satmap);
+    g_signal_connect(satmap->canvas, "query-tooltip",
+                     G_CALLBACK(on_query_tooltip), satmap);
+
+    /* satellites are drawn on top of the canvas */
+    if (satmap->direct)
+    {
+        satmap->dirty = cairo_region_create();
+        g_signal_connect_after(satmap->canvas, "draw",
+                               G_CALLBACK(gtk_sat_map_render_draw), satmap);
+    }
+
     gtk_widget_show(satmap->canvas);
 
     root = create_canvas_model(satmap);
@@ -511,6 +591,7 @@ static void size_allocate_cb(GtkWidget * widget, GtkAllocation * allocation,
 static void update_map_size(GtkSatMap * satmap)
 {
     GtkAllocation   allocation;
+    vertex_count_t  count;
     GdkPixbuf      *pbuf;
     gfloat          x, y;
     gfloat          ratio;      /* ratio between map width and height */
@@ -597,10 +678,33 @@ static void update_map_size(GtkSatMap * satmap)
                      "y", (gdouble) satmap->y0 + satmap->height - 1, NULL);
 
         g_hash_table_foreach(satmap->sats, update_sat, satmap);
+        index_sats(satmap);
         satmap->resize = FALSE;
+
+        memset(&count, 0, sizeof(count));
+        g_hash_table_foreach(satmap->obj, count_vertices, &count);
+        sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                    _("%s: %ux%u map shows %u of %u ground track points "
+                      "and %u of %u range circle points"), __func__,
+                    satmap->width, satmap->height, count.track,
+                    count.track_raw, count.cov, count.cov_raw);
     }
 }
 
+/** Add the canvas points of a satellite object to a vertex_count_t. */
+static void count_vertices(gpointer key, gpointer value, gpointer data)
+{
+    sat_map_obj_t  *obj = SAT_MAP_OBJ(value);
+    vertex_count_t *count = (vertex_count_t *) data;
+
+    (void)key;
+
+    count->track += obj->track_vertices;
+    count->track_raw += obj->track_data.num;
+    count->cov += obj->cov_vertices;
+    count->cov_raw += 2 * SAT_MAP_RANGE_CIRCLE_POINTS;
+}
+
 static void on_canvas_realized(GtkWidget * canvas, gpointer data)
 {
     GtkSatMap      *satmap = GTK_SAT_MAP(data);
@@ -670,6 +774,7 @@ void gtk_sat_map_update(GtkWidget * widget)
                      "y", (gdouble) satmap->y0 + 1, NULL);
 
         g_hash_table_foreach(satmap->sats, update_sat, satmap);
+        index_sats(satmap);
 
         /* Update the Solar Terminator if necessary */
         if (satmap->show_terminator &&
@@ -766,6 +871,8 @@ void gtk_sat_map_update(GtkWidget * widget)
             g_object_set(satmap->next, "text", "", NULL);
         }
     }
+
+    gtk_sat_map_render_flush(satmap);
 }
 
 /* Assumes that -180 <= lon <= 180 and -90 <= lat <= 90 */
@@ -833,10 +940,9 @@ static gboolean on_motion_notify(GooCanvasItem * item,
  * This function is called when a canvas item is created. Its purpose is to connect
  * the corresponding signals to the created items.
  *
- * The root item, ie the background is connected to motion notify event, while other
- * items (sats) are connected to mouse click events.
- *
- * @bug Should filter out QTH or do we want to click on the QTH?
+ * Only the root item, ie the background, is connected to motion notify event.
+ * Clicks and tooltips on satellites are handled by the canvas widget, see
+ * on_canvas_button_press() and on_query_tooltip().
  */
 static void on_item_created(GooCanvas * canvas,
                             GooCanvasItem * item,
@@ -849,28 +955,88 @@ static void on_item_created(GooCanvas * canvas,
         g_signal_connect(item, "motion_notify_event",
                          (GCallback) on_motion_notify, data);
     }
-    else if (!g_object_get_data(G_OBJECT(item), "skip-signal-connection"))
-    {
-        g_signal_connect(item, "button_press_event",
-                         (GCallback) on_button_press, data);
-        g_signal_connect(item, "button_release_event",
-                         (GCallback) on_button_release, data);
-    }
 }
 
-static gboolean on_button_press(GooCanvasItem * item,
-                                GooCanvasItem * target, GdkEventButton * event,
-                                gpointer data)
+/**
+ * Handle button press on the canvas.
+ *
+ * The satellite under the pointer is looked up in the marker and label
+ * grids, so GooCanvas does not have to pick it among all the items, and
+ * with direct rendering there are no items to pick. Clicks elsewhere go to
+ * the canvas.
+ */
+static gboolean on_canvas_button_press(GtkWidget * widget,
+                                       GdkEventButton * event, gpointer data)
+{
+    GtkSatMap      *satmap = GTK_SAT_MAP(data);
+    sat_map_obj_t  *obj;
+
+    (void)widget;
+
+    obj = find_sat(satmap, event->x, event->y);
+    if (obj == NULL)
+        return FALSE;
+
+    sat_button_press(satmap, obj->catnum, event);
+
+    return TRUE;
+}
+
+/** Handle button release on the canvas, see on_canvas_button_press(). */
+static gboolean on_canvas_button_release(GtkWidget * widget,
+                                         GdkEventButton * event,
+                                         gpointer data)
 {
-    GooCanvasItemModel *model = goo_canvas_item_get_model(item);
     GtkSatMap      *satmap = GTK_SAT_MAP(data);
-    gint            catnum =
-        GPOINTER_TO_INT(g_object_get_data(G_OBJECT(model), "catnum"));
+    sat_map_obj_t  *obj;
+
+    (void)widget;
+
+    obj = find_sat(satmap, event->x, event->y);
+    if (obj == NULL)
+        return FALSE;
+
+    sat_button_release(satmap, obj->catnum, event);
+
+    return TRUE;
+}
+
+/** Show the tooltip of the satellite under the pointer. */
+static gboolean on_query_tooltip(GtkWidget * widget, gint x, gint y,
+                                 gboolean keyboard_mode, GtkTooltip * tooltip,
+                                 gpointer data)
+{
+    GtkSatMap      *satmap = GTK_SAT_MAP(data);
+    sat_map_obj_t  *obj;
+    sat_t          *sat;
+    gchar          *text;
+
+    (void)widget;
+
+    if (keyboard_mode)
+        return FALSE;
+
+    obj = find_sat(satmap, x, y);
+    if (obj == NULL)
+        return FALSE;
+
+    sat = SAT(g_hash_table_lookup(satmap->sats, &obj->catnum));
+    if (sat == NULL)
+        return FALSE;
+
+    text = sat_tooltip(satmap, sat);
+    gtk_tooltip_set_markup(tooltip, text);
+    g_free(text);
+
+    return TRUE;
+}
+
+static void sat_button_press(GtkSatMap * satmap, gint catnum,
+                             GdkEventButton * event)
+{
     gint           *catpoint = NULL;
     sat_t          *sat = NULL;
 
-    (void)target;
-
     switch (event->button)
     {
         /* double-left-click */
@@ -883,7 +1049,8 @@ static gboolean on_button_press(GooCanvasItem * item,
             sat = SAT(g_hash_table_lookup(satmap->sats, catpoint));
             if (sat != NULL)
             {
-                show_sat_info(sat, gtk_widget_get_toplevel(GTK_WIDGET(data)));
+                show_sat_info(sat,
+                              gtk_widget_get_toplevel(GTK_WIDGET(satmap)));
             }
             else
             {
@@ -913,24 +1080,15 @@ static gboolean on_button_press(GooCanvasItem * item,
     default:
         break;
     }
-
-    return TRUE;
 }
 
-static gboolean on_button_release(GooCanvasItem * item,
-                                  GooCanvasItem * target,
-                                  GdkEventButton * event, gpointer data)
+static void sat_button_release(GtkSatMap * satmap, gint catnum,
+                               GdkEventButton * event)
 {
-    GooCanvasItemModel *model = goo_canvas_item_get_model(item);
-    GtkSatMap      *satmap = GTK_SAT_MAP(data);
-    gint            catnum =
-        GPOINTER_TO_INT(g_object_get_data(G_OBJECT(model), "catnum"));
     gint           *catpoint = NULL;
     sat_map_obj_t  *obj = NULL;
     guint32         col;
 
-    (void)target;
-
     catpoint = g_try_new0(gint, 1);
     *catpoint = catnum;
 
@@ -968,19 +1126,13 @@ static gboolean on_button_release(GooCanvasItem * item,
                 g_object_set(satmap->sel, "text", "", NULL);
             }
 
-            g_object_set(obj->marker,
-                         "fill-color-rgba", col,
-                         "stroke-color-rgba", col, NULL);
-            g_object_set(obj->label,
-                         "fill-color-rgba", col,
-                         "stroke-color-rgba", col, NULL);
-            g_object_set(obj->range1, "stroke-color-rgba", col, NULL);
-
-            if (obj->oldrcnum == 2)
-                g_object_set(obj->range2, "stroke-color-rgba", col, NULL);
+            set_sat_colour(obj, col);
 
             /* clear other selections */
             g_hash_table_foreach(satmap->obj, clear_selection, catpoint);
+            index_sats(satmap);
+            gtk_sat_map_render_queue_all(satmap);
+            gtk_sat_map_render_flush(satmap);
         }
         break;
     default:
@@ -988,8 +1140,126 @@ static gboolean on_button_release(GooCanvasItem * item,
     }
 
     g_free(catpoint);
+}
 
-    return TRUE;
+/**
+ * Set the colour of the canvas items of a satellite.
+ *
+ * Does nothing with direct rendering where the colour follows obj->selected.
+ */
+static void set_sat_colour(sat_map_obj_t * obj, guint32 col)
+{
+    if (obj->marker == NULL)
+        return;
+
+    g_object_set(obj->marker,
+                 "fill-color-rgba", col, "stroke-color-rgba", col, NULL);
+    g_object_set(obj->label,
+                 "fill-color-rgba", col, "stroke-color-rgba", col, NULL);
+    g_object_set(obj->range1, "stroke-color-rgba", col, NULL);
+
+    if (obj->oldrcnum == 2)
+        g_object_set(obj->range2, "stroke-color-rgba", col, NULL);
+}
+
+/**
+ * Rebuild the marker and label grids after the satellites have moved.
+ *
+ * The labels are placed in order, the selected satellite first, and with
+ * decluttering a label that would overlap one placed before is hidden.
+ * The labels that were shown in the previous cycle are placed before the
+ * hidden ones, so a label stays in place as long as it still fits instead
+ * of flickering with its neighbours.
+ */
+static void index_sats(GtkSatMap * satmap)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+    GPtrArray      *hidden;
+    sat_map_obj_t  *obj;
+    guint           i;
+
+    screen_grid_reset(satmap->markers, satmap->x0 + satmap->width,
+                      satmap->y0 + satmap->height);
+    screen_grid_reset(satmap->labels, satmap->x0 + satmap->width,
+                      satmap->y0 + satmap->height);
+
+    g_hash_table_iter_init(&iter, satmap->obj);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        obj = SAT_MAP_OBJ(value);
+        screen_grid_add(satmap->markers, obj->x, obj->y, 0.0, 0.0, obj);
+        if (obj->selected)
+            place_label(satmap, obj);
+    }
+
+    hidden = g_ptr_array_new();
+    g_hash_table_iter_init(&iter, satmap->obj);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        obj = SAT_MAP_OBJ(value);
+        if (obj->selected)
+            continue;
+
+        if (obj->label_shown)
+            place_label(satmap, obj);
+        else
+            g_ptr_array_add(hidden, obj);
+    }
+
+    for (i = 0; i < hidden->len; i++)
+        place_label(satmap, g_ptr_array_index(hidden, i));
+    g_ptr_array_free(hidden, TRUE);
+}
+
+/* Add the label of a satellite to the label grid, or hide it */
+static void place_label(GtkSatMap * satmap, sat_map_obj_t * obj)
+{
+    gdouble         x, y, w, h;
+    gboolean        shown;
+
+    gtk_sat_map_render_label_box(satmap, obj, &x, &y, &w, &h);
+    shown = !satmap->declutter || obj->selected ||
+        !screen_grid_overlaps(satmap->labels, x, y, w, h);
+
+    if (shown)
+        screen_grid_add(satmap->labels, x, y, w, h, obj);
+
+    if (shown == obj->label_shown)
+        return;
+
+    obj->label_shown = shown;
+    if (satmap->direct)
+    {
+        gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER);
+    }
+    else
+    {
+        g_object_set(obj->label, "visibility", shown ?
+                     GOO_CANVAS_ITEM_VISIBLE : GOO_CANVAS_ITEM_HIDDEN, NULL);
+        g_object_set(obj->shadowl, "visibility", shown ?
+                     GOO_CANVAS_ITEM_VISIBLE : GOO_CANVAS_ITEM_HIDDEN, NULL);
+    }
+}
+
+/**
+ * Find the satellite at a given position.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param x The x coordinate in canvas units.
+ * @param y The y coordinate in canvas units.
+ * @return The satellite object whose marker is closest to x,y, or whose
+ *         label contains x,y, or NULL if there is none.
+ */
+static sat_map_obj_t *find_sat(GtkSatMap * satmap, gdouble x, gdouble y)
+{
+    sat_map_obj_t  *obj;
+
+    obj = screen_grid_find(satmap->markers, x, y, HIT_RADIUS);
+    if (obj == NULL)
+        obj = screen_grid_find(satmap->labels, x, y, 0.0);
+
+    return obj;
 }
 
 static void clear_selection(gpointer key, gpointer val, gpointer data)
@@ -1006,14 +1276,7 @@ static void clear_selection(gpointer key, gpointer val, gpointer data)
         /** FIXME: this is only global default; need the satmap here! */
         col = sat_cfg_get_int(SAT_CFG_INT_MAP_SAT_COL);
 
-        g_object_set(obj->marker,
-                     "fill-color-rgba", col, "stroke-color-rgba", col, NULL);
-        g_object_set(obj->label,
-                     "fill-color-rgba", col, "stroke-color-rgba", col, NULL);
-        g_object_set(obj->range1, "stroke-color-rgba", col, NULL);
-
-        if (obj->oldrcnum == 2)
-            g_object_set(obj->range2, "stroke-color-rgba", col, NULL);
+        set_sat_colour(obj, col);
     }
 }
 
@@ -1043,17 +1306,13 @@ void gtk_sat_map_select_sat(GtkWidget * satmap, gint catnum)
                               MOD_CFG_MAP_SAT_SEL_COL,
                               SAT_CFG_INT_MAP_SAT_SEL_COL);
 
-        g_object_set(obj->marker,
-                     "fill-color-rgba", col, "stroke-color-rgba", col, NULL);
-        g_object_set(obj->label,
-                     "fill-color-rgba", col, "stroke-color-rgba", col, NULL);
-        g_object_set(obj->range1, "stroke-color-rgba", col, NULL);
-
-        if (obj->oldrcnum == 2)
-            g_object_set(obj->range2, "stroke-color-rgba", col, NULL);
+        set_sat_colour(obj, col);
 
         /* clear other selections */
         g_hash_table_foreach(smap->obj, clear_selection, catpoint);
+        index_sats(smap);
+        gtk_sat_map_render_queue_all(smap);
+        gtk_sat_map_render_flush(smap);
     }
 
     g_free(catpoint);
@@ -1174,28 +1433,6 @@ static void load_map_file(GtkSatMap * satmap, float clon)
         satmap->left_side_lon = 180.0 + clon;
 }
 
-static gdouble arccos(gdouble x, gdouble y)
-{
-    if (x && y)
-    {
-        if (y > 0.0)
-            return acos(x / y);
-        else if (y < 0.0)
-            return pi + acos(x / y);
-    }
-
-    return 0.0;
-}
-
-/* Check whether the footprint covers the North or South pole. */
-static gboolean pole_is_covered(sat_t * sat)
-{
-    if (north_pole_is_covered(sat) || south_pole_is_covered(sat))
-        return TRUE;
-    else
-        return FALSE;
-}
-
 /* Check whether the footprint covers the North pole. */
 static gboolean north_pole_is_covered(sat_t * sat)
 {
@@ -1320,8 +1557,10 @@ static guint calculate_footprint(GtkSatMap * satmap, sat_t * sat)
 {
     guint           azi;
     gfloat          sx, sy, msx, msy, ssx, ssy;
-    gdouble         ssplat, ssplon, beta, azimuth, num, dem;
-    gdouble         rangelon, rangelat, mlon;
+    gdouble         rangelat[FOOTPRINT_POINTS];
+    gdouble         rangelon[FOOTPRINT_POINTS];
+    gdouble         mlon;
+    gboolean        npole, spole;
     gboolean        warped = FALSE;
     guint           numrc = 1;
 
@@ -1330,45 +1569,19 @@ static guint calculate_footprint(GtkSatMap * satmap, sat_t * sat)
      * who borrowed from John Magliacane, KD2BD.
      * Optimized by Alexandru Csete and William J Beksi.
      */
-    ssplat = sat->ssplat * de2ra;
-    ssplon = sat->ssplon * de2ra;
-    beta = (0.5 * sat->footprint) / xkmper;
-
-    for (azi = 0; azi < 180; azi++)
-    {
-        azimuth = de2ra * (double)azi;
-        rangelat = asin(sin(ssplat) * cos(beta) + cos(azimuth) *
-                        sin(beta) * cos(ssplat));
-        num = cos(beta) - (sin(ssplat) * sin(rangelat));
-        dem = cos(ssplat) * cos(rangelat);
-
-        if (azi == 0 && north_pole_is_covered(sat))
-            rangelon = ssplon + pi;
-        else if (fabs(num / dem) > 1.0)
-            rangelon = ssplon;
-        else
-        {
-            if ((180.0 - azi) >= 0)
-                rangelon = ssplon - arccos(num, dem);
-            else
-                rangelon = ssplon + arccos(num, dem);
-        }
-
-        while (rangelon < -pi)
-            rangelon += twopi;
-
-        while (rangelon > (pi))
-            rangelon -= twopi;
-
-        rangelat = rangelat / de2ra;
-        rangelon = rangelon / de2ra;
+    npole = north_pole_is_covered(sat);
+    spole = south_pole_is_covered(sat);
+    footprint_half_circle(sat->ssplat, sat->ssplon, sat->footprint, npole,
+                          rangelat, rangelon);
 
+    for (azi = 0; azi < FOOTPRINT_POINTS; azi++)
+    {
         /* mirror longitude */
-        if (mirror_lon(sat, rangelon, &mlon, satmap->left_side_lon))
+        if (mirror_lon(sat, rangelon[azi], &mlon, satmap->left_side_lon))
             warped = TRUE;
 
-        lonlat_to_xy(satmap, rangelon, rangelat, &sx, &sy);
-        lonlat_to_xy(satmap, mlon, rangelat, &msx, &msy);
+        lonlat_to_xy(satmap, rangelon[azi], rangelat[azi], &sx, &sy);
+        lonlat_to_xy(satmap, mlon, rangelat[azi], &msx, &msy);
 
         points1->coords[2 * azi] = sx;
         points1->coords[2 * azi + 1] = sy;
@@ -1383,7 +1596,7 @@ static guint calculate_footprint(GtkSatMap * satmap, sat_t * sat)
      */
 
     /* pole is covered => sort points1 and add additional points */
-    if (pole_is_covered(sat))
+    if (npole || spole)
     {
 
         sort_points_x(satmap, sat, points1, 360);
@@ -1409,6 +1622,60 @@ static guint calculate_footprint(GtkSatMap * satmap, sat_t * sat)
     return numrc;
 }
 
+/**
+ * Simplify the range circle to the pixel scale of the map.
+ *
+ * @param obj The satellite object; newrcnum must be up to date.
+ *
+ * The range circle is computed with a fixed number of points, which is far
+ * more than needed for small footprints or a small map. This reduces
+ * points1 and points2 to the points that make a visible difference.
+ */
+static void simplify_footprint(sat_map_obj_t * obj)
+{
+    points1->num_points = map_tools_simplify(points1->coords,
+                                             points1->num_points,
+                                             SAT_MAP_LOD_TOLERANCE);
+    obj->cov_vertices = points1->num_points;
+
+    if (obj->newrcnum == 2)
+    {
+        points2->num_points = map_tools_simplify(points2->coords,
+                                                 points2->num_points,
+                                                 SAT_MAP_LOD_TOLERANCE);
+        obj->cov_vertices += points2->num_points;
+    }
+}
+
+/**
+ * Check whether the range circle of a satellite needs to be recalculated.
+ *
+ * @param satmap The GtkSatMap structure.
+ * @param obj The satellite object.
+ * @param sat The satellite.
+ * @return TRUE if the centre or the radius of the range circle has moved by
+ *         at least FOOTPRINT_MIN_MOVE pixels since it was last calculated.
+ */
+static gboolean footprint_moved(GtkSatMap * satmap, sat_map_obj_t * obj,
+                                sat_t * sat)
+{
+    gdouble         dlon, dx, dy, dr;
+
+    dlon = fabs(sat->ssplon - obj->cov_lon);
+    if (dlon > 180.0)
+        dlon = 360.0 - dlon;
+
+    dx = dlon * satmap->width / 360.0;
+    dy = fabs(sat->ssplat - obj->cov_lat) * satmap->height / 180.0;
+
+    /* footprint is the diameter in km along the surface */
+    dr = fabs(sat->footprint - obj->cov_size) * satmap->width /
+        (4.0 * pi * xkmper);
+
+    return (dx >= FOOTPRINT_MIN_MOVE || dy >= FOOTPRINT_MIN_MOVE ||
+            dr >= FOOTPRINT_MIN_MOVE);
+}
+
 /**
  * Split and sort polyline points.
  *
@@ -1779,11 +2046,8 @@ static void plot_sat(gpointer key, gpointer value, gpointer data)
     GtkSatMap      *satmap = GTK_SAT_MAP(data);
     sat_map_obj_t  *obj = NULL;
     sat_t          *sat = SAT(value);
-    GooCanvasItemModel *root;
     gint           *catnum;
-    guint32         col, covcol, shadowcol;
     gfloat          x, y;
-    gchar          *tooltip;
 
     (void)key;
 
@@ -1830,37 +2094,84 @@ static void plot_sat(gpointer key, gpointer value, gpointer data)
     obj->istarget = FALSE;
     obj->oldrcnum = 0;
     obj->newrcnum = 0;
+    obj->marker = NULL;
+    obj->shadowm = NULL;
+    obj->label = NULL;
+    obj->shadowl = NULL;
+    obj->range1 = NULL;
     obj->range2 = NULL;
     obj->catnum = sat->tle.catnr;
-    obj->track_data.latlon = NULL;
+    obj->track_data.ssp = NULL;
+    obj->track_data.size = 0;
+    obj->track_data.head = 0;
+    obj->track_data.num = 0;
+    g_queue_init(&obj->track_data.orbits);
     obj->track_data.lines = NULL;
     obj->track_orbit = 0;
+    obj->track_vertices = 0;
+    obj->cov_vertices = 0;
+    obj->x = x;
+    obj->y = y;
+    obj->label_w = 0.0;
+    obj->label_shown = TRUE;
+    gtk_sat_map_render_init_obj(obj);
 
-    root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
-
-    /* satellite color */
-    col = mod_cfg_get_int(satmap->cfgdata,
-                          MOD_CFG_MAP_SECTION,
-                          MOD_CFG_MAP_SAT_COL, SAT_CFG_INT_MAP_SAT_COL);
-
-    /* area coverage colour */
-    covcol = mod_cfg_get_int(satmap->cfgdata,
-                             MOD_CFG_MAP_SECTION,
-                             MOD_CFG_MAP_SAT_COV_COL,
-                             SAT_CFG_INT_MAP_SAT_COV_COL);
-    /* coverage color */
-    if (obj->showcov)
+    if (satmap->direct)
     {
-        covcol = mod_cfg_get_int(satmap->cfgdata,
-                                 MOD_CFG_MAP_SECTION,
-                                 MOD_CFG_MAP_SAT_COV_COL,
-                                 SAT_CFG_INT_MAP_SAT_COV_COL);
+        gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER);
     }
     else
     {
-        covcol = 0x00000000;
+        create_marker_items(satmap, obj, sat, x, y);
     }
 
+    /* initialize points for footprint */
+    points1 = goo_canvas_points_new(360);
+    points2 = goo_canvas_points_new(360);
+
+    /* calculate footprint */
+    obj->newrcnum = calculate_footprint(satmap, sat);
+    obj->oldrcnum = obj->newrcnum;
+    simplify_footprint(obj);
+    obj->cov_lat = sat->ssplat;
+    obj->cov_lon = sat->ssplon;
+    obj->cov_size = sat->footprint;
+
+    if (satmap->direct)
+        gtk_sat_map_render_set_coverage(satmap, obj, points1,
+                                        (obj->newrcnum == 2) ?
+                                        points2 : NULL);
+    else
+        create_range_items(satmap, obj);
+
+    goo_canvas_points_unref(points1);
+    goo_canvas_points_unref(points2);
+
+    /* add sat to hash table */
+    g_hash_table_insert(satmap->obj, catnum, obj);
+}
+
+/**
+ * Create the canvas items of a satellite marker and label.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param obj The satellite object.
+ * @param sat The satellite.
+ * @param x The x coordinate of the marker.
+ * @param y The y coordinate of the marker.
+ */
+static void create_marker_items(GtkSatMap * satmap, sat_map_obj_t * obj,
+                                sat_t * sat, gfloat x, gfloat y)
+{
+    GooCanvasItemModel *root;
+    guint32         col, shadowcol;
+
+    root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
+
+    /* satellite color */
+    col = mod_cfg_get_int(satmap->cfgdata,
+                          MOD_CFG_MAP_SECTION,
+                          MOD_CFG_MAP_SAT_COL, SAT_CFG_INT_MAP_SAT_COL);
 
     /* shadow colour (only alpha channel) */
     shadowcol = mod_cfg_get_int(satmap->cfgdata,
@@ -1868,16 +2179,6 @@ static void plot_sat(gpointer key, gpointer value, gpointer data)
                                 MOD_CFG_MAP_SHADOW_ALPHA,
                                 SAT_CFG_INT_MAP_SHADOW_ALPHA);
 
-    /* create tooltip */
-    tooltip = g_markup_printf_escaped("<b>%s</b>\n"
-                                      "Lon: %5.1f\302\260\n"
-                                      "Lat: %5.1f\302\260\n"
-                                      " Az: %5.1f\302\260\n"
-                                      " El: %5.1f\302\260",
-                                      sat->nickname,
-                                      sat->ssplon, sat->ssplat,
-                                      sat->az, sat->el);
-
     /* create satellite marker and label + shadows. We create shadows first */
     obj->shadowm = goo_canvas_rect_model_new(root,
                                              x - MARKER_SIZE_HALF + 1,
@@ -1893,8 +2194,7 @@ static void plot_sat(gpointer key, gpointer value, gpointer data)
                                             2 * MARKER_SIZE_HALF,
                                             2 * MARKER_SIZE_HALF,
                                             "fill-color-rgba", col,
-                                            "stroke-color-rgba", col,
-                                            "tooltip", tooltip, NULL);
+                                            "stroke-color-rgba", col, NULL);
 
     obj->shadowl = goo_canvas_text_model_new(root, sat->nickname,
                                              x + 1,
@@ -1910,23 +2210,47 @@ static void plot_sat(gpointer key, gpointer value, gpointer data)
                                            -1,
                                            GOO_CANVAS_ANCHOR_NORTH,
                                            "font", "Sans 8",
-                                           "fill-color-rgba", col,
-                                           "tooltip", tooltip, NULL);
-
-    g_free(tooltip);
+                                           "fill-color-rgba", col, NULL);
 
     g_object_set_data(G_OBJECT(obj->marker), "catnum",
-                      GINT_TO_POINTER(*catnum));
+                      GINT_TO_POINTER(obj->catnum));
     g_object_set_data(G_OBJECT(obj->label), "catnum",
-                      GINT_TO_POINTER(*catnum));
+                      GINT_TO_POINTER(obj->catnum));
+}
 
-    /* initialize points for footprint */
-    points1 = goo_canvas_points_new(360);
-    points2 = goo_canvas_points_new(360);
+/**
+ * Create the canvas items of a range circle.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param obj The satellite object.
+ *
+ * points1 and points2 must hold the range circle, and obj->newrcnum its
+ * number of parts.
+ */
+static void create_range_items(GtkSatMap * satmap, sat_map_obj_t * obj)
+{
+    GooCanvasItemModel *root;
+    guint32         col, covcol;
 
-    /* calculate footprint */
-    obj->newrcnum = calculate_footprint(satmap, sat);
-    obj->oldrcnum = obj->newrcnum;
+    root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
+
+    /* satellite color */
+    col = mod_cfg_get_int(satmap->cfgdata,
+                          MOD_CFG_MAP_SECTION,
+                          MOD_CFG_MAP_SAT_COL, SAT_CFG_INT_MAP_SAT_COL);
+
+    /* coverage color */
+    if (obj->showcov)
+    {
+        covcol = mod_cfg_get_int(satmap->cfgdata,
+                                 MOD_CFG_MAP_SECTION,
+                                 MOD_CFG_MAP_SAT_COV_COL,
+                                 SAT_CFG_INT_MAP_SAT_COV_COL);
+    }
+    else
+    {
+        covcol = 0x00000000;
+    }
 
     /* invisible footprint for decayed sats (STS fix) */
     /*     if (sat->otype == ORBIT_TYPE_DECAYED) { */
@@ -1944,13 +2268,11 @@ static void plot_sat(gpointer key, gpointer value, gpointer data)
                                                 "line-join",
                                                 CAIRO_LINE_JOIN_MITER, NULL);
     g_object_set_data(G_OBJECT(obj->range1), "catnum",
-                      GINT_TO_POINTER(*catnum));
+                      GINT_TO_POINTER(obj->catnum));
 
     /* create second part if available */
     if (obj->newrcnum == 2)
     {
-        //g_print ("N1:%d  N2:%d\n", points1->num_points, points2->num_points);
-
         obj->range2 = goo_canvas_polyline_model_new(root, FALSE, 0,
                                                     "points", points2,
                                                     "line-width", 1.0,
@@ -1962,15 +2284,8 @@ static void plot_sat(gpointer key, gpointer value, gpointer data)
                                                     CAIRO_LINE_JOIN_MITER,
                                                     NULL);
         g_object_set_data(G_OBJECT(obj->range2), "catnum",
-                          GINT_TO_POINTER(*catnum));
-
+                          GINT_TO_POINTER(obj->catnum));
     }
-
-    goo_canvas_points_unref(points1);
-    goo_canvas_points_unref(points2);
-
-    /* add sat to hash table */
-    g_hash_table_insert(satmap->obj, catnum, obj);
 }
 
 /**
@@ -1995,6 +2310,13 @@ static void free_sat_obj(gpointer key, gpointer value, gpointer data)
 
     (void)key;
 
+    if (satmap->direct)
+    {
+        gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER |
+                                 SAT_MAP_RENDER_COVERAGE);
+        gtk_sat_map_render_free_obj(obj);
+    }
+
     root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
 
     idx = goo_canvas_item_model_find_child(root, obj->marker);
@@ -2034,6 +2356,91 @@ static void free_sat_obj(gpointer key, gpointer value, gpointer data)
     }
 }
 
+/**
+ * Update the canvas items of a range circle.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param obj The satellite object.
+ *
+ * points1 and points2 must hold the new range circle, and obj->newrcnum its
+ * number of parts. The second part is created or removed as needed.
+ */
+static void update_range_items(GtkSatMap * satmap, sat_map_obj_t * obj)
+{
+    GooCanvasItemModel *root;
+    gint            idx;
+    guint32         col, covcol;
+
+    root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
+
+    /* always update first part */
+    g_object_set(obj->range1, "points", points1, NULL);
+
+    if (obj->newrcnum == 2)
+    {
+        if (obj->oldrcnum == 1)
+        {
+            /* we need to create the second part */
+            if (obj->selected)
+            {
+                col = mod_cfg_get_int(satmap->cfgdata,
+                                      MOD_CFG_MAP_SECTION,
+                                      MOD_CFG_MAP_SAT_SEL_COL,
+                                      SAT_CFG_INT_MAP_SAT_SEL_COL);
+            }
+            else
+            {
+                col = mod_cfg_get_int(satmap->cfgdata,
+                                      MOD_CFG_MAP_SECTION,
+                                      MOD_CFG_MAP_SAT_COL,
+                                      SAT_CFG_INT_MAP_SAT_COL);
+            }
+            /* coverage color */
+            if (obj->showcov)
+            {
+                covcol = mod_cfg_get_int(satmap->cfgdata,
+                                         MOD_CFG_MAP_SECTION,
+                                         MOD_CFG_MAP_SAT_COV_COL,
+                                         SAT_CFG_INT_MAP_SAT_COV_COL);
+            }
+            else
+            {
+                covcol = 0x00000000;
+            }
+            obj->range2 = goo_canvas_polyline_model_new(root, FALSE, 0,
+                                                        "points", points2,
+                                                        "line-width", 1.0,
+                                                        "fill-color-rgba",
+                                                        covcol,
+                                                        "stroke-color-rgba",
+                                                        col, "line-cap",
+                                                        CAIRO_LINE_CAP_SQUARE,
+                                                        "line-join",
+                                                        CAIRO_LINE_JOIN_MITER,
+                                                        NULL);
+            g_object_set_data(G_OBJECT(obj->range2), "catnum",
+                              GINT_TO_POINTER(obj->catnum));
+        }
+        else
+        {
+            /* just update the second part */
+            g_object_set(obj->range2, "points", points2, NULL);
+        }
+    }
+    else
+    {
+        if (obj->oldrcnum == 2)
+        {
+            /* remove second part */
+            idx = goo_canvas_item_model_find_child(root, obj->range2);
+            if (idx != -1)
+            {
+                goo_canvas_item_model_remove_child(root, idx);
+            }
+        }
+    }
+}
+
 /** Update a given satellite. */
 static void update_sat(gpointer key, gpointer value, gpointer data)
 {
@@ -2044,16 +2451,9 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
     gfloat          x, y;
     gdouble         oldx, oldy;
     gdouble         now;        // = get_current_daynum ();
-    GooCanvasItemModel *root;
-    gint            idx;
-    guint32         col, covcol;
-    gchar          *tooltip;
-    gchar          *aosstr;
 
     //gdouble sspla,ssplo;
 
-    root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
-
     catnum = g_new0(gint, 1);
     *catnum = sat->tle.catnr;
 
@@ -2100,34 +2500,30 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
         update_selected(satmap, sat);
     }
 
-    g_object_set(obj->label, "text", sat->nickname, NULL);
-    g_object_set(obj->shadowl, "text", sat->nickname, NULL);
-
-    aosstr = aoslos_time_to_str(satmap, sat);
-    tooltip = g_markup_printf_escaped("<b>%s</b>\n"
-                                      "Lon: %5.1f\302\260\n"
-                                      "Lat: %5.1f\302\260\n"
-                                      " Az: %5.1f\302\260\n"
-                                      " El: %5.1f\302\260\n"
-                                      "%s",
-                                      sat->nickname,
-                                      sat->ssplon, sat->ssplat,
-                                      sat->az, sat->el, aosstr);
-    g_object_set(obj->marker, "tooltip", tooltip, NULL);
-    g_object_set(obj->label, "tooltip", tooltip, NULL);
-    g_free(tooltip);
-    g_free(aosstr);
+    /* the label text is only changed by update_label() and the tooltip is
+       created when it is shown, see on_query_tooltip() */
 
     lonlat_to_xy(satmap, sat->ssplon, sat->ssplat, &x, &y);
 
     /* update only if satellite has moved at least
        2 * MARKER_SIZE_HALF (no need to drain CPU all the time)
      */
-    g_object_get(obj->marker, "x", &oldx, "y", &oldy, NULL);
+    oldx = obj->x;
+    oldy = obj->y;
 
-    if ((fabs(oldx - x) >= 2 * MARKER_SIZE_HALF) ||
-        (fabs(oldy - y) >= 2 * MARKER_SIZE_HALF))
+    if (satmap->direct && ((fabs(oldx - x) >= 2 * MARKER_SIZE_HALF) ||
+                           (fabs(oldy - y) >= 2 * MARKER_SIZE_HALF)))
     {
+        gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER);
+        obj->x = x;
+        obj->y = y;
+        gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER);
+    }
+    else if ((fabs(oldx - x) >= 2 * MARKER_SIZE_HALF) ||
+             (fabs(oldy - y) >= 2 * MARKER_SIZE_HALF))
+    {
+        obj->x = x;
+        obj->y = y;
         g_object_set(obj->marker,
                      "x", (gdouble) (x - MARKER_SIZE_HALF),
                      "y", (gdouble) (y - MARKER_SIZE_HALF), NULL);
@@ -2177,80 +2573,30 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
                          "y", (gdouble) (y + 2 + 1),
                          "anchor", GOO_CANVAS_ANCHOR_NORTH, NULL);
         }
+    }
 
+    /* the range circle is only recalculated if it has moved or changed size
+       by at least FOOTPRINT_MIN_MOVE pixels or if the map has been resized
+     */
+    if (satmap->resize || footprint_moved(satmap, obj, sat))
+    {
         /* initialize points for footprint */
         points1 = goo_canvas_points_new(360);
         points2 = goo_canvas_points_new(360);
 
         /* calculate footprint */
         obj->newrcnum = calculate_footprint(satmap, sat);
-
-        /* always update first part */
-        g_object_set(obj->range1, "points", points1, NULL);
-
-        if (obj->newrcnum == 2)
-        {
-            if (obj->oldrcnum == 1)
-            {
-                /* we need to create the second part */
-                if (obj->selected)
-                {
-                    col = mod_cfg_get_int(satmap->cfgdata,
-                                          MOD_CFG_MAP_SECTION,
-                                          MOD_CFG_MAP_SAT_SEL_COL,
-                                          SAT_CFG_INT_MAP_SAT_SEL_COL);
-                }
-                else
-                {
-                    col = mod_cfg_get_int(satmap->cfgdata,
-                                          MOD_CFG_MAP_SECTION,
-                                          MOD_CFG_MAP_SAT_COL,
-                                          SAT_CFG_INT_MAP_SAT_COL);
-                }
-                /* coverage color */
-                if (obj->showcov)
-                {
-                    covcol = mod_cfg_get_int(satmap->cfgdata,
-                                             MOD_CFG_MAP_SECTION,
-                                             MOD_CFG_MAP_SAT_COV_COL,
-                                             SAT_CFG_INT_MAP_SAT_COV_COL);
-                }
-                else
-                {
-                    covcol = 0x00000000;
-                }
-                obj->range2 = goo_canvas_polyline_model_new(root, FALSE, 0,
-                                                            "points", points2,
-                                                            "line-width", 1.0,
-                                                            "fill-color-rgba",
-                                                            covcol,
-                                                            "stroke-color-rgba",
-                                                            col, "line-cap",
-                                                            CAIRO_LINE_CAP_SQUARE,
-                                                            "line-join",
-                                                            CAIRO_LINE_JOIN_MITER,
-                                                            NULL);
-                g_object_set_data(G_OBJECT(obj->range2), "catnum",
-                                  GINT_TO_POINTER(*catnum));
-            }
-            else
-            {
-                /* just update the second part */
-                g_object_set(obj->range2, "points", points2, NULL);
-            }
-        }
+        simplify_footprint(obj);
+        obj->cov_lat = sat->ssplat;
+        obj->cov_lon = sat->ssplon;
+        obj->cov_size = sat->footprint;
+
+        if (satmap->direct)
+            gtk_sat_map_render_set_coverage(satmap, obj, points1,
+                                            (obj->newrcnum == 2) ?
+                                            points2 : NULL);
         else
-        {
-            if (obj->oldrcnum == 2)
-            {
-                /* remove second part */
-                idx = goo_canvas_item_model_find_child(root, obj->range2);
-                if (idx != -1)
-                {
-                    goo_canvas_item_model_remove_child(root, idx);
-                }
-            }
-        }
+            update_range_items(satmap, obj);
 
         /* update rc-number */
         obj->oldrcnum = obj->newrcnum;
@@ -2748,6 +3094,37 @@ void gtk_sat_map_reload_sats(GtkWidget * satmap, GHashTable * sats)
 
     /* reset ground track orbit to force repaint */
     g_hash_table_foreach(GTK_SAT_MAP(satmap)->obj, reset_ground_track, NULL);
+
+    /* the nicknames may have changed */
+    g_hash_table_foreach(GTK_SAT_MAP(satmap)->obj, update_label, satmap);
+}
+
+/**
+ * Refresh a satellite whose elements have been replaced.
+ *
+ * @param widget The GtkSatMap widget.
+ * @param catnum Catalog number of the satellite.
+ *
+ * Only the ground track of this satellite is recalculated.
+ */
+void gtk_sat_map_refresh_sat(GtkWidget * widget, gint catnum)
+{
+    GtkSatMap      *satmap = GTK_SAT_MAP(widget);
+    sat_map_obj_t  *obj;
+
+    /* next AOS will be found in the next cycle */
+    if (satmap->ncat == catnum)
+    {
+        satmap->naos = 0.0;
+        satmap->ncat = 0;
+    }
+
+    obj = (sat_map_obj_t *) g_hash_table_lookup(satmap->obj, &catnum);
+    if (obj != NULL)
+    {
+        obj->track_orbit = 0;
+        update_label(&catnum, obj, satmap);
+    }
 }
 
 static void reset_ground_track(gpointer key, gpointer value,
@@ -2760,6 +3137,63 @@ static void reset_ground_track(gpointer key, gpointer value,
     obj->track_orbit = 0;
 }
 
+/**
+ * Set the label of a satellite to its current nickname.
+ *
+ * The label text is not touched in the update cycle; it only changes when
+ * the satellite data is reloaded.
+ */
+static void update_label(gpointer key, gpointer value, gpointer data)
+{
+    sat_map_obj_t  *obj = SAT_MAP_OBJ(value);
+    GtkSatMap      *satmap = GTK_SAT_MAP(data);
+    sat_t          *sat;
+
+    (void)key;
+
+    sat = SAT(g_hash_table_lookup(satmap->sats, &obj->catnum));
+    if (sat == NULL)
+        return;
+
+    /* the width may change */
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER);
+    obj->label_w = 0.0;
+    gtk_sat_map_render_queue(satmap, obj, SAT_MAP_RENDER_MARKER);
+
+    if (!satmap->direct)
+    {
+        g_object_set(obj->label, "text", sat->nickname, NULL);
+        g_object_set(obj->shadowl, "text", sat->nickname, NULL);
+    }
+}
+
+/**
+ * Create the tooltip of a satellite.
+ *
+ * @param satmap The GtkSatMap widget.
+ * @param sat The satellite.
+ * @return A newly allocated markup string.
+ */
+static gchar   *sat_tooltip(GtkSatMap * satmap, sat_t * sat)
+{
+    gchar          *aosstr;
+    gchar          *tooltip;
+
+    aosstr = aoslos_time_to_str(satmap, sat);
+    tooltip = g_markup_printf_escaped("<b>%s</b>\n"
+                                      "Lon: %5.1f\302\260\n"
+                                      "Lat: %5.1f\302\260\n"
+                                      " Az: %5.1f\302\260\n"
+                                      " El: %5.1f\302\260\n"
+                                      "%s",
+                                      sat->nickname,
+                                      sat->ssplon, sat->ssplat,
+                                      sat->az, sat->el, aosstr);
+    g_free(aosstr);
+
+    return tooltip;
+}
+
 static gchar   *aoslos_time_to_str(GtkSatMap * satmap, sat_t * sat)
 {
     guint           h, m, s;
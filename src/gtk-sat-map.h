@@ -8,6 +8,7 @@
 #include <gtk/gtk.h>
 
 #include "gtk-sat-data.h"
+#include "screen-grid.h"
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -16,6 +17,7 @@ extern "C" {
 /* *INDENT-ON* */
 
 #define SAT_MAP_RANGE_CIRCLE_POINTS    180      /*!< Number of points used to plot a satellite range half circle. */
+#define SAT_MAP_LOD_TOLERANCE          0.5      /*!< Largest deviation of simplified tracks and range circles in pixels. */
 
 #define GTK_SAT_MAP(obj)          G_TYPE_CHECK_INSTANCE_CAST (obj, gtk_sat_map_get_type (), GtkSatMap)
 #define GTK_SAT_MAP_CLASS(klass)  G_TYPE_CHECK_CLASS_CAST (klass, gtk_sat_map_get_type (), GtkSatMapClass)
@@ -31,10 +33,20 @@ typedef struct {
     double          lon;        /*!< Longitude in decimal degrees West. */
 } ssp_t;
 
-/** Data storage for ground tracks */
+/**
+ * Data storage for ground tracks.
+ *
+ * The SSPs are kept in a ring buffer, oldest first starting at head, so that
+ * the track can move on by one orbit without recomputing the orbits that are
+ * still shown.
+ */
 typedef struct {
-    GSList         *latlon;     /*!< List of ssp_t */
-    GSList         *lines;      /*!< List of GooCanvasPolyLine */
+    ssp_t          *ssp;        /*!< Ring buffer of SSPs */
+    guint           size;       /*!< Capacity of the ring buffer */
+    guint           head;       /*!< Index of the oldest SSP */
+    guint           num;        /*!< Number of SSPs in the ring buffer */
+    GQueue          orbits;     /*!< Number of SSPs in each orbit, oldest first */
+    GSList         *lines;      /*!< List of GooCanvasPolyLine, or of GooCanvasPoints with direct rendering */
 } ground_track_t;
 
 /**
@@ -68,7 +80,21 @@ typedef struct {
     gint            catnum;     /*!< Catalogue number of satellite. */
 
     ground_track_t  track_data; /*!< Ground track data. */
-    long            track_orbit;        /*!< Orbit when the ground track has been updated. */
+    guint           track_vertices;     /*!< Ground track points on the canvas. */
+    guint           cov_vertices;       /*!< Range circle points on the canvas. */
+    gdouble         cov_lat;    /*!< SSP latitude of the range circle on the canvas. */
+    gdouble         cov_lon;    /*!< SSP longitude of the range circle on the canvas. */
+    gdouble         cov_size;   /*!< Footprint of the range circle on the canvas. */
+    gdouble         x;          /*!< X coordinate of the marker. */
+    gdouble         y;          /*!< Y coordinate of the marker. */
+    gdouble         label_w;    /*!< Width of the label; 0 if not known yet. */
+    gboolean        label_shown;        /*!< FALSE if the label is hidden to avoid overlapping. */
+
+    /* direct rendering, see gtk-sat-map-render.c */
+    GooCanvasPoints *cov[2];    /*!< Parts of the range circle. */
+    GdkRectangle    cov_box;    /*!< Area covered by the range circle. */
+    GdkRectangle    track_box;  /*!< Area covered by the ground track. */
+    long            track_orbit;        /*!< First orbit of the ground track; 0 if it must be recomputed. */
 
 } sat_map_obj_t;
 
@@ -129,6 +155,11 @@ typedef struct {
     gboolean        showgrid;   /*!< Show grid on map. */
     gboolean        keepratio;  /*!< Keep map aspect ratio. */
     gboolean        resize;     /*!< Flag indicating that the map has been resized. */
+    gboolean        direct;     /*!< Draw satellites with Cairo instead of canvas items. */
+    cairo_region_t *dirty;      /*!< Area to redraw with direct rendering. */
+    gboolean        declutter;  /*!< Hide labels that overlap other labels. */
+    screen_grid_t  *markers;    /*!< Satellite markers for hit-testing. */
+    screen_grid_t  *labels;     /*!< Shown labels for hit-testing and decluttering. */
 
     gchar          *infobgd;    /*!< Background color of info text. */
 
@@ -150,6 +181,7 @@ void            gtk_sat_map_lonlat_to_xy(GtkSatMap * m,
                                          gdouble * x, gdouble * y);
 
 void            gtk_sat_map_reload_sats(GtkWidget * satmap, GHashTable * sats);
+void            gtk_sat_map_refresh_sat(GtkWidget * widget, gint catnum);
 void            gtk_sat_map_select_sat(GtkWidget * satmap, gint catnum);
 
 /* *INDENT-OFF* */
@@ -67,6 +67,9 @@
 
 static GtkVBoxClass *parent_class = NULL;
 
+static void     cancel_load_sats(GtkSatModule * module);
+static void     cancel_refresh_sats(GtkSatModule * module);
+
 static void gtk_sat_module_free_sat(gpointer sat)
 {
     gtk_sat_data_free_sat(SAT(sat));
@@ -148,6 +151,10 @@ static void gtk_sat_module_destroy(GtkWidget * widget)
         module->timerid = 0;
     }
 
+    /* stop loading satellites */
+    cancel_load_sats(module);
+    cancel_refresh_sats(module);
+
     /* destroy time controller */
     if (module->tmgActive)
     {
@@ -193,6 +200,12 @@ static void gtk_sat_module_destroy(GtkWidget * widget)
         module->satellites = NULL;
     }
 
+    if (module->event_queue)
+    {
+        g_queue_free(module->event_queue);
+        module->event_queue = NULL;
+    }
+
     if (module->grid)
     {
         g_free(module->grid);
@@ -226,8 +239,17 @@ static void gtk_sat_module_init(GtkSatModule * module,
     module->qth = g_try_new0(qth_t, 1);
     qth_init(module->qth);
 
+    /* the keys point to the catalog number inside the satellite */
     module->satellites = g_hash_table_new_full(g_int_hash, g_int_equal,
-                                               g_free, gtk_sat_module_free_sat);
+                                               NULL, gtk_sat_module_free_sat);
+    module->loader = NULL;
+    module->loaded = NULL;
+    module->load_total = 0;
+    module->load_pending = 0;
+    module->load_succ = 0;
+    module->load_id = 0;
+    module->load_cancel = 0;
+    module->event_queue = g_queue_new();
 
     module->rotctrlwin = NULL;
     module->rotctrl = NULL;
@@ -409,21 +431,210 @@ static void create_module_layout(GtkSatModule * module)
 }
 
 
+/** A satellite handed to the loader thread pool */
+typedef struct {
+    gint            catnum;     /*!< Catalog number to read */
+    qth_t           qth;        /*!< Copy of the module QTH position */
+    sat_t          *sat;        /*!< The satellite or NULL if it could not be read */
+} sat_load_job_t;
+
+/**
+ * Read and initialise a satellite.
+ *
+ * @param data Pointer to the sat_load_job_t.
+ * @param user_data Pointer to the GtkSatModule.
+ *
+ * This function is executed by the loader thread pool. It does not touch the
+ * satellite hash table or the module QTH; the finished job is pushed onto
+ * module->loaded and collected by the main thread. Jobs started after the
+ * loading has been cancelled are pushed without reading anything.
+ */
+static void load_sat_worker(gpointer data, gpointer user_data)
+{
+    sat_load_job_t *job = (sat_load_job_t *) data;
+    GtkSatModule   *module = (GtkSatModule *) user_data;
+
+    if (g_atomic_int_get(&module->load_cancel))
+    {
+        g_async_queue_push(module->loaded, job);
+        return;
+    }
+
+    job->sat = g_new0(sat_t, 1);
+
+    if (gtk_sat_data_read_sat_qth(job->catnum, job->sat, &job->qth))
+    {
+        gtk_sat_data_free_sat(job->sat);
+        job->sat = NULL;
+    }
+
+    g_async_queue_push(module->loaded, job);
+}
+
+/**
+ * Add the satellites read by the loader threads to the hash table.
+ *
+ * @param module Pointer to the GtkSatModule widget.
+ * @return The number of satellites collected.
+ *
+ * The hash table key is the catalog number stored in the satellite itself,
+ * so no separate key needs to be allocated.
+ */
+static guint collect_loaded_sats(GtkSatModule * module)
+{
+    sat_load_job_t *job;
+    guint           n = 0;
+
+    while ((job = g_async_queue_try_pop(module->loaded)) != NULL)
+    {
+        n++;
+        module->load_pending--;
+
+        if (job->sat == NULL)
+        {
+            /* the satellite could not be read */
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s: Error reading data for #%d"),
+                        __func__, job->catnum);
+        }
+        else if (g_hash_table_lookup(module->satellites,
+                                     &job->sat->tle.catnr) == NULL)
+        {
+            g_hash_table_insert(module->satellites,
+                                &job->sat->tle.catnr, job->sat);
+            module->load_succ++;
+            sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                        _("%s: Read data for #%d"), __func__, job->catnum);
+        }
+        else
+        {
+            /* check whether satellite is already in list
+               in order to avoid duplicates */
+            sat_log_log(SAT_LOG_LEVEL_WARN,
+                        _("%s: Sat #%d already in list"),
+                        __func__, job->catnum);
+            gtk_sat_data_free_sat(job->sat);
+        }
+
+        g_free(job);
+    }
+
+    return n;
+}
+
+/** Release the loader resources once all satellites have been collected. */
+static void finish_load_sats(GtkSatModule * module)
+{
+    sat_log_log(SAT_LOG_LEVEL_INFO,
+                _("%s: Read %d out of %d satellites"), __func__,
+                module->load_succ, module->load_total);
+
+    g_async_queue_unref(module->loaded);
+    module->loaded = NULL;
+    module->load_id = 0;
+}
+
+/**
+ * Stop loading satellites.
+ *
+ * Jobs that have not been started are run without reading anything, running
+ * jobs are waited for, and all of them are then freed. Used when the module
+ * is destroyed or reloaded while it is still loading.
+ */
+static void cancel_load_sats(GtkSatModule * module)
+{
+    sat_load_job_t *job;
+
+    if (module->load_id > 0)
+    {
+        g_source_remove(module->load_id);
+        module->load_id = 0;
+    }
+
+    if (module->loader != NULL)
+    {
+        g_atomic_int_set(&module->load_cancel, 1);
+        g_thread_pool_free(module->loader, FALSE, TRUE);
+        module->loader = NULL;
+        g_atomic_int_set(&module->load_cancel, 0);
+    }
+
+    if (module->loaded != NULL)
+    {
+        while ((job = g_async_queue_try_pop(module->loaded)) != NULL)
+        {
+            gtk_sat_data_free_sat(job->sat);
+            g_free(job);
+        }
+        g_async_queue_unref(module->loaded);
+        module->loaded = NULL;
+    }
+
+    module->load_pending = 0;
+}
+
+/**
+ * Collect satellites while they are being loaded in the background.
+ *
+ * This is a timeout callback started by gtk_sat_module_load_sats when
+ * loading asynchronously. It streams the ready satellites into the hash table
+ * and creates the views once the last satellite has arrived.
+ */
+static gboolean load_sats_timeout_cb(gpointer data)
+{
+    GtkSatModule   *module = GTK_SAT_MODULE(data);
+    gchar          *text;
+
+    collect_loaded_sats(module);
+
+    if (module->load_pending > 0)
+    {
+        text = g_strdup_printf(_("Loading satellites (%d/%d)"),
+                               module->load_total - module->load_pending,
+                               module->load_total);
+        gtk_label_set_text(GTK_LABEL(module->header), text);
+        g_free(text);
+
+        return TRUE;
+    }
+
+    /* all jobs have been collected so the pool is idle */
+    g_thread_pool_free(module->loader, FALSE, TRUE);
+    module->loader = NULL;
+    finish_load_sats(module);
+
+    create_module_layout(module);
+    gtk_widget_show_all(GTK_WIDGET(module));
+    gtk_widget_set_sensitive(module->popup_button, TRUE);
+
+    return FALSE;
+}
+
 /**
  * Read satellites into memory.
  *
+ * @param module Pointer to the GtkSatModule widget.
+ * @param async Whether to return before the satellites have been loaded.
+ *
  * This function reads the list of satellites from the configfile and
- * and then adds each satellite to the hash table.
+ * and then adds each satellite to the hash table. The .sat files are read
+ * and initialised by a thread pool with one thread per CPU.
+ *
+ * When async is FALSE the function waits for all satellites. Otherwise the
+ * satellites are added to the hash table from the main loop as they become
+ * ready and the module layout is created when all satellites are loaded.
+ *
+ * AOS/LOS times are not calculated here; they are calculated a few
+ * satellites at a time during the following module cycles, see
+ * update_events.
  */
-static void gtk_sat_module_load_sats(GtkSatModule * module)
+static void gtk_sat_module_load_sats(GtkSatModule * module, gboolean async)
 {
     gint           *sats = NULL;
     gsize           length;
     GError         *error = NULL;
     guint           i;
-    sat_t          *sat;
-    guint          *key = NULL;
-    guint           succ = 0;
+    sat_load_job_t *job;
 
     /* get list of satellites from config file; abort in case of error */
     sats = g_key_file_get_integer_list(module->cfgdata,
@@ -444,56 +655,41 @@ static void gtk_sat_module_load_sats(GtkSatModule * module)
             g_free(sats);
         }
 
-        return;
+        length = 0;
     }
 
-    /* read each satellite into hash table */
+    module->load_total = length;
+    module->load_pending = length;
+    module->load_succ = 0;
+    module->loaded = g_async_queue_new();
+    module->loader = g_thread_pool_new(load_sat_worker, module,
+                                       MAX(1, g_get_num_processors()),
+                                       FALSE, NULL);
+
+    /* queue each satellite */
     for (i = 0; i < length; i++)
     {
-        sat = g_new(sat_t, 1);
-
-        if (gtk_sat_data_read_sat(sats[i], sat))
-        {
-            /* the satellite could not be read */
-            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _("%s: Error reading data for #%d"),
-                        __func__, sats[i]);
-
-            g_free(sat);
-        }
-        else
-        {
-            /* check whether satellite is already in list
-               in order to avoid duplicates
-             */
-            key = g_new0(guint, 1);
-            *key = sats[i];
-
-            if (g_hash_table_lookup(module->satellites, key) == NULL)
-            {
-                gtk_sat_data_init_sat(sat, module->qth);
-                g_hash_table_insert(module->satellites, key, sat);
-                succ++;
-                sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                            _("%s: Read data for #%d"), __func__, sats[i]);
-            }
-            else
-            {
-                sat_log_log(SAT_LOG_LEVEL_WARN,
-                            _("%s: Sat #%d already in list"),
-                            __func__, sats[i]);
+        job = g_new0(sat_load_job_t, 1);
+        job->catnum = sats[i];
+        job->qth.lat = module->qth->lat;
+        job->qth.lon = module->qth->lon;
+        job->qth.alt = module->qth->alt;
+        g_thread_pool_push(module->loader, job, NULL);
+    }
 
-                /* it is not needed in this case */
-                g_free(sat);
-            }
+    g_free(sats);
 
-        }
+    if (async)
+    {
+        module->load_id = g_timeout_add(50, load_sats_timeout_cb, module);
+        return;
     }
 
-    sat_log_log(SAT_LOG_LEVEL_INFO,
-                _("%s: Read %d out of %d satellites"), __func__, succ, length);
-
-    g_free(sats);
+    /* wait for all jobs to finish */
+    g_thread_pool_free(module->loader, FALSE, TRUE);
+    module->loader = NULL;
+    collect_loaded_sats(module);
+    finish_load_sats(module);
 }
 
 /**
@@ -644,20 +840,10 @@ static void gtk_sat_module_update_sat(gpointer key, gpointer val,
     /* get current time (real or simulated */
     daynum = module->tmgCdnum;
 
-    /* update events if the event counter has been reset
-       and the other requirements are fulfilled */
-    if ((GTK_SAT_MODULE(module)->event_count == 0) &&
-        has_aos(sat, module->qth))
-    {
-        /* Note that has_aos may return TRUE for geostationary sats
-           whose orbit deviate from a true-geostat orbit, however,
-           find_aos and find_los will not go beyond the time limit
-           we specify (in those cases they return 0.0 for AOS/LOS times.
-           We use SAT_CFG_INT_PRED_LOOK_AHEAD for upper time limit */
-        sat->aos = find_aos(sat, module->qth, daynum, maxdt);
-        sat->los = find_los(sat, module->qth, daynum, maxdt);
-    }
     /*
+       A full AOS/LOS update is done by update_events when the event counter
+       has been reset.
+
        Update AOS and LOS for this satellite if it was known and is before
        the current time.
 
@@ -678,7 +864,7 @@ static void gtk_sat_module_update_sat(gpointer key, gpointer val,
        Single sat/list/event/map views all use these values and they
        should be up to date.
 
-       The above code is still required for dealing with circumstances
+       The full update is still required for dealing with circumstances
        where the qth moves from someplace where the qth can have an AOS and
        where qth does not and for satellites in parking orbits where the
        AOS may be further than maxdt out results in aos==0.0 until the
@@ -702,6 +888,80 @@ static void gtk_sat_module_update_sat(gpointer key, gpointer val,
     predict_calc(sat, module->qth, daynum);
 }
 
+/**
+ * Calculate AOS/LOS for the satellites waiting in the event queue.
+ *
+ * @param module Pointer to the GtkSatModule widget.
+ *
+ * When the event counter has been reset all satellites are queued, the
+ * current target first. Each cycle spends at most a quarter of the module
+ * timeout on the queue, so loading a module or moving the QTH does not stall
+ * the main loop with an AOS/LOS search for every satellite. The event lists
+ * are told to check their events when some satellites have been updated.
+ */
+static void update_events(GtkSatModule * module)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+    GtkWidget      *child;
+    sat_t          *sat;
+    gint64          deadline;
+    gdouble         maxdt;
+    gint            catnum;
+    guint           n = 0;
+    guint           i;
+
+    if (module->event_count == 0)
+    {
+        g_queue_clear(module->event_queue);
+        g_hash_table_iter_init(&iter, module->satellites);
+        while (g_hash_table_iter_next(&iter, NULL, &value))
+        {
+            catnum = SAT(value)->tle.catnr;
+            if (catnum == module->target)
+                g_queue_push_head(module->event_queue, GINT_TO_POINTER(catnum));
+            else
+                g_queue_push_tail(module->event_queue, GINT_TO_POINTER(catnum));
+        }
+    }
+
+    if (g_queue_is_empty(module->event_queue))
+        return;
+
+    maxdt = (gdouble) sat_cfg_get_int(SAT_CFG_INT_PRED_LOOK_AHEAD);
+    deadline = g_get_monotonic_time() + 250 * (gint64) module->timeout;
+
+    do
+    {
+        catnum = GPOINTER_TO_INT(g_queue_pop_head(module->event_queue));
+        sat = SAT(g_hash_table_lookup(module->satellites, &catnum));
+
+        /* Note that has_aos may return TRUE for geostationary sats
+           whose orbit deviate from a true-geostat orbit, however,
+           find_aos and find_los will not go beyond the time limit
+           we specify (in those cases they return 0.0 for AOS/LOS times.
+           We use SAT_CFG_INT_PRED_LOOK_AHEAD for upper time limit */
+        if (sat != NULL && has_aos(sat, module->qth))
+        {
+            sat->aos = find_aos(sat, module->qth, module->tmgCdnum, maxdt);
+            sat->los = find_los(sat, module->qth, module->tmgCdnum, maxdt);
+            n++;
+        }
+    }
+    while (!g_queue_is_empty(module->event_queue) &&
+           g_get_monotonic_time() < deadline);
+
+    if (n == 0)
+        return;
+
+    for (i = 0; i < module->nviews; i++)
+    {
+        child = GTK_WIDGET(g_slist_nth_data(module->views, i));
+        if (IS_GTK_EVENT_LIST(child))
+            gtk_event_list_refresh_sat(child, catnum);
+    }
+}
+
 /** Module timeout callback. */
 static gboolean gtk_sat_module_timeout_cb(gpointer module)
 {
@@ -712,6 +972,10 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
     gdouble         delta;
     guint           i;
 
+    /* nothing to do until the satellites have been loaded */
+    if (mod->load_id > 0)
+        return TRUE;
+
     /*update the qth position */
     qth_data_update(mod->qth, mod->tmgCdnum);
 
@@ -781,6 +1045,10 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
             qth_small_save(mod->qth, &(mod->qth_event));
         }
 
+        /* calculate AOS/LOS for some of the queued satellites */
+        if (mod->satellites != NULL)
+            update_events(mod);
+
         /* update satellite data */
         if (mod->satellites != NULL)
             g_hash_table_foreach(mod->satellites,
@@ -1053,8 +1321,6 @@ GtkWidget *gtk_sat_module_new(const gchar * cfgfile)
     module->tmgPdnum = get_current_daynum();
     module->tmgCdnum = get_current_daynum();
 
-    gtk_sat_module_load_sats(module);
-
     /* menu */
     GtkWidget * image = gtk_image_new_from_icon_name("open-menu-symbolic",
                                          GTK_ICON_SIZE_BUTTON);
@@ -1090,7 +1356,10 @@ GtkWidget *gtk_sat_module_new(const gchar * cfgfile)
                        gtk_separator_new(GTK_ORIENTATION_HORIZONTAL),
                        FALSE, FALSE, 0);
 
-    create_module_layout(module);
+    /* the views are created when all satellites have been loaded */
+    gtk_label_set_text(GTK_LABEL(module->header), _("Loading satellites"));
+    gtk_widget_set_sensitive(module->popup_button, FALSE);
+    gtk_sat_module_load_sats(module, TRUE);
     gtk_widget_show_all(GTK_WIDGET(module));
 
     /* start timeout */
@@ -1401,11 +1670,11 @@ static void reload_sats_in_child(GtkWidget * widget, GtkSatModule * module)
     }
     else if (IS_GTK_SAT_LIST(widget))
     {
-        /* NOP */
+        gtk_sat_list_reload_sats(widget, module->satellites);
     }
     else if (IS_GTK_EVENT_LIST(widget))
     {
-        /* NOP */
+        gtk_event_list_reload_sats(widget, module->satellites);
     }
     else
     {
@@ -1436,6 +1705,9 @@ void gtk_sat_module_reload_sats(GtkSatModule * module)
 
     g_return_if_fail(IS_GTK_SAT_MODULE(module));
 
+    /* a full reload supersedes a refresh in progress */
+    cancel_refresh_sats(module);
+
     /* lock module */
     g_mutex_lock(&module->busy);
 
@@ -1443,6 +1715,17 @@ void gtk_sat_module_reload_sats(GtkSatModule * module)
                 _("%s: Reloading satellites for module %s"),
                 __func__, module->name);
 
+    /* the views do not exist yet if the module is still being loaded;
+       restart the background loading so that it picks up the new data */
+    if (module->load_id > 0)
+    {
+        cancel_load_sats(module);
+        g_hash_table_remove_all(module->satellites);
+        gtk_sat_module_load_sats(module, TRUE);
+        g_mutex_unlock(&module->busy);
+        return;
+    }
+
     /* remove each element from the hash table, but keep the hash table */
     g_hash_table_remove_all(module->satellites);
 
@@ -1450,7 +1733,7 @@ void gtk_sat_module_reload_sats(GtkSatModule * module)
     module->event_count = 0;
 
     /* load satellites */
-    gtk_sat_module_load_sats(module);
+    gtk_sat_module_load_sats(module, FALSE);
 
     /* update children */
     for (i = 0; i < module->nviews; i++)
@@ -1465,6 +1748,284 @@ void gtk_sat_module_reload_sats(GtkSatModule * module)
     g_mutex_unlock(&module->busy);
 }
 
+
+/** A satellite handed to the refresh thread pool */
+typedef struct {
+    gint            catnum;     /*!< Catalog number to read */
+    gdouble         epoch;      /*!< Epoch of the elements in use */
+    gdouble         daynum;     /*!< Module time to bring the new elements to */
+    gdouble         maxdt;      /*!< Look ahead for AOS/LOS */
+    qth_t           qth;        /*!< Copy of the module QTH position */
+    sat_t          *sat;        /*!< New satellite or NULL if unchanged */
+} sat_refresh_job_t;
+
+/**
+ * Read fresh elements for a satellite.
+ *
+ * @param data Pointer to the sat_refresh_job_t.
+ * @param user_data Pointer to the GtkSatModule.
+ *
+ * This function is executed by the refresh thread pool. If the epoch of the
+ * elements on disk differs from the one in use, the new satellite is
+ * propagated to the module time and its AOS/LOS are calculated so that it
+ * can replace the old one without any work in the main loop. Like the
+ * loader it uses the copy of the QTH in the job and skips jobs started after
+ * the refresh has been cancelled.
+ */
+static void refresh_sat_worker(gpointer data, gpointer user_data)
+{
+    sat_refresh_job_t *job = (sat_refresh_job_t *) data;
+    GtkSatModule   *module = (GtkSatModule *) user_data;
+    sat_t          *sat;
+
+    if (g_atomic_int_get(&module->refresh_cancel))
+    {
+        g_async_queue_push(module->refreshed, job);
+        return;
+    }
+
+    sat = g_new0(sat_t, 1);
+
+    if (gtk_sat_data_read_sat_qth(job->catnum, sat, &job->qth) ||
+        (sat->tle.epoch == job->epoch))
+    {
+        /* unreadable or unchanged; keep what we have */
+        gtk_sat_data_free_sat(sat);
+    }
+    else
+    {
+        predict_calc(sat, &job->qth, job->daynum);
+        if (has_aos(sat, &job->qth))
+        {
+            sat->aos = find_aos(sat, &job->qth, job->daynum, job->maxdt);
+            sat->los = find_los(sat, &job->qth, job->daynum, job->maxdt);
+        }
+        job->sat = sat;
+    }
+
+    g_async_queue_push(module->refreshed, job);
+}
+
+/** Refresh a satellite in a view */
+static void refresh_sat_in_child(GtkWidget * widget, gint catnum)
+{
+    if (IS_GTK_POLAR_VIEW(widget))
+    {
+        gtk_polar_view_refresh_sat(widget, catnum);
+    }
+    else if (IS_GTK_SAT_MAP(widget))
+    {
+        gtk_sat_map_refresh_sat(widget, catnum);
+    }
+    else if (IS_GTK_EVENT_LIST(widget))
+    {
+        gtk_event_list_refresh_sat(widget, catnum);
+    }
+
+    /* the other views use the satellite data directly */
+}
+
+/**
+ * Replace the elements of a satellite.
+ *
+ * @param module Pointer to the GtkSatModule widget.
+ * @param newsat The refreshed satellite. It is freed.
+ *
+ * The contents of the satellites are swapped rather than the pointers, so
+ * that the views and the radio and rotator controllers keep a valid
+ * reference and the hash table key (the catalog number stored in the
+ * satellite) stays in place. The views and controllers are told to
+ * recalculate what they derived from the old elements.
+ */
+static void swap_refreshed_sat(GtkSatModule * module, sat_t * newsat)
+{
+    sat_t          *sat;
+    sat_t           tmp;
+    guint           i;
+
+    sat = SAT(g_hash_table_lookup(module->satellites, &newsat->tle.catnr));
+    if (sat == NULL)
+    {
+        /* the satellite has been removed in the meantime */
+        gtk_sat_data_free_sat(newsat);
+        return;
+    }
+
+    tmp = *sat;
+    *sat = *newsat;
+    *newsat = tmp;
+    gtk_sat_data_free_sat(newsat);
+
+    for (i = 0; i < module->nviews; i++)
+        refresh_sat_in_child(GTK_WIDGET(g_slist_nth_data(module->views, i)),
+                             sat->tle.catnr);
+
+    /* passes and the rotator plan of the radio and rotator controllers */
+    if (module->rigctrl != NULL)
+        gtk_rig_ctrl_refresh_sat(GTK_RIG_CTRL(module->rigctrl),
+                                 sat->tle.catnr);
+
+    if (module->rotctrl != NULL)
+        gtk_rot_ctrl_refresh_sat(GTK_ROT_CTRL(module->rotctrl),
+                                 sat->tle.catnr);
+
+    module->refresh_succ++;
+    sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                _("%s: New elements for #%d"), __func__, sat->tle.catnr);
+}
+
+/**
+ * Swap in refreshed satellites.
+ *
+ * This is a timeout callback started by gtk_sat_module_refresh_sats. It runs
+ * in the main loop between two module cycles and swaps in the satellites
+ * that are ready.
+ */
+static gboolean refresh_sats_timeout_cb(gpointer data)
+{
+    GtkSatModule   *module = GTK_SAT_MODULE(data);
+    sat_refresh_job_t *job;
+    guint           swapped = 0;
+
+    /* try again later if the module is busy */
+    if (g_mutex_trylock(&module->busy) == FALSE)
+        return TRUE;
+
+    while ((job = g_async_queue_try_pop(module->refreshed)) != NULL)
+    {
+        module->refresh_pending--;
+        if (job->sat != NULL)
+        {
+            swap_refreshed_sat(module, job->sat);
+            swapped++;
+        }
+        g_free(job);
+    }
+
+    /* GtkSkyGlance shows the passes of all satellites */
+    if (swapped > 0)
+        module->lastSkgUpd = 0.0;
+
+    g_mutex_unlock(&module->busy);
+
+    if (module->refresh_pending > 0)
+        return TRUE;
+
+    /* all jobs have been collected so the pool is idle */
+    g_thread_pool_free(module->refresher, FALSE, TRUE);
+    module->refresher = NULL;
+    g_async_queue_unref(module->refreshed);
+    module->refreshed = NULL;
+    module->refresh_id = 0;
+
+    sat_log_log(SAT_LOG_LEVEL_INFO,
+                _("%s: New elements for %d satellites in module %s"),
+                __func__, module->refresh_succ, module->name);
+
+    return FALSE;
+}
+
+/**
+ * Stop refreshing satellites and discard the results.
+ *
+ * Jobs that have not been started are run without reading anything, running
+ * jobs are waited for, and all of them are then freed.
+ */
+static void cancel_refresh_sats(GtkSatModule * module)
+{
+    sat_refresh_job_t *job;
+
+    if (module->refresh_id > 0)
+    {
+        g_source_remove(module->refresh_id);
+        module->refresh_id = 0;
+    }
+
+    if (module->refresher != NULL)
+    {
+        g_atomic_int_set(&module->refresh_cancel, 1);
+        g_thread_pool_free(module->refresher, FALSE, TRUE);
+        module->refresher = NULL;
+        g_atomic_int_set(&module->refresh_cancel, 0);
+    }
+
+    if (module->refreshed != NULL)
+    {
+        while ((job = g_async_queue_try_pop(module->refreshed)) != NULL)
+        {
+            gtk_sat_data_free_sat(job->sat);
+            g_free(job);
+        }
+        g_async_queue_unref(module->refreshed);
+        module->refreshed = NULL;
+    }
+
+    module->refresh_pending = 0;
+}
+
+/**
+ * Refresh the satellite elements after a TLE update.
+ *
+ * @param module Pointer to a GtkSatModule widget.
+ *
+ * Unlike gtk_sat_module_reload_sats, this function keeps the satellites and
+ * the views. The .sat files are read by a thread pool and only satellites
+ * whose epoch has changed are swapped in, between two module cycles. Their
+ * ground tracks and passes are recalculated; nothing else is reset, so
+ * selections are kept.
+ *
+ * The set of satellites in the module is not changed; use
+ * gtk_sat_module_reload_sats when the module configuration has changed.
+ */
+void gtk_sat_module_refresh_sats(GtkSatModule * module)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+    sat_refresh_job_t *job;
+    gdouble         maxdt;
+
+    g_return_if_fail(IS_GTK_SAT_MODULE(module));
+
+    /* the loader will pick up the new data */
+    if (module->load_id > 0)
+    {
+        gtk_sat_module_reload_sats(module);
+        return;
+    }
+
+    /* start over if a refresh is already running */
+    cancel_refresh_sats(module);
+
+    sat_log_log(SAT_LOG_LEVEL_INFO,
+                _("%s: Refreshing satellites for module %s"),
+                __func__, module->name);
+
+    maxdt = (gdouble) sat_cfg_get_int(SAT_CFG_INT_PRED_LOOK_AHEAD);
+
+    module->refresh_succ = 0;
+    module->refreshed = g_async_queue_new();
+    module->refresher = g_thread_pool_new(refresh_sat_worker, module,
+                                          MAX(1, g_get_num_processors()),
+                                          FALSE, NULL);
+
+    g_hash_table_iter_init(&iter, module->satellites);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        job = g_new0(sat_refresh_job_t, 1);
+        job->catnum = SAT(value)->tle.catnr;
+        job->epoch = SAT(value)->tle.epoch;
+        job->daynum = module->tmgCdnum;
+        job->maxdt = maxdt;
+        job->qth.lat = module->qth->lat;
+        job->qth.lon = module->qth->lon;
+        job->qth.alt = module->qth->alt;
+        module->refresh_pending++;
+        g_thread_pool_push(module->refresher, job, NULL);
+    }
+
+    module->refresh_id = g_timeout_add(50, refresh_sats_timeout_cb, module);
+}
+
 /** Select a new satellite */
 void gtk_sat_module_select_sat(GtkSatModule * module, gint catnum)
 {
@@ -68,6 +68,7 @@ struct _gtk_sat_module {
     guint           head_timeout;
     guint           event_count;
     guint           event_timeout;
+    GQueue         *event_queue;        /*!< Catalog numbers waiting for new AOS/LOS */
 
     /* layout and children */
     guint          *grid;       /*!< The grid layout array [(type,left,right,top,bottom),...] */
@@ -79,6 +80,22 @@ struct _gtk_sat_module {
     qth_small_t     qth_event;  /*!< QTH information for last AOS/LOS update. */
     GHashTable     *satellites; /*!< Satellites. */
 
+    /* satellite loading */
+    GThreadPool    *loader;     /*!< Worker pool reading satellites */
+    GAsyncQueue    *loaded;     /*!< Satellites ready to be added to the hash table */
+    guint           load_total; /*!< Number of satellites requested */
+    guint           load_pending;       /*!< Number of satellites not yet collected */
+    guint           load_succ;  /*!< Number of satellites successfully loaded */
+    guint           load_id;    /*!< Timeout source collecting loaded satellites */
+    gint            load_cancel;        /*!< Set to make the loader skip its jobs */
+
+    GThreadPool    *refresher;  /*!< Worker pool reading refreshed satellites */
+    GAsyncQueue    *refreshed;  /*!< Refreshed satellites ready to be swapped in */
+    guint           refresh_pending;    /*!< Number of satellites not yet collected */
+    guint           refresh_succ;       /*!< Number of satellites swapped in */
+    guint           refresh_id; /*!< Timeout source swapping in refreshed satellites */
+    gint            refresh_cancel;     /*!< Set to make the refresher skip its jobs */
+
     guint32         timeout;    /*!< Timeout value [msec] */
 
     gtk_sat_mod_state_t state;  /*!< The state of the module. */
@@ -131,6 +148,7 @@ void            gtk_sat_module_close_cb(GtkWidget * button, gpointer data);
 void            gtk_sat_module_config_cb(GtkWidget * button, gpointer data);
 
 void            gtk_sat_module_reload_sats(GtkSatModule * module);
+void            gtk_sat_module_refresh_sats(GtkSatModule * module);
 void            gtk_sat_module_reconf(GtkSatModule * module, gboolean local);
 void            gtk_sat_module_select_sat(GtkSatModule * module, gint catnum);
 
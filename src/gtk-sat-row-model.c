@@ -0,0 +1,540 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/**
+ * Tree model with one row per satellite.
+ *
+ * This is the common part of the satellite list and event list models. The
+ * shown rows are kept in an array in display order and the iterators point
+ * at the rows, so the GtkTreeModel functions are simple lookups. The model
+ * sorts the rows itself: the derived model computes a numeric key per row
+ * for the sort column, the nickname column is sorted by collation key, and
+ * ties are broken by catalogue number. The rows are mostly in order from one
+ * cycle to the next, so an insertion sort brings them back in order in about
+ * one comparison per row.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "gtk-sat-row-model.h"
+#include "orbit-tools.h"
+
+
+static void     gtk_sat_row_model_init(GtkSatRowModel * model,
+                                       gpointer g_class);
+static void     gtk_sat_row_model_class_init(GtkSatRowModelClass * class,
+                                             gpointer class_data);
+static void     gtk_sat_row_model_finalize(GObject * object);
+static void     tree_model_init(GtkTreeModelIface * iface, gpointer data);
+static void     tree_sortable_init(GtkTreeSortableIface * iface,
+                                   gpointer data);
+
+static GObjectClass *parent_class = NULL;
+
+
+GType gtk_sat_row_model_get_type()
+{
+    static GType    gtk_sat_row_model_type = 0;
+
+    if (!gtk_sat_row_model_type)
+    {
+        static const GTypeInfo gtk_sat_row_model_info = {
+            sizeof(GtkSatRowModelClass),
+            NULL,               /* base_init */
+            NULL,               /* base_finalize */
+            (GClassInitFunc) gtk_sat_row_model_class_init,
+            NULL,               /* class_finalize */
+            NULL,               /* class_data */
+            sizeof(GtkSatRowModel),
+            0,                  /* n_preallocs */
+            (GInstanceInitFunc) gtk_sat_row_model_init,
+            NULL
+        };
+        static const GInterfaceInfo tree_model_info = {
+            (GInterfaceInitFunc) tree_model_init,
+            NULL,
+            NULL
+        };
+        static const GInterfaceInfo tree_sortable_info = {
+            (GInterfaceInitFunc) tree_sortable_init,
+            NULL,
+            NULL
+        };
+
+        gtk_sat_row_model_type = g_type_register_static(G_TYPE_OBJECT,
+                                                        "GtkSatRowModel",
+                                                        &gtk_sat_row_model_info,
+                                                        G_TYPE_FLAG_ABSTRACT);
+        g_type_add_interface_static(gtk_sat_row_model_type,
+                                    GTK_TYPE_TREE_MODEL, &tree_model_info);
+        g_type_add_interface_static(gtk_sat_row_model_type,
+                                    GTK_TYPE_TREE_SORTABLE,
+                                    &tree_sortable_info);
+    }
+
+    return gtk_sat_row_model_type;
+}
+
+static void gtk_sat_row_model_class_init(GtkSatRowModelClass * class,
+                                         gpointer class_data)
+{
+    GObjectClass   *object_class = (GObjectClass *) class;
+
+    (void)class_data;
+
+    object_class->finalize = gtk_sat_row_model_finalize;
+
+    parent_class = g_type_class_peek_parent(class);
+}
+
+static void row_free(gpointer data)
+{
+    sat_row_t      *row = data;
+
+    g_free(row->name_key);
+    g_free(row->nickname);
+    g_free(row);
+}
+
+static void gtk_sat_row_model_init(GtkSatRowModel * model, gpointer g_class)
+{
+    (void)g_class;
+
+    model->sats = NULL;
+    model->rows = g_ptr_array_new_with_free_func(row_free);
+    model->hidden = g_ptr_array_new_with_free_func(row_free);
+    model->stamp = g_random_int();
+    model->sort_column = GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID;
+    model->sort_order = GTK_SORT_ASCENDING;
+}
+
+static void gtk_sat_row_model_finalize(GObject * object)
+{
+    GtkSatRowModel *model = GTK_SAT_ROW_MODEL(object);
+
+    g_ptr_array_free(model->rows, TRUE);
+    g_ptr_array_free(model->hidden, TRUE);
+
+    (*parent_class->finalize) (object);
+}
+
+/* GtkTreeModel interface; the rows are stored in the iterators */
+
+static GtkTreeModelFlags get_flags(GtkTreeModel * tree_model)
+{
+    (void)tree_model;
+
+    return GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+static gint get_n_columns(GtkTreeModel * tree_model)
+{
+    return GTK_SAT_ROW_MODEL_GET_CLASS(tree_model)->n_columns;
+}
+
+static GType get_column_type(GtkTreeModel * tree_model, gint index)
+{
+    GtkSatRowModelClass *klass = GTK_SAT_ROW_MODEL_GET_CLASS(tree_model);
+
+    g_return_val_if_fail(index >= 0 && index < klass->n_columns,
+                         G_TYPE_INVALID);
+
+    return klass->column_types[index];
+}
+
+static gboolean set_iter(GtkSatRowModel * model, GtkTreeIter * iter, gint n)
+{
+    if (n < 0 || (guint) n >= model->rows->len)
+    {
+        iter->stamp = 0;
+        return FALSE;
+    }
+
+    iter->stamp = model->stamp;
+    iter->user_data = g_ptr_array_index(model->rows, n);
+
+    return TRUE;
+}
+
+static gboolean get_iter(GtkTreeModel * tree_model, GtkTreeIter * iter,
+                         GtkTreePath * path)
+{
+    if (gtk_tree_path_get_depth(path) != 1)
+        return FALSE;
+
+    return set_iter(GTK_SAT_ROW_MODEL(tree_model), iter,
+                    gtk_tree_path_get_indices(path)[0]);
+}
+
+static GtkTreePath *get_path(GtkTreeModel * tree_model, GtkTreeIter * iter)
+{
+    sat_row_t      *row = iter->user_data;
+
+    g_return_val_if_fail(iter->stamp == GTK_SAT_ROW_MODEL(tree_model)->stamp,
+                         NULL);
+
+    return gtk_tree_path_new_from_indices(row->index, -1);
+}
+
+static void get_value(GtkTreeModel * tree_model, GtkTreeIter * iter,
+                      gint column, GValue * value)
+{
+    GtkSatRowModel *model = GTK_SAT_ROW_MODEL(tree_model);
+    GtkSatRowModelClass *klass = GTK_SAT_ROW_MODEL_GET_CLASS(model);
+
+    g_return_if_fail(iter->stamp == model->stamp);
+    g_return_if_fail(column >= 0 && column < klass->n_columns);
+
+    g_value_init(value, klass->column_types[column]);
+    klass->get_value(model, iter->user_data, column, value);
+}
+
+static gboolean iter_next(GtkTreeModel * tree_model, GtkTreeIter * iter)
+{
+    sat_row_t      *row = iter->user_data;
+
+    return set_iter(GTK_SAT_ROW_MODEL(tree_model), iter, row->index + 1);
+}
+
+static gboolean iter_children(GtkTreeModel * tree_model, GtkTreeIter * iter,
+                              GtkTreeIter * parent)
+{
+    if (parent != NULL)
+        return FALSE;
+
+    return set_iter(GTK_SAT_ROW_MODEL(tree_model), iter, 0);
+}
+
+static gboolean iter_has_child(GtkTreeModel * tree_model, GtkTreeIter * iter)
+{
+    (void)tree_model;
+    (void)iter;
+
+    return FALSE;
+}
+
+static gint iter_n_children(GtkTreeModel * tree_model, GtkTreeIter * iter)
+{
+    if (iter != NULL)
+        return 0;
+
+    return GTK_SAT_ROW_MODEL(tree_model)->rows->len;
+}
+
+static gboolean iter_nth_child(GtkTreeModel * tree_model, GtkTreeIter * iter,
+                               GtkTreeIter * parent, gint n)
+{
+    if (parent != NULL)
+        return FALSE;
+
+    return set_iter(GTK_SAT_ROW_MODEL(tree_model), iter, n);
+}
+
+static gboolean iter_parent(GtkTreeModel * tree_model, GtkTreeIter * iter,
+                            GtkTreeIter * child)
+{
+    (void)tree_model;
+    (void)iter;
+    (void)child;
+
+    return FALSE;
+}
+
+static void tree_model_init(GtkTreeModelIface * iface, gpointer data)
+{
+    (void)data;
+
+    iface->get_flags = get_flags;
+    iface->get_n_columns = get_n_columns;
+    iface->get_column_type = get_column_type;
+    iface->get_iter = get_iter;
+    iface->get_path = get_path;
+    iface->get_value = get_value;
+    iface->iter_next = iter_next;
+    iface->iter_children = iter_children;
+    iface->iter_has_child = iter_has_child;
+    iface->iter_n_children = iter_n_children;
+    iface->iter_nth_child = iter_nth_child;
+    iface->iter_parent = iter_parent;
+}
+
+/* Sorting */
+
+/* Compare two rows; ties are broken by catalogue number */
+static gint compare_rows(GtkSatRowModel * model, gint name_column,
+                         sat_row_t * a, sat_row_t * b)
+{
+    gint            result;
+
+    if (model->sort_column == name_column)
+        result = strcmp(a->name_key, b->name_key);
+    else
+        result = (a->key > b->key) - (a->key < b->key);
+
+    if (result == 0)
+        result = (a->catnum > b->catnum) - (a->catnum < b->catnum);
+
+    return (model->sort_order == GTK_SORT_DESCENDING) ? -result : result;
+}
+
+static gint compare_rows_ptr(gconstpointer a, gconstpointer b, gpointer data)
+{
+    GtkSatRowModel *model = GTK_SAT_ROW_MODEL(data);
+
+    return compare_rows(model, GTK_SAT_ROW_MODEL_GET_CLASS(model)->name_column,
+                        *(sat_row_t **) a, *(sat_row_t **) b);
+}
+
+/**
+ * Sort the shown rows and tell the view where they went.
+ *
+ * @param model The satellite row model.
+ * @param full TRUE to sort from scratch, FALSE if the rows are mostly in
+ *             order already.
+ */
+void gtk_sat_row_model_sort(GtkSatRowModel * model, gboolean full)
+{
+    GtkSatRowModelClass *klass = GTK_SAT_ROW_MODEL_GET_CLASS(model);
+    sat_row_t      *row;
+    GtkTreePath    *path;
+    gint           *new_order;
+    gboolean        moved = FALSE;
+    guint           i, j;
+
+    if (model->sort_column < 0 || model->rows->len < 2)
+        return;
+
+    if (model->sort_column != klass->name_column)
+        klass->prepare_keys(model);
+
+    if (full)
+    {
+        g_ptr_array_sort_with_data(model->rows, compare_rows_ptr, model);
+    }
+    else
+    {
+        for (i = 1; i < model->rows->len; i++)
+        {
+            row = g_ptr_array_index(model->rows, i);
+            for (j = i;
+                 j > 0 && compare_rows(model, klass->name_column,
+                                       g_ptr_array_index(model->rows, j - 1),
+                                       row) > 0; j--)
+            {
+                g_ptr_array_index(model->rows, j) =
+                    g_ptr_array_index(model->rows, j - 1);
+            }
+            g_ptr_array_index(model->rows, j) = row;
+        }
+    }
+
+    new_order = g_new(gint, model->rows->len);
+    for (i = 0; i < model->rows->len; i++)
+    {
+        row = g_ptr_array_index(model->rows, i);
+        new_order[i] = row->index;
+        if (row->index != i)
+            moved = TRUE;
+        row->index = i;
+    }
+
+    if (moved)
+    {
+        path = gtk_tree_path_new();
+        gtk_tree_model_rows_reordered(GTK_TREE_MODEL(model), path, NULL,
+                                      new_order);
+        gtk_tree_path_free(path);
+    }
+
+    g_free(new_order);
+}
+
+static gboolean get_sort_column_id(GtkTreeSortable * sortable,
+                                   gint * sort_column_id, GtkSortType * order)
+{
+    GtkSatRowModel *model = GTK_SAT_ROW_MODEL(sortable);
+
+    if (sort_column_id != NULL)
+        *sort_column_id = model->sort_column;
+    if (order != NULL)
+        *order = model->sort_order;
+
+    return (model->sort_column != GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID &&
+            model->sort_column != GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID);
+}
+
+static void set_sort_column_id(GtkTreeSortable * sortable,
+                               gint sort_column_id, GtkSortType order)
+{
+    GtkSatRowModel *model = GTK_SAT_ROW_MODEL(sortable);
+
+    /* there is no default sort function */
+    if (sort_column_id == GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID)
+        sort_column_id = GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID;
+
+    if (model->sort_column == sort_column_id && model->sort_order == order)
+        return;
+
+    model->sort_column = sort_column_id;
+    model->sort_order = order;
+
+    gtk_tree_sortable_sort_column_changed(sortable);
+    gtk_sat_row_model_sort(model, TRUE);
+}
+
+static gboolean has_default_sort_func(GtkTreeSortable * sortable)
+{
+    (void)sortable;
+
+    return FALSE;
+}
+
+static void tree_sortable_init(GtkTreeSortableIface * iface, gpointer data)
+{
+    (void)data;
+
+    iface->get_sort_column_id = get_sort_column_id;
+    iface->set_sort_column_id = set_sort_column_id;
+    iface->has_default_sort_func = has_default_sort_func;
+}
+
+/* Rows */
+
+/**
+ * Bring the collation key of a row up to date.
+ *
+ * @param row The row.
+ *
+ * The nickname changes when the elements are refreshed. The string may be
+ * reallocated at the same address, so it is compared by content.
+ */
+void gtk_sat_row_model_refresh_name(sat_row_t * row)
+{
+    if (g_strcmp0(row->nickname, row->sat->nickname) == 0)
+        return;
+
+    g_free(row->name_key);
+    g_free(row->nickname);
+    row->name_key = g_utf8_collate_key(row->sat->nickname, -1);
+    row->nickname = g_strdup(row->sat->nickname);
+}
+
+/**
+ * Append a row to the shown rows.
+ *
+ * @param model The satellite row model.
+ * @param row The row; the model takes it over.
+ */
+void gtk_sat_row_model_show(GtkSatRowModel * model, sat_row_t * row)
+{
+    GtkTreeIter     iter;
+    GtkTreePath    *path;
+
+    row->index = model->rows->len;
+    g_ptr_array_add(model->rows, row);
+
+    path = gtk_tree_path_new_from_indices(row->index, -1);
+    set_iter(model, &iter, row->index);
+    gtk_tree_model_row_inserted(GTK_TREE_MODEL(model), path, &iter);
+    gtk_tree_path_free(path);
+}
+
+/**
+ * Remove a row from the shown rows without freeing it.
+ *
+ * @param model The satellite row model.
+ * @param index The position of the row.
+ * @return The row; the caller takes it over.
+ */
+sat_row_t      *gtk_sat_row_model_unshow(GtkSatRowModel * model, guint index)
+{
+    sat_row_t      *row;
+    GtkTreePath    *path;
+    guint           i;
+
+    row = g_ptr_array_index(model->rows, index);
+
+    /* remove the row before telling the view, as GtkListStore does */
+    g_ptr_array_remove_index(model->rows, index);
+    for (i = index; i < model->rows->len; i++)
+        ((sat_row_t *) g_ptr_array_index(model->rows, i))->index = i;
+
+    path = gtk_tree_path_new_from_indices(index, -1);
+    gtk_tree_model_row_deleted(GTK_TREE_MODEL(model), path);
+    gtk_tree_path_free(path);
+
+    return row;
+}
+
+/**
+ * Add a new row to the model.
+ *
+ * @param model The satellite row model.
+ * @param row The row; the model takes it over.
+ *
+ * The row is shown unless the satellite has decayed.
+ */
+void gtk_sat_row_model_add(GtkSatRowModel * model, sat_row_t * row)
+{
+    row->catnum = row->sat->tle.catnr;
+    gtk_sat_row_model_refresh_name(row);
+
+    if (decayed(row->sat))
+        g_ptr_array_add(model->hidden, row);
+    else
+        gtk_sat_row_model_show(model, row);
+}
+
+/**
+ * Remove and free all rows.
+ *
+ * @param model The satellite row model.
+ */
+void gtk_sat_row_model_clear(GtkSatRowModel * model)
+{
+    while (model->rows->len > 0)
+        row_free(gtk_sat_row_model_unshow(model, model->rows->len - 1));
+    g_ptr_array_set_size(model->hidden, 0);
+}
+
+/**
+ * Tell the view that the values of a shown row have changed.
+ *
+ * @param model The satellite row model.
+ * @param row The row.
+ */
+void gtk_sat_row_model_row_changed(GtkSatRowModel * model, sat_row_t * row)
+{
+    GtkTreeIter     iter;
+    GtkTreePath    *path;
+
+    path = gtk_tree_path_new_from_indices(row->index, -1);
+    set_iter(model, &iter, row->index);
+    gtk_tree_model_row_changed(GTK_TREE_MODEL(model), path, &iter);
+    gtk_tree_path_free(path);
+}
@@ -0,0 +1,120 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef __GTK_SAT_ROW_MODEL_H__
+#define __GTK_SAT_ROW_MODEL_H__ 1
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include "gtk-sat-data.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#define GTK_TYPE_SAT_ROW_MODEL   (gtk_sat_row_model_get_type ())
+#define GTK_SAT_ROW_MODEL(obj)   G_TYPE_CHECK_INSTANCE_CAST (obj,\
+                                     gtk_sat_row_model_get_type (),\
+                                     GtkSatRowModel)
+#define GTK_SAT_ROW_MODEL_GET_CLASS(obj) G_TYPE_INSTANCE_GET_CLASS (obj,\
+                                     gtk_sat_row_model_get_type (),\
+                                     GtkSatRowModelClass)
+#define IS_GTK_SAT_ROW_MODEL(obj) G_TYPE_CHECK_INSTANCE_TYPE (obj, gtk_sat_row_model_get_type ())
+
+typedef struct _GtkSatRowModel GtkSatRowModel;
+typedef struct _GtkSatRowModelClass GtkSatRowModelClass;
+
+/**
+ * A row of a satellite row model.
+ *
+ * The rows of the derived models start with this structure. They must not
+ * own any other memory, as they are freed by the base model.
+ */
+typedef struct {
+    sat_t          *sat;        /*!< The satellite. */
+    gint            catnum;     /*!< Catalogue number of the satellite. */
+    guint           index;      /*!< Position in the shown rows. */
+    gdouble         key;        /*!< Sort key in this cycle. */
+    gchar          *name_key;   /*!< Collation key of the nickname. */
+    gchar          *nickname;   /*!< Nickname the collation key was made of. */
+} sat_row_t;
+
+/**
+ * Abstract list model with one row per satellite.
+ *
+ * The model keeps the shown rows in display order and the rows of decayed
+ * satellites aside, implements GtkTreeModel on top of them and sorts the
+ * rows itself. The derived models provide the columns and the sort keys.
+ */
+struct _GtkSatRowModel {
+    GObject         parent;
+
+    GHashTable     *sats;       /*!< Satellites of the module. */
+
+    GPtrArray      *rows;       /*!< Shown rows in display order. */
+    GPtrArray      *hidden;     /*!< Rows of decayed satellites. */
+    gint            stamp;      /*!< Stamp of valid iterators. */
+
+    gint            sort_column;        /*!< Sort column or GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID. */
+    GtkSortType     sort_order; /*!< Sort order. */
+};
+
+struct _GtkSatRowModelClass {
+    GObjectClass    parent_class;
+
+    gint            n_columns;  /*!< Number of columns. */
+    const GType    *column_types;       /*!< Column types indexed by column. */
+    gint            name_column;        /*!< Column sorted by the nickname. */
+
+    /** Set the value of a cell; value is initialised to the column type. */
+    void            (*get_value) (GtkSatRowModel * model, sat_row_t * row,
+                                  gint column, GValue * value);
+
+    /** Compute the sort keys of the shown rows for the sort column. */
+    void            (*prepare_keys) (GtkSatRowModel * model);
+};
+
+GType           gtk_sat_row_model_get_type(void);
+void            gtk_sat_row_model_refresh_name(sat_row_t * row);
+void            gtk_sat_row_model_add(GtkSatRowModel * model, sat_row_t * row);
+void            gtk_sat_row_model_show(GtkSatRowModel * model,
+                                       sat_row_t * row);
+sat_row_t      *gtk_sat_row_model_unshow(GtkSatRowModel * model,
+                                         guint index);
+void            gtk_sat_row_model_clear(GtkSatRowModel * model);
+void            gtk_sat_row_model_row_changed(GtkSatRowModel * model,
+                                              sat_row_t * row);
+void            gtk_sat_row_model_sort(GtkSatRowModel * model,
+                                       gboolean full);
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+}
+#endif
+/* *INDENT-ON* */
+
+#endif
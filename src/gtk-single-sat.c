@@ -32,6 +32,7 @@
 #include "mod-cfg-get-param.h"
 #include "orbit-tools.h"
 #include "predict-tools.h"
+#include "radec-tools.h"
 #include "sat-cfg.h"
 #include "sat-info.h"
 #include "sat-log.h"
@@ -394,52 +395,6 @@ static void store_sats(gpointer key, gpointer value, gpointer user_data)
                                              (GCompareFunc) sat_name_compare);
 }
 
-static void Calculate_RADec(sat_t * sat, qth_t * qth, obs_astro_t * obs_set)
-{
-    /* Reference:  Methods of Orbit Determination by  */
-    /*                Pedro Ramon Escobal, pp. 401-402 */
-
-    double          phi, theta, sin_theta, cos_theta, sin_phi, cos_phi,
-        az, el, Lxh, Lyh, Lzh, Sx, Ex, Zx, Sy, Ey, Zy, Sz, Ez, Zz,
-        Lx, Ly, Lz, cos_delta, sin_alpha, cos_alpha;
-    geodetic_t      geodetic;
-
-    geodetic.lon = qth->lon * de2ra;
-    geodetic.lat = qth->lat * de2ra;
-    geodetic.alt = qth->alt / 1000.0;
-    geodetic.theta = 0;
-
-    az = sat->az * de2ra;
-    el = sat->el * de2ra;
-    phi = geodetic.lat;
-    theta = FMod2p(ThetaG_JD(sat->jul_utc) + geodetic.lon);
-    sin_theta = sin(theta);
-    cos_theta = cos(theta);
-    sin_phi = sin(phi);
-    cos_phi = cos(phi);
-    Lxh = -cos(az) * cos(el);
-    Lyh = sin(az) * cos(el);
-    Lzh = sin(el);
-    Sx = sin_phi * cos_theta;
-    Ex = -sin_theta;
-    Zx = cos_theta * cos_phi;
-    Sy = sin_phi * sin_theta;
-    Ey = cos_theta;
-    Zy = sin_theta * cos_phi;
-    Sz = -cos_phi;
-    Ez = 0;
-    Zz = sin_phi;
-    Lx = Sx * Lxh + Ex * Lyh + Zx * Lzh;
-    Ly = Sy * Lxh + Ey * Lyh + Zy * Lzh;
-    Lz = Sz * Lxh + Ez * Lyh + Zz * Lzh;
-    obs_set->dec = ArcSin(Lz);  /* Declination (radians) */
-    cos_delta = sqrt(1 - Sqr(Lz));
-    sin_alpha = Ly / cos_delta;
-    cos_alpha = Lx / cos_delta;
-    obs_set->ra = AcTan(sin_alpha, cos_alpha);  /* Right Ascension (radians) */
-    obs_set->ra = FMod2p(obs_set->ra);
-}
-
 static void select_satellite(GtkWidget * menuitem, gpointer data)
 {
     GtkSingleSat   *ssat = GTK_SINGLE_SAT(data);
@@ -660,13 +615,12 @@ void gtk_single_sat_update(GtkWidget * widget)
         if ((ssat->flags & SINGLE_SAT_FLAG_RA) ||
             (ssat->flags & SINGLE_SAT_FLAG_DEC))
         {
-            obs_astro_t     astro;
             sat_t          *sat =
                 SAT(g_slist_nth_data(ssat->sats, ssat->selected));
 
-            Calculate_RADec(sat, ssat->qth, &astro);
-            sat->ra = Degrees(astro.ra);
-            sat->dec = Degrees(astro.dec);
+            radec_frame_set(&ssat->frame, ssat->qth, sat->jul_utc);
+            radec_from_azel(&ssat->frame, 1, &sat->az, &sat->el,
+                            &sat->ra, &sat->dec, NULL);
         }
 
         /* update visible fields one by one */
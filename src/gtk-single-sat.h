@@ -7,6 +7,7 @@
 
 #include "gtk-sat-data.h"
 #include "gtk-sat-module.h"
+#include "radec-tools.h"
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -97,6 +98,7 @@ struct _gtk_single_sat {
     GKeyFile       *cfgdata;    /*!< Configuration data. */
     GSList         *sats;       /*!< Satellites. */
     qth_t          *qth;        /*!< Pointer to current location. */
+    radec_frame_t   frame;      /*!< Observer frame for RA/Dec. */
 
 
     guint32         flags;      /*!< Flags indicating which columns are visible. */
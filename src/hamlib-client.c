@@ -0,0 +1,593 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Client for the rigctld and rotctld network daemons of hamlib.
+ *
+ * All sockets are non-blocking and are served by a single I/O thread
+ * running its own GLib main context, so a stalled daemon can never block
+ * a controller beyond the deadline of its command. Controllers talking to
+ * the same host:port share one connection; their commands are written in
+ * the order they are submitted and the replies are matched in the same
+ * order using the reply framing given with each command.
+ *
+ * A failed or stalled connection is closed, every command waiting on it
+ * fails, and a new connection attempt is made after a backoff delay that
+ * doubles on each failure. Commands submitted while the connection is
+ * down fail right away; commands submitted while connecting are sent once
+ * the connection is up.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <gio/gio.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <string.h>
+
+#include "hamlib-client.h"
+#include "sat-log.h"
+
+
+#define CONNECT_TIMEOUT  5      /*!< Connection timeout in seconds */
+#define BACKOFF_MIN    500      /*!< First reconnect delay in msec */
+#define BACKOFF_MAX  10000      /*!< Longest reconnect delay in msec */
+
+typedef enum {
+    CONN_DOWN = 0,              /*!< Waiting for the next connection attempt */
+    CONN_CONNECTING,            /*!< Connection attempt in progress */
+    CONN_UP                     /*!< Connected */
+} conn_state_t;
+
+struct _hamlib_conn {
+    gchar          *key;        /*!< host:port; key in the connection table */
+    gchar          *host;
+    gint            port;
+    gint            refcount;   /*!< Protected by conns_lock */
+
+    /* the fields below are only used by the I/O thread */
+    conn_state_t    state;
+    gboolean        closing;    /*!< Last reference dropped while connecting */
+    GCancellable   *cancel;     /*!< Cancels the connection attempt */
+    GSocketConnection *connection;
+    GSocket        *socket;
+    GSource        *insrc;      /*!< Readable socket */
+    GSource        *outsrc;     /*!< Writable socket; only while outbuf is full */
+    GSource        *retrysrc;   /*!< Reconnect timer */
+    GString        *outbuf;     /*!< Data not yet written to the socket */
+    GString        *line;       /*!< Partially received line */
+    GQueue         *pending;    /*!< Commands waiting for a reply */
+    guint           backoff;    /*!< Next reconnect delay in msec */
+};
+
+/* A command submitted by a controller thread */
+typedef struct {
+    hamlib_conn_t  *conn;
+    const gchar    *cmd;
+    hamlib_reply_t  type;
+    gint            n;          /*!< Number of lines or replies expected */
+    gint            count;      /*!< Number of lines or replies received */
+    guint           timeout;    /*!< Deadline in msec */
+    GString        *reply;
+    GSource        *timer;      /*!< Deadline timer */
+    gboolean        done;       /*!< Protected by req_lock */
+    gboolean        ok;
+} hamlib_req_t;
+
+static GMutex   conns_lock;
+static GHashTable *conns = NULL;
+static GMainContext *io_context = NULL;
+
+static GMutex   req_lock;
+static GCond    req_cond;
+
+static void     conn_fail(hamlib_conn_t * conn);
+static gboolean conn_flush_cb(GSocket * socket, GIOCondition cond,
+                              gpointer data);
+
+
+static gpointer io_thread(gpointer data)
+{
+    GMainLoop      *loop;
+
+    (void)data;
+
+    g_main_context_push_thread_default(io_context);
+    loop = g_main_loop_new(io_context, FALSE);
+    g_main_loop_run(loop);
+
+    return NULL;
+}
+
+/* Attach a source to the I/O context and return it with a reference */
+static GSource *io_attach(GSource * source, GSourceFunc func, gpointer data)
+{
+    g_source_set_callback(source, func, data, NULL);
+    g_source_attach(source, io_context);
+
+    return source;
+}
+
+static void io_detach(GSource ** source)
+{
+    if (*source != NULL)
+    {
+        g_source_destroy(*source);
+        g_source_unref(*source);
+        *source = NULL;
+    }
+}
+
+/* Hand a finished command back to the waiting controller */
+static void req_finish(hamlib_req_t * req, gboolean ok)
+{
+    io_detach(&req->timer);
+
+    g_mutex_lock(&req_lock);
+    req->ok = ok;
+    req->done = TRUE;
+    g_cond_broadcast(&req_cond);
+    g_mutex_unlock(&req_lock);
+}
+
+static void conn_free(hamlib_conn_t * conn)
+{
+    g_clear_object(&conn->cancel);
+    g_queue_free(conn->pending);
+    g_string_free(conn->outbuf, TRUE);
+    g_string_free(conn->line, TRUE);
+    g_free(conn->host);
+    g_free(conn->key);
+    g_free(conn);
+}
+
+static void conn_disconnect(hamlib_conn_t * conn)
+{
+    io_detach(&conn->insrc);
+    io_detach(&conn->outsrc);
+
+    if (conn->connection != NULL)
+    {
+        g_io_stream_close(G_IO_STREAM(conn->connection), NULL, NULL);
+        g_object_unref(conn->connection);
+        conn->connection = NULL;
+        conn->socket = NULL;
+    }
+
+    g_string_truncate(conn->outbuf, 0);
+    g_string_truncate(conn->line, 0);
+}
+
+/* Write as much of the output buffer as the socket accepts */
+static void conn_flush(hamlib_conn_t * conn)
+{
+    GError         *err = NULL;
+    gssize          n;
+
+    while (conn->outbuf->len > 0)
+    {
+        n = g_socket_send(conn->socket, conn->outbuf->str, conn->outbuf->len,
+                          NULL, &err);
+        if (n < 0)
+        {
+            if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+            {
+                g_error_free(err);
+                if (conn->outsrc == NULL)
+                    conn->outsrc =
+                        io_attach(g_socket_create_source(conn->socket,
+                                                         G_IO_OUT, NULL),
+                                  (GSourceFunc) conn_flush_cb, conn);
+                return;
+            }
+
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s: Failed to send to %s: %s"),
+                        __func__, conn->key, err->message);
+            g_error_free(err);
+            conn_fail(conn);
+            return;
+        }
+
+        g_string_erase(conn->outbuf, 0, n);
+    }
+
+    io_detach(&conn->outsrc);
+}
+
+static gboolean conn_flush_cb(GSocket * socket, GIOCondition cond,
+                              gpointer data)
+{
+    (void)socket;
+    (void)cond;
+
+    conn_flush((hamlib_conn_t *) data);
+
+    return TRUE;
+}
+
+/* Add a received line to the reply of the oldest pending command */
+static void conn_line(hamlib_conn_t * conn, const gchar * line)
+{
+    hamlib_req_t   *req;
+    gboolean        rprt;
+
+    req = g_queue_peek_head(conn->pending);
+    if (req == NULL)
+    {
+        sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                    _("%s: Unexpected data from %s: %s"),
+                    __func__, conn->key, line);
+        return;
+    }
+
+    g_string_append(req->reply, line);
+    g_string_append_c(req->reply, '\n');
+
+    rprt = g_str_has_prefix(line, "RPRT");
+    if (req->type == HAMLIB_REPLY_EXTENDED)
+    {
+        if (rprt)
+            req->count++;
+    }
+    else
+    {
+        req->count = rprt ? req->n : req->count + 1;
+    }
+
+    if (req->count >= req->n)
+    {
+        g_queue_pop_head(conn->pending);
+        req_finish(req, TRUE);
+    }
+}
+
+static gboolean conn_read_cb(GSocket * socket, GIOCondition cond,
+                             gpointer data)
+{
+    hamlib_conn_t  *conn = data;
+    GError         *err = NULL;
+    gchar           buff[256];
+    gssize          n, i;
+
+    (void)cond;
+
+    n = g_socket_receive(socket, buff, sizeof(buff), NULL, &err);
+    if (n < 0 && g_error_matches(err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+    {
+        g_error_free(err);
+        return TRUE;
+    }
+    if (n <= 0)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Connection to %s closed: %s"), __func__,
+                    conn->key, (err != NULL) ? err->message : _("end of file"));
+        g_clear_error(&err);
+        conn_fail(conn);
+        return FALSE;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        if (buff[i] == '\n')
+        {
+            conn_line(conn, conn->line->str);
+            g_string_truncate(conn->line, 0);
+        }
+        else if (buff[i] != '\r')
+        {
+            g_string_append_c(conn->line, buff[i]);
+        }
+    }
+
+    return TRUE;
+}
+
+static void conn_connected_cb(GObject * source, GAsyncResult * res,
+                              gpointer data)
+{
+    hamlib_conn_t  *conn = data;
+    GSocketConnection *connection;
+    GError         *err = NULL;
+    GList          *node;
+
+    connection =
+        g_socket_client_connect_to_host_finish(G_SOCKET_CLIENT(source), res,
+                                               &err);
+    g_object_unref(source);
+
+    if (conn->closing)
+    {
+        if (connection != NULL)
+            g_object_unref(connection);
+        g_clear_error(&err);
+        conn_free(conn);
+        return;
+    }
+
+    if (connection == NULL)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Connection to %s failed: %s"),
+                    __func__, conn->key, err->message);
+        g_error_free(err);
+        conn_fail(conn);
+        return;
+    }
+
+    sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                _("%s: Connection opened to %s"), __func__, conn->key);
+
+    conn->connection = connection;
+    conn->socket = g_socket_connection_get_socket(connection);
+    g_socket_set_blocking(conn->socket, FALSE);
+    conn->state = CONN_UP;
+    conn->backoff = BACKOFF_MIN;
+    conn->insrc = io_attach(g_socket_create_source(conn->socket,
+                                                   G_IO_IN | G_IO_ERR |
+                                                   G_IO_HUP, NULL),
+                            (GSourceFunc) conn_read_cb, conn);
+
+    /* send the commands submitted while connecting */
+    for (node = conn->pending->head; node != NULL; node = node->next)
+        g_string_append(conn->outbuf, ((hamlib_req_t *) node->data)->cmd);
+    conn_flush(conn);
+}
+
+static void conn_connect(hamlib_conn_t * conn)
+{
+    GSocketClient  *client;
+
+    conn->state = CONN_CONNECTING;
+    g_clear_object(&conn->cancel);
+    conn->cancel = g_cancellable_new();
+
+    client = g_socket_client_new();
+    g_socket_client_set_timeout(client, CONNECT_TIMEOUT);
+    g_socket_client_connect_to_host_async(client, conn->host, conn->port,
+                                          conn->cancel, conn_connected_cb,
+                                          conn);
+}
+
+static gboolean conn_retry_cb(gpointer data)
+{
+    hamlib_conn_t  *conn = data;
+
+    io_detach(&conn->retrysrc);
+    conn_connect(conn);
+
+    return FALSE;
+}
+
+/* Drop the connection, fail pending commands and schedule a reconnect */
+static void conn_fail(hamlib_conn_t * conn)
+{
+    hamlib_req_t   *req;
+
+    conn_disconnect(conn);
+    while ((req = g_queue_pop_head(conn->pending)) != NULL)
+        req_finish(req, FALSE);
+
+    sat_log_log(SAT_LOG_LEVEL_INFO,
+                _("%s: Reconnecting to %s in %u msec"),
+                __func__, conn->key, conn->backoff);
+
+    conn->state = CONN_DOWN;
+    conn->retrysrc = io_attach(g_timeout_source_new(conn->backoff),
+                               conn_retry_cb, conn);
+    conn->backoff = MIN(conn->backoff * 2, BACKOFF_MAX);
+}
+
+static gboolean conn_start_cb(gpointer data)
+{
+    conn_connect((hamlib_conn_t *) data);
+
+    return FALSE;
+}
+
+static gboolean conn_close_cb(gpointer data)
+{
+    hamlib_conn_t  *conn = data;
+
+    io_detach(&conn->retrysrc);
+
+    if (conn->state == CONN_CONNECTING)
+    {
+        /* conn_connected_cb() frees the connection */
+        conn->closing = TRUE;
+        g_cancellable_cancel(conn->cancel);
+        return FALSE;
+    }
+
+    /* let the daemon know that we are leaving */
+    if (conn->state == CONN_UP)
+        g_socket_send(conn->socket, "q\n", 2, NULL, NULL);
+
+    conn_disconnect(conn);
+    conn_free(conn);
+
+    return FALSE;
+}
+
+static gboolean req_timeout_cb(gpointer data)
+{
+    hamlib_req_t   *req = data;
+    hamlib_conn_t  *conn = req->conn;
+
+    sat_log_log(SAT_LOG_LEVEL_ERROR,
+                _("%s: No reply from %s within %u msec"),
+                __func__, conn->key, req->timeout);
+
+    if (conn->state == CONN_UP)
+    {
+        /* a late reply would be taken for the reply to the next command */
+        conn_fail(conn);
+    }
+    else
+    {
+        g_queue_remove(conn->pending, req);
+        req_finish(req, FALSE);
+    }
+
+    return FALSE;
+}
+
+static gboolean req_submit_cb(gpointer data)
+{
+    hamlib_req_t   *req = data;
+    hamlib_conn_t  *conn = req->conn;
+
+    if (conn->state == CONN_DOWN)
+    {
+        req_finish(req, FALSE);
+        return FALSE;
+    }
+
+    req->timer = io_attach(g_timeout_source_new(req->timeout),
+                           req_timeout_cb, req);
+    g_queue_push_tail(conn->pending, req);
+
+    if (conn->state == CONN_UP)
+    {
+        g_string_append(conn->outbuf, req->cmd);
+        conn_flush(conn);
+    }
+
+    return FALSE;
+}
+
+/**
+ * Open a connection to a hamlib daemon.
+ *
+ * @param host The host name of the daemon.
+ * @param port The port of the daemon.
+ * @return The connection, shared with other users of the same host:port.
+ *
+ * The connection is established in the background; commands submitted in
+ * the meantime are sent as soon as it is up.
+ */
+hamlib_conn_t  *hamlib_conn_open(const gchar * host, gint port)
+{
+    hamlib_conn_t  *conn;
+    gchar          *key;
+
+    g_mutex_lock(&conns_lock);
+
+    if (conns == NULL)
+    {
+        conns = g_hash_table_new(g_str_hash, g_str_equal);
+        io_context = g_main_context_new();
+        g_thread_unref(g_thread_new("hamlib_io", io_thread, NULL));
+    }
+
+    key = g_strdup_printf("%s:%d", host, port);
+    conn = g_hash_table_lookup(conns, key);
+    if (conn != NULL)
+    {
+        conn->refcount++;
+        g_free(key);
+    }
+    else
+    {
+        conn = g_new0(hamlib_conn_t, 1);
+        conn->key = key;
+        conn->host = g_strdup(host);
+        conn->port = port;
+        conn->refcount = 1;
+        conn->state = CONN_CONNECTING;
+        conn->pending = g_queue_new();
+        conn->outbuf = g_string_sized_new(128);
+        conn->line = g_string_sized_new(64);
+        conn->backoff = BACKOFF_MIN;
+        g_hash_table_insert(conns, conn->key, conn);
+        g_main_context_invoke(io_context, conn_start_cb, conn);
+    }
+
+    g_mutex_unlock(&conns_lock);
+
+    return conn;
+}
+
+/**
+ * Release a connection.
+ *
+ * The connection is closed when its last user has released it.
+ */
+void hamlib_conn_close(hamlib_conn_t * conn)
+{
+    if (conn == NULL)
+        return;
+
+    g_mutex_lock(&conns_lock);
+    if (--conn->refcount == 0)
+    {
+        g_hash_table_remove(conns, conn->key);
+        g_main_context_invoke(io_context, conn_close_cb, conn);
+    }
+    g_mutex_unlock(&conns_lock);
+}
+
+/**
+ * Send a command to the daemon and wait for the reply.
+ *
+ * @param conn The connection.
+ * @param cmd The command including the trailing newline. Several commands
+ *            can be sent at once using the extended response protocol.
+ * @param type How the end of the reply is recognised.
+ * @param n The number of reply lines (plain) or replies (extended).
+ * @param timeout The deadline in msec.
+ * @param reply The reply lines, each terminated by a newline.
+ * @return TRUE if the complete reply has been received in time, FALSE
+ *         if the connection is down, failed or the deadline expired.
+ *
+ * Blocks the calling thread until the reply has arrived, the connection
+ * has failed or the deadline has expired.
+ */
+gboolean hamlib_conn_exec(hamlib_conn_t * conn, const gchar * cmd,
+                          hamlib_reply_t type, gint n, guint timeout,
+                          GString * reply)
+{
+    hamlib_req_t    req;
+
+    memset(&req, 0, sizeof(req));
+    req.conn = conn;
+    req.cmd = cmd;
+    req.type = type;
+    req.n = MAX(n, 1);
+    req.timeout = timeout;
+    req.reply = reply;
+    g_string_truncate(reply, 0);
+
+    g_main_context_invoke(io_context, req_submit_cb, &req);
+
+    /* the I/O thread finishes every command, at the latest on its deadline */
+    g_mutex_lock(&req_lock);
+    while (!req.done)
+        g_cond_wait(&req_cond, &req_lock);
+    g_mutex_unlock(&req_lock);
+
+    return req.ok;
+}
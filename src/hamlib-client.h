@@ -0,0 +1,45 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef HAMLIB_CLIENT_H
+#define HAMLIB_CLIENT_H 1
+
+#include <glib.h>
+
+/** Connection to a rigctld or rotctld daemon. */
+typedef struct _hamlib_conn hamlib_conn_t;
+
+/** How the end of a reply is recognised. */
+typedef enum {
+    HAMLIB_REPLY_PLAIN = 0,     /*!< n lines, or a single RPRT line */
+    HAMLIB_REPLY_EXTENDED = 1   /*!< n replies, each ending with a RPRT line */
+} hamlib_reply_t;
+
+hamlib_conn_t  *hamlib_conn_open(const gchar * host, gint port);
+void            hamlib_conn_close(hamlib_conn_t * conn);
+gboolean        hamlib_conn_exec(hamlib_conn_t * conn, const gchar * cmd,
+                                 hamlib_reply_t type, gint n, guint timeout,
+                                 GString * reply);
+
+#endif
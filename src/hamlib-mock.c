@@ -0,0 +1,895 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Mock rigctld and rotctld for testing the radio and rotator controllers
+ * without hardware.
+ *
+ *   hamlib-mock serve      Run a mock rigctld and rotctld until killed.
+ *   hamlib-mock bench-rig  Track the Doppler shift of a pass on the mock rig
+ *                          and report the frequency error.
+ *   hamlib-mock bench-rot  Track a pass with the mock rotator and report the
+ *                          pointing error.
+ *
+ * The mocks implement the commands used by gpredict (F f I i S t T P p q
+ * and get_dcd) in the plain and in the extended '+' response protocol. Each
+ * command is answered after a configurable latency with random jitter. The
+ * rig rounds frequencies to its tuning step and the rotator moves towards
+ * the commanded position at a limited slew rate.
+ *
+ * The benchmarks use the real client in hamlib-client.c, the tuning policy
+ * in rig-tuning.c and the trajectory planner in rot-planner.c, driven the
+ * way gtk-rig-ctrl.c and gtk-rot-ctrl.c drive them. A sampler compares the
+ * state of the mock with the ideal values of the pass every 10 ms. The pass
+ * is either read from a file with one "t az el range_rate" sample per line
+ * (seconds, degrees, km/s) or a synthetic LEO pass.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <gio/gio.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-stubs.h"
+#include "hamlib-client.h"
+#include "rig-tuning.h"
+#include "rot-planner.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+#define C_KMS        299792.458 /* speed of light in km/s */
+#define EARTH_R      6378.135   /* Earth radius in km */
+#define SAMPLE_USEC  10000      /* sampling period of the benchmarks */
+#define MIN_DELAY    100000     /* shortest benchmark cycle in usec */
+#define CMD_TIMEOUT  3000       /* command deadline in msec */
+#define MAX_LAG      10.0       /* longest lead for rotator lag in sec */
+
+/* command line options */
+static gint     rig_port = 4532;
+static gint     rot_port = 4533;
+static gdouble  latency = 20.0;
+static gdouble  jitter = 5.0;
+static gdouble  step = 10.0;
+static gdouble  slew = 6.0;
+static gdouble  freq0 = 435.0e6;
+static gint     cycle = 1000;
+static gint     update = 1000;
+static gdouble  threshold = 5.0;
+static gdouble  speed = 1.0;
+static gdouble  offset = 10.0;
+static gchar   *passfile = NULL;
+
+static GOptionEntry options[] = {
+    {"rig-port", 0, 0, G_OPTION_ARG_INT, &rig_port,
+     "Port of the mock rigctld (serve)", "PORT"},
+    {"rot-port", 0, 0, G_OPTION_ARG_INT, &rot_port,
+     "Port of the mock rotctld (serve)", "PORT"},
+    {"latency", 'l', 0, G_OPTION_ARG_DOUBLE, &latency,
+     "Response latency in msec", "MS"},
+    {"jitter", 'j', 0, G_OPTION_ARG_DOUBLE, &jitter,
+     "Random extra latency up to this many msec", "MS"},
+    {"step", 's', 0, G_OPTION_ARG_DOUBLE, &step,
+     "Tuning step of the rig in Hz", "HZ"},
+    {"slew", 'r', 0, G_OPTION_ARG_DOUBLE, &slew,
+     "Slew rate of the rotator in deg/s", "DEG"},
+    {"freq", 'f', 0, G_OPTION_ARG_DOUBLE, &freq0,
+     "Downlink frequency of the satellite in Hz", "HZ"},
+    {"cycle", 'c', 0, G_OPTION_ARG_INT, &cycle,
+     "Longest controller cycle in msec", "MS"},
+    {"update", 'u', 0, G_OPTION_ARG_INT, &update,
+     "Module refresh period for the rig benchmark in msec", "MS"},
+    {"threshold", 't', 0, G_OPTION_ARG_DOUBLE, &threshold,
+     "Rotator motion threshold in deg", "DEG"},
+    {"speed", 'x', 0, G_OPTION_ARG_DOUBLE, &speed,
+     "Play the pass this many times faster than real time; latency and "
+     "slew rate are not scaled", "X"},
+    {"offset", 'o', 0, G_OPTION_ARG_DOUBLE, &offset,
+     "Cross track angle of the synthetic pass in deg", "DEG"},
+    {"pass", 'p', 0, G_OPTION_ARG_FILENAME, &passfile,
+     "Recorded pass with \"t az el range_rate\" lines", "FILE"},
+    {"verbose", 'v', 0, G_OPTION_ARG_NONE, &bench_verbose,
+     "Log client errors and debug messages", NULL},
+    {NULL, 0, 0, 0, NULL, NULL, NULL}
+};
+
+
+/* State of the mock devices; protected by lock */
+typedef struct {
+    GMutex          lock;
+    gdouble         freq;       /*!< Main VFO */
+    gdouble         freqtx;     /*!< Split VFO */
+    gboolean        ptt;
+    gboolean        split;
+    gdouble         az, el;     /*!< Current rotator position */
+    gdouble         taz, tel;   /*!< Commanded rotator position */
+    gint64          tmove;      /*!< Time of the last position update */
+    guint           cmds;       /*!< Commands served */
+} mock_t;
+
+static mock_t   mock;
+
+/* One sample of a pass */
+typedef struct {
+    gdouble         t;          /*!< Seconds since the start of the pass */
+    gdouble         az, el;     /*!< Degrees */
+    gdouble         rr;         /*!< Range rate in km/s */
+} pass_sample_t;
+
+static GArray  *pass = NULL;
+static gint64   tstart;         /* monotonic time when playback started */
+
+
+/* Move the rotator towards the commanded position; lock must be held */
+static void mock_rot_move(gint64 now)
+{
+    gdouble         maxd = slew * (now - mock.tmove) / 1.0e6;
+
+    mock.az += CLAMP(mock.taz - mock.az, -maxd, maxd);
+    mock.el += CLAMP(mock.tel - mock.el, -maxd, maxd);
+    mock.tmove = now;
+}
+
+/* Round a frequency to the tuning step of the mock rig */
+static gdouble mock_quantise(gdouble freq)
+{
+    return (step > 1.0) ? step * floor(freq / step + 0.5) : floor(freq + 0.5);
+}
+
+/*
+ * Execute one command.
+ *
+ * @param rig TRUE for the rigctld, FALSE for the rotctld command set.
+ * @param cmd The command line without prefix and newline.
+ * @param name Returns the long command name used in extended replies.
+ * @param reply Returns the value lines of the reply as "Name: value".
+ * @return The RPRT code or 1 if the reply consists of the values only.
+ */
+static gint mock_exec(gboolean rig, const gchar * cmd, const gchar ** name,
+                      GString * reply)
+{
+    gchar           c = cmd[0];
+    const gchar    *args = (cmd[0] != '\0') ? cmd + 1 : cmd;
+    gdouble         a, b;
+    gint            ret = 0;
+
+    g_mutex_lock(&mock.lock);
+    mock.cmds++;
+
+    if (rig)
+    {
+        switch (c)
+        {
+        case 'F':
+            *name = "set_freq";
+            mock.freq = mock_quantise(g_ascii_strtod(args, NULL));
+            break;
+        case 'f':
+            *name = "get_freq";
+            g_string_append_printf(reply, "Frequency: %.0f\n", mock.freq);
+            ret = 1;
+            break;
+        case 'I':
+            *name = "set_split_freq";
+            mock.freqtx = mock_quantise(g_ascii_strtod(args, NULL));
+            break;
+        case 'i':
+            *name = "get_split_freq";
+            g_string_append_printf(reply, "TX Frequency: %.0f\n",
+                                   mock.freqtx);
+            ret = 1;
+            break;
+        case 'S':
+            *name = "set_split_vfo";
+            mock.split = (g_ascii_strtoll(args, NULL, 10) != 0);
+            break;
+        case 't':
+            *name = "get_ptt";
+            g_string_append_printf(reply, "PTT: %d\n", mock.ptt ? 1 : 0);
+            ret = 1;
+            break;
+        case 'T':
+            *name = "set_ptt";
+            mock.ptt = (g_ascii_strtoll(args, NULL, 10) != 0);
+            break;
+        case '\x8b':
+            *name = "get_dcd";
+            g_string_append(reply, "DCD: 0\n");
+            ret = 1;
+            break;
+        default:
+            *name = cmd;
+            ret = -4;           /* RIG_ENIMPL */
+        }
+    }
+    else
+    {
+        mock_rot_move(g_get_monotonic_time());
+
+        switch (c)
+        {
+        case 'P':
+            *name = "set_pos";
+            if (sscanf(args, "%lf %lf", &a, &b) == 2)
+            {
+                mock.taz = CLAMP(a, 0.0, 360.0);
+                mock.tel = CLAMP(b, 0.0, 90.0);
+            }
+            else
+            {
+                ret = -1;       /* RIG_EINVAL */
+            }
+            break;
+        case 'p':
+            *name = "get_pos";
+            g_string_append_printf(reply, "Azimuth: %.2f\nElevation: %.2f\n",
+                                   mock.az, mock.el);
+            ret = 1;
+            break;
+        case 'S':
+            *name = "stop";
+            mock.taz = mock.az;
+            mock.tel = mock.el;
+            break;
+        default:
+            *name = cmd;
+            ret = -4;
+        }
+    }
+
+    g_mutex_unlock(&mock.lock);
+
+    return ret;
+}
+
+/* Format the reply in the plain or in the extended protocol */
+static void mock_reply(GString * out, gboolean extended, const gchar * cmd,
+                       const gchar * name, gint ret, const gchar * values)
+{
+    const gchar    *line, *sep, *end;
+
+    if (extended)
+    {
+        g_string_append_printf(out, "%s:%s\n", name, cmd + 1);
+        g_string_append(out, values);
+        g_string_append_printf(out, "RPRT %d\n", MIN(ret, 0));
+    }
+    else if (ret == 1)
+    {
+        /* plain values without the "Name: " labels */
+        for (line = values; *line != '\0'; line = end + 1)
+        {
+            sep = strstr(line, ": ") + 2;
+            end = strchr(sep, '\n');
+            g_string_append_len(out, sep, end - sep);
+            g_string_append_c(out, '\n');
+        }
+    }
+    else
+    {
+        g_string_append_printf(out, "RPRT %d\n", ret);
+    }
+}
+
+/* Serve one client connection; runs in a thread of the socket service */
+static gboolean mock_run_cb(GThreadedSocketService * service,
+                            GSocketConnection * connection,
+                            GObject * source, gpointer data)
+{
+    gboolean        rig = GPOINTER_TO_INT(data);
+    GDataInputStream *in;
+    GOutputStream  *out;
+    GString        *values, *reply;
+    const gchar    *name;
+    gchar          *line, *cmd;
+    gboolean        extended;
+    gint            ret;
+
+    (void)service;
+    (void)source;
+
+    in = g_data_input_stream_new(g_io_stream_get_input_stream
+                                 (G_IO_STREAM(connection)));
+    g_data_input_stream_set_newline_type(in, G_DATA_STREAM_NEWLINE_TYPE_ANY);
+    out = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+    values = g_string_new(NULL);
+    reply = g_string_new(NULL);
+
+    while ((line = g_data_input_stream_read_line(in, NULL, NULL, NULL)))
+    {
+        extended = (line[0] == '+');
+        cmd = g_strstrip(extended ? line + 1 : line);
+        if (cmd[0] == 'q')
+        {
+            g_free(line);
+            break;
+        }
+        if (cmd[0] == '\0')
+        {
+            g_free(line);
+            continue;
+        }
+
+        g_string_truncate(values, 0);
+        g_string_truncate(reply, 0);
+        ret = mock_exec(rig, cmd, &name, values);
+        mock_reply(reply, extended, cmd, name, ret, values->str);
+        g_free(line);
+
+        g_usleep((latency + g_random_double() * jitter) * 1000.0);
+        if (!g_output_stream_write_all(out, reply->str, reply->len, NULL,
+                                       NULL, NULL))
+            break;
+    }
+
+    g_string_free(values, TRUE);
+    g_string_free(reply, TRUE);
+    g_object_unref(in);
+
+    return TRUE;
+}
+
+/* Start a mock daemon on port; 0 selects a free port, which is returned */
+static gint mock_listen(gboolean rig, gint port)
+{
+    GSocketService *service;
+    GError         *err = NULL;
+    gboolean        ok;
+
+    service = g_threaded_socket_service_new(8);
+    if (port == 0)
+    {
+        port = g_socket_listener_add_any_inet_port(G_SOCKET_LISTENER(service),
+                                                   NULL, &err);
+        ok = (port != 0);
+    }
+    else
+    {
+        ok = g_socket_listener_add_inet_port(G_SOCKET_LISTENER(service),
+                                             port, NULL, &err);
+    }
+
+    if (!ok)
+    {
+        g_printerr("Failed to listen on port %d: %s\n", port, err->message);
+        exit(EXIT_FAILURE);
+    }
+
+    g_signal_connect(service, "run", G_CALLBACK(mock_run_cb),
+                     GINT_TO_POINTER(rig));
+    g_socket_service_start(service);
+
+    return port;
+}
+
+static gpointer mock_loop(gpointer data)
+{
+    g_main_loop_run((GMainLoop *) data);
+
+    return NULL;
+}
+
+/* Load a recorded pass */
+static gboolean pass_load(const gchar * filename)
+{
+    pass_sample_t   s;
+    gchar          *contents, **lines;
+    gint            i;
+    GError         *err = NULL;
+
+    if (!g_file_get_contents(filename, &contents, NULL, &err))
+    {
+        g_printerr("%s\n", err->message);
+        g_error_free(err);
+        return FALSE;
+    }
+
+    lines = g_strsplit(contents, "\n", -1);
+    for (i = 0; lines[i] != NULL; i++)
+    {
+        if (lines[i][0] == '#')
+            continue;
+        if (sscanf(lines[i], "%lf %lf %lf %lf", &s.t, &s.az, &s.el, &s.rr) ==
+            4)
+            g_array_append_val(pass, s);
+    }
+    g_strfreev(lines);
+    g_free(contents);
+
+    return pass->len >= 2;
+}
+
+/*
+ * Create a synthetic pass of a satellite in a 500 km circular orbit whose
+ * ground track passes offset degrees from the station.
+ */
+static void pass_synthesize(void)
+{
+    pass_sample_t   s;
+    gdouble         r = EARTH_R + 500.0;
+    gdouble         w = sqrt(398600.8 / r) / r;         /* rad/s */
+    gdouble         beta = offset * G_PI / 180.0;
+    gdouble         phi, x, y, z, rng, prng = 0.0;
+    gdouble         t;
+
+    for (t = -1200.0; t <= 1200.0; t += 1.0)
+    {
+        /* station on the z axis, x east, y north */
+        phi = w * t;
+        x = r * sin(phi);
+        y = r * cos(phi) * sin(beta);
+        z = r * cos(phi) * cos(beta) - EARTH_R;
+        rng = sqrt(x * x + y * y + z * z);
+
+        s.t = t;
+        s.az = fmod(atan2(x, y) * 180.0 / G_PI + 360.0, 360.0);
+        s.el = asin(z / rng) * 180.0 / G_PI;
+        s.rr = (t > -1200.0) ? rng - prng : 0.0;
+        prng = rng;
+
+        if (s.el >= 0.0)
+            g_array_append_val(pass, s);
+    }
+}
+
+/* Interpolate the pass at t seconds after its start */
+static pass_sample_t pass_at(gdouble t)
+{
+    pass_sample_t  *a, *b, s;
+    gdouble         f;
+    guint           i;
+
+    t += g_array_index(pass, pass_sample_t, 0).t;
+    for (i = 1; i < pass->len - 1; i++)
+        if (g_array_index(pass, pass_sample_t, i).t > t)
+            break;
+
+    a = &g_array_index(pass, pass_sample_t, i - 1);
+    b = &g_array_index(pass, pass_sample_t, i);
+    f = CLAMP((t - a->t) / (b->t - a->t), 0.0, 1.0);
+
+    s.t = t;
+    s.az = a->az + f * (b->az - a->az);
+    if (fabs(b->az - a->az) > 180.0)
+        s.az = (f < 0.5) ? a->az : b->az;
+    s.el = a->el + f * (b->el - a->el);
+    s.rr = a->rr + f * (b->rr - a->rr);
+
+    return s;
+}
+
+static gdouble pass_duration(void)
+{
+    return g_array_index(pass, pass_sample_t, pass->len - 1).t -
+        g_array_index(pass, pass_sample_t, 0).t;
+}
+
+/* Pass time corresponding to a monotonic time */
+static gdouble pass_time(gint64 now)
+{
+    return (now - tstart) / 1.0e6 * speed;
+}
+
+/* Received frequency with Doppler shift */
+static gdouble doppler_freq(gdouble rr)
+{
+    return freq0 * (1.0 - rr / C_KMS);
+}
+
+/* Angle between two directions in degrees */
+static gdouble angle_between(gdouble az1, gdouble el1, gdouble az2,
+                             gdouble el2)
+{
+    gdouble         d2r = G_PI / 180.0;
+    gdouble         c;
+
+    c = sin(el1 * d2r) * sin(el2 * d2r) +
+        cos(el1 * d2r) * cos(el2 * d2r) * cos((az1 - az2) * d2r);
+
+    return acos(CLAMP(c, -1.0, 1.0)) / d2r;
+}
+
+/* Error statistics */
+typedef struct {
+    gboolean        rig;
+    gboolean        running;
+    guint           n;
+    gdouble         sum2;
+    gdouble         max;
+} bench_stats_t;
+
+/* State of the controller driven by a benchmark */
+typedef struct {
+    /* rig */
+    gdouble         dd;         /*!< Doppler shift at the last module update */
+    gdouble         ddrate;     /*!< Rate of the Doppler shift in Hz/s */
+    gint64          dtime;      /*!< Time of the last module update */
+    gint64          nextupd;    /*!< Time of the next module update */
+    gdouble         lastf;      /*!< Frequency read back from the rig */
+    gdouble         lastreq;    /*!< Last frequency acknowledged by the rig */
+    gdouble         rtt;        /*!< Smoothed round trip in usec */
+    /* rotator */
+    rot_plan_t     *plan;
+    guint           planidx;    /*!< Index of the last set-point sent */
+    gdouble         setaz, setel;       /*!< Last set-point sent */
+    gboolean        settled;    /*!< Rotator has reached the set-point */
+    gint64          tsent;      /*!< Time the set-point was sent */
+    gdouble         lag;        /*!< Smoothed rotator lag in sec */
+    guint           sent;       /*!< Commands sent */
+    guint           failed;     /*!< Commands that failed */
+} bench_ctrl_t;
+
+static gpointer bench_sampler(gpointer data)
+{
+    bench_stats_t  *st = data;
+    pass_sample_t   s;
+    gint64          now;
+    gdouble         err;
+
+    while (g_atomic_int_get(&st->running))
+    {
+        g_usleep(SAMPLE_USEC);
+        now = g_get_monotonic_time();
+        s = pass_at(pass_time(now));
+
+        g_mutex_lock(&mock.lock);
+        if (st->rig)
+        {
+            err = fabs(mock.freq - doppler_freq(s.rr));
+        }
+        else
+        {
+            mock_rot_move(now);
+            err = angle_between(mock.az, mock.el, s.az, s.el);
+        }
+        g_mutex_unlock(&mock.lock);
+
+        st->n++;
+        st->sum2 += err * err;
+        st->max = MAX(st->max, err);
+    }
+
+    return NULL;
+}
+
+/* Parse a floating point value following label in a reply */
+static gboolean reply_value(GString * reply, const gchar * label,
+                            gdouble * value)
+{
+    const gchar    *p = strstr(reply->str, label);
+
+    if (p == NULL)
+        return FALSE;
+
+    *value = g_ascii_strtod(p + strlen(label), NULL);
+
+    return TRUE;
+}
+
+/*
+ * Rig controller cycle; returns the delay until the next cycle in usec.
+ *
+ * The module is updated every update msec like the satellite module does
+ * with its refresh rate, and each cycle extrapolates the Doppler shift of
+ * the last update and applies the tuning policy of gtk-rig-ctrl.c.
+ */
+static gint64 bench_rig_cycle(hamlib_conn_t * conn, GString * reply,
+                              bench_ctrl_t * ctrl)
+{
+    pass_sample_t   s, s1;
+    gint64          now = g_get_monotonic_time(), tsent;
+    gdouble         t, f;
+    gchar          *cmd;
+
+    if (now >= ctrl->nextupd)
+    {
+        t = pass_time(now);
+        s = pass_at(t);
+        s1 = pass_at(t + 1.0);
+        ctrl->dd = doppler_freq(s.rr) - freq0;
+        ctrl->ddrate = doppler_freq(s1.rr) - doppler_freq(s.rr);
+        ctrl->dtime = now;
+        ctrl->nextupd = now + update * 1000;
+    }
+
+    f = freq0 + ctrl->dd + ctrl->ddrate *
+        rig_tuning_horizon(ctrl->dtime, speed, ctrl->rtt, now);
+
+    if (rig_tuning_needs_update(f, ctrl->lastf, ctrl->lastreq, step))
+    {
+        cmd = g_strdup_printf("+F %10.0f\n+f\n", f);
+        tsent = g_get_monotonic_time();
+        ctrl->sent++;
+        if (hamlib_conn_exec(conn, cmd, HAMLIB_REPLY_EXTENDED, 2,
+                             CMD_TIMEOUT, reply) &&
+            reply_value(reply, "Frequency: ", &ctrl->lastf))
+        {
+            ctrl->lastreq = f;
+            now = g_get_monotonic_time();
+            if (ctrl->rtt > 0.0)
+                ctrl->rtt = 0.8 * ctrl->rtt + 0.2 * (now - tsent);
+            else
+                ctrl->rtt = now - tsent;
+        }
+        else
+        {
+            ctrl->failed++;
+        }
+        g_free(cmd);
+    }
+
+    return rig_tuning_delay(cycle * 1000.0, fabs(ctrl->ddrate) * speed, step,
+                            ctrl->rtt);
+}
+
+/* Plan the pass with the rotator planner of gtk-rot-ctrl.c */
+static rot_plan_t *bench_rot_plan(void)
+{
+    rotor_conf_t    conf;
+    rot_setpoint_t  point;
+    pass_sample_t  *s;
+    rot_plan_t     *plan;
+    GArray         *track;
+    guint           i;
+
+    memset(&conf, 0, sizeof(conf));
+    conf.aztype = ROT_AZ_TYPE_360;
+    conf.minaz = 0.0;
+    conf.maxaz = 360.0;
+    conf.azstoppos = 0.0;
+    conf.minel = 0.0;
+    conf.maxel = 90.0;
+    conf.azrate = slew;
+    conf.elrate = slew;
+
+    track = g_array_sized_new(FALSE, FALSE, sizeof(rot_setpoint_t),
+                              pass->len);
+    for (i = 0; i < pass->len; i++)
+    {
+        s = &g_array_index(pass, pass_sample_t, i);
+        point.t = (s->t - g_array_index(pass, pass_sample_t, 0).t) / secday;
+        point.az = s->az;
+        point.el = s->el;
+        g_array_append_val(track, point);
+    }
+
+    plan = rot_plan_new(track, &conf, threshold);
+    g_array_free(track, TRUE);
+
+    return plan;
+}
+
+/*
+ * Rotator controller cycle; returns the delay until the next cycle in usec.
+ *
+ * Follows rot_ctrl_cycle() in gtk-rot-ctrl.c: the set-point for the pass
+ * time plus the measured rotator lag is sent whenever it changes, and the
+ * next cycle is due when the plan reaches its next set-point.
+ */
+static gint64 bench_rot_cycle(hamlib_conn_t * conn, GString * reply,
+                              bench_ctrl_t * ctrl)
+{
+    rot_setpoint_t *point;
+    gint64          now = g_get_monotonic_time();
+    gint64          delay = cycle * 1000;
+    gdouble         t, az, el;
+    gchar          *cmd;
+    guint           idx;
+
+    t = pass_time(now) + ctrl->lag * speed;
+    idx = rot_plan_find(ctrl->plan, t / secday);
+    if (idx + 1 < ctrl->plan->points->len)
+    {
+        point = &g_array_index(ctrl->plan->points, rot_setpoint_t, idx + 1);
+        delay = MIN(delay, (point->t * secday - t) / speed * 1.0e6);
+    }
+
+    if (idx != ctrl->planidx)
+    {
+        point = &g_array_index(ctrl->plan->points, rot_setpoint_t, idx);
+        cmd = g_strdup_printf("P %.2f %.2f\n", point->az, point->el);
+        ctrl->sent++;
+        if (hamlib_conn_exec(conn, cmd, HAMLIB_REPLY_PLAIN, 1, CMD_TIMEOUT,
+                             reply))
+        {
+            ctrl->planidx = idx;
+            ctrl->setaz = point->az;
+            ctrl->setel = point->el;
+            ctrl->settled = FALSE;
+            ctrl->tsent = now;
+        }
+        else
+        {
+            ctrl->failed++;
+        }
+        g_free(cmd);
+    }
+
+    ctrl->sent++;
+    if (!hamlib_conn_exec(conn, "p\n", HAMLIB_REPLY_PLAIN, 2, CMD_TIMEOUT,
+                          reply) ||
+        sscanf(reply->str, "%lf %lf", &az, &el) != 2)
+    {
+        ctrl->failed++;
+    }
+    else if (!ctrl->settled && fabs(az - ctrl->setaz) <= threshold / 2.0 &&
+             fabs(el - ctrl->setel) <= threshold / 2.0)
+    {
+        ctrl->settled = TRUE;
+        t = (g_get_monotonic_time() - ctrl->tsent) / 1.0e6;
+        ctrl->lag = 0.75 * ctrl->lag + 0.25 * MIN(t, MAX_LAG);
+    }
+
+    return MAX(delay, MIN_DELAY);
+}
+
+/* Play the pass against a mock daemon */
+static void bench(gboolean rig)
+{
+    hamlib_conn_t  *conn;
+    GString        *reply;
+    GThread        *sampler;
+    bench_stats_t   st;
+    bench_ctrl_t    ctrl;
+    pass_sample_t   s;
+    gint64          t0, delay;
+    guint           cycles = 0;
+
+    conn = hamlib_conn_open("localhost", mock_listen(rig, 0));
+    reply = g_string_new(NULL);
+
+    memset(&ctrl, 0, sizeof(ctrl));
+    ctrl.planidx = G_MAXUINT;
+    ctrl.settled = TRUE;
+    if (!rig)
+    {
+        ctrl.plan = bench_rot_plan();
+        if (ctrl.plan == NULL)
+        {
+            g_printerr("The pass is too short to plan\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* start with the rotator parked at the beginning of the pass */
+    s = pass_at(0.0);
+    mock.az = mock.taz = s.az;
+    mock.el = mock.tel = s.el;
+    mock.tmove = g_get_monotonic_time();
+
+    memset(&st, 0, sizeof(st));
+    st.rig = rig;
+    st.running = TRUE;
+    tstart = g_get_monotonic_time();
+    sampler = g_thread_new("sampler", bench_sampler, &st);
+
+    while (pass_time(g_get_monotonic_time()) < pass_duration())
+    {
+        t0 = g_get_monotonic_time();
+        cycles++;
+
+        if (rig)
+            delay = bench_rig_cycle(conn, reply, &ctrl);
+        else
+            delay = bench_rot_cycle(conn, reply, &ctrl);
+
+        delay -= g_get_monotonic_time() - t0;
+        if (delay > 0)
+            g_usleep(delay);
+    }
+
+    g_atomic_int_set(&st.running, FALSE);
+    g_thread_join(sampler);
+    hamlib_conn_close(conn);
+    g_string_free(reply, TRUE);
+
+    g_print("%s benchmark: %.0f s pass at %.1fx, latency %.1f+%.1f ms\n",
+            rig ? "Rig" : "Rotator", pass_duration(), speed, latency, jitter);
+    g_print("  cycles %u, commands %u, failed %u\n", cycles, ctrl.sent,
+            ctrl.failed);
+    if (rig)
+        g_print("  step %.0f Hz, round trip %.1f ms\n"
+                "  frequency error: rms %.1f Hz, max %.1f Hz\n",
+                step, ctrl.rtt / 1000.0, sqrt(st.sum2 / MAX(st.n, 1)),
+                st.max);
+    else
+        g_print("  slew %.1f deg/s, threshold %.1f deg, %u set-points, "
+                "lag %.2f s\n"
+                "  pointing error: rms %.2f deg, max %.2f deg\n",
+                slew, threshold, ctrl.plan->points->len, ctrl.lag,
+                sqrt(st.sum2 / MAX(st.n, 1)), st.max);
+
+    rot_plan_free(ctrl.plan);
+}
+
+int main(int argc, char *argv[])
+{
+    GOptionContext *context;
+    GMainLoop      *loop;
+    GError         *err = NULL;
+    const gchar    *mode;
+
+    context = g_option_context_new("serve|bench-rig|bench-rot");
+    g_option_context_set_summary(context,
+                                 "Mock rigctld and rotctld with benchmarks "
+                                 "for the gpredict controllers.");
+    g_option_context_add_main_entries(context, options, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &err))
+    {
+        g_printerr("%s\n", err->message);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(context);
+
+    mode = (argc > 1) ? argv[1] : "serve";
+    g_mutex_init(&mock.lock);
+    mock.freq = mock.freqtx = freq0;
+    mock.tmove = g_get_monotonic_time();
+
+    loop = g_main_loop_new(NULL, FALSE);
+
+    if (g_strcmp0(mode, "serve") == 0)
+    {
+        mock_listen(TRUE, rig_port);
+        mock_listen(FALSE, rot_port);
+        g_print("Mock rigctld on port %d, rotctld on port %d\n",
+                rig_port, rot_port);
+        g_main_loop_run(loop);
+        return EXIT_SUCCESS;
+    }
+
+    pass = g_array_new(FALSE, FALSE, sizeof(pass_sample_t));
+    if (passfile != NULL)
+    {
+        if (!pass_load(passfile))
+        {
+            g_printerr("No usable pass in %s\n", passfile);
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        pass_synthesize();
+    }
+
+    /* the socket services accept connections from the default context */
+    g_thread_unref(g_thread_new("mock", mock_loop, loop));
+
+    if (g_strcmp0(mode, "bench-rig") == 0)
+        bench(TRUE);
+    else if (g_strcmp0(mode, "bench-rot") == 0)
+        bench(FALSE);
+    else
+    {
+        g_printerr("Unknown mode %s\n", mode);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
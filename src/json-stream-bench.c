@@ -0,0 +1,501 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Throughput benchmark for the streaming JSON parser.
+ *
+ * A synthetic transmitter list in the SatNOGS format is written to a
+ * temporary file, or an existing list is given with --file, and parsed
+ * twice: once with a bare event callback and once with
+ * json_stream_objects() collecting the transmitters of each satellite the
+ * way the transponder update does. Both passes report their throughput,
+ * and the object pass checks the transmitter count and the sum of the
+ * downlink frequencies against the generated data.
+ *
+ * The transmitters are then loaded into the transponder database and
+ * trsp_db_find() is checked against a linear scan of the transponders for
+ * random frequency ranges, and for the known downlink band of the
+ * synthetic list.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-stubs.h"
+#include "json-stream.h"
+#include "trsp-db.h"
+
+
+/* command line options */
+static gint     count = 100000;
+static gint     numsats = 2500;
+static gint     repeat = 3;
+static gint     queries = 10000;
+static gchar   *jsonfile = NULL;
+static gboolean keep = FALSE;
+
+static GOptionEntry options[] = {
+    {"count", 'n', 0, G_OPTION_ARG_INT, &count,
+     "Number of synthetic transmitters", "N"},
+    {"sats", 's', 0, G_OPTION_ARG_INT, &numsats,
+     "Number of satellites the transmitters belong to", "N"},
+    {"repeat", 'r', 0, G_OPTION_ARG_INT, &repeat,
+     "Parse the file this many times and report the best run", "N"},
+    {"queries", 'q', 0, G_OPTION_ARG_INT, &queries,
+     "Number of random transponder database queries", "N"},
+    {"file", 'f', 0, G_OPTION_ARG_FILENAME, &jsonfile,
+     "Parse this transmitter list instead of a synthetic one", "FILE"},
+    {"keep", 'k', 0, G_OPTION_ARG_NONE, &keep,
+     "Keep the synthetic file", NULL},
+    {"verbose", 'v', 0, G_OPTION_ARG_NONE, &bench_verbose,
+     "Log debug messages", NULL},
+    {NULL, 0, 0, 0, NULL, NULL, NULL}
+};
+
+/* Results of the object pass */
+typedef struct {
+    GHashTable     *sats;       /*!< catnum -> number of transmitters */
+    guint           objects;
+    gint64          downsum;    /*!< Sum of downlink_low in Hz */
+} bench_t;
+
+/* Downlink band of the synthetic transmitters in Hz */
+#define DOWN_LOW   435000000
+#define DOWN_HIGH  475030000
+
+
+/**
+ * Write a synthetic transmitter list.
+ *
+ * @param fp The output file.
+ * @param downsum Set to the sum of the downlink_low members.
+ * @return TRUE on success.
+ *
+ * The entries carry all members of the SatNOGS API, including nulls,
+ * escapes and a nested array, in a fixed pseudo random mix.
+ */
+static gboolean generate(FILE * fp, gint64 * downsum)
+{
+    GRand          *rnd = g_rand_new_with_seed(4532);
+    gint            i;
+    gint64          down;
+    gint            catnum;
+    gboolean        uplink;
+
+    *downsum = 0;
+    fputs("[", fp);
+
+    for (i = 0; i < count; i++)
+    {
+        catnum = 10000 + (i % numsats) * 7;
+        down = 435000000 + 1000 * (gint64) g_rand_int_range(rnd, 0, 40000);
+        uplink = g_rand_boolean(rnd);
+        *downsum += down;
+
+        fprintf(fp, "%s\n  {\n", (i > 0) ? "," : "");
+        fprintf(fp, "    \"uuid\": \"%08x-%04x-%04x\",\n",
+                g_rand_int(rnd), i & 0xffff, catnum & 0xffff);
+        fprintf(fp, "    \"description\": \"Mode %c %s \\\"%d\\\" "
+                "\\u00e9\\ud83d\\udce1\",\n", 'A' + i % 26,
+                uplink ? "transponder" : "telemetry", i);
+        fprintf(fp, "    \"alive\": %s,\n", (i % 10) ? "true" : "false");
+        fprintf(fp, "    \"type\": \"%s\",\n",
+                uplink ? "Transponder" : "Transmitter");
+        if (uplink)
+        {
+            fprintf(fp, "    \"uplink_low\": %" G_GINT64_FORMAT ",\n",
+                    down - 290000000);
+            fprintf(fp, "    \"uplink_high\": %" G_GINT64_FORMAT ",\n",
+                    down - 289970000);
+        }
+        else
+        {
+            fputs("    \"uplink_low\": null,\n", fp);
+            fputs("    \"uplink_high\": null,\n", fp);
+        }
+        fputs("    \"uplink_drift\": null,\n", fp);
+        fprintf(fp, "    \"downlink_low\": %" G_GINT64_FORMAT ",\n", down);
+        if (uplink)
+            fprintf(fp, "    \"downlink_high\": %" G_GINT64_FORMAT ",\n",
+                    down + 30000);
+        else
+            fputs("    \"downlink_high\": null,\n", fp);
+        fprintf(fp, "    \"downlink_drift\": %d,\n",
+                g_rand_int_range(rnd, -500, 500));
+        fprintf(fp, "    \"mode\": \"%s\",\n", uplink ? "FM" : "GMSK");
+        fprintf(fp, "    \"mode_id\": %d,\n", uplink ? 1 : 9);
+        fputs("    \"uplink_mode\": null,\n", fp);
+        fprintf(fp, "    \"invert\": %s,\n", (i % 3) ? "false" : "true");
+        fprintf(fp, "    \"baud\": %s,\n", uplink ? "null" : "9600.0");
+        fprintf(fp, "    \"sat_id\": \"SAT-%04d-%04d\",\n", catnum / 10000,
+                catnum % 10000);
+        fprintf(fp, "    \"norad_cat_id\": %d,\n", catnum);
+        fputs("    \"status\": \"active\",\n", fp);
+        fputs("    \"updated\": \"2026-10-18T12:00:00.000000Z\",\n", fp);
+        fputs("    \"citation\": \"https://example.org/a\\/b\",\n", fp);
+        fputs("    \"service\": \"Amateur\",\n", fp);
+        fputs("    \"iaru_coordination\": \"IARU Coordinated\",\n", fp);
+        fputs("    \"itu_notification\": {\"urls\": [\"x\", \"y\"]},\n", fp);
+        fputs("    \"frequency_violation\": false,\n", fp);
+        fputs("    \"unconfirmed\": false\n  }", fp);
+    }
+
+    fputs("\n]\n", fp);
+    g_rand_free(rnd);
+
+    return !ferror(fp);
+}
+
+static gboolean count_event(json_event_t event, const gchar * text,
+                            gsize len, guint depth, gpointer data)
+{
+    (void)event;
+    (void)text;
+    (void)len;
+    (void)depth;
+
+    (*(guint *) data)++;
+
+    return TRUE;
+}
+
+static gboolean collect_object(GHashTable * fields, gpointer data)
+{
+    bench_t        *b = (bench_t *) data;
+    const gchar    *val;
+    gpointer        key;
+
+    val = g_hash_table_lookup(fields, "norad_cat_id");
+    if (val == NULL)
+        return TRUE;
+
+    key = GUINT_TO_POINTER((guint) g_ascii_strtoull(val, NULL, 10));
+    g_hash_table_insert(b->sats, key,
+                        GUINT_TO_POINTER(GPOINTER_TO_UINT
+                                         (g_hash_table_lookup(b->sats, key))
+                                         + 1));
+
+    val = g_hash_table_lookup(fields, "downlink_low");
+    if (val != NULL)
+        b->downsum += g_ascii_strtoll(val, NULL, 10);
+    b->objects++;
+
+    return TRUE;
+}
+
+static void report(const gchar * what, gint64 usec, gint64 bytes,
+                   guint items, const gchar * unit)
+{
+    gdouble         sec = MAX(usec, 1) / 1.0e6;
+
+    g_print("%-8s %8.1f ms %8.1f MB/s %12.0f %s/s\n", what, sec * 1.0e3,
+            bytes / sec / 1.0e6, items / sec, unit);
+}
+
+/* Add a transmitter to the transponder list of its satellite */
+static gboolean collect_trsp(GHashTable * fields, gpointer data)
+{
+    GHashTable     *lists = (GHashTable *) data;
+    const gchar    *val;
+    trsp_t         *trsp;
+    gpointer        key;
+
+    val = g_hash_table_lookup(fields, "norad_cat_id");
+    if (val == NULL)
+        return TRUE;
+
+    key = GUINT_TO_POINTER((guint) g_ascii_strtoull(val, NULL, 10));
+
+    trsp = g_new0(trsp_t, 1);
+    trsp->name = g_strdup(g_hash_table_lookup(fields, "uuid"));
+    val = g_hash_table_lookup(fields, "uplink_low");
+    trsp->uplow = (val != NULL) ? g_ascii_strtoll(val, NULL, 10) : 0;
+    val = g_hash_table_lookup(fields, "uplink_high");
+    trsp->uphigh = (val != NULL) ? g_ascii_strtoll(val, NULL, 10) : 0;
+    val = g_hash_table_lookup(fields, "downlink_low");
+    trsp->downlow = (val != NULL) ? g_ascii_strtoll(val, NULL, 10) : 0;
+    val = g_hash_table_lookup(fields, "downlink_high");
+    trsp->downhigh = (val != NULL) ? g_ascii_strtoll(val, NULL, 10) : 0;
+
+    g_hash_table_insert(lists, key,
+                        g_slist_prepend(g_hash_table_lookup(lists, key),
+                                        trsp));
+
+    return TRUE;
+}
+
+static gint catnum_compare(gconstpointer a, gconstpointer b)
+{
+    guint           ua = *(const guint *)a, ub = *(const guint *)b;
+
+    return (ua > ub) - (ua < ub);
+}
+
+/* Find the satellites with a transponder in a range by a linear scan */
+static GArray  *find_linear(GHashTable * lists, gint64 low, gint64 high,
+                            gboolean uplink)
+{
+    GHashTableIter  iter;
+    gpointer        key, value;
+    GSList         *node;
+    trsp_t         *trsp;
+    GArray         *result;
+    gint64          rlow, rhigh;
+    guint           catnum;
+
+    result = g_array_new(FALSE, FALSE, sizeof(guint));
+    g_hash_table_iter_init(&iter, lists);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        for (node = value; node != NULL; node = node->next)
+        {
+            trsp = node->data;
+            rlow = uplink ? trsp->uplow : trsp->downlow;
+            rhigh = uplink ? trsp->uphigh : trsp->downhigh;
+            if (rlow <= 0 && rhigh <= 0)
+                continue;
+
+            if (rlow <= high && MAX(rlow, rhigh) >= low)
+            {
+                catnum = GPOINTER_TO_UINT(key);
+                g_array_append_val(result, catnum);
+                break;
+            }
+        }
+    }
+    g_array_sort(result, catnum_compare);
+
+    return result;
+}
+
+/*
+ * Compare trsp_db_find() with a linear scan.
+ *
+ * The time spent in trsp_db_find() is added to usec and the number of
+ * satellites found is returned in found.
+ */
+static gboolean check_find(GHashTable * lists, gint64 low, gint64 high,
+                           gboolean uplink, gint64 * usec, guint * found)
+{
+    GArray         *fast, *slow;
+    gint64          t;
+    gboolean        ok;
+
+    t = g_get_monotonic_time();
+    fast = trsp_db_find(low, high, uplink, NULL);
+    *usec += g_get_monotonic_time() - t;
+
+    slow = find_linear(lists, low, high, uplink);
+    ok = (fast->len == slow->len &&
+          memcmp(fast->data, slow->data, fast->len * sizeof(guint)) == 0);
+    if (!ok)
+        g_printerr("trsp_db_find(%" G_GINT64_FORMAT ", %" G_GINT64_FORMAT
+                   ", %s) found %u satellites instead of %u\n", low, high,
+                   uplink ? "uplink" : "downlink", fast->len, slow->len);
+
+    *found = fast->len;
+    g_array_free(fast, TRUE);
+    g_array_free(slow, TRUE);
+
+    return ok;
+}
+
+/*
+ * Load the transmitters into the transponder database and check
+ * trsp_db_find() against a linear scan.
+ */
+static gboolean check_trsp_db(void)
+{
+    GHashTable     *lists;
+    GHashTableIter  iter;
+    gpointer        key, value;
+    GRand          *rnd;
+    gint64          low, usec = 0;
+    guint           found;
+    gint            i;
+    gboolean        ok, uplink;
+
+    lists = g_hash_table_new(g_direct_hash, g_direct_equal);
+    if (json_stream_objects(jsonfile, collect_trsp, lists) < 0)
+    {
+        g_hash_table_destroy(lists);
+        return FALSE;
+    }
+
+    /* the database takes ownership of the lists */
+    g_hash_table_iter_init(&iter, lists);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+        trsp_db_set(GPOINTER_TO_UINT(key), value);
+
+    /* every synthetic satellite has a downlink in the band and none below */
+    ok = check_find(lists, DOWN_LOW, DOWN_HIGH, FALSE, &usec, &found);
+    if (ok && count > 0 && found != (guint) numsats)
+    {
+        g_printerr("%u of %d satellites found in the downlink band\n",
+                   found, numsats);
+        ok = FALSE;
+    }
+    ok = ok && check_find(lists, DOWN_LOW - 10000, DOWN_LOW - 1, FALSE,
+                          &usec, &found);
+    if (ok && count > 0 && found != 0)
+    {
+        g_printerr("%u satellites found below the downlink band\n", found);
+        ok = FALSE;
+    }
+
+    /* random 30 kHz windows around the uplink and downlink bands */
+    rnd = g_rand_new_with_seed(4533);
+    usec = 0;
+    for (i = 0; ok && i < queries; i++)
+    {
+        uplink = g_rand_boolean(rnd);
+        low = (uplink ? 140000000 : 430000000) +
+            1000 * (gint64) g_rand_int_range(rnd, 0, 50000);
+        ok = check_find(lists, low, low + 30000, uplink, &usec, &found);
+    }
+    g_rand_free(rnd);
+
+    if (ok && queries > 0)
+        g_print("find     %8.1f ms %12.0f queries/s\n", usec / 1.0e3,
+                queries / (MAX(usec, 1) / 1.0e6));
+
+    trsp_db_close();
+    g_hash_table_destroy(lists);
+
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    GOptionContext *context;
+    GError         *err = NULL;
+    GStatBuf        st;
+    FILE           *fp;
+    bench_t         b;
+    gint64          downsum = 0;
+    gint64          t, best_events, best_objects;
+    guint           events;
+    gint            fd, i;
+    gboolean        ok = TRUE;
+
+    context = g_option_context_new(NULL);
+    g_option_context_set_summary(context,
+                                 "Throughput benchmark for the streaming "
+                                 "JSON parser.");
+    g_option_context_add_main_entries(context, options, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &err))
+    {
+        g_printerr("%s\n", err->message);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(context);
+
+    if (jsonfile == NULL)
+    {
+        fd = g_file_open_tmp("json-stream-XXXXXX.json", &jsonfile, &err);
+        if (fd < 0 || (fp = fdopen(fd, "w")) == NULL)
+        {
+            g_printerr("Could not create a temporary file: %s\n",
+                       err ? err->message : "fdopen failed");
+            return EXIT_FAILURE;
+        }
+        count = MAX(count, 1);
+        numsats = CLAMP(numsats, 1, count);
+        ok = generate(fp, &downsum);
+        if (fclose(fp) || !ok)
+        {
+            g_printerr("Could not write %s\n", jsonfile);
+            g_unlink(jsonfile);
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        /* nothing to check the results against */
+        count = 0;
+        keep = TRUE;
+    }
+
+    if (g_stat(jsonfile, &st))
+    {
+        g_printerr("Could not stat %s\n", jsonfile);
+        return EXIT_FAILURE;
+    }
+    g_print("%s: %.1f MB\n", jsonfile, st.st_size / 1.0e6);
+
+    best_events = best_objects = G_MAXINT64;
+    b.sats = g_hash_table_new(g_direct_hash, g_direct_equal);
+    events = 0;
+
+    for (i = 0; ok && i < MAX(repeat, 1); i++)
+    {
+        events = 0;
+        t = g_get_monotonic_time();
+        ok = json_stream_parse_file(jsonfile, count_event, &events);
+        best_events = MIN(best_events, g_get_monotonic_time() - t);
+
+        g_hash_table_remove_all(b.sats);
+        b.objects = 0;
+        b.downsum = 0;
+        t = g_get_monotonic_time();
+        ok = ok && (json_stream_objects(jsonfile, collect_object, &b) >= 0);
+        best_objects = MIN(best_objects, g_get_monotonic_time() - t);
+    }
+
+    if (ok)
+    {
+        report("events", best_events, st.st_size, events, "events");
+        report("objects", best_objects, st.st_size, b.objects, "objects");
+        g_print("%u transmitters of %u satellites\n", b.objects,
+                g_hash_table_size(b.sats));
+
+        if (count > 0 && (b.objects != (guint) count ||
+                          (gint) g_hash_table_size(b.sats) != numsats ||
+                          b.downsum != downsum))
+        {
+            g_printerr("Parsed data does not match the generated data\n");
+            ok = FALSE;
+        }
+
+        ok = ok && check_trsp_db();
+    }
+    else
+    {
+        g_printerr("Could not parse %s\n", jsonfile);
+    }
+
+    if (!keep)
+        g_unlink(jsonfile);
+
+    g_hash_table_destroy(b.sats);
+    g_free(jsonfile);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
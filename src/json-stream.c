@@ -0,0 +1,651 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Streaming JSON parser.
+ *
+ * The input is fed in chunks of any size to a byte level state machine,
+ * which reports each key, scalar and container boundary to a callback as
+ * soon as it is complete. Memory use is bounded by the longest string or
+ * number token and the nesting depth, independent of the document size,
+ * so large feeds like the SatNOGS transmitter list can be processed in
+ * one linear pass without building a document tree.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json-stream.h"
+#include "sat-log.h"
+
+
+#define JSON_MAX_DEPTH    64    /*!< Deepest container nesting accepted */
+#define JSON_CHUNK_SIZE   65536 /*!< Bytes read from a file at a time */
+
+typedef enum {
+    STATE_VALUE = 0,            /*!< Expecting a value */
+    STATE_VALUE_OR_END,         /*!< After '[': a value or ']' */
+    STATE_KEY_OR_END,           /*!< After '{': a key or '}' */
+    STATE_KEY,                  /*!< After ',' in an object */
+    STATE_COLON,                /*!< After a key */
+    STATE_COMMA_OR_END,         /*!< After a value inside a container */
+    STATE_STRING,               /*!< Inside a string or key */
+    STATE_ESCAPE,               /*!< After a backslash in a string */
+    STATE_UNICODE,              /*!< Inside a \uXXXX escape */
+    STATE_NUMBER,               /*!< Inside a number */
+    STATE_LITERAL,              /*!< Inside true, false or null */
+    STATE_DONE                  /*!< Top level value complete */
+} json_state_t;
+
+struct _json_stream {
+    json_event_fn   cb;
+    gpointer        data;
+
+    json_state_t    state;
+    gchar           stack[JSON_MAX_DEPTH];      /*!< '{' or '[' per level */
+    guint           depth;
+
+    GString        *tok;        /*!< Current string or number */
+    gboolean        is_key;     /*!< The current string is a key */
+    gunichar        uchar;      /*!< \u escape being decoded */
+    guint           udigits;    /*!< Hex digits of uchar seen so far */
+    gunichar        surrogate;  /*!< Pending high surrogate or 0 */
+
+    const gchar    *literal;    /*!< Literal being matched */
+    guint           litpos;     /*!< Characters of literal matched */
+    json_event_t    litevent;   /*!< Event for the literal */
+
+    guint           line;       /*!< Current input line for messages */
+    gboolean        failed;     /*!< Syntax error or aborted by callback */
+};
+
+
+/**
+ * Create a new parser.
+ *
+ * @param cb The event callback.
+ * @param data User data passed to the callback.
+ * @return A new parser to be freed with json_stream_free().
+ */
+json_stream_t  *json_stream_new(json_event_fn cb, gpointer data)
+{
+    json_stream_t  *js = g_new0(json_stream_t, 1);
+
+    js->cb = cb;
+    js->data = data;
+    js->state = STATE_VALUE;
+    js->tok = g_string_sized_new(256);
+    js->line = 1;
+
+    return js;
+}
+
+void json_stream_free(json_stream_t * js)
+{
+    if (js == NULL)
+        return;
+
+    g_string_free(js->tok, TRUE);
+    g_free(js);
+}
+
+/* Log a syntax error under the parser name and stop parsing */
+static gboolean syntax_error(json_stream_t * js, const gchar * what)
+{
+    sat_log_log(SAT_LOG_LEVEL_ERROR,
+                _("%s: JSON syntax error at line %u: %s"),
+                "json_stream", js->line, what);
+    js->failed = TRUE;
+
+    return FALSE;
+}
+
+static gboolean emit(json_stream_t * js, json_event_t event,
+                     const gchar * text, gsize len)
+{
+    if (!js->cb(event, text, len, js->depth, js->data))
+        js->failed = TRUE;
+
+    return !js->failed;
+}
+
+/* A value has been completed; decide what may follow it */
+static void value_done(json_stream_t * js)
+{
+    js->state = (js->depth == 0) ? STATE_DONE : STATE_COMMA_OR_END;
+}
+
+static gboolean push(json_stream_t * js, gchar c)
+{
+    if (js->depth == JSON_MAX_DEPTH)
+        return syntax_error(js, "nesting too deep");
+
+    if (!emit(js, (c == '{') ? JSON_EVENT_OBJECT_START :
+              JSON_EVENT_ARRAY_START, NULL, 0))
+        return FALSE;
+
+    js->stack[js->depth++] = c;
+    js->state = (c == '{') ? STATE_KEY_OR_END : STATE_VALUE_OR_END;
+
+    return TRUE;
+}
+
+static gboolean pop(json_stream_t * js, gchar c)
+{
+    gchar           open = (c == '}') ? '{' : '[';
+
+    if (js->depth == 0 || js->stack[js->depth - 1] != open)
+        return syntax_error(js, "unbalanced bracket");
+
+    js->depth--;
+    if (!emit(js, (c == '}') ? JSON_EVENT_OBJECT_END : JSON_EVENT_ARRAY_END,
+              NULL, 0))
+        return FALSE;
+
+    value_done(js);
+
+    return TRUE;
+}
+
+static void start_literal(json_stream_t * js, const gchar * literal,
+                          json_event_t event)
+{
+    js->literal = literal;
+    js->litpos = 1;
+    js->litevent = event;
+    js->state = STATE_LITERAL;
+}
+
+/* Start of a value at character c */
+static gboolean begin_value(json_stream_t * js, gchar c)
+{
+    switch (c)
+    {
+    case '{':
+    case '[':
+        return push(js, c);
+
+    case '"':
+        g_string_truncate(js->tok, 0);
+        js->is_key = FALSE;
+        js->state = STATE_STRING;
+        return TRUE;
+
+    case 't':
+        start_literal(js, "true", JSON_EVENT_TRUE);
+        return TRUE;
+
+    case 'f':
+        start_literal(js, "false", JSON_EVENT_FALSE);
+        return TRUE;
+
+    case 'n':
+        start_literal(js, "null", JSON_EVENT_NULL);
+        return TRUE;
+
+    default:
+        if (c == '-' || g_ascii_isdigit(c))
+        {
+            g_string_truncate(js->tok, 0);
+            g_string_append_c(js->tok, c);
+            js->state = STATE_NUMBER;
+            return TRUE;
+        }
+        return syntax_error(js, "unexpected character");
+    }
+}
+
+static gboolean end_number(json_stream_t * js)
+{
+    gchar          *end;
+
+    g_ascii_strtod(js->tok->str, &end);
+    if (*end != '\0')
+        return syntax_error(js, "malformed number");
+
+    if (!emit(js, JSON_EVENT_NUMBER, js->tok->str, js->tok->len))
+        return FALSE;
+
+    value_done(js);
+
+    return TRUE;
+}
+
+static gboolean end_string(json_stream_t * js)
+{
+    if (js->surrogate)
+    {
+        g_string_append_unichar(js->tok, 0xFFFD);
+        js->surrogate = 0;
+    }
+
+    if (js->is_key)
+    {
+        js->state = STATE_COLON;
+        return emit(js, JSON_EVENT_KEY, js->tok->str, js->tok->len);
+    }
+
+    if (!emit(js, JSON_EVENT_STRING, js->tok->str, js->tok->len))
+        return FALSE;
+
+    value_done(js);
+
+    return TRUE;
+}
+
+/* Append a decoded \u escape, combining surrogate pairs */
+static void append_unicode(json_stream_t * js, gunichar u)
+{
+    if (js->surrogate)
+    {
+        if (u >= 0xDC00 && u <= 0xDFFF)
+        {
+            u = 0x10000 + ((js->surrogate - 0xD800) << 10) + (u - 0xDC00);
+            js->surrogate = 0;
+            g_string_append_unichar(js->tok, u);
+            return;
+        }
+        g_string_append_unichar(js->tok, 0xFFFD);
+        js->surrogate = 0;
+    }
+
+    if (u >= 0xD800 && u <= 0xDBFF)
+        js->surrogate = u;
+    else if (u >= 0xDC00 && u <= 0xDFFF)
+        g_string_append_unichar(js->tok, 0xFFFD);
+    else
+        g_string_append_unichar(js->tok, u);
+}
+
+static gboolean parse_char(json_stream_t * js, gchar c)
+{
+    switch (js->state)
+    {
+    case STATE_STRING:
+        if (c == '"')
+            return end_string(js);
+        if (c == '\\')
+        {
+            js->state = STATE_ESCAPE;
+            return TRUE;
+        }
+        if ((guchar) c < 0x20)
+            return syntax_error(js, "control character in string");
+        if (js->surrogate)
+        {
+            g_string_append_unichar(js->tok, 0xFFFD);
+            js->surrogate = 0;
+        }
+        g_string_append_c(js->tok, c);
+        return TRUE;
+
+    case STATE_ESCAPE:
+        js->state = STATE_STRING;
+        if (c == 'u')
+        {
+            js->uchar = 0;
+            js->udigits = 0;
+            js->state = STATE_UNICODE;
+            return TRUE;
+        }
+        if (js->surrogate)
+        {
+            g_string_append_unichar(js->tok, 0xFFFD);
+            js->surrogate = 0;
+        }
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            g_string_append_c(js->tok, c);
+            return TRUE;
+        case 'b':
+            g_string_append_c(js->tok, '\b');
+            return TRUE;
+        case 'f':
+            g_string_append_c(js->tok, '\f');
+            return TRUE;
+        case 'n':
+            g_string_append_c(js->tok, '\n');
+            return TRUE;
+        case 'r':
+            g_string_append_c(js->tok, '\r');
+            return TRUE;
+        case 't':
+            g_string_append_c(js->tok, '\t');
+            return TRUE;
+        default:
+            return syntax_error(js, "invalid escape");
+        }
+
+    case STATE_UNICODE:
+        if (!g_ascii_isxdigit(c))
+            return syntax_error(js, "invalid \\u escape");
+        js->uchar = (js->uchar << 4) | g_ascii_xdigit_value(c);
+        if (++js->udigits == 4)
+        {
+            append_unicode(js, js->uchar);
+            js->state = STATE_STRING;
+        }
+        return TRUE;
+
+    case STATE_NUMBER:
+        if (g_ascii_isdigit(c) || c == '.' || c == 'e' || c == 'E' ||
+            c == '+' || c == '-')
+        {
+            g_string_append_c(js->tok, c);
+            return TRUE;
+        }
+        /* the character after a number belongs to what follows it */
+        if (!end_number(js))
+            return FALSE;
+        return parse_char(js, c);
+
+    case STATE_LITERAL:
+        if (c != js->literal[js->litpos])
+            return syntax_error(js, "invalid literal");
+        if (js->literal[++js->litpos] == '\0')
+        {
+            if (!emit(js, js->litevent, js->literal, js->litpos))
+                return FALSE;
+            value_done(js);
+        }
+        return TRUE;
+
+    default:
+        break;
+    }
+
+    /* the remaining states skip white space between tokens */
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+        return TRUE;
+
+    switch (js->state)
+    {
+    case STATE_VALUE:
+        return begin_value(js, c);
+
+    case STATE_VALUE_OR_END:
+        if (c == ']')
+            return pop(js, c);
+        return begin_value(js, c);
+
+    case STATE_KEY_OR_END:
+        if (c == '}')
+            return pop(js, c);
+        /* fall through */
+    case STATE_KEY:
+        if (c != '"')
+            return syntax_error(js, "expected a key");
+        g_string_truncate(js->tok, 0);
+        js->is_key = TRUE;
+        js->state = STATE_STRING;
+        return TRUE;
+
+    case STATE_COLON:
+        if (c != ':')
+            return syntax_error(js, "expected ':'");
+        js->state = STATE_VALUE;
+        return TRUE;
+
+    case STATE_COMMA_OR_END:
+        if (c == '}' || c == ']')
+            return pop(js, c);
+        if (c != ',')
+            return syntax_error(js, "expected ',' or end of container");
+        js->state = (js->stack[js->depth - 1] == '{') ? STATE_KEY :
+            STATE_VALUE;
+        return TRUE;
+
+    case STATE_DONE:
+        return syntax_error(js, "trailing data");
+
+    default:
+        return syntax_error(js, "internal error");
+    }
+}
+
+/**
+ * Feed a chunk of input to the parser.
+ *
+ * @param js The parser.
+ * @param buf The input bytes; chunks may split tokens anywhere.
+ * @param len Number of bytes in buf.
+ * @return FALSE on a syntax error or when the callback stopped the parser.
+ */
+gboolean json_stream_feed(json_stream_t * js, const gchar * buf, gsize len)
+{
+    gsize           i, j;
+
+    if (js->failed)
+        return FALSE;
+
+    for (i = 0; i < len; i++)
+    {
+        /* copy runs of plain string characters in one go */
+        if (js->state == STATE_STRING && !js->surrogate)
+        {
+            j = i;
+            while (j < len && buf[j] != '"' && buf[j] != '\\' &&
+                   (guchar) buf[j] >= 0x20)
+                j++;
+            g_string_append_len(js->tok, buf + i, j - i);
+            if (j == len)
+                break;
+            i = j;
+        }
+
+        if (buf[i] == '\n')
+            js->line++;
+        if (!parse_char(js, buf[i]))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Signal the end of the input.
+ *
+ * @param js The parser.
+ * @return TRUE if the input was one complete JSON value.
+ */
+gboolean json_stream_finish(json_stream_t * js)
+{
+    if (js->failed)
+        return FALSE;
+
+    /* a number at the very end has no terminating character */
+    if (js->state == STATE_NUMBER && !end_number(js))
+        return FALSE;
+
+    if (js->state != STATE_DONE)
+        return syntax_error(js, "unexpected end of input");
+
+    return TRUE;
+}
+
+/**
+ * Parse a JSON file.
+ *
+ * @param fname The file name.
+ * @param cb The event callback.
+ * @param data User data passed to the callback.
+ * @return TRUE if the whole file has been parsed.
+ *
+ * The file is read in fixed size chunks, so memory use does not depend on
+ * the file size.
+ */
+gboolean json_stream_parse_file(const gchar * fname, json_event_fn cb,
+                                gpointer data)
+{
+    json_stream_t  *js;
+    FILE           *fp;
+    gchar          *buf;
+    gsize           n;
+    gboolean        ok = TRUE;
+
+    fp = g_fopen(fname, "rb");
+    if (fp == NULL)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR, _("%s: Could not open %s"),
+                    __func__, fname);
+        return FALSE;
+    }
+
+    js = json_stream_new(cb, data);
+    buf = g_malloc(JSON_CHUNK_SIZE);
+
+    while (ok && (n = fread(buf, 1, JSON_CHUNK_SIZE, fp)) > 0)
+        ok = json_stream_feed(js, buf, n);
+
+    if (ok && ferror(fp))
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR, _("%s: Error reading %s"),
+                    __func__, fname);
+        ok = FALSE;
+    }
+
+    if (ok)
+        ok = json_stream_finish(js);
+
+    g_free(buf);
+    json_stream_free(js);
+    fclose(fp);
+
+    return ok;
+}
+
+/* State of json_stream_objects() */
+typedef struct {
+    json_object_fn  cb;
+    gpointer        data;
+    GHashTable     *fields;     /*!< Scalar members of the current object */
+    gchar          *key;        /*!< Member waiting for its value */
+    gint            count;      /*!< Objects delivered */
+} objects_t;
+
+static gboolean objects_event(json_event_t event, const gchar * text,
+                              gsize len, guint depth, gpointer data)
+{
+    objects_t      *obj = (objects_t *) data;
+
+    if (depth == 0)
+    {
+        if (event == JSON_EVENT_ARRAY_START || event == JSON_EVENT_ARRAY_END)
+            return TRUE;
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Top level value is not an array"), __func__);
+        return FALSE;
+    }
+
+    if (depth == 1)
+    {
+        /* elements of the top level array; anything but objects is skipped */
+        if (event == JSON_EVENT_OBJECT_START)
+        {
+            g_hash_table_remove_all(obj->fields);
+        }
+        else if (event == JSON_EVENT_OBJECT_END)
+        {
+            obj->count++;
+            return obj->cb(obj->fields, obj->data);
+        }
+        return TRUE;
+    }
+
+    if (depth > 2)
+        return TRUE;
+
+    /* members of an element; nested containers are skipped */
+    switch (event)
+    {
+    case JSON_EVENT_KEY:
+        g_free(obj->key);
+        obj->key = g_strndup(text, len);
+        break;
+
+    case JSON_EVENT_STRING:
+    case JSON_EVENT_NUMBER:
+    case JSON_EVENT_TRUE:
+    case JSON_EVENT_FALSE:
+        if (obj->key != NULL)
+            g_hash_table_replace(obj->fields, obj->key, g_strndup(text, len));
+        obj->key = NULL;
+        break;
+
+    case JSON_EVENT_NULL:
+        if (obj->key != NULL)
+            g_hash_table_replace(obj->fields, obj->key, NULL);
+        obj->key = NULL;
+        break;
+
+    default:
+        g_free(obj->key);
+        obj->key = NULL;
+        break;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Parse a file holding an array of flat objects.
+ *
+ * @param fname The file name.
+ * @param cb Callback invoked once for each object in the array.
+ * @param data User data passed to the callback.
+ * @return The number of objects delivered, or -1 if the file could not be
+ *         parsed or the callback stopped the parser.
+ *
+ * Only the scalar members of each object are collected; nested objects and
+ * arrays are skipped. Objects delivered before an error are not undone.
+ */
+gint json_stream_objects(const gchar * fname, json_object_fn cb,
+                         gpointer data)
+{
+    objects_t       obj;
+    gboolean        ok;
+
+    obj.cb = cb;
+    obj.data = data;
+    obj.fields = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                       g_free, g_free);
+    obj.key = NULL;
+    obj.count = 0;
+
+    ok = json_stream_parse_file(fname, objects_event, &obj);
+
+    g_free(obj.key);
+    g_hash_table_destroy(obj.fields);
+
+    return ok ? obj.count : -1;
+}
@@ -0,0 +1,82 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H 1
+
+#include <glib.h>
+
+/** Events reported by the streaming JSON parser. */
+typedef enum {
+    JSON_EVENT_OBJECT_START = 0,
+    JSON_EVENT_OBJECT_END,
+    JSON_EVENT_ARRAY_START,
+    JSON_EVENT_ARRAY_END,
+    JSON_EVENT_KEY,             /*!< Object member name */
+    JSON_EVENT_STRING,          /*!< String value, unescaped UTF-8 */
+    JSON_EVENT_NUMBER,          /*!< Number value as it appears in the input */
+    JSON_EVENT_TRUE,
+    JSON_EVENT_FALSE,
+    JSON_EVENT_NULL
+} json_event_t;
+
+/**
+ * Event callback.
+ *
+ * @param event The event type.
+ * @param text The key or scalar text; NULL for container events. Only valid
+ *             during the call.
+ * @param len Length of text in bytes.
+ * @param depth Number of open containers around the event, i.e. 0 for the
+ *              top level value and 1 for the members of a top level array.
+ * @param data User data.
+ * @return FALSE to stop parsing.
+ */
+typedef gboolean(*json_event_fn) (json_event_t event, const gchar * text,
+                                  gsize len, guint depth, gpointer data);
+
+/**
+ * Object callback used by json_stream_objects().
+ *
+ * @param fields The scalar members of the object; keys and values are
+ *               strings and a JSON null is stored as a NULL value. The table
+ *               is reused for the next object.
+ * @param data User data.
+ * @return FALSE to stop parsing.
+ */
+typedef gboolean(*json_object_fn) (GHashTable * fields, gpointer data);
+
+typedef struct _json_stream json_stream_t;
+
+json_stream_t  *json_stream_new(json_event_fn cb, gpointer data);
+void            json_stream_free(json_stream_t * js);
+gboolean        json_stream_feed(json_stream_t * js, const gchar * buf,
+                                 gsize len);
+gboolean        json_stream_finish(json_stream_t * js);
+gboolean        json_stream_parse_file(const gchar * fname,
+                                       json_event_fn cb, gpointer data);
+gint            json_stream_objects(const gchar * fname,
+                                    json_object_fn cb, gpointer data);
+
+#endif
@@ -34,6 +34,7 @@
 #include "gui.h"
 #include "first-time.h"
 #include "tle-update.h"
+#include "trsp-db.h"
 #include "mod-mgr.h"
 #include "sat-cfg.h"
 #include "sat-log.h"
@@ -136,6 +137,12 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    /* finish a TLE update that was interrupted while saving */
+    tle_update_recover();
+
+    /* load transponder database */
+    trsp_db_load();
+
     /* create application */
     gpredict_app_create();
     gtk_widget_show_all(app);
@@ -155,6 +162,7 @@ int main(int argc, char *argv[])
     g_option_context_free(context);
 
     sat_cfg_save();
+    trsp_db_close();
     sat_log_close();
     sat_cfg_close();
 
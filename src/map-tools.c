@@ -107,3 +107,80 @@ void map_tools_shift_center(GdkPixbuf *in, GdkPixbuf *out, float clon)
     }   
 }
 
+
+/*! \brief Simplify a polyline.
+ *  \param coords The x,y pairs of the polyline; simplified in place.
+ *  \param num The number of points in coords.
+ *  \param tolerance The largest distance of a dropped point from the
+ *                   simplified line.
+ *  \return The number of points left in coords.
+ *
+ * This is the Douglas-Peucker algorithm: the point farthest from the line
+ * between the end points is kept if it is farther than the tolerance, and
+ * the two halves are simplified the same way. The end points are always
+ * kept, so closed outlines stay closed. With coordinates in pixels and a
+ * tolerance below one pixel, the result looks the same on screen.
+ */
+guint map_tools_simplify(gdouble *coords, guint num, gdouble tolerance)
+{
+    guint8 *keep;
+    guint  *stack;
+    guint   top = 0;
+    guint   a, b, i, imax, n;
+    gdouble dx, dy, len2, px, py, u, d2, dmax;
+
+    if (num < 3 || tolerance <= 0.0)
+        return num;
+
+    keep = g_new0(guint8, num);
+    stack = g_new(guint, 2 * num);
+    keep[0] = keep[num - 1] = 1;
+    stack[top++] = 0;
+    stack[top++] = num - 1;
+
+    while (top > 0) {
+        b = stack[--top];
+        a = stack[--top];
+        dx = coords[2 * b] - coords[2 * a];
+        dy = coords[2 * b + 1] - coords[2 * a + 1];
+        len2 = dx * dx + dy * dy;
+        dmax = 0.0;
+        imax = a;
+
+        /* squared distance of each point from the segment a-b */
+        for (i = a + 1; i < b; i++) {
+            px = coords[2 * i] - coords[2 * a];
+            py = coords[2 * i + 1] - coords[2 * a + 1];
+            u = (len2 > 0.0) ? CLAMP((px * dx + py * dy) / len2, 0.0, 1.0)
+                             : 0.0;
+            px -= u * dx;
+            py -= u * dy;
+            d2 = px * px + py * py;
+            if (d2 > dmax) {
+                dmax = d2;
+                imax = i;
+            }
+        }
+
+        if (dmax > tolerance * tolerance) {
+            keep[imax] = 1;
+            stack[top++] = a;
+            stack[top++] = imax;
+            stack[top++] = imax;
+            stack[top++] = b;
+        }
+    }
+
+    for (i = 0, n = 0; i < num; i++) {
+        if (keep[i]) {
+            coords[2 * n] = coords[2 * i];
+            coords[2 * n + 1] = coords[2 * i + 1];
+            n++;
+        }
+    }
+
+    g_free(keep);
+    g_free(stack);
+
+    return n;
+}
@@ -32,3 +32,4 @@
 
 
 void map_tools_shift_center(GdkPixbuf *in, GdkPixbuf *out, float clon);
+guint map_tools_simplify(gdouble *coords, guint num, gdouble tolerance);
@@ -635,8 +635,8 @@ static void menubar_tle_net_cb(GtkWidget * widget, gpointer data)
     gtk_dialog_set_response_sensitive(GTK_DIALOG(dialog), GTK_RESPONSE_ACCEPT,
                                       TRUE);
 
-    /* reload satellites */
-    mod_mgr_reload_sats();
+    /* swap in the new elements */
+    mod_mgr_refresh_sats();
 }
 
 /* Update TLE from local files */
@@ -780,8 +780,8 @@ static void menubar_tle_local_cb(GtkWidget * widget, gpointer data)
     if (dir)
         g_free(dir);
 
-    /* reload satellites */
-    mod_mgr_reload_sats();
+    /* swap in the new elements */
+    mod_mgr_refresh_sats();
 }
 
 static void menubar_help_cb(GtkWidget * widget, gpointer data)
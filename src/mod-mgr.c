@@ -597,6 +597,27 @@ void mod_mgr_reload_sats()
     }
 }
 
+/**
+ * Refresh the satellite elements in all modules after a TLE update.
+ *
+ * See gtk_sat_module_refresh_sats.
+ */
+void mod_mgr_refresh_sats()
+{
+    GSList         *iter;
+
+    if (!nbook)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Attempt to refresh sats but mod-mgr is NULL?"),
+                    __func__);
+        return;
+    }
+
+    for (iter = modules; iter != NULL; iter = iter->next)
+        gtk_sat_module_refresh_sats(GTK_SAT_MODULE(iter->data));
+}
+
 static void create_module_window(GtkWidget * module)
 {
     gint            w, h;
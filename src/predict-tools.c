@@ -108,6 +108,37 @@ void predict_calc(sat_t * sat, qth_t * qth, gdouble t)
                              (sat->tle.xmo + sat->tle.omegao) / twopi) + sat->tle.revnum ;
 }
 
+/**
+ * \brief Find the start time of an orbit.
+ * \param sat The satellite.
+ * \param orbit The orbit number.
+ * \return The time when sat->orbit becomes orbit, in "jul_utc", or 0.0 if
+ *         the orbit number is never reached.
+ *
+ * predict_calc() numbers the orbits by the integer part of
+ *
+ *     (n + b * age) * age + c + revnum
+ *
+ * where age is the time since epoch in days. The start of an orbit is the
+ * root of this quadratic that is closest to epoch, which is found without
+ * propagating the satellite.
+ */
+gdouble find_orbit_start(sat_t * sat, long orbit)
+{
+    gdouble         n, b, c, d;
+
+    n = sat->tle.xno * xmnpda / twopi;
+    b = sat->tle.bstar * ae;
+    c = (sat->tle.xmo + sat->tle.omegao) / twopi + sat->tle.revnum - orbit;
+    d = n * n - 4.0 * b * c;
+
+    if (n <= 0.0 || d < 0.0)
+        return 0.0;
+
+    /* the root that tends to -c/n when b goes to zero */
+    return sat->jul_epoch - 2.0 * c / (n + sqrt(d));
+}
+
 /**
  * \brief Find the AOS time of the next pass.
  * \author Alexandru Csete, OZ9AEC
@@ -0,0 +1,113 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/**
+ * Conversion of topocentric azimuth and elevation to right ascension,
+ * declination and local hour angle.
+ *
+ * Reference: Methods of Orbit Determination by Pedro Ramon Escobal,
+ *            pp. 401-402
+ *
+ * The rotation from the horizon frame to the equatorial frame is done in
+ * two steps. The rotation about the local vertical by the latitude gives
+ * the hour angle and the declination directly; the right ascension is the
+ * local sidereal time minus the hour angle. Only the first step depends on
+ * the satellite, so a batch of satellites at the same time shares the
+ * sidereal time.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <math.h>
+
+#include "radec-tools.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/**
+ * Set up the observer frame for a given time.
+ *
+ * @param frame The frame to set up.
+ * @param qth The observer location.
+ * @param jul_utc The time as Julian date.
+ *
+ * Nothing is computed if the frame is already set up for the same time and
+ * location. Otherwise the serial number of the frame changes, which allows
+ * callers to tell whether results cached with the frame are still valid.
+ * Zero-initialise a frame before its first use.
+ */
+void radec_frame_set(radec_frame_t * frame, qth_t * qth, gdouble jul_utc)
+{
+    if (frame->serial != 0 && frame->jul_utc == jul_utc &&
+        frame->lat == qth->lat && frame->lon == qth->lon)
+        return;
+
+    frame->jul_utc = jul_utc;
+    frame->lat = qth->lat;
+    frame->lon = qth->lon;
+    frame->lst = FMod2p(ThetaG_JD(jul_utc) + qth->lon * de2ra);
+    frame->sin_lat = sin(qth->lat * de2ra);
+    frame->cos_lat = cos(qth->lat * de2ra);
+    frame->serial++;
+    if (frame->serial == 0)
+        frame->serial = 1;
+}
+
+/**
+ * Convert azimuth and elevation to equatorial coordinates.
+ *
+ * @param frame The observer frame at the time of the positions.
+ * @param n The number of positions.
+ * @param az Azimuths in degrees.
+ * @param el Elevations in degrees.
+ * @param ra Right ascensions in degrees, 0 to 360.
+ * @param dec Declinations in degrees.
+ * @param ha Local hour angles in degrees, -180 to 180, or NULL.
+ */
+void radec_from_azel(const radec_frame_t * frame, guint n,
+                     const gdouble * az, const gdouble * el,
+                     gdouble * ra, gdouble * dec, gdouble * ha)
+{
+    gdouble         caz, saz, cel, sel, x, z, h;
+    guint           i;
+
+    for (i = 0; i < n; i++)
+    {
+        caz = cos(az[i] * de2ra);
+        saz = sin(az[i] * de2ra);
+        cel = cos(el[i] * de2ra);
+        sel = sin(el[i] * de2ra);
+
+        /* north and up components turned into the equatorial plane */
+        x = frame->cos_lat * sel - frame->sin_lat * caz * cel;
+        z = frame->sin_lat * sel + frame->cos_lat * caz * cel;
+
+        h = atan2(-saz * cel, x);
+        dec[i] = Degrees(asin(CLAMP(z, -1.0, 1.0)));
+        ra[i] = Degrees(FMod2p(frame->lst - h));
+        if (ha != NULL)
+            ha[i] = Degrees(h);
+    }
+}
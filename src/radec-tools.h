@@ -0,0 +1,55 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef RADEC_TOOLS_H
+#define RADEC_TOOLS_H 1
+
+#include <glib.h>
+
+#include "gtk-sat-data.h"
+
+/**
+ * Observer frame at a given time.
+ *
+ * The sidereal time and the trigonometry of the observer latitude are the
+ * same for all satellites at a time step, so they are computed once and
+ * shared by all conversions at that time.
+ */
+typedef struct {
+    gdouble         jul_utc;    /*!< Time of the frame */
+    gdouble         lat;        /*!< Observer latitude in degrees */
+    gdouble         lon;        /*!< Observer longitude in degrees */
+    gdouble         lst;        /*!< Local sidereal time in radians */
+    gdouble         sin_lat;    /*!< Sine of the latitude */
+    gdouble         cos_lat;    /*!< Cosine of the latitude */
+    guint           serial;     /*!< Incremented each time the frame changes */
+} radec_frame_t;
+
+void            radec_frame_set(radec_frame_t * frame, qth_t * qth,
+                                gdouble jul_utc);
+void            radec_from_azel(const radec_frame_t * frame, guint n,
+                                const gdouble * az, const gdouble * el,
+                                gdouble * ra, gdouble * dec, gdouble * ha);
+
+#endif
@@ -39,6 +39,7 @@
 #define KEY_CYCLE       "Cycle"
 #define KEY_LO          "LO"
 #define KEY_LOUP        "LO_UP"
+#define KEY_STEP        "STEP"
 #define KEY_TYPE        "Type"
 #define KEY_PTT         "PTT"
 #define KEY_VFO_DOWN    "VFO_DOWN"
@@ -47,6 +48,7 @@
 #define KEY_SIG_LOS     "SIGNAL_LOS"
 
 #define DEFAULT_CYCLE_MS    1000
+#define DEFAULT_STEP_HZ     1.0
 
 /**
  * \brief Read radio configuration.
@@ -175,6 +177,27 @@ gboolean radio_conf_read(radio_conf_t * conf)
         conf->loup = 0.0;
     }
 
+    /* KEY_STEP is optional */
+    if (g_key_file_has_key(cfg, GROUP, KEY_STEP, NULL))
+    {
+        conf->step = g_key_file_get_double(cfg, GROUP, KEY_STEP, &error);
+        if (error != NULL)
+        {
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s: Error reading radio conf from %s (%s)."),
+                        __func__, conf->name, error->message);
+            g_clear_error(&error);
+            g_key_file_free(cfg);
+            return FALSE;
+        }
+        if (conf->step < DEFAULT_STEP_HZ)
+            conf->step = DEFAULT_STEP_HZ;
+    }
+    else
+    {
+        conf->step = DEFAULT_STEP_HZ;
+    }
+
     /* Radio type */
     conf->type = g_key_file_get_integer(cfg, GROUP, KEY_TYPE, &error);
     if (error != NULL)
@@ -272,6 +295,8 @@ void radio_conf_save(radio_conf_t * conf)
     g_key_file_set_integer(cfg, GROUP, KEY_PORT, conf->port);
     g_key_file_set_double(cfg, GROUP, KEY_LO, conf->lo);
     g_key_file_set_double(cfg, GROUP, KEY_LOUP, conf->loup);
+    if (conf->step > DEFAULT_STEP_HZ)
+        g_key_file_set_double(cfg, GROUP, KEY_STEP, conf->step);
     g_key_file_set_integer(cfg, GROUP, KEY_TYPE, conf->type);
     g_key_file_set_integer(cfg, GROUP, KEY_PTT, conf->ptt);
 
@@ -0,0 +1,122 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Tuning policy of the radio controller.
+ *
+ * These functions decide when a new frequency is sent to the radio, how far
+ * ahead the Doppler shift is predicted and when the next cycle is due. They
+ * do not depend on the widgets, so that hamlib-mock can drive the same
+ * policy against a mock rigctld.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <math.h>
+
+#include "rig-tuning.h"
+
+
+#define RIG_MIN_DELAY 100000    /* shortest cycle period in usec */
+#define RIG_MAX_PREDICT 10.0    /* max Doppler prediction horizon in seconds */
+
+
+/**
+ * Check whether a new frequency needs to be sent to the radio.
+ *
+ * @param freq The frequency we want the radio to be tuned to.
+ * @param lastf The frequency last read back from the radio or 0.0 if the sync
+ *              has been invalidated.
+ * @param lastreq The last frequency acknowledged by the radio.
+ * @param step The tuning step of the radio in Hz.
+ *
+ * The frequency is only sent when it differs from the radio frequency by at
+ * least half a tuning step, i.e. when the radio would actually tune to a new
+ * step. A request within one step of the last acknowledged request is not
+ * sent again even if the radio reads back a different value because it
+ * rounds to its tuning step.
+ */
+gboolean rig_tuning_needs_update(gdouble freq, gdouble lastf,
+                                 gdouble lastreq, gdouble step)
+{
+    if (fabs(lastf - freq) < MAX(step / 2.0, 1.0))
+        return FALSE;
+
+    if ((lastf > 0.0) && (fabs(lastreq - freq) < step))
+        return FALSE;
+
+    return TRUE;
+}
+
+/**
+ * Get the time to extrapolate the Doppler shifts by.
+ *
+ * @param dtime Monotonic time in usec at which the shifts were computed, or
+ *              0 if they have not been computed yet.
+ * @param trate Rate of the module time relative to real time.
+ * @param latency The rigctld round trip time in usec.
+ * @param now The current monotonic time in usec.
+ * @return The time in seconds of module time.
+ *
+ * The shifts refer to the time of the last module update, while a frequency
+ * sent now reaches the radio about half a round trip later.
+ */
+gdouble rig_tuning_horizon(gint64 dtime, gdouble trate, gdouble latency,
+                           gint64 now)
+{
+    gdouble         dt;
+
+    if (dtime <= 0)
+        return 0.0;
+
+    dt = (now - dtime + latency / 2.0) / 1.0e6 * trate;
+
+    return CLAMP(dt, 0.0, RIG_MAX_PREDICT);
+}
+
+/**
+ * Compute the delay until the next cycle.
+ *
+ * @param delay The cycle period set by the user in usec.
+ * @param rate The rate of change of the Doppler shift in Hz per second of
+ *             real time, or 0 if not tracking.
+ * @param step The tuning step of the radio in Hz.
+ * @param latency The rigctld round trip time in usec.
+ * @return The delay in usec.
+ *
+ * The cycle period is the upper limit. While tracking, the next cycle is
+ * due when the Doppler shift has changed by one tuning step, so the command
+ * rate follows the Doppler slope of the pass. The delay is never shorter
+ * than RIG_MIN_DELAY or the round trip.
+ */
+gint64 rig_tuning_delay(gdouble delay, gdouble rate, gdouble step,
+                        gdouble latency)
+{
+    if (rate * delay > step * 1.0e6)
+        delay = step * 1.0e6 / rate;
+
+    return (gint64) MAX(delay, MAX(RIG_MIN_DELAY, latency));
+}
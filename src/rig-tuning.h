@@ -0,0 +1,37 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef RIG_TUNING_H
+#define RIG_TUNING_H 1
+
+#include <glib.h>
+
+gboolean        rig_tuning_needs_update(gdouble freq, gdouble lastf,
+                                        gdouble lastreq, gdouble step);
+gdouble         rig_tuning_horizon(gint64 dtime, gdouble trate,
+                                   gdouble latency, gint64 now);
+gint64          rig_tuning_delay(gdouble delay, gdouble rate, gdouble step,
+                                 gdouble latency);
+
+#endif
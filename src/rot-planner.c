@@ -0,0 +1,349 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Rotator trajectory planner.
+ *
+ * The trajectory of a pass is computed once when the pass, the target or
+ * the rotator changes, from the track of the satellite between AOS and LOS
+ * sampled by the caller. The azimuth is unwrapped and placed within the travel range given by the
+ * azimuth stop. Flipping over the zenith is chosen for the whole pass,
+ * and only when it needs fewer unwinds across the stop than normal
+ * tracking. The track is then limited to the slew rates of the rotator
+ * and reduced to set-points that are at least the motion threshold
+ * apart. Each set-point is the middle of the stretch of track it
+ * covers, so the rotator leads the satellite by half the threshold
+ * while the set-point applies.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <math.h>
+
+#include "rot-planner.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/* A trajectory sample in continuous azimuth */
+typedef struct {
+    gdouble         t;
+    gdouble         az;
+    gdouble         el;
+    gboolean        wrap;       /*!< The rotator unwinds before this sample */
+} plan_sample_t;
+
+
+/* Difference between two azimuths in (-180, 180] */
+static gdouble az_delta(gdouble from, gdouble to)
+{
+    gdouble         d = fmod(to - from, 360.0);
+
+    if (d > 180.0)
+        d -= 360.0;
+    else if (d <= -180.0)
+        d += 360.0;
+
+    return d;
+}
+
+/*
+ * Map raw azimuths to the travel range of the rotator.
+ *
+ * The azimuth is kept continuous and unwound by a full turn whenever it
+ * would run into a stop. Every starting turn within the travel range is
+ * tried and the one with the fewest unwinds is kept.
+ *
+ * The travel range is at least a full turn, so there is always a
+ * starting turn. Returns the number of unwinds.
+ */
+static guint place_track(GArray * samples, gboolean flip,
+                         gdouble lo, gdouble hi)
+{
+    plan_sample_t  *s;
+    gdouble         start, off, best_start = 0.0, az, prev;
+    guint           i, wraps, best = G_MAXUINT;
+
+    s = &g_array_index(samples, plan_sample_t, 0);
+    start = fmod(s->az + (flip ? 180.0 : 0.0), 360.0);
+    while (start >= lo)
+        start -= 360.0;
+
+    for (start += 360.0; start <= hi; start += 360.0)
+    {
+        wraps = 0;
+        off = start;
+        prev = s[0].az;
+        for (i = 1; i < samples->len; i++)
+        {
+            off += az_delta(prev, s[i].az);
+            prev = s[i].az;
+            if (off > hi)
+            {
+                off -= 360.0;
+                wraps++;
+            }
+            else if (off < lo)
+            {
+                off += 360.0;
+                wraps++;
+            }
+        }
+
+        if (wraps < best)
+        {
+            best = wraps;
+            best_start = start;
+        }
+    }
+
+    /* apply the best placement */
+    az = best_start;
+    prev = s[0].az;
+    for (i = 0; i < samples->len; i++)
+    {
+        if (i > 0)
+            az += az_delta(prev, s[i].az);
+        s[i].wrap = FALSE;
+        prev = s[i].az;
+        if (az > hi)
+        {
+            az -= 360.0;
+            s[i].wrap = TRUE;
+        }
+        else if (az < lo)
+        {
+            az += 360.0;
+            s[i].wrap = TRUE;
+        }
+        s[i].az = az;
+        if (flip)
+            s[i].el = 180.0 - s[i].el;
+    }
+
+    return best;
+}
+
+/* Count the unwinds of a track without changing it */
+static guint count_wraps(GArray * samples, gboolean flip,
+                         gdouble lo, gdouble hi)
+{
+    GArray         *copy;
+    guint           wraps;
+
+    copy = g_array_sized_new(FALSE, FALSE, sizeof(plan_sample_t),
+                             samples->len);
+    g_array_append_vals(copy, samples->data, samples->len);
+    wraps = place_track(copy, flip, lo, hi);
+    g_array_free(copy, TRUE);
+
+    return wraps;
+}
+
+/*
+ * Limit the motion of one axis to a slew rate.
+ *
+ * The track is limited once forwards and once backwards, and the average
+ * is used. The forward pass lags behind fast stretches of the track and
+ * the backward pass starts moving early, so the average splits the
+ * pointing error between the two while keeping within the rate.
+ */
+static void limit_rate(GArray * samples, gsize offset, gdouble rate)
+{
+    plan_sample_t  *s = (plan_sample_t *) samples->data;
+    gdouble        *fwd;
+    gdouble         max, prev;
+    guint           i, n = samples->len;
+
+    if (rate <= 0.0 || n < 2)
+        return;
+
+    fwd = g_new(gdouble, n);
+
+#define AXIS(i) (*(gdouble *) ((gchar *) &s[i] + offset))
+    fwd[0] = AXIS(0);
+    for (i = 1; i < n; i++)
+    {
+        if (s[i].wrap)
+        {
+            fwd[i] = AXIS(i);
+            continue;
+        }
+        max = rate * (s[i].t - s[i - 1].t) * secday;
+        fwd[i] = fwd[i - 1] + CLAMP(AXIS(i) - fwd[i - 1], -max, max);
+    }
+
+    prev = AXIS(n - 1);
+    for (i = n - 1; i-- > 0;)
+    {
+        max = rate * (s[i + 1].t - s[i].t) * secday;
+        if (!s[i + 1].wrap)
+            prev += CLAMP(AXIS(i) - prev, -max, max);
+        else
+            prev = AXIS(i);
+        AXIS(i) = (fwd[i] + prev) / 2.0;
+    }
+    AXIS(n - 1) = (fwd[n - 1] + AXIS(n - 1)) / 2.0;
+#undef AXIS
+
+    g_free(fwd);
+}
+
+/* Convert a continuous azimuth to the range accepted by the rotator */
+static gdouble to_rotator(rotor_conf_t * conf, gdouble az)
+{
+    while (az > conf->maxaz)
+        az -= 360.0;
+    while (az < conf->minaz)
+        az += 360.0;
+
+    return CLAMP(az, conf->minaz, conf->maxaz);
+}
+
+static void add_setpoint(rot_plan_t * plan, rotor_conf_t * conf,
+                         plan_sample_t * first, plan_sample_t * last)
+{
+    rot_setpoint_t  point;
+
+    point.t = first->t;
+    point.az = to_rotator(conf, (first->az + last->az) / 2.0);
+    point.el = CLAMP((first->el + last->el) / 2.0, conf->minel, conf->maxel);
+    g_array_append_val(plan->points, point);
+}
+
+/**
+ * Plan the rotator trajectory for a pass.
+ *
+ * @param track The track of the satellite as rot_setpoint_t in time order,
+ *              with the time in days and the azimuth and elevation as seen
+ *              from the station.
+ * @param conf The rotator configuration.
+ * @param threshold The motion threshold in degrees.
+ * @return A newly allocated plan, or NULL if there is nothing to plan.
+ */
+rot_plan_t     *rot_plan_new(GArray * track, rotor_conf_t * conf,
+                             gdouble threshold)
+{
+    rot_plan_t     *plan;
+    GArray         *samples;
+    rot_setpoint_t *point;
+    plan_sample_t   sample, *s, *first;
+    gdouble         lo, hi;
+    guint           i, wraps, fwraps;
+
+    if (track == NULL || track->len < 2 || conf == NULL)
+        return NULL;
+
+    samples = g_array_sized_new(FALSE, FALSE, sizeof(plan_sample_t),
+                                track->len);
+    for (i = 0; i < track->len; i++)
+    {
+        point = &g_array_index(track, rot_setpoint_t, i);
+        sample.t = point->t;
+        sample.az = point->az;
+        sample.el = MAX(point->el, 0.0);
+        sample.wrap = FALSE;
+        g_array_append_val(samples, sample);
+    }
+
+    /* travel range starting at the azimuth stop */
+    lo = conf->azstoppos;
+    hi = lo + MAX(360.0, conf->maxaz - conf->minaz);
+
+    plan = g_new0(rot_plan_t, 1);
+    wraps = count_wraps(samples, FALSE, lo, hi);
+    if (wraps > 0 && conf->maxel >= 180.0)
+    {
+        fwraps = count_wraps(samples, TRUE, lo, hi);
+        plan->flipped = fwraps < wraps;
+    }
+    plan->wraps = place_track(samples, plan->flipped, lo, hi);
+
+    limit_rate(samples, G_STRUCT_OFFSET(plan_sample_t, az), conf->azrate);
+    limit_rate(samples, G_STRUCT_OFFSET(plan_sample_t, el), conf->elrate);
+
+    /* reduce to set-points at least threshold apart */
+    plan->points = g_array_new(FALSE, FALSE, sizeof(rot_setpoint_t));
+    s = (plan_sample_t *) samples->data;
+    first = &s[0];
+    for (i = 1; i < samples->len; i++)
+    {
+        if (s[i].wrap || fabs(s[i].az - first->az) > threshold ||
+            fabs(s[i].el - first->el) > threshold)
+        {
+            add_setpoint(plan, conf, first, &s[i - 1]);
+            first = &s[i];
+        }
+    }
+    add_setpoint(plan, conf, first, &s[samples->len - 1]);
+
+    g_array_free(samples, TRUE);
+
+    return plan;
+}
+
+void rot_plan_free(rot_plan_t * plan)
+{
+    if (plan == NULL)
+        return;
+
+    g_array_free(plan->points, TRUE);
+    g_free(plan);
+}
+
+/**
+ * Find the set-point that applies at a given time.
+ *
+ * @param plan The plan.
+ * @param t The time.
+ * @return Index of the set-point. The first set-point applies before the
+ *         pass and the last one after it.
+ */
+guint rot_plan_find(rot_plan_t * plan, gdouble t)
+{
+    guint           lo = 0, hi = plan->points->len, mid;
+
+    while (hi - lo > 1)
+    {
+        mid = (lo + hi) / 2;
+        if (g_array_index(plan->points, rot_setpoint_t, mid).t <= t)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/** Get the set-point that applies at a given time. */
+void rot_plan_get(rot_plan_t * plan, gdouble t, gdouble * az, gdouble * el)
+{
+    rot_setpoint_t *point;
+
+    point = &g_array_index(plan->points, rot_setpoint_t,
+                           rot_plan_find(plan, t));
+    *az = point->az;
+    *el = point->el;
+}
@@ -0,0 +1,53 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef ROT_PLANNER_H
+#define ROT_PLANNER_H 1
+
+#include <glib.h>
+
+#include "rotor-conf.h"
+
+/** A rotator set-point. */
+typedef struct {
+    gdouble         t;          /*!< Time from which the set-point applies */
+    gdouble         az;         /*!< Azimuth in rotator coordinates */
+    gdouble         el;         /*!< Elevation in rotator coordinates */
+} rot_setpoint_t;
+
+/** Rotator trajectory for a whole pass. */
+typedef struct {
+    GArray         *points;     /*!< rot_setpoint_t in time order */
+    gboolean        flipped;    /*!< Pass is tracked over the zenith */
+    guint           wraps;      /*!< Number of unwinds across the az stop */
+} rot_plan_t;
+
+rot_plan_t     *rot_plan_new(GArray * track, rotor_conf_t * conf,
+                             gdouble threshold);
+void            rot_plan_free(rot_plan_t * plan);
+guint           rot_plan_find(rot_plan_t * plan, gdouble t);
+void            rot_plan_get(rot_plan_t * plan, gdouble t,
+                             gdouble * az, gdouble * el);
+
+#endif
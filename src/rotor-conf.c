@@ -45,6 +45,8 @@
 #define KEY_MAXEL       "MaxEl"
 #define KEY_AZSTOPPOS   "AzStopPos"
 #define KEY_THLD        "Threshold"
+#define KEY_AZRATE      "AzRate"
+#define KEY_ELRATE      "ElRate"
 
 #define DEFAULT_CYCLE_MS    1000
 #define DEFAULT_THLD_DEG    5.0
@@ -216,6 +218,10 @@ gboolean rotor_conf_read(rotor_conf_t * conf)
         conf->azstoppos = conf->minaz;
     }
 
+    /* slew rates are optional; 0 means no limit is known */
+    conf->azrate = g_key_file_get_double(cfg, GROUP, KEY_AZRATE, NULL);
+    conf->elrate = g_key_file_get_double(cfg, GROUP, KEY_ELRATE, NULL);
+
     g_key_file_free(cfg);
 
     return TRUE;
@@ -260,6 +266,11 @@ void rotor_conf_save(rotor_conf_t * conf)
     else
         g_key_file_set_double(cfg, GROUP, KEY_THLD, conf->threshold);
 
+    if (conf->azrate > 0.0)
+        g_key_file_set_double(cfg, GROUP, KEY_AZRATE, conf->azrate);
+    if (conf->elrate > 0.0)
+        g_key_file_set_double(cfg, GROUP, KEY_ELRATE, conf->elrate);
+
     /* build filename */
     confdir = get_hwconf_dir();
     fname = g_strconcat(confdir, G_DIR_SEPARATOR_S, conf->name, ".rot", NULL);
@@ -51,6 +51,8 @@ typedef struct {
     gdouble         maxel;      /*!< Upper elevation limit */
     gdouble         azstoppos;  /*!< absolute position of rotation stops; normally = minaz */
     gdouble         threshold;  /*!< Angle difference that triggers new motion command */
+    gdouble         azrate;     /*!< Azimuth slew rate in deg/sec; 0 if unknown */
+    gdouble         elrate;     /*!< Elevation slew rate in deg/sec; 0 if unknown */
 } rotor_conf_t;
 
 
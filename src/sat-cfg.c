@@ -124,11 +124,14 @@ sat_cfg_bool_t  sat_cfg_bool[SAT_CFG_BOOL_NUM] = {
     {"MODULES", "MAP_SHOW_GRID", TRUE},
     {"MODULES", "MAP_SHOW_TERMINATOR", TRUE},
     {"MODULES", "MAP_KEEP_RATIO", FALSE},
+    {"MODULES", "MAP_DIRECT_RENDER", FALSE},
+    {"MODULES", "MAP_DECLUTTER_LABELS", FALSE},
     {"MODULES", "POLAR_QTH_INFO", TRUE},
     {"MODULES", "POLAR_NEXT_EVENT", TRUE},
     {"MODULES", "POLAR_CURSOR_TRACK", TRUE},
     {"MODULES", "POLAR_EXTRA_AZ_TICKS", FALSE},
     {"MODULES", "POLAR_SHOW_TRACK_AUTO", FALSE},
+    {"MODULES", "POLAR_DECLUTTER_LABELS", FALSE},
     {"TLE", "SERVER_AUTH", FALSE},
     {"TLE", "PROXY_AUTH", FALSE},
     {"TLE", "ADD_NEW_SATS", TRUE},
@@ -44,11 +44,14 @@ typedef enum {
     SAT_CFG_BOOL_MAP_SHOW_GRID, /*!< Show grid on map. */
     SAT_CFG_BOOL_MAP_SHOW_TERMINATOR,   /*!< Show solar terminator on map. */
     SAT_CFG_BOOL_MAP_KEEP_RATIO,        /*!< Keep original aspect ratio */
+    SAT_CFG_BOOL_MAP_DIRECT_RENDER,     /*!< Draw satellites without canvas items */
+    SAT_CFG_BOOL_MAP_DECLUTTER, /*!< Hide labels that overlap other labels. */
     SAT_CFG_BOOL_POL_SHOW_QTH_INFO,     /*!< Show QTH info on polar plot */
     SAT_CFG_BOOL_POL_SHOW_NEXT_EV,      /*!< Show next event on polar plot */
     SAT_CFG_BOOL_POL_SHOW_CURS_TRACK,   /*!< Track mouse cursor on polar plot. */
     SAT_CFG_BOOL_POL_SHOW_EXTRA_AZ_TICKS,       /*!< Extra Az ticks at every 30 deg. */
     SAT_CFG_BOOL_POL_SHOW_TRACK_AUTO,   /*!< Automatically show the sky track. */
+    SAT_CFG_BOOL_POL_DECLUTTER, /*!< Hide labels that overlap other labels. */
     SAT_CFG_BOOL_TLE_SERVER_AUTH,       /*!< TLE server requires authentication. */
     SAT_CFG_BOOL_TLE_PROXY_AUTH,        /*!< Proxy requires authentication. */
     SAT_CFG_BOOL_TLE_ADD_NEW,   /*!< Add new satellites to database. */
@@ -39,6 +39,7 @@
 #include "sat-pass-dialogs.h"
 #include "sgpsdp/sgp4sdp4.h"
 #include "trsp-conf.h"
+#include "trsp-db.h"
 
 
 /**
@@ -66,7 +67,7 @@ static GtkWidget *create_transponder_table(guint catnum)
     gchar          *text;
 
 
-    trsplist = read_transponders(catnum);
+    trsplist = trsp_db_get(catnum);
     if (trsplist == NULL)
     {
         swin = gtk_label_new(_("No transponders"));
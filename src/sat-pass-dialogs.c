@@ -41,6 +41,7 @@
 #include "pass-popup-menu.h"
 #include "predict-tools.h"
 #include "print-pass.h"
+#include "radec-tools.h"
 #include "sat-cfg.h"
 #include "sat-log.h"
 #include "sat-vis.h"
@@ -232,9 +233,6 @@ static gboolean button_press_cb(GtkWidget * treeview,
 static void     view_popup_menu(GtkWidget * treeview,
                                 GdkEventButton * event, gpointer data);
 
-static void     Calc_RADec(gdouble jul_utc, gdouble saz, gdouble sel,
-                           qth_t * qth, obs_astro_t * obs_set);
-
 static void     single_pass_response(GtkWidget * dialog, gint response,
                                      gpointer data);
 static void     multi_pass_response(GtkWidget * dialog, gint response,
@@ -284,7 +282,7 @@ void show_pass(const gchar * satname, qth_t * qth, pass_t * pass,
     gdouble         doppler;
     gdouble         delay;
     gdouble         loss;
-    obs_astro_t     astro;
+    radec_frame_t   frame = { 0 };
     gdouble         ra, dec;
 
     /* get columns flags */
@@ -365,10 +363,9 @@ void show_pass(const gchar * satname, qth_t * qth, pass_t * pass,
         /*     SINGLE_PASS_COL_DEC */
         if (flags & (SINGLE_PASS_FLAG_RA | SINGLE_PASS_FLAG_DEC))
         {
-            Calc_RADec(detail->time, detail->az, detail->el, qth, &astro);
-
-            ra = Degrees(astro.ra);
-            dec = Degrees(astro.dec);
+            radec_frame_set(&frame, qth, detail->time);
+            radec_from_azel(&frame, 1, &detail->az, &detail->el,
+                            &ra, &dec, NULL);
 
             gtk_list_store_set(liststore, &item,
                                SINGLE_PASS_COL_RA, ra, SINGLE_PASS_COL_DEC,
@@ -871,52 +868,6 @@ static void single_pass_dialog_destroy(GtkWidget * dialog, gpointer data)
     gtk_widget_destroy(dialog);
 }
 
-/*** FIXME: other copies */
-static void Calc_RADec(gdouble jul_utc, gdouble saz, gdouble sel,
-                       qth_t * qth, obs_astro_t * obs_set)
-{
-
-    double          phi, theta, sin_theta, cos_theta, sin_phi, cos_phi,
-        az, el, Lxh, Lyh, Lzh, Sx, Ex, Zx, Sy, Ey, Zy, Sz, Ez, Zz,
-        Lx, Ly, Lz, cos_delta, sin_alpha, cos_alpha;
-    geodetic_t      geodetic;
-
-    geodetic.lon = qth->lon * de2ra;
-    geodetic.lat = qth->lat * de2ra;
-    geodetic.alt = qth->alt / 1000.0;
-    geodetic.theta = 0;
-
-    az = saz * de2ra;
-    el = sel * de2ra;
-    phi = geodetic.lat;
-    theta = FMod2p(ThetaG_JD(jul_utc) + geodetic.lon);
-    sin_theta = sin(theta);
-    cos_theta = cos(theta);
-    sin_phi = sin(phi);
-    cos_phi = cos(phi);
-    Lxh = -cos(az) * cos(el);
-    Lyh = sin(az) * cos(el);
-    Lzh = sin(el);
-    Sx = sin_phi * cos_theta;
-    Ex = -sin_theta;
-    Zx = cos_theta * cos_phi;
-    Sy = sin_phi * sin_theta;
-    Ey = cos_theta;
-    Zy = sin_theta * cos_phi;
-    Sz = -cos_phi;
-    Ez = 0;
-    Zz = sin_phi;
-    Lx = Sx * Lxh + Ex * Lyh + Zx * Lzh;
-    Ly = Sy * Lxh + Ey * Lyh + Zy * Lzh;
-    Lz = Sz * Lxh + Ez * Lyh + Zz * Lzh;
-    obs_set->dec = ArcSin(Lz);  /* Declination (radians) */
-    cos_delta = sqrt(1 - Sqr(Lz));
-    sin_alpha = Ly / cos_delta;
-    cos_alpha = Lx / cos_delta;
-    obs_set->ra = AcTan(sin_alpha, cos_alpha);  /* Right Ascension (radians) */
-    obs_set->ra = FMod2p(obs_set->ra);
-}
-
 /***   MULTI PASS  ***/
 
 /**
@@ -37,6 +37,7 @@ static gchar   *mapf = NULL;
 
 /* content selectors */
 static GtkWidget *qth, *next, *curs, *grid, *terminatoronoff;
+static GtkWidget *declutter;
 
 /* colour selectors */
 static GtkWidget *qthc, *gridc, *tickc;
@@ -201,6 +202,9 @@ static void reset_cb(GtkWidget * button, gpointer cfg)
         gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(terminatoronoff),
                                      sat_cfg_get_bool_def
                                      (SAT_CFG_BOOL_MAP_SHOW_TERMINATOR));
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(declutter),
+                                     sat_cfg_get_bool_def
+                                     (SAT_CFG_BOOL_MAP_DECLUTTER));
         /* colours */
         rgba = sat_cfg_get_int_def(SAT_CFG_INT_MAP_QTH_COL);
         rgba_from_cfg(rgba, &gdk_rgba);
@@ -284,6 +288,9 @@ static void reset_cb(GtkWidget * button, gpointer cfg)
         gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(terminatoronoff),
                                      sat_cfg_get_bool
                                      (SAT_CFG_BOOL_MAP_SHOW_TERMINATOR));
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(declutter),
+                                     sat_cfg_get_bool
+                                     (SAT_CFG_BOOL_MAP_DECLUTTER));
 
         /* colours */
         rgba = sat_cfg_get_int(SAT_CFG_INT_MAP_QTH_COL);
@@ -398,6 +405,10 @@ void sat_pref_map_view_ok(GKeyFile * cfg)
                                    MOD_CFG_MAP_SHOW_TERMINATOR,
                                    gtk_toggle_button_get_active
                                    (GTK_TOGGLE_BUTTON(terminatoronoff)));
+            g_key_file_set_boolean(cfg, MOD_CFG_MAP_SECTION,
+                                   MOD_CFG_MAP_DECLUTTER,
+                                   gtk_toggle_button_get_active
+                                   (GTK_TOGGLE_BUTTON(declutter)));
 
             /* colours */
             gtk_color_chooser_get_rgba(GTK_COLOR_CHOOSER(qthc), &gdk_rgba);
@@ -498,6 +509,9 @@ void sat_pref_map_view_ok(GKeyFile * cfg)
             sat_cfg_set_bool(SAT_CFG_BOOL_MAP_SHOW_TERMINATOR,
                              gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON
                                                           (terminatoronoff)));
+            sat_cfg_set_bool(SAT_CFG_BOOL_MAP_DECLUTTER,
+                             gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON
+                                                          (declutter)));
 
 
             /* colours */
@@ -587,6 +601,9 @@ void sat_pref_map_view_ok(GKeyFile * cfg)
             g_key_file_remove_key(cfg,
                                   MOD_CFG_MAP_SECTION,
                                   MOD_CFG_MAP_SHOW_TERMINATOR, NULL);
+            g_key_file_remove_key(cfg,
+                                  MOD_CFG_MAP_SECTION,
+                                  MOD_CFG_MAP_DECLUTTER, NULL);
             g_key_file_remove_key(cfg,
                                   MOD_CFG_MAP_SECTION,
                                   MOD_CFG_MAP_QTH_COL, NULL);
@@ -637,6 +654,7 @@ void sat_pref_map_view_ok(GKeyFile * cfg)
             sat_cfg_reset_bool(SAT_CFG_BOOL_MAP_SHOW_CURS_TRACK);
             sat_cfg_reset_bool(SAT_CFG_BOOL_MAP_SHOW_GRID);
             sat_cfg_reset_bool(SAT_CFG_BOOL_MAP_SHOW_TERMINATOR);
+            sat_cfg_reset_bool(SAT_CFG_BOOL_MAP_DECLUTTER);
 
             /* colours */
             sat_cfg_reset_int(SAT_CFG_INT_MAP_QTH_COL);
@@ -905,6 +923,29 @@ static void create_bool_selectors(GKeyFile * cfg, GtkBox * vbox)
     }
     g_signal_connect(terminatoronoff, "toggled", G_CALLBACK(content_changed), NULL);
     gtk_box_pack_start(GTK_BOX(hbox), terminatoronoff, FALSE, TRUE, 0);
+
+    /* Label decluttering */
+    declutter = gtk_check_button_new_with_label(_("Declutter Labels"));
+    gtk_widget_set_tooltip_text(declutter,
+                                _("Hide satellite labels that overlap other "
+                                  "labels. The label of the selected "
+                                  "satellite is always shown."));
+    if (cfg != NULL)
+    {
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(declutter),
+                                     mod_cfg_get_bool(cfg,
+                                                      MOD_CFG_MAP_SECTION,
+                                                      MOD_CFG_MAP_DECLUTTER,
+                                                      SAT_CFG_BOOL_MAP_DECLUTTER));
+    }
+    else
+    {
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(declutter),
+                                     sat_cfg_get_bool
+                                     (SAT_CFG_BOOL_MAP_DECLUTTER));
+    }
+    g_signal_connect(declutter, "toggled", G_CALLBACK(content_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(hbox), declutter, FALSE, TRUE, 0);
 }
 
 /**
@@ -41,6 +41,7 @@ static GtkWidget *bgd, *axis, *tick, *sat, *ssat, *track, *info;
 
 /* Misc */
 static GtkWidget *showtrack;
+static GtkWidget *declutter;
 
 /* misc bookkeeping */
 static gint     orient = POLAR_VIEW_NESW;
@@ -169,6 +170,9 @@ static void reset_cb(GtkWidget * button, gpointer cfg)
         gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(showtrack),
                                      sat_cfg_get_bool_def
                                      (SAT_CFG_BOOL_POL_SHOW_TRACK_AUTO));
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(declutter),
+                                     sat_cfg_get_bool_def
+                                     (SAT_CFG_BOOL_POL_DECLUTTER));
     }
     else
     {
@@ -221,6 +225,9 @@ static void reset_cb(GtkWidget * button, gpointer cfg)
         gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(showtrack),
                                      sat_cfg_get_bool
                                      (SAT_CFG_BOOL_POL_SHOW_TRACK_AUTO));
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(declutter),
+                                     sat_cfg_get_bool
+                                     (SAT_CFG_BOOL_POL_DECLUTTER));
     }
 
     /* orientation needs some special attention */
@@ -727,6 +734,29 @@ static void create_misc_selectors(GKeyFile * cfg, GtkBox * vbox)
     }
     g_signal_connect(showtrack, "toggled", G_CALLBACK(content_changed), NULL);
     gtk_box_pack_start(GTK_BOX(hbox), showtrack, FALSE, TRUE, 0);
+
+    /* label decluttering */
+    declutter = gtk_check_button_new_with_label(_("Declutter labels"));
+    gtk_widget_set_tooltip_text(declutter,
+                                _("Hide satellite labels that overlap other "
+                                  "labels. The label of the selected "
+                                  "satellite is always shown."));
+    if (cfg != NULL)
+    {
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(declutter),
+                                     mod_cfg_get_bool(cfg,
+                                                      MOD_CFG_POLAR_SECTION,
+                                                      MOD_CFG_POLAR_DECLUTTER,
+                                                      SAT_CFG_BOOL_POL_DECLUTTER));
+    }
+    else
+    {
+        gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(declutter),
+                                     sat_cfg_get_bool
+                                     (SAT_CFG_BOOL_POL_DECLUTTER));
+    }
+    g_signal_connect(declutter, "toggled", G_CALLBACK(content_changed), NULL);
+    gtk_box_pack_start(GTK_BOX(hbox), declutter, FALSE, TRUE, 0);
 }
 
 /**
@@ -850,6 +880,11 @@ void sat_pref_polar_view_ok(GKeyFile * cfg)
                                    MOD_CFG_POLAR_SHOW_TRACK_AUTO,
                                    gtk_toggle_button_get_active
                                    (GTK_TOGGLE_BUTTON(showtrack)));
+            g_key_file_set_boolean(cfg,
+                                   MOD_CFG_POLAR_SECTION,
+                                   MOD_CFG_POLAR_DECLUTTER,
+                                   gtk_toggle_button_get_active
+                                   (GTK_TOGGLE_BUTTON(declutter)));
 
         }
         else
@@ -906,6 +941,9 @@ void sat_pref_polar_view_ok(GKeyFile * cfg)
             sat_cfg_set_bool(SAT_CFG_BOOL_POL_SHOW_TRACK_AUTO,
                              gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON
                                                           (showtrack)));
+            sat_cfg_set_bool(SAT_CFG_BOOL_POL_DECLUTTER,
+                             gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON
+                                                          (declutter)));
         }
 
         dirty = FALSE;
@@ -954,6 +992,9 @@ void sat_pref_polar_view_ok(GKeyFile * cfg)
             g_key_file_remove_key(cfg,
                                   MOD_CFG_POLAR_SECTION,
                                   MOD_CFG_POLAR_SHOW_TRACK_AUTO, NULL);
+            g_key_file_remove_key(cfg,
+                                  MOD_CFG_POLAR_SECTION,
+                                  MOD_CFG_POLAR_DECLUTTER, NULL);
         }
         else
         {
@@ -978,6 +1019,7 @@ void sat_pref_polar_view_ok(GKeyFile * cfg)
 
             /* misc */
             sat_cfg_reset_bool(SAT_CFG_BOOL_POL_SHOW_TRACK_AUTO);
+            sat_cfg_reset_bool(SAT_CFG_BOOL_POL_DECLUTTER);
         }
         reset = FALSE;
     }
@@ -41,6 +41,7 @@ static GtkWidget *ptt;          /* PTT */
 static GtkWidget *vfo;          /* VFO Up/Down selector */
 static GtkWidget *lo;           /* local oscillator of downconverter */
 static GtkWidget *loup;         /* local oscillator of upconverter */
+static GtkWidget *step;         /* tuning step */
 static GtkWidget *sigaos;       /* AOS signalling */
 static GtkWidget *siglos;       /* LOS signalling */
 
@@ -52,6 +53,7 @@ static void clear_widgets()
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(port), 4532);     /* hamlib default? */
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(lo), 0);
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(loup), 0);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(step), 1);
     gtk_combo_box_set_active(GTK_COMBO_BOX(type), RIG_TYPE_RX);
     gtk_combo_box_set_active(GTK_COMBO_BOX(ptt), PTT_TYPE_NONE);
     gtk_combo_box_set_active(GTK_COMBO_BOX(vfo), 0);
@@ -100,6 +102,9 @@ static void update_widgets(radio_conf_t * conf)
     /* lo up in MHz */
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(loup), conf->loup / 1000000.0);
 
+    /* tuning step in Hz */
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(step), conf->step);
+
     /* AOS / LOS signalling */
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(sigaos), conf->signal_aos);
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(siglos), conf->signal_los);
@@ -421,18 +426,38 @@ static GtkWidget *create_editor_widgets(radio_conf_t * conf)
     g_object_set(label, "xalign", 0.0, "yalign", 0.5, NULL);
     gtk_grid_attach(GTK_GRID(table), label, 3, 7, 1, 1);
 
+    /* Tuning step */
+    label = gtk_label_new(_("Tuning step"));
+    g_object_set(label, "xalign", 1.0, "yalign", 0.5, NULL);
+    gtk_grid_attach(GTK_GRID(table), label, 0, 8, 1, 1);
+
+    step = gtk_spin_button_new_with_range(1, 10000, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(step), 1);
+    gtk_spin_button_set_digits(GTK_SPIN_BUTTON(step), 0);
+    gtk_widget_set_tooltip_text(step,
+                                _
+                                ("Enter the smallest tuning step of the radio. "
+                                 "Doppler corrections are only sent to the "
+                                 "radio when they change the frequency by at "
+                                 "least one step."));
+    gtk_grid_attach(GTK_GRID(table), step, 1, 8, 2, 1);
+
+    label = gtk_label_new(_("Hz"));
+    g_object_set(label, "xalign", 0.0, "yalign", 0.5, NULL);
+    gtk_grid_attach(GTK_GRID(table), label, 3, 8, 1, 1);
+
     /* AOS / LOS signalling */
     label = gtk_label_new(_("Signalling"));
     g_object_set(label, "xalign", 1.0, "yalign", 0.5, NULL);
-    gtk_grid_attach(GTK_GRID(table), label, 0, 8, 1, 1);
+    gtk_grid_attach(GTK_GRID(table), label, 0, 9, 1, 1);
 
     sigaos = gtk_check_button_new_with_label(_("AOS"));
-    gtk_grid_attach(GTK_GRID(table), sigaos, 1, 8, 1, 1);
+    gtk_grid_attach(GTK_GRID(table), sigaos, 1, 9, 1, 1);
     gtk_widget_set_tooltip_text(sigaos,
                                 _("Enable AOS signalling for this radio."));
 
     siglos = gtk_check_button_new_with_label(_("LOS"));
-    gtk_grid_attach(GTK_GRID(table), siglos, 2, 8, 1, 1);
+    gtk_grid_attach(GTK_GRID(table), siglos, 2, 9, 1, 1);
     gtk_widget_set_tooltip_text(siglos,
                                 _("Enable LOS signalling for this radio."));
 
@@ -468,6 +493,9 @@ static gboolean apply_changes(radio_conf_t * conf)
     /* lo up freq */
     conf->loup = 1000000.0 * gtk_spin_button_get_value(GTK_SPIN_BUTTON(loup));
 
+    /* tuning step */
+    conf->step = gtk_spin_button_get_value(GTK_SPIN_BUTTON(step));
+
     /* rig type */
     conf->type = gtk_combo_box_get_active(GTK_COMBO_BOX(type));
 
@@ -60,6 +60,7 @@ static GtkTreeModel *create_and_fill_model()
                                    G_TYPE_INT,  // VFO Down
                                    G_TYPE_DOUBLE,       // LO DOWN
                                    G_TYPE_DOUBLE,       // LO UO
+                                   G_TYPE_DOUBLE,       // Tuning step
                                    G_TYPE_BOOLEAN,      // AOS signalling
                                    G_TYPE_BOOLEAN       // LOS signalling
         );
@@ -96,6 +97,7 @@ static GtkTreeModel *create_and_fill_model()
                                        RIG_LIST_COL_VFODOWN, conf.vfoDown,
                                        RIG_LIST_COL_LO, conf.lo,
                                        RIG_LIST_COL_LOUP, conf.loup,
+                                       RIG_LIST_COL_STEP, conf.step,
                                        RIG_LIST_COL_SIGAOS, conf.signal_aos,
                                        RIG_LIST_COL_SIGLOS, conf.signal_los,
                                        -1);
@@ -298,6 +300,33 @@ static void render_lo(GtkTreeViewColumn * col,
     g_free(buff);
 }
 
+/**
+ * Render tuning step.
+ *
+ * @param col Pointer to the tree view column.
+ * @param renderer Pointer to the renderer.
+ * @param model Pointer to the tree model.
+ * @param iter Pointer to the tree iterator.
+ * @param column The column number in the model.
+ */
+static void render_step(GtkTreeViewColumn * col,
+                        GtkCellRenderer * renderer,
+                        GtkTreeModel * model,
+                        GtkTreeIter * iter, gpointer column)
+{
+    gdouble         number;
+    gchar          *buff;
+    guint           coli = GPOINTER_TO_UINT(column);
+
+    (void)col;
+
+    gtk_tree_model_get(model, iter, coli, &number, -1);
+
+    buff = g_strdup_printf("%.0f Hz", number);
+    g_object_set(renderer, "text", buff, NULL);
+    g_free(buff);
+}
+
 /**
  * Render VFO selection.
  *
@@ -393,6 +422,7 @@ static void edit_cb(GtkWidget * button, gpointer data)
         .vfoDown = 0,
         .lo = 0.0,
         .loup = 0.0,
+        .step = 1.0,
         .signal_aos = FALSE,
         .signal_los = FALSE
     };
@@ -425,6 +455,7 @@ static void edit_cb(GtkWidget * button, gpointer data)
                            RIG_LIST_COL_VFODOWN, &conf.vfoDown,
                            RIG_LIST_COL_LO, &conf.lo,
                            RIG_LIST_COL_LOUP, &conf.loup,
+                           RIG_LIST_COL_STEP, &conf.step,
                            RIG_LIST_COL_SIGAOS, &conf.signal_aos,
                            RIG_LIST_COL_SIGLOS, &conf.signal_los, -1);
     }
@@ -461,6 +492,7 @@ static void edit_cb(GtkWidget * button, gpointer data)
                            RIG_LIST_COL_VFODOWN, conf.vfoDown,
                            RIG_LIST_COL_LO, conf.lo,
                            RIG_LIST_COL_LOUP, conf.loup,
+                           RIG_LIST_COL_STEP, conf.step,
                            RIG_LIST_COL_SIGAOS, conf.signal_aos,
                            RIG_LIST_COL_SIGLOS, conf.signal_los, -1);
     }
@@ -587,6 +619,16 @@ static void create_rig_list()
                                             (RIG_LIST_COL_LOUP), NULL);
     gtk_tree_view_insert_column(GTK_TREE_VIEW(riglist), column, -1);
 
+    /* tuning step */
+    renderer = gtk_cell_renderer_text_new();
+    column = gtk_tree_view_column_new_with_attributes(_("Step"), renderer,
+                                                      "text",
+                                                      RIG_LIST_COL_STEP, NULL);
+    gtk_tree_view_column_set_cell_data_func(column, renderer, render_step,
+                                            GUINT_TO_POINTER
+                                            (RIG_LIST_COL_STEP), NULL);
+    gtk_tree_view_insert_column(GTK_TREE_VIEW(riglist), column, -1);
+
     /* AOS signalling */
     renderer = gtk_cell_renderer_text_new();
     column =
@@ -688,6 +730,7 @@ static void add_cb(GtkWidget * button, gpointer data)
         .vfoDown = 0,
         .lo = 0.0,
         .loup = 0.0,
+        .step = 1.0,
         .signal_aos = FALSE,
         .signal_los = FALSE,
     };
@@ -711,6 +754,7 @@ static void add_cb(GtkWidget * button, gpointer data)
                            RIG_LIST_COL_VFODOWN, conf.vfoDown,
                            RIG_LIST_COL_LO, conf.lo,
                            RIG_LIST_COL_LOUP, conf.loup,
+                           RIG_LIST_COL_STEP, conf.step,
                            RIG_LIST_COL_SIGAOS, conf.signal_aos,
                            RIG_LIST_COL_SIGLOS, conf.signal_los, -1);
 
@@ -812,6 +856,7 @@ void sat_pref_rig_ok()
         .vfoDown = 0,
         .lo = 0.0,
         .loup = 0.0,
+        .step = 1.0,
         .signal_aos = FALSE,
         .signal_los = FALSE
     };
@@ -858,6 +903,7 @@ void sat_pref_rig_ok()
                                RIG_LIST_COL_VFODOWN, &conf.vfoDown,
                                RIG_LIST_COL_LO, &conf.lo,
                                RIG_LIST_COL_LOUP, &conf.loup,
+                               RIG_LIST_COL_STEP, &conf.step,
                                RIG_LIST_COL_SIGAOS, &conf.signal_aos,
                                RIG_LIST_COL_SIGLOS, &conf.signal_los, -1);
             radio_conf_save(&conf);
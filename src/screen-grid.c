@@ -0,0 +1,272 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/**
+ * Spatial index for hit-testing and label placement in the map and polar
+ * views.
+ *
+ * The views add the boxes of their markers or labels once per update cycle,
+ * after the satellites have moved. The screen is divided into square cells
+ * and each cell lists the boxes that touch it, so that a query only looks
+ * at the boxes near the query point instead of at every satellite.
+ *
+ * The memory of the grid is kept between cycles; screen_grid_reset() only
+ * empties it.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <math.h>
+
+#include "screen-grid.h"
+
+
+typedef struct {
+    gdouble         x;          /*!< Left edge */
+    gdouble         y;          /*!< Top edge */
+    gdouble         w;          /*!< Width */
+    gdouble         h;          /*!< Height */
+    gpointer        data;       /*!< User data */
+} grid_box_t;
+
+struct _screen_grid {
+    gdouble         cell;       /*!< Width and height of a cell */
+    gint            cols;       /*!< Number of columns */
+    gint            rows;       /*!< Number of rows */
+    GArray         *boxes;      /*!< grid_box_t in the order they were added */
+    GArray        **cells;      /*!< Indices into boxes for each cell */
+    guint           ncells;     /*!< Number of allocated cells */
+};
+
+
+/**
+ * Create a new grid.
+ *
+ * @param cell The size of a cell in pixels. A few times the size of a
+ *             label works well.
+ * @return A new empty grid; call screen_grid_reset() before adding boxes.
+ */
+screen_grid_t  *screen_grid_new(gdouble cell)
+{
+    screen_grid_t  *grid = g_new0(screen_grid_t, 1);
+
+    grid->cell = MAX(cell, 1.0);
+    grid->boxes = g_array_new(FALSE, FALSE, sizeof(grid_box_t));
+
+    return grid;
+}
+
+void screen_grid_free(screen_grid_t * grid)
+{
+    guint           i;
+
+    if (grid == NULL)
+        return;
+
+    for (i = 0; i < grid->ncells; i++)
+        g_array_free(grid->cells[i], TRUE);
+    g_free(grid->cells);
+    g_array_free(grid->boxes, TRUE);
+    g_free(grid);
+}
+
+/**
+ * Remove all boxes and resize the grid.
+ *
+ * @param grid The grid.
+ * @param width The width of the screen area.
+ * @param height The height of the screen area.
+ *
+ * Boxes outside the screen area are put in the cells at its edge.
+ */
+void screen_grid_reset(screen_grid_t * grid, gdouble width, gdouble height)
+{
+    guint           i, n;
+
+    grid->cols = MAX((gint) ceil(width / grid->cell), 1);
+    grid->rows = MAX((gint) ceil(height / grid->cell), 1);
+    n = grid->cols * grid->rows;
+
+    if (n > grid->ncells)
+    {
+        grid->cells = g_renew(GArray *, grid->cells, n);
+        for (i = grid->ncells; i < n; i++)
+            grid->cells[i] = g_array_new(FALSE, FALSE, sizeof(guint));
+        grid->ncells = n;
+    }
+
+    for (i = 0; i < n; i++)
+        g_array_set_size(grid->cells[i], 0);
+    g_array_set_size(grid->boxes, 0);
+}
+
+/* Get the range of cells covered by a box */
+static void cell_range(screen_grid_t * grid, gdouble x, gdouble y,
+                       gdouble w, gdouble h,
+                       gint * c0, gint * r0, gint * c1, gint * r1)
+{
+    *c0 = CLAMP((gint) floor(x / grid->cell), 0, grid->cols - 1);
+    *r0 = CLAMP((gint) floor(y / grid->cell), 0, grid->rows - 1);
+    *c1 = CLAMP((gint) floor((x + w) / grid->cell), 0, grid->cols - 1);
+    *r1 = CLAMP((gint) floor((y + h) / grid->cell), 0, grid->rows - 1);
+}
+
+/**
+ * Add a box to the grid.
+ *
+ * @param grid The grid.
+ * @param x The left edge of the box.
+ * @param y The top edge of the box.
+ * @param w The width of the box; 0 for a point.
+ * @param h The height of the box; 0 for a point.
+ * @param data Returned by screen_grid_find() for this box.
+ *
+ * Boxes added first win ties in screen_grid_find().
+ */
+void screen_grid_add(screen_grid_t * grid, gdouble x, gdouble y,
+                     gdouble w, gdouble h, gpointer data)
+{
+    grid_box_t      box;
+    guint           idx = grid->boxes->len;
+    gint            c0, r0, c1, r1, c, r;
+
+    box.x = x;
+    box.y = y;
+    box.w = w;
+    box.h = h;
+    box.data = data;
+    g_array_append_val(grid->boxes, box);
+
+    cell_range(grid, x, y, w, h, &c0, &r0, &c1, &r1);
+    for (r = r0; r <= r1; r++)
+        for (c = c0; c <= c1; c++)
+            g_array_append_val(grid->cells[r * grid->cols + c], idx);
+}
+
+/* Distance from a point to a box along the axis where it is largest */
+static gdouble box_distance(const grid_box_t * box, gdouble x, gdouble y)
+{
+    gdouble         dx = 0.0, dy = 0.0;
+
+    if (x < box->x)
+        dx = box->x - x;
+    else if (x > box->x + box->w)
+        dx = x - box->x - box->w;
+
+    if (y < box->y)
+        dy = box->y - y;
+    else if (y > box->y + box->h)
+        dy = y - box->y - box->h;
+
+    return MAX(dx, dy);
+}
+
+/**
+ * Find the box closest to a point.
+ *
+ * @param grid The grid.
+ * @param x The x coordinate of the point.
+ * @param y The y coordinate of the point.
+ * @param radius The largest distance between the point and the box; 0 to
+ *               only find boxes that contain the point.
+ * @return The data of the closest box, or NULL if no box is close enough.
+ */
+gpointer screen_grid_find(screen_grid_t * grid, gdouble x, gdouble y,
+                          gdouble radius)
+{
+    grid_box_t     *box;
+    GArray         *cell;
+    guint           i, idx, best = G_MAXUINT;
+    gdouble         d, dmin = radius;
+    gint            c0, r0, c1, r1, c, r;
+
+    if (grid->boxes->len == 0)
+        return NULL;
+
+    cell_range(grid, x - radius, y - radius, 2 * radius, 2 * radius,
+               &c0, &r0, &c1, &r1);
+    for (r = r0; r <= r1; r++)
+    {
+        for (c = c0; c <= c1; c++)
+        {
+            cell = grid->cells[r * grid->cols + c];
+            for (i = 0; i < cell->len; i++)
+            {
+                idx = g_array_index(cell, guint, i);
+                box = &g_array_index(grid->boxes, grid_box_t, idx);
+                d = box_distance(box, x, y);
+                if (d < dmin || (d == dmin && idx < best))
+                {
+                    dmin = d;
+                    best = idx;
+                }
+            }
+        }
+    }
+
+    if (best == G_MAXUINT)
+        return NULL;
+
+    return g_array_index(grid->boxes, grid_box_t, best).data;
+}
+
+/**
+ * Check whether a box overlaps any box in the grid.
+ *
+ * @param grid The grid.
+ * @param x The left edge of the box.
+ * @param y The top edge of the box.
+ * @param w The width of the box.
+ * @param h The height of the box.
+ * @return TRUE if the box overlaps a box in the grid; touching edges do not
+ *         count.
+ */
+gboolean screen_grid_overlaps(screen_grid_t * grid, gdouble x, gdouble y,
+                              gdouble w, gdouble h)
+{
+    grid_box_t     *box;
+    GArray         *cell;
+    guint           i;
+    gint            c0, r0, c1, r1, c, r;
+
+    cell_range(grid, x, y, w, h, &c0, &r0, &c1, &r1);
+    for (r = r0; r <= r1; r++)
+    {
+        for (c = c0; c <= c1; c++)
+        {
+            cell = grid->cells[r * grid->cols + c];
+            for (i = 0; i < cell->len; i++)
+            {
+                box = &g_array_index(grid->boxes, grid_box_t,
+                                     g_array_index(cell, guint, i));
+                if (x < box->x + box->w && box->x < x + w &&
+                    y < box->y + box->h && box->y < y + h)
+                    return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
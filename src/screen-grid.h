@@ -0,0 +1,44 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef SCREEN_GRID_H
+#define SCREEN_GRID_H 1
+
+#include <glib.h>
+
+/** Uniform grid of boxes in screen coordinates. */
+typedef struct _screen_grid screen_grid_t;
+
+screen_grid_t  *screen_grid_new(gdouble cell);
+void            screen_grid_free(screen_grid_t * grid);
+void            screen_grid_reset(screen_grid_t * grid,
+                                  gdouble width, gdouble height);
+void            screen_grid_add(screen_grid_t * grid, gdouble x, gdouble y,
+                                gdouble w, gdouble h, gpointer data);
+gpointer        screen_grid_find(screen_grid_t * grid, gdouble x, gdouble y,
+                                 gdouble radius);
+gboolean        screen_grid_overlaps(screen_grid_t * grid, gdouble x,
+                                     gdouble y, gdouble w, gdouble h);
+
+#endif
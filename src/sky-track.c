@@ -0,0 +1,187 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/**
+ * Sky tracks in a form that is independent of the size and orientation of
+ * the polar plot.
+ *
+ * A point at azimuth az and elevation el is stored at distance
+ * 1 - el / 90 deg from the centre of the unit disc, in the direction of az.
+ * A view with radius r maps it to the canvas with a scale of +r or -r per
+ * axis, depending on its orientation.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <math.h>
+
+#include "sky-track.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/* Store a point on the unit disc */
+static void set_point(sky_track_t * track, guint i, gdouble az, gdouble el)
+{
+    gdouble         rel = 1.0 - (2.0 * el * de2ra) / M_PI;
+
+    track->xy[2 * i] = rel * sin(az * de2ra);
+    track->xy[2 * i + 1] = rel * cos(az * de2ra);
+}
+
+/**
+ * Create the sky track of a pass.
+ *
+ * @param pass The pass. It is not referenced by the track.
+ * @return A new sky track with one reference, or NULL if the pass has no
+ *         details.
+ *
+ * The track starts at the AOS azimuth and ends at the LOS azimuth on the
+ * horizon. Details below the horizon are drawn at the previous point.
+ */
+sky_track_t    *sky_track_new(pass_t * pass)
+{
+    sky_track_t    *track;
+    pass_detail_t  *detail;
+    GSList         *node;
+    guint           num, i;
+
+    num = g_slist_length(pass->details);
+    if (num == 0)
+        return NULL;
+
+    track = g_new0(sky_track_t, 1);
+    track->ref = 1;
+    track->aos = pass->aos;
+    track->los = pass->los;
+    track->qth_comp = pass->qth_comp;
+    track->num = num;
+    track->xy = g_new(gdouble, 2 * num);
+    track->time = g_new(gdouble, num);
+
+    for (node = pass->details, i = 0; node != NULL; node = node->next, i++)
+    {
+        detail = PASS_DETAIL(node->data);
+        track->time[i] = detail->time;
+
+        if (i == 0)
+        {
+            set_point(track, i, pass->aos_az, 0.0);
+            track->time[i] = pass->aos;
+        }
+        else if (i == num - 1)
+        {
+            set_point(track, i, pass->los_az, 0.0);
+        }
+        else if (detail->el >= 0.0)
+        {
+            set_point(track, i, detail->az, detail->el);
+        }
+        else
+        {
+            track->xy[2 * i] = track->xy[2 * i - 2];
+            track->xy[2 * i + 1] = track->xy[2 * i - 1];
+        }
+    }
+
+    return track;
+}
+
+/** Take a reference to a sky track. */
+sky_track_t    *sky_track_ref(sky_track_t * track)
+{
+    g_atomic_int_inc(&track->ref);
+
+    return track;
+}
+
+/** Drop a reference to a sky track; NULL is ignored. */
+void sky_track_unref(sky_track_t * track)
+{
+    if (track == NULL || !g_atomic_int_dec_and_test(&track->ref))
+        return;
+
+    g_free(track->xy);
+    g_free(track->time);
+    g_free(track);
+}
+
+/**
+ * Map a sky track to canvas coordinates.
+ *
+ * @param track The sky track.
+ * @param cx The x coordinate of the zenith.
+ * @param cy The y coordinate of the zenith.
+ * @param rx The radius of the horizon towards east; negative if east is
+ *           on the left.
+ * @param ry The radius of the horizon towards north; negative if north is
+ *           at the bottom.
+ * @param coords Array of 2 * track->num coordinates, e.g. the coords of a
+ *               GooCanvasPoints.
+ */
+void sky_track_project(const sky_track_t * track, gdouble cx, gdouble cy,
+                       gdouble rx, gdouble ry, gdouble * coords)
+{
+    guint           i;
+
+    for (i = 0; i < track->num; i++)
+    {
+        coords[2 * i] = cx + rx * track->xy[2 * i];
+        coords[2 * i + 1] = cy - ry * track->xy[2 * i + 1];
+    }
+}
+
+/**
+ * Choose the points of the time ticks along a sky track.
+ *
+ * @param track The sky track.
+ * @param num The largest number of ticks.
+ * @param index Array of num elements receiving the point of each tick.
+ * @return The number of ticks.
+ *
+ * The first tick is at AOS and the others are evenly spaced along the
+ * track, leaving out the LOS point.
+ */
+guint sky_track_ticks(const sky_track_t * track, guint num, guint * index)
+{
+    guint           step, n = 0;
+    guint           i;
+
+    if (num == 0)
+        return 0;
+
+    index[n++] = 0;
+
+    if (track->num < 3 || num < 2)
+        return n;
+
+    step = (track->num - 2) / (num - 1);
+    if (step == 0)
+        return n;
+
+    for (i = step; i < track->num - 1 && n < num; i += step)
+        index[n++] = i;
+
+    return n;
+}
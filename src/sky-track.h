@@ -0,0 +1,60 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+ 
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+  
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+  
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef SKY_TRACK_H
+#define SKY_TRACK_H 1
+
+#include <glib.h>
+
+#include "predict-tools.h"
+
+/**
+ * Sky track of a pass.
+ *
+ * The points are stored on the unit disc of the polar plot, with the
+ * zenith in the centre, x towards east and y towards north, so that a
+ * view can draw the track at any size and orientation without any
+ * trigonometry. A sky track does not change once created and is shared by
+ * reference counting, which is thread safe.
+ */
+typedef struct {
+    gint            ref;        /*!< Reference count */
+    gdouble         aos;        /*!< AOS time in "jul_utc" */
+    gdouble         los;        /*!< LOS time in "jul_utc" */
+    qth_small_t     qth_comp;   /*!< Location the pass was predicted for */
+    guint           num;        /*!< Number of points */
+    gdouble        *xy;         /*!< Points on the unit disc, x and y interleaved */
+    gdouble        *time;       /*!< Time of each point */
+} sky_track_t;
+
+sky_track_t    *sky_track_new(pass_t * pass);
+sky_track_t    *sky_track_ref(sky_track_t * track);
+void            sky_track_unref(sky_track_t * track);
+void            sky_track_project(const sky_track_t * track,
+                                  gdouble cx, gdouble cy,
+                                  gdouble rx, gdouble ry, gdouble * coords);
+guint           sky_track_ticks(const sky_track_t * track, guint num,
+                                guint * index);
+
+#endif
@@ -0,0 +1,400 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Station controller shared by all radio and rotator controllers.
+ *
+ * Every engaged controller registers a chain with a cycle function. One
+ * scheduler thread keeps track of when each chain is due and hands due
+ * chains to a shared worker pool, so a station with several radios and
+ * rotators runs on a fixed number of threads regardless of how many
+ * controllers are open. A chain never runs concurrently with itself and
+ * sets its own cadence through the delay returned by each cycle.
+ *
+ * The time between a chain becoming due and its cycle starting is the
+ * scheduling overhead of the chain. It is logged periodically and when
+ * the chain stops, together with the time spent in the cycles.
+ *
+ * Controllers tracking the same satellite from the same location also
+ * share the predicted passes through a small cache, which is keyed by
+ * satellite, TLE epoch, location and prediction settings and dropped once
+ * the pass is over.
+ * The polar view takes the sky tracks of the current passes from the same
+ * cache.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "sat-cfg.h"
+#include "sat-log.h"
+#include "station-ctrl.h"
+#include "time-tools.h"
+
+
+#define STATION_MAX_THREADS        8    /*!< Size of the worker pool */
+#define STATION_REPORT_INTERVAL  600    /*!< Overhead report interval in sec */
+
+struct _station_chain {
+    gchar          *name;
+    station_cycle_fn cycle;
+    gpointer        data;
+
+    /* the fields below are protected by lock */
+    gint64          due;        /*!< Monotonic time of the next cycle */
+    gboolean        running;    /*!< Cycle queued or executing */
+    gboolean        wake;       /*!< Woken up while running */
+    gboolean        stopped;    /*!< Cycle returned a negative delay */
+
+    guint64         cycles;     /*!< Number of cycles executed */
+    gint64          lat_sum;    /*!< Total scheduling latency in usec */
+    gint64          lat_max;    /*!< Worst scheduling latency in usec */
+    gint64          exec_sum;   /*!< Total cycle time in usec */
+    gint64          exec_max;   /*!< Longest cycle in usec */
+    gint64          report;     /*!< Time of the next periodic report */
+};
+
+/* A pass shared by the controllers */
+typedef struct {
+    pass_t         *pass;
+    gdouble         start;      /*!< Start time of the prediction */
+    sky_track_t    *track;      /*!< Sky track of the pass; NULL until asked for */
+} station_pass_t;
+
+static GMutex   lock;
+static GCond    cond;
+static GList   *chains = NULL;
+static GThreadPool *pool = NULL;
+
+static GMutex   pass_lock;
+static GHashTable *passes = NULL;
+
+
+static void chain_report(station_chain_t * chain, gint level)
+{
+    guint64         n = MAX(chain->cycles, 1);
+
+    sat_log_log(level,
+                _("%s: %s: %" G_GUINT64_FORMAT " cycles, scheduling latency "
+                  "%.2f/%.2f ms (avg/max), cycle time %.2f/%.2f ms (avg/max)"),
+                __func__, chain->name, chain->cycles,
+                chain->lat_sum / (n * 1000.0), chain->lat_max / 1000.0,
+                chain->exec_sum / (n * 1000.0), chain->exec_max / 1000.0);
+}
+
+/* Execute one cycle of a chain; runs in the worker pool */
+static void chain_run(gpointer data, gpointer user_data)
+{
+    station_chain_t *chain = data;
+    gint64          start, end, delay;
+
+    (void)user_data;
+
+    start = g_get_monotonic_time();
+    delay = chain->cycle(chain->data);
+    end = g_get_monotonic_time();
+
+    g_mutex_lock(&lock);
+
+    chain->cycles++;
+    chain->lat_sum += start - chain->due;
+    chain->lat_max = MAX(chain->lat_max, start - chain->due);
+    chain->exec_sum += end - start;
+    chain->exec_max = MAX(chain->exec_max, end - start);
+
+    if (delay < 0)
+    {
+        chain_report(chain, SAT_LOG_LEVEL_INFO);
+        chains = g_list_remove(chains, chain);
+        chain->stopped = TRUE;
+    }
+    else
+    {
+        chain->due = chain->wake ? end : end + delay;
+        if (end >= chain->report)
+        {
+            chain_report(chain, SAT_LOG_LEVEL_DEBUG);
+            chain->report = end + STATION_REPORT_INTERVAL * G_USEC_PER_SEC;
+        }
+    }
+    chain->wake = FALSE;
+    chain->running = FALSE;
+
+    g_cond_broadcast(&cond);
+    g_mutex_unlock(&lock);
+}
+
+/* Hand the chains to the worker pool as they become due */
+static gpointer scheduler_run(gpointer data)
+{
+    station_chain_t *chain, *next;
+    GList          *node;
+
+    (void)data;
+
+    g_mutex_lock(&lock);
+    while (TRUE)
+    {
+        next = NULL;
+        for (node = chains; node != NULL; node = node->next)
+        {
+            chain = node->data;
+            if (!chain->running && (next == NULL || chain->due < next->due))
+                next = chain;
+        }
+
+        if (next == NULL)
+            g_cond_wait(&cond, &lock);
+        else if (next->due > g_get_monotonic_time())
+            g_cond_wait_until(&cond, &lock, next->due);
+        else
+        {
+            next->running = TRUE;
+            g_thread_pool_push(pool, next, NULL);
+        }
+    }
+    g_mutex_unlock(&lock);
+
+    return NULL;
+}
+
+/**
+ * Start a chain.
+ *
+ * @param name Name of the chain used in the log.
+ * @param cycle The controller cycle.
+ * @param data Data passed to the cycle.
+ * @return The new chain. The first cycle is executed right away.
+ *
+ * Every chain must be stopped by having its cycle return a negative delay
+ * and be released with station_chain_join().
+ */
+station_chain_t *station_chain_start(const gchar * name,
+                                     station_cycle_fn cycle, gpointer data)
+{
+    station_chain_t *chain = g_new0(station_chain_t, 1);
+
+    chain->name = g_strdup(name);
+    chain->cycle = cycle;
+    chain->data = data;
+    chain->due = g_get_monotonic_time();
+    chain->report = chain->due + STATION_REPORT_INTERVAL * G_USEC_PER_SEC;
+
+    g_mutex_lock(&lock);
+    if (pool == NULL)
+    {
+        pool = g_thread_pool_new(chain_run, NULL, STATION_MAX_THREADS, FALSE,
+                                 NULL);
+        g_thread_unref(g_thread_new("station_sched", scheduler_run, NULL));
+    }
+    chains = g_list_append(chains, chain);
+    g_cond_broadcast(&cond);
+    g_mutex_unlock(&lock);
+
+    return chain;
+}
+
+/**
+ * Execute the next cycle of a chain as soon as possible.
+ *
+ * @param chain The chain.
+ *
+ * Used when the controller settings have changed. If the chain is running
+ * a cycle, the next one follows right after it.
+ */
+void station_chain_wake(station_chain_t * chain)
+{
+    g_mutex_lock(&lock);
+    if (chain->running)
+        chain->wake = TRUE;
+    else if (!chain->stopped)
+    {
+        chain->due = g_get_monotonic_time();
+        g_cond_broadcast(&cond);
+    }
+    g_mutex_unlock(&lock);
+}
+
+/**
+ * Wait until a chain has stopped and free it.
+ *
+ * @param chain The chain.
+ *
+ * The caller must make sure that the next cycle returns a negative delay,
+ * usually by clearing a flag and waking the chain.
+ */
+void station_chain_join(station_chain_t * chain)
+{
+    g_mutex_lock(&lock);
+    while (!chain->stopped)
+        g_cond_wait(&cond, &lock);
+    g_mutex_unlock(&lock);
+
+    g_free(chain->name);
+    g_free(chain);
+}
+
+static void pass_free(gpointer data)
+{
+    station_pass_t *entry = data;
+
+    free_pass(entry->pass);
+    sky_track_unref(entry->track);
+    g_free(entry);
+}
+
+/* Drop the passes that are over at time t */
+static gboolean pass_expired(gpointer key, gpointer value, gpointer data)
+{
+    station_pass_t *entry = value;
+
+    (void)key;
+
+    return entry->pass->los < *(gdouble *) data;
+}
+
+/* Copy a cached pass or take a reference to its sky track; pass_lock must
+   be held */
+static gpointer share_pass(station_pass_t * entry, gboolean track)
+{
+    if (!track)
+        return copy_pass(entry->pass);
+
+    if (entry->track == NULL)
+        entry->track = sky_track_new(entry->pass);
+
+    return (entry->track != NULL) ? sky_track_ref(entry->track) : NULL;
+}
+
+/*
+ * Look up a pass in the cache or predict it.
+ *
+ * The cached pass is reused for any start time between the start of its
+ * prediction and its LOS, since no other pass can begin in that interval.
+ * Returns a copy of the pass, or a reference to its sky track if track is
+ * TRUE.
+ */
+static gpointer get_shared_pass(sat_t * sat, qth_t * qth, gdouble start,
+                                gdouble maxdt, gboolean current,
+                                gboolean track)
+{
+    station_pass_t *entry;
+    pass_t         *pass;
+    gpointer        result = NULL;
+    gchar          *key;
+
+    /* the details of a pass depend on the prediction settings too */
+    key = g_strdup_printf("%c:%d:%.8f:%.6f:%.6f:%d:%d:%d:%d",
+                          current ? 'c' : 'p', sat->tle.catnr, sat->tle.epoch,
+                          qth->lat, qth->lon, qth->alt,
+                          sat_cfg_get_int(SAT_CFG_INT_PRED_MIN_EL),
+                          sat_cfg_get_int(SAT_CFG_INT_PRED_RESOLUTION),
+                          sat_cfg_get_int(SAT_CFG_INT_PRED_NUM_ENTRIES));
+
+    g_mutex_lock(&pass_lock);
+    if (passes == NULL)
+        passes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                       pass_free);
+
+    entry = g_hash_table_lookup(passes, key);
+    if (entry != NULL && entry->start <= start && start < entry->pass->los &&
+        (!current || entry->pass->aos <= start))
+    {
+        if (current || maxdt <= 0.0 || entry->pass->aos <= start + maxdt)
+            result = share_pass(entry, track);
+        g_mutex_unlock(&pass_lock);
+        g_free(key);
+
+        return result;
+    }
+    g_mutex_unlock(&pass_lock);
+
+    /* predict without holding the lock */
+    if (current)
+        pass = get_current_pass(sat, qth, start);
+    else
+        pass = get_pass(sat, qth, start, maxdt);
+
+    if (pass == NULL)
+    {
+        g_free(key);
+        return NULL;
+    }
+
+    entry = g_new0(station_pass_t, 1);
+    entry->pass = pass;
+    entry->start = current ? pass->aos : start;
+
+    g_mutex_lock(&pass_lock);
+    g_hash_table_foreach_remove(passes, pass_expired, &start);
+    g_hash_table_replace(passes, key, entry);
+    result = share_pass(entry, track);
+    g_mutex_unlock(&pass_lock);
+
+    return result;
+}
+
+/**
+ * Get the first pass after a certain time from the shared cache.
+ *
+ * Same as get_pass(); the returned pass must be freed with free_pass().
+ */
+pass_t         *station_get_pass(sat_t * sat, qth_t * qth, gdouble start,
+                                 gdouble maxdt)
+{
+    return get_shared_pass(sat, qth, start, maxdt, FALSE, FALSE);
+}
+
+/**
+ * Get the current pass from the shared cache.
+ *
+ * Same as get_current_pass(); the returned pass must be freed with
+ * free_pass().
+ */
+pass_t         *station_get_current_pass(sat_t * sat, qth_t * qth,
+                                         gdouble start)
+{
+    if (start <= 0.0)
+        start = get_current_daynum();
+
+    return get_shared_pass(sat, qth, start, 0.0, TRUE, FALSE);
+}
+
+/**
+ * Get the sky track of the current pass from the shared cache.
+ *
+ * Same as station_get_current_pass() but returns the sky track of the
+ * pass; it must be released with sky_track_unref().
+ */
+sky_track_t    *station_get_current_track(sat_t * sat, qth_t * qth,
+                                          gdouble start)
+{
+    if (start <= 0.0)
+        start = get_current_daynum();
+
+    return get_shared_pass(sat, qth, start, 0.0, TRUE, TRUE);
+}
@@ -0,0 +1,58 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef STATION_CTRL_H
+#define STATION_CTRL_H 1
+
+#include <glib.h>
+
+#include "gtk-sat-data.h"
+#include "predict-tools.h"
+#include "sky-track.h"
+
+/** A radio or rotator chain driven by the station controller. */
+typedef struct _station_chain station_chain_t;
+
+/**
+ * Controller cycle of a chain.
+ *
+ * @param data The data given to station_chain_start().
+ * @return The delay in usec until the next cycle, or a negative value to
+ *         stop the chain.
+ */
+typedef gint64  (*station_cycle_fn) (gpointer data);
+
+station_chain_t *station_chain_start(const gchar * name,
+                                     station_cycle_fn cycle, gpointer data);
+void            station_chain_wake(station_chain_t * chain);
+void            station_chain_join(station_chain_t * chain);
+
+pass_t         *station_get_pass(sat_t * sat, qth_t * qth, gdouble start,
+                                 gdouble maxdt);
+pass_t         *station_get_current_pass(sat_t * sat, qth_t * qth,
+                                         gdouble start);
+sky_track_t    *station_get_current_track(sat_t * sat, qth_t * qth,
+                                          gdouble start);
+
+#endif
@@ -0,0 +1,518 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Test of the conditional TLE download against a local HTTP server.
+ *
+ * A small HTTP/1.1 server on the loopback interface stands in for the TLE
+ * sources:
+ *
+ *   /etag.txt      200 with a fixed ETag, 304 when it is sent back
+ *   /lastmod.txt   200 with a fixed Last-Modified, 304 when the request is
+ *                  conditional on a time not before it
+ *   /changing.txt  200 with a new ETag and body on every request
+ *   anything else  404
+ *
+ * tle_fetch_files() is run three times with the same download history:
+ * the first run must fetch everything but the missing source and record
+ * the validators, the second must send them back, leave no files for the
+ * unchanged sources and keep their validators, and the third, after the
+ * history has been saved and loaded, must behave like the second.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <curl/curl.h>
+#include <gio/gio.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-stubs.h"
+#include "tle-fetch.h"
+
+
+#define LASTMOD "Wed, 14 Oct 2026 12:00:00 GMT"
+#define NUMSRC  4
+
+static const gchar *tle_body =
+    "ISS (ZARYA)\n"
+    "1 25544U 98067A   26287.50000000  .00016717  00000-0  10270-3 0  9005\n"
+    "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.49815304 12345\n";
+
+static const gchar *paths[NUMSRC] = {
+    "/etag.txt", "/lastmod.txt", "/changing.txt", "/missing.txt"
+};
+
+/** A request seen by the server. */
+typedef struct {
+    gchar          *path;
+    gchar          *if_none_match;      /*!< NULL if not sent */
+    gchar          *if_modified_since;  /*!< NULL if not sent */
+    guint           code;       /*!< Response code */
+} request_t;
+
+/** The stand-in server. */
+typedef struct {
+    GSocketListener *listener;
+    GCancellable   *cancel;
+    GThread        *thread;
+    GMutex          lock;
+    GPtrArray      *requests;   /*!< request_t of the current run */
+    guint           version;    /*!< Version of /changing.txt */
+} server_t;
+
+static guint    failed = 0;
+
+
+static void check(gboolean ok, const gchar * fmt, ...)
+{
+    va_list         args;
+    gchar          *text;
+
+    va_start(args, fmt);
+    text = g_strdup_vprintf(fmt, args);
+    va_end(args);
+
+    g_print("%s %s\n", ok ? "ok  " : "FAIL", text);
+    g_free(text);
+
+    if (!ok)
+        failed++;
+}
+
+static void free_request(gpointer data)
+{
+    request_t      *req = (request_t *) data;
+
+    g_free(req->path);
+    g_free(req->if_none_match);
+    g_free(req->if_modified_since);
+    g_free(req);
+}
+
+static void respond(GOutputStream * out, guint code, const gchar * headers,
+                    const gchar * body)
+{
+    gchar          *text;
+    const gchar    *reason;
+
+    switch (code)
+    {
+    case 200:
+        reason = "OK";
+        break;
+    case 304:
+        reason = "Not Modified";
+        body = "";
+        break;
+    default:
+        reason = "Not Found";
+        break;
+    }
+
+    text = g_strdup_printf("HTTP/1.1 %u %s\r\n"
+                           "Content-Length: %u\r\n"
+                           "Connection: close\r\n"
+                           "%s\r\n%s", code, reason, (guint) strlen(body),
+                           headers, body);
+    g_output_stream_write_all(out, text, strlen(text), NULL, NULL, NULL);
+    g_free(text);
+}
+
+/** Read one request from conn and answer it. */
+static void serve_request(server_t * srv, GSocketConnection * conn)
+{
+    GDataInputStream *in;
+    GOutputStream  *out;
+    request_t      *req;
+    gchar          *line;
+    gchar         **parts;
+    gchar          *headers = NULL;
+    gchar          *body = NULL;
+
+    in = g_data_input_stream_new(g_io_stream_get_input_stream
+                                 (G_IO_STREAM(conn)));
+    g_data_input_stream_set_newline_type(in,
+                                         G_DATA_STREAM_NEWLINE_TYPE_CR_LF);
+    out = g_io_stream_get_output_stream(G_IO_STREAM(conn));
+
+    line = g_data_input_stream_read_line(in, NULL, NULL, NULL);
+    if (line == NULL)
+    {
+        g_object_unref(in);
+        return;
+    }
+
+    req = g_new0(request_t, 1);
+    parts = g_strsplit(line, " ", 3);
+    req->path = g_strdup(parts[0] && parts[1] ? parts[1] : "");
+    g_strfreev(parts);
+    g_free(line);
+
+    while ((line = g_data_input_stream_read_line(in, NULL, NULL, NULL))
+           != NULL && *line != '\0')
+    {
+        if (g_ascii_strncasecmp(line, "If-None-Match:", 14) == 0)
+            req->if_none_match = g_strstrip(g_strdup(line + 14));
+        else if (g_ascii_strncasecmp(line, "If-Modified-Since:", 18) == 0)
+            req->if_modified_since = g_strstrip(g_strdup(line + 18));
+        g_free(line);
+    }
+    g_free(line);
+
+    /* the request is recorded before it is answered, so that it is seen
+       when the transfer has finished */
+    g_mutex_lock(&srv->lock);
+
+    if (!g_strcmp0(req->path, "/etag.txt"))
+    {
+        req->code = g_strcmp0(req->if_none_match, "\"v1\"") ? 200 : 304;
+        headers = g_strdup("ETag: \"v1\"\r\n");
+        body = g_strdup(tle_body);
+    }
+    else if (!g_strcmp0(req->path, "/lastmod.txt"))
+    {
+        req->code = 200;
+        if (req->if_modified_since != NULL &&
+            curl_getdate(req->if_modified_since, NULL) >=
+            curl_getdate(LASTMOD, NULL))
+            req->code = 304;
+        headers = g_strdup("Last-Modified: " LASTMOD "\r\n");
+        body = g_strdup(tle_body);
+    }
+    else if (!g_strcmp0(req->path, "/changing.txt"))
+    {
+        srv->version++;
+        req->code = 200;
+        headers = g_strdup_printf("ETag: \"v%u\"\r\n", srv->version);
+        body = g_strdup_printf("%sversion %u\n", tle_body, srv->version);
+    }
+    else
+    {
+        req->code = 404;
+        headers = g_strdup("");
+        body = g_strdup("not found\n");
+    }
+
+    g_ptr_array_add(srv->requests, req);
+    g_mutex_unlock(&srv->lock);
+
+    respond(out, req->code, headers, body);
+    g_free(headers);
+    g_free(body);
+
+    g_io_stream_close(G_IO_STREAM(conn), NULL, NULL);
+    g_object_unref(in);
+}
+
+static gpointer server_thread(gpointer data)
+{
+    server_t       *srv = (server_t *) data;
+    GSocketConnection *conn;
+
+    while ((conn = g_socket_listener_accept(srv->listener, NULL,
+                                            srv->cancel, NULL)) != NULL)
+    {
+        serve_request(srv, conn);
+        g_object_unref(conn);
+    }
+
+    return NULL;
+}
+
+/** Start the server on a free loopback port; returns the port or 0. */
+static guint16 server_start(server_t * srv)
+{
+    GInetAddress   *addr;
+    GSocketAddress *saddr;
+    GSocketAddress *bound = NULL;
+    guint16         port = 0;
+
+    srv->listener = g_socket_listener_new();
+    srv->cancel = g_cancellable_new();
+    srv->requests = g_ptr_array_new_with_free_func(free_request);
+    srv->version = 0;
+    g_mutex_init(&srv->lock);
+
+    addr = g_inet_address_new_loopback(G_SOCKET_FAMILY_IPV4);
+    saddr = g_inet_socket_address_new(addr, 0);
+    if (g_socket_listener_add_address(srv->listener, saddr,
+                                      G_SOCKET_TYPE_STREAM,
+                                      G_SOCKET_PROTOCOL_TCP, NULL,
+                                      &bound, NULL))
+    {
+        port = g_inet_socket_address_get_port(G_INET_SOCKET_ADDRESS(bound));
+        g_object_unref(bound);
+        srv->thread = g_thread_new("http", server_thread, srv);
+    }
+    g_object_unref(saddr);
+    g_object_unref(addr);
+
+    return port;
+}
+
+static void server_stop(server_t * srv)
+{
+    g_cancellable_cancel(srv->cancel);
+    if (srv->thread != NULL)
+        g_thread_join(srv->thread);
+    g_socket_listener_close(srv->listener);
+    g_object_unref(srv->listener);
+    g_object_unref(srv->cancel);
+    g_ptr_array_free(srv->requests, TRUE);
+    g_mutex_clear(&srv->lock);
+}
+
+/** Find the request of the current run for source idx. */
+static request_t *find_request(server_t * srv, guint idx)
+{
+    request_t      *req;
+    guint           i;
+
+    for (i = 0; i < srv->requests->len; i++)
+    {
+        req = g_ptr_array_index(srv->requests, i);
+        if (!g_strcmp0(req->path, paths[idx]))
+            return req;
+    }
+
+    return NULL;
+}
+
+static void progress_cb(guint done, guint numfiles, gpointer data)
+{
+    (void)numfiles;
+
+    *(guint *) data = done;
+}
+
+/** Check whether the local file of a source holds the expected body. */
+static void check_file(const gchar * locfile, const gchar * expected,
+                       const gchar * what)
+{
+    gchar          *contents = NULL;
+    gboolean        exists;
+
+    exists = g_file_get_contents(locfile, &contents, NULL, NULL);
+    if (expected == NULL)
+        check(!exists, "%s: no local file", what);
+    else
+        check(exists && !g_strcmp0(contents, expected),
+              "%s: local file holds the response", what);
+    g_free(contents);
+}
+
+static void remove_files(gchar ** locfiles)
+{
+    guint           i;
+
+    for (i = 0; i < NUMSRC; i++)
+        g_remove(locfiles[i]);
+}
+
+/** Run tle_fetch_files and check the counts it returns. */
+static void run_fetch(server_t * srv, gchar ** files, gchar ** locfiles,
+                      GKeyFile * srcdata, guint expect_success,
+                      guint expect_unchanged, const gchar * what)
+{
+    guint           success;
+    guint           unchanged = 99;
+    guint           done = 0;
+    guint           nreq;
+
+    g_mutex_lock(&srv->lock);
+    g_ptr_array_set_size(srv->requests, 0);
+    g_mutex_unlock(&srv->lock);
+
+    success = tle_fetch_files(files, locfiles, NUMSRC, NULL, srcdata,
+                              progress_cb, &done, &unchanged);
+
+    /* the server is idle now; later checks read the requests without lock */
+    g_mutex_lock(&srv->lock);
+    nreq = srv->requests->len;
+    g_mutex_unlock(&srv->lock);
+
+    check(success == expect_success, "%s: %u files fetched (expected %u)",
+          what, success, expect_success);
+    check(unchanged == expect_unchanged,
+          "%s: %u sources unchanged (expected %u)", what, unchanged,
+          expect_unchanged);
+    check(done == NUMSRC, "%s: progress reports %u of %u sources done",
+          what, done, NUMSRC);
+    check(nreq == NUMSRC, "%s: server saw %u requests", what, nreq);
+}
+
+/** Checks common to the second and third run. */
+static void check_conditional_run(server_t * srv, gchar ** files,
+                                  gchar ** locfiles, GKeyFile * srcdata,
+                                  const gchar * what)
+{
+    request_t      *req;
+    gchar          *etag;
+    gchar          *expected;
+
+    req = find_request(srv, 0);
+    check(req && !g_strcmp0(req->if_none_match, "\"v1\"") &&
+          req->code == 304, "%s: ETag sent back and answered with 304",
+          what);
+    req = find_request(srv, 1);
+    check(req && req->if_modified_since != NULL && req->code == 304,
+          "%s: Last-Modified sent back and answered with 304", what);
+    req = find_request(srv, 2);
+    check(req && req->if_none_match != NULL && req->code == 200,
+          "%s: changed source sent its ETag and got new data", what);
+
+    check_file(locfiles[0], NULL, "etag.txt");
+    check_file(locfiles[1], NULL, "lastmod.txt");
+    expected = g_strdup_printf("%sversion %u\n", tle_body, srv->version);
+    check_file(locfiles[2], expected, "changing.txt");
+    g_free(expected);
+    check_file(locfiles[3], NULL, "missing.txt");
+
+    /* validators of unchanged sources are kept, new ones stored */
+    etag = g_key_file_get_string(srcdata, files[0], "ETAG", NULL);
+    check(!g_strcmp0(etag, "\"v1\""), "%s: unchanged ETag kept", what);
+    g_free(etag);
+    check(g_key_file_get_int64(srcdata, files[1], "LAST_MODIFIED", NULL) ==
+          curl_getdate(LASTMOD, NULL), "%s: Last-Modified kept", what);
+    etag = g_key_file_get_string(srcdata, files[2], "ETAG", NULL);
+    expected = g_strdup_printf("\"v%u\"", srv->version);
+    check(!g_strcmp0(etag, expected), "%s: new ETag %s stored", what,
+          expected);
+    g_free(expected);
+    g_free(etag);
+}
+
+int main(int argc, char *argv[])
+{
+    server_t        srv;
+    GKeyFile       *srcdata;
+    GKeyFile       *loaded;
+    request_t      *req;
+    gchar          *files[NUMSRC + 1];
+    gchar          *locfiles[NUMSRC + 1];
+    gchar          *tmpdir;
+    gchar          *data;
+    gchar          *etag;
+    guint16         port;
+    guint           i;
+
+    if (argc > 1 && (!strcmp(argv[1], "-v") || !strcmp(argv[1], "--verbose")))
+        bench_verbose = TRUE;
+
+    /* the requests must go to the loopback server */
+    g_unsetenv("http_proxy");
+    g_unsetenv("all_proxy");
+    g_unsetenv("ALL_PROXY");
+
+    memset(&srv, 0, sizeof(srv));
+    port = server_start(&srv);
+    if (port == 0)
+    {
+        g_printerr("Could not start the HTTP server\n");
+        return EXIT_FAILURE;
+    }
+
+    tmpdir = g_dir_make_tmp("tle-fetch-XXXXXX", NULL);
+    if (tmpdir == NULL)
+    {
+        g_printerr("Could not create a temporary directory\n");
+        server_stop(&srv);
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < NUMSRC; i++)
+    {
+        files[i] = g_strdup_printf("http://127.0.0.1:%u%s", port, paths[i]);
+        locfiles[i] = g_strdup_printf("%s%sfile-%u.tle", tmpdir,
+                                      G_DIR_SEPARATOR_S, i);
+    }
+    files[NUMSRC] = locfiles[NUMSRC] = NULL;
+
+    srcdata = g_key_file_new();
+
+    /* first run: nothing known, everything is downloaded */
+    run_fetch(&srv, files, locfiles, srcdata, 3, 0, "first run");
+    for (i = 0; i < NUMSRC; i++)
+    {
+        req = find_request(&srv, i);
+        check(req && !req->if_none_match && !req->if_modified_since,
+              "first run: %s requested unconditionally", paths[i]);
+    }
+    check_file(locfiles[0], tle_body, "etag.txt");
+    check_file(locfiles[1], tle_body, "lastmod.txt");
+    data = g_strdup_printf("%sversion 1\n", tle_body);
+    check_file(locfiles[2], data, "changing.txt");
+    g_free(data);
+    check_file(locfiles[3], NULL, "missing.txt");
+
+    etag = g_key_file_get_string(srcdata, files[0], "ETAG", NULL);
+    check(!g_strcmp0(etag, "\"v1\""), "first run: ETag stored");
+    g_free(etag);
+    check(g_key_file_get_int64(srcdata, files[1], "LAST_MODIFIED", NULL) ==
+          curl_getdate(LASTMOD, NULL), "first run: Last-Modified stored");
+    check(!g_key_file_has_key(srcdata, files[1], "ETAG", NULL),
+          "first run: no ETag for a source without one");
+    check(!g_key_file_has_group(srcdata, files[3]),
+          "first run: nothing stored for a failed source");
+    remove_files(locfiles);
+
+    /* second run: the validators are sent back */
+    run_fetch(&srv, files, locfiles, srcdata, 1, 2, "second run");
+    check_conditional_run(&srv, files, locfiles, srcdata, "second run");
+    remove_files(locfiles);
+
+    /* third run: the history survives being saved and loaded */
+    data = g_key_file_to_data(srcdata, NULL, NULL);
+    loaded = g_key_file_new();
+    check(g_key_file_load_from_data(loaded, data, strlen(data),
+                                    G_KEY_FILE_NONE, NULL),
+          "saved history can be loaded");
+    g_free(data);
+    run_fetch(&srv, files, locfiles, loaded, 1, 2, "third run");
+    check_conditional_run(&srv, files, locfiles, loaded, "third run");
+    remove_files(locfiles);
+
+    g_key_file_free(loaded);
+    g_key_file_free(srcdata);
+    server_stop(&srv);
+
+    for (i = 0; i < NUMSRC; i++)
+    {
+        g_free(files[i]);
+        g_free(locfiles[i]);
+    }
+    g_rmdir(tmpdir);
+    g_free(tmpdir);
+
+    if (failed > 0)
+        g_print("%u checks failed\n", failed);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,346 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Conditional download of the TLE sources.
+ *
+ * The sources are fetched concurrently with the curl multi interface. The
+ * ETag and Last-Modified validators of each source are kept in a key file
+ * by the caller and sent back on the next request, so that sources which
+ * have not changed are not downloaded again.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <curl/curl.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+
+#include "sat-log.h"
+#include "tle-fetch.h"
+
+
+static size_t   my_write_func(void *ptr, size_t size, size_t nmemb,
+                              FILE * stream);
+static size_t   my_header_func(char *buffer, size_t size, size_t nitems,
+                               void *userdata);
+
+
+/** State of a TLE download; one for each source URL. */
+typedef struct {
+    const gchar    *url;        /*!< Source URL */
+    gchar          *locfile;    /*!< Local cache file */
+    FILE           *outfile;    /*!< Open handle to locfile, NULL when done */
+    CURL           *curl;       /*!< Easy handle performing the transfer */
+    struct curl_slist *headers; /*!< Extra request headers */
+    gchar          *etag;       /*!< ETag received with the response */
+    CURLcode        res;        /*!< Result of the transfer */
+    glong           code;       /*!< HTTP response code */
+    glong           filetime;   /*!< Last-Modified as Unix time, -1 if unknown */
+    gdouble         bytes;      /*!< Number of bytes received */
+    gdouble         time;       /*!< Duration of the transfer in seconds */
+} tle_source_t;
+
+/** Create a transfer for the source url, conditional if it was seen before. */
+static gboolean tle_source_init(tle_source_t * src, const gchar * url,
+                                const gchar * locfile, const gchar * proxy,
+                                GKeyFile * srcdata)
+{
+    gchar          *etag;
+    gchar          *header;
+    gint64          lastmod;
+
+    src->url = url;
+    src->locfile = g_strdup(locfile);
+    src->outfile = g_fopen(src->locfile, "wb");
+    src->res = CURLE_FAILED_INIT;
+    src->filetime = -1;
+
+    if (src->outfile == NULL)
+    {
+        sat_log_log(SAT_LOG_LEVEL_INFO,
+                    _("%s: Failed to open %s preventing update"),
+                    __func__, src->locfile);
+        return FALSE;
+    }
+
+    src->curl = curl_easy_init();
+    if (proxy != NULL)
+        curl_easy_setopt(src->curl, CURLOPT_PROXY, proxy);
+
+    curl_easy_setopt(src->curl, CURLOPT_URL, url);
+    curl_easy_setopt(src->curl, CURLOPT_USERAGENT, "gpredict/curl");
+    curl_easy_setopt(src->curl, CURLOPT_CONNECTTIMEOUT, 10);
+    curl_easy_setopt(src->curl, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(src->curl, CURLOPT_FILETIME, 1L);
+    curl_easy_setopt(src->curl, CURLOPT_PRIVATE, src);
+    curl_easy_setopt(src->curl, CURLOPT_WRITEDATA, src->outfile);
+    curl_easy_setopt(src->curl, CURLOPT_WRITEFUNCTION, my_write_func);
+    curl_easy_setopt(src->curl, CURLOPT_HEADERDATA, src);
+    curl_easy_setopt(src->curl, CURLOPT_HEADERFUNCTION, my_header_func);
+
+    /* conditional request using the validators from the last download */
+    etag = g_key_file_get_string(srcdata, url, "ETAG", NULL);
+    if (etag != NULL)
+    {
+        header = g_strdup_printf("If-None-Match: %s", etag);
+        src->headers = curl_slist_append(NULL, header);
+        curl_easy_setopt(src->curl, CURLOPT_HTTPHEADER, src->headers);
+        g_free(header);
+        g_free(etag);
+    }
+
+    lastmod = g_key_file_get_int64(srcdata, url, "LAST_MODIFIED", NULL);
+    if (lastmod > 0)
+    {
+        curl_easy_setopt(src->curl, CURLOPT_TIMECONDITION,
+                         (long)CURL_TIMECOND_IFMODSINCE);
+        curl_easy_setopt(src->curl, CURLOPT_TIMEVALUE, (long)lastmod);
+    }
+
+    return TRUE;
+}
+
+/** Collect the result of a finished transfer and close the cache file. */
+static void tle_source_done(tle_source_t * src, CURLcode res)
+{
+#if LIBCURL_VERSION_NUM >= 0x073700
+    curl_off_t      bytes, usec;
+#endif
+
+    src->res = res;
+    curl_easy_getinfo(src->curl, CURLINFO_RESPONSE_CODE, &src->code);
+    curl_easy_getinfo(src->curl, CURLINFO_FILETIME, &src->filetime);
+#if LIBCURL_VERSION_NUM >= 0x073700
+    curl_easy_getinfo(src->curl, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+    curl_easy_getinfo(src->curl, CURLINFO_TOTAL_TIME_T, &usec);
+    src->bytes = (gdouble) bytes;
+    src->time = usec / 1.0e6;
+#else
+    curl_easy_getinfo(src->curl, CURLINFO_SIZE_DOWNLOAD, &src->bytes);
+    curl_easy_getinfo(src->curl, CURLINFO_TOTAL_TIME, &src->time);
+#endif
+
+    fclose(src->outfile);
+    src->outfile = NULL;
+}
+
+/** Free the resources of a transfer. */
+static void tle_source_free(tle_source_t * src, CURLM * multi)
+{
+    if (src->curl != NULL)
+    {
+        curl_multi_remove_handle(multi, src->curl);
+        curl_easy_cleanup(src->curl);
+    }
+    if (src->outfile != NULL)
+        fclose(src->outfile);
+
+    curl_slist_free_all(src->headers);
+    g_free(src->locfile);
+    g_free(src->etag);
+}
+
+/**
+ * Download TLE files.
+ *
+ * @param files List of URLs.
+ * @param locfiles The local file for each URL.
+ * @param numfiles The number of URLs in files.
+ * @param proxy Proxy server or NULL.
+ * @param srcdata Download history of the sources, updated with the results.
+ * @param progress Progress callback or NULL.
+ * @param data User data passed to progress.
+ * @param unchanged OUT: number of sources not modified since last download.
+ * @return The number of files downloaded.
+ *
+ * All files are downloaded concurrently using the curl multi interface.
+ * Sources that were downloaded before are requested conditionally using
+ * If-None-Match and If-Modified-Since; if the server replies that the data
+ * has not changed, no local file is left for the source. The same happens
+ * when the download fails so that partial files are not used for update.
+ */
+guint tle_fetch_files(gchar ** files, gchar ** locfiles, guint numfiles,
+                      const gchar * proxy, GKeyFile * srcdata,
+                      tle_fetch_progress_fn progress, gpointer data,
+                      guint * unchanged)
+{
+    tle_source_t   *srcs;
+    tle_source_t   *src;
+    CURLM          *multi;
+    CURLMcode       mres;
+    CURLMsg        *msg;
+    gint            running = 0;
+    gint            queued;
+    guint           done = 0;
+    guint           success = 0;
+    guint           i;
+
+    *unchanged = 0;
+
+    srcs = g_new0(tle_source_t, numfiles);
+    multi = curl_multi_init();
+
+    for (i = 0; i < numfiles; i++)
+    {
+        if (tle_source_init(&srcs[i], files[i], locfiles[i], proxy, srcdata))
+            curl_multi_add_handle(multi, srcs[i].curl);
+        else
+            done++;
+    }
+
+    /* run all transfers until they are finished */
+    do
+    {
+        mres = curl_multi_perform(multi, &running);
+        if (mres == CURLM_OK)
+            mres = curl_multi_wait(multi, NULL, 0, 100, NULL);
+
+        if (mres != CURLM_OK)
+        {
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s: Error fetching TLE files (%s)"),
+                        __func__, curl_multi_strerror(mres));
+            break;
+        }
+
+        while ((msg = curl_multi_info_read(multi, &queued)) != NULL)
+        {
+            if (msg->msg != CURLMSG_DONE)
+                continue;
+
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &src);
+            tle_source_done(src, msg->data.result);
+            done++;
+        }
+
+        if (progress != NULL)
+            progress(done, numfiles, data);
+    }
+    while (running > 0);
+
+    /* evaluate results and record them in the download history */
+    for (i = 0; i < numfiles; i++)
+    {
+        src = &srcs[i];
+
+        if (src->curl == NULL)
+            continue;
+
+        if (src->res != CURLE_OK)
+        {
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s: Error fetching %s (%s)"),
+                        __func__, src->url, curl_easy_strerror(src->res));
+            g_remove(src->locfile);
+            continue;
+        }
+
+        g_key_file_set_double(srcdata, src->url, "BYTES", src->bytes);
+        g_key_file_set_double(srcdata, src->url, "TIME", src->time);
+
+        if (src->code == 304)
+        {
+            sat_log_log(SAT_LOG_LEVEL_INFO,
+                        _("%s: %s not modified (%.2f s)"),
+                        __func__, src->url, src->time);
+            g_remove(src->locfile);
+            (*unchanged)++;
+            continue;
+        }
+
+        sat_log_log(SAT_LOG_LEVEL_INFO,
+                    _("%s: Successfully fetched %s (%.0f bytes in %.2f s)"),
+                    __func__, src->url, src->bytes, src->time);
+        success++;
+
+        if (src->etag != NULL)
+            g_key_file_set_string(srcdata, src->url, "ETAG", src->etag);
+        else
+            g_key_file_remove_key(srcdata, src->url, "ETAG", NULL);
+
+        if (src->filetime > 0)
+            g_key_file_set_int64(srcdata, src->url, "LAST_MODIFIED",
+                                 src->filetime);
+        else
+            g_key_file_remove_key(srcdata, src->url, "LAST_MODIFIED", NULL);
+    }
+
+    for (i = 0; i < numfiles; i++)
+        tle_source_free(&srcs[i], multi);
+
+    curl_multi_cleanup(multi);
+    g_free(srcs);
+
+    return success;
+}
+
+/**
+ * Write TLE data block to file.
+ *
+ * @param ptr Pointer to the data block to be written.
+ * @param size Size of data block.
+ * @param nmemb Size multiplier?
+ * @param stream Pointer to the file handle.
+ * @return The number of bytes actually written.
+ *
+ * This function writes the received data to the file pointed to by stream.
+ * It is used as write callback by to curl exec function.
+ */
+static size_t my_write_func(void *ptr, size_t size, size_t nmemb,
+                            FILE * stream)
+{
+    /*** FIXME: TBC whether this works in wintendo */
+    return fwrite(ptr, size, nmemb, stream);
+}
+
+/**
+ * Process an HTTP response header.
+ *
+ * @param buffer The header line (not zero terminated).
+ * @param size Always 1.
+ * @param nitems Length of the header line.
+ * @param userdata Pointer to the tle_source_t of the transfer.
+ * @return The number of bytes processed.
+ *
+ * Stores the ETag of the response so that the next request can be
+ * conditional. Last-Modified is handled by curl (CURLOPT_FILETIME).
+ */
+static size_t my_header_func(char *buffer, size_t size, size_t nitems,
+                             void *userdata)
+{
+    tle_source_t   *src = (tle_source_t *) userdata;
+    size_t          len = size * nitems;
+
+    if (len > 5 && g_ascii_strncasecmp(buffer, "ETag:", 5) == 0)
+    {
+        g_free(src->etag);
+        src->etag = g_strstrip(g_strndup(buffer + 5, len - 5));
+    }
+
+    return len;
+}
@@ -0,0 +1,49 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef TLE_FETCH_H
+#define TLE_FETCH_H 1
+
+#include <glib.h>
+
+/**
+ * Progress callback.
+ *
+ * @param done The number of sources that have been completed.
+ * @param numfiles The total number of sources.
+ * @param data User data.
+ *
+ * Called repeatedly while the transfers are running, also when no source
+ * has been completed since the last call.
+ */
+typedef void    (*tle_fetch_progress_fn) (guint done, guint numfiles,
+                                          gpointer data);
+
+guint           tle_fetch_files(gchar ** files, gchar ** locfiles,
+                                guint numfiles, const gchar * proxy,
+                                GKeyFile * srcdata,
+                                tle_fetch_progress_fn progress,
+                                gpointer data, guint * unchanged);
+
+#endif
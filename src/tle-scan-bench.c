@@ -0,0 +1,759 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Fuzz test and throughput benchmark for the in-place TLE scanner.
+ *
+ * tle_scan_buffer() and tle_lines_to_tle() are compared against the line
+ * reader that tle-update.c used before, which reads the file with fgets()
+ * into a three line window and converts each set with Get_Next_Tle_Set().
+ * Both must report the same element sets in the same order, with the same
+ * validity and bit-identical fields.
+ *
+ * The fuzz pass generates small files of three line and bare two line
+ * sets mixed with junk, and damages them: CRLF line ends, truncation at a
+ * random byte, characters replaced in the element lines, blank lines,
+ * whitespace around lines, and deleted or duplicated lines. A failing
+ * input is written to tle-scan-fail-N.txt.
+ *
+ * The throughput pass writes a file with --count synthetic sets, or uses
+ * --file, and reads it with both readers.
+ *
+ * The old reader is only well defined for text without NUL bytes and with
+ * lines shorter than 80 characters, so the generated input stays within
+ * these limits. Its buffers are cleared before use so that short lines are
+ * not checked against stale bytes, and the designator of bare sets is
+ * terminated before it is stripped. The old reader does not terminate
+ * names of 25 characters or more; for those only the first 24 characters
+ * without trailing spaces are compared, which is what the new reader keeps.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-stubs.h"
+#include "sgpsdp/sgp4sdp4.h"
+#include "tle-tools.h"
+
+
+/* command line options */
+static gint     count = 100000;
+static gint     fuzz = 20000;
+static gint     seed = 2017;
+static gint     repeat = 3;
+static gchar   *tlefile = NULL;
+
+static GOptionEntry options[] = {
+    {"count", 'n', 0, G_OPTION_ARG_INT, &count,
+     "Number of synthetic element sets in the throughput test", "N"},
+    {"fuzz", 'z', 0, G_OPTION_ARG_INT, &fuzz,
+     "Number of fuzz cases", "N"},
+    {"seed", 's', 0, G_OPTION_ARG_INT, &seed,
+     "Seed of the fuzz cases", "N"},
+    {"repeat", 'r', 0, G_OPTION_ARG_INT, &repeat,
+     "Read the file this many times and report the best run", "N"},
+    {"file", 'f', 0, G_OPTION_ARG_FILENAME, &tlefile,
+     "Read this TLE file instead of a synthetic one", "FILE"},
+    {"verbose", 'v', 0, G_OPTION_ARG_NONE, &bench_verbose,
+     "Log debug messages", NULL},
+    {NULL, 0, 0, 0, NULL, NULL, NULL}
+};
+
+/** An element set reported by one of the readers. */
+typedef struct {
+    gboolean        ok;         /*!< Whether the set passed the checks */
+    tle_t           tle;
+} result_t;
+
+/* characters used to replace characters in the element lines */
+static const gchar flipchars[] = "0123456789 .-+eEx\t&[]AZ";
+
+
+/** Strip in place and clear the rest of the 80 character line buffer. */
+static void strip_line(gchar * line)
+{
+    gsize           len;
+
+    g_strstrip(line);
+    len = strlen(line);
+    memset(line + len, 0, 80 - len);
+}
+
+/** Convert the sets found in the window as the old reader did. */
+static void old_convert(gchar tle_str[3][80], GArray * out)
+{
+    result_t        res;
+
+    tle_str[1][69] = '\0';
+    tle_str[2][69] = '\0';
+
+    memset(&res, 0, sizeof(res));
+    res.ok = (Get_Next_Tle_Set(tle_str, &res.tle) == 1);
+    g_array_append_val(out, res);
+}
+
+/**
+ * Read a TLE file with the reader used before tle_scan_buffer().
+ *
+ * This is the loop of the old read_fresh_tle() without the hash table and
+ * .cat file handling. The year of a bare set is signed, since converting
+ * a negative year to unsigned is undefined.
+ */
+static void old_read(const gchar * path, GArray * out)
+{
+    FILE           *fp;
+    gchar           tle_str[3][80];
+    gchar           tle_working[3][80];
+    gchar           linetmp[80];
+    guint           linesneeded = 3;
+    gchar           idstr[7], idyearstr[3];
+    gchar          *b;
+    gint            idyear;
+
+    fp = g_fopen(path, "r");
+    if (fp == NULL)
+        return;
+
+    memset(tle_str, 0, sizeof(tle_str));
+    memset(tle_working, 0, sizeof(tle_working));
+    memset(linetmp, 0, sizeof(linetmp));
+    b = linetmp;
+
+    while (fgets(linetmp, 80, fp))
+    {
+        switch (linesneeded)
+        {
+        case 3:
+            strncpy(tle_working[0], linetmp, 80);
+            tle_working[0][79] = 0;
+            memset(tle_working[1], 0, 80);
+            b = fgets(tle_working[1], 80, fp);
+            if (b == NULL)
+            {
+                tle_working[1][0] = '\0';
+                break;
+            }
+            memset(tle_working[2], 0, 80);
+            if (fgets(tle_working[2], 80, fp) == NULL)
+                tle_working[2][0] = '\0';
+            break;
+        case 2:
+            strncpy(tle_working[0], tle_working[2], 80);
+            strncpy(tle_working[1], linetmp, 80);
+            memset(tle_working[2], 0, 80);
+            if (fgets(tle_working[2], 80, fp) == NULL)
+                tle_working[2][0] = '\0';
+            break;
+        case 1:
+            strncpy(tle_working[0], tle_working[1], 80);
+            strncpy(tle_working[1], tle_working[2], 80);
+            strncpy(tle_working[2], linetmp, 80);
+            tle_working[2][79] = 0;
+            break;
+        }
+        memset(linetmp, 0, sizeof(linetmp));
+
+        if (b == NULL)
+            break;
+
+        strip_line(tle_working[0]);
+        strip_line(tle_working[1]);
+        strip_line(tle_working[2]);
+
+        if ((tle_working[1][0] == '1') &&
+            (tle_working[2][0] == '2') &&
+            Checksum_Good(tle_working[1]) && Checksum_Good(tle_working[2]))
+        {
+            strncpy(tle_str[0], tle_working[0], 80);
+            tle_str[0][79] = 0;
+            strncpy(tle_str[1], tle_working[1], 80);
+            strncpy(tle_str[2], tle_working[2], 80);
+            linesneeded = 3;
+        }
+        else if ((tle_working[0][0] == '1') &&
+                 (tle_working[1][0] == '2') &&
+                 Checksum_Good(tle_working[0]) &&
+                 Checksum_Good(tle_working[1]))
+        {
+            memset(idstr, 0, sizeof(idstr));
+            strncpy(idstr, &tle_working[0][11], 6);
+            g_strstrip(idstr);
+            strncpy(idyearstr, &tle_working[0][9], 2);
+            idstr[6] = '\0';
+            idyearstr[2] = '\0';
+            idyear = g_ascii_strtod(idyearstr, NULL);
+
+            if (idyear >= 57)
+                idyear += 1900;
+            else
+                idyear += 2000;
+
+            memset(tle_str[0], 0, 80);
+            snprintf(tle_str[0], 79, "%d-%s", idyear, idstr);
+            strncpy(tle_str[1], tle_working[0], 80);
+            strncpy(tle_str[2], tle_working[1], 80);
+            linesneeded = 2;
+        }
+        else
+        {
+            linesneeded = 1;
+            continue;
+        }
+
+        old_convert(tle_str, out);
+    }
+
+    fclose(fp);
+}
+
+static void add_result(const tle_lines_t * lines, gpointer data)
+{
+    result_t        res;
+
+    memset(&res, 0, sizeof(res));
+    res.ok = (tle_lines_to_tle(lines, &res.tle) == TLE_CONV_SUCCESS);
+    g_array_append_val((GArray *) data, res);
+}
+
+/** Read a TLE buffer with tle_scan_buffer(). */
+static void new_read(const gchar * buf, gsize len, GArray * out)
+{
+    tle_scan_buffer(buf, len, add_result, out);
+}
+
+/** Copy a name the way it is compared; see the comment at the top. */
+static void cmp_name(const gchar * name, gchar * buf)
+{
+    gsize           len = 0;
+
+    while (len < 24 && name[len] != '\0')
+        len++;
+    memcpy(buf, name, len);
+    buf[len] = '\0';
+
+    /* the name was not terminated within the 25 characters */
+    if (len == 24 && name[24] != '\0')
+        while (len > 0 && buf[len - 1] == ' ')
+            buf[--len] = '\0';
+}
+
+/** Compare two sets field by field; returns the first differing field. */
+static const gchar *diff_result(const result_t * a, const result_t * b)
+{
+    gchar           na[25], nb[25];
+
+    if (a->ok != b->ok)
+        return "validity";
+    if (!a->ok)
+        return NULL;
+
+    cmp_name(a->tle.sat_name, na);
+    cmp_name(b->tle.sat_name, nb);
+
+#define DIFF(field) if (a->tle.field != b->tle.field) return #field
+    DIFF(catnr);
+    DIFF(status);
+    DIFF(epoch);
+    DIFF(epoch_year);
+    DIFF(epoch_day);
+    DIFF(epoch_fod);
+    DIFF(xndt2o);
+    DIFF(xndd6o);
+    DIFF(bstar);
+    DIFF(elset);
+    DIFF(xincl);
+    DIFF(xnodeo);
+    DIFF(eo);
+    DIFF(omegao);
+    DIFF(xmo);
+    DIFF(xno);
+    DIFF(revnum);
+#undef DIFF
+    if (strcmp(na, nb))
+        return "sat_name";
+    if (strcmp(a->tle.idesg, b->tle.idesg))
+        return "idesg";
+
+    return NULL;
+}
+
+/** Compare the results of both readers; reports the first difference. */
+static gboolean compare(GArray * old, GArray * new, const gchar * what)
+{
+    const gchar    *field;
+    result_t       *a, *b;
+    guint           i;
+
+    if (old->len != new->len)
+    {
+        g_printerr("%s: %u sets found, expected %u\n", what, new->len,
+                   old->len);
+        return FALSE;
+    }
+
+    for (i = 0; i < old->len; i++)
+    {
+        a = &g_array_index(old, result_t, i);
+        b = &g_array_index(new, result_t, i);
+        field = diff_result(a, b);
+        if (field != NULL)
+        {
+            g_printerr("%s: set %u (#%d): %s differs\n", what, i,
+                       a->tle.catnr, field);
+            g_printerr("  old: ok=%d name='%.24s' epoch=%.17g eo=%.17g\n",
+                       a->ok, a->tle.sat_name, a->tle.epoch, a->tle.eo);
+            g_printerr("  new: ok=%d name='%.24s' epoch=%.17g eo=%.17g\n",
+                       b->ok, b->tle.sat_name, b->tle.epoch, b->tle.eo);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/** Append the checksum digit and the line end to a 68 character line. */
+static void finish_line(GString * s, gsize start)
+{
+    gint            checksum = 0;
+    gsize           i;
+
+    for (i = start; i < start + 68 && i < s->len; i++)
+    {
+        if (g_ascii_isdigit(s->str[i]))
+            checksum += s->str[i] - '0';
+        else if (s->str[i] == '-')
+            checksum++;
+    }
+
+    g_string_append_printf(s, "%d\n", checksum % 10);
+}
+
+/** Append a valid element set; bare two line data if name is NULL. */
+static void gen_set(GRand * rnd, GString * s, gint catnum,
+                    const gchar * name)
+{
+    gsize           start;
+    gint            day;
+
+    if (name != NULL)
+        g_string_append_printf(s, "%s\n", name);
+
+    start = s->len;
+    day = g_rand_int_range(rnd, 1, 367);
+    g_string_append_printf(s, "1 %05dU %02d%03d%-3s %02d",
+                           catnum, g_rand_int_range(rnd, 0, 100),
+                           g_rand_int_range(rnd, 1, 400),
+                           g_rand_boolean(rnd) ? "A" : "BCD",
+                           g_rand_int_range(rnd, 0, 100));
+    /* the day of year is sometimes padded with spaces */
+    g_string_append_printf(s, g_rand_int_range(rnd, 0, 4) ? "%03d" : "%3d",
+                           day);
+    g_string_append_printf(s, ".%08d %c.%08d %c%05d%c%d %c%05d%c%d 0 %4d",
+                           g_rand_int_range(rnd, 0, 100000000),
+                           g_rand_boolean(rnd) ? ' ' : '-',
+                           g_rand_int_range(rnd, 0, 100000),
+                           g_rand_boolean(rnd) ? ' ' : '-',
+                           g_rand_int_range(rnd, 0, 100000),
+                           g_rand_boolean(rnd) ? '+' : '-',
+                           g_rand_int_range(rnd, 0, 10),
+                           g_rand_boolean(rnd) ? ' ' : '-',
+                           g_rand_int_range(rnd, 0, 100000),
+                           g_rand_boolean(rnd) ? '+' : '-',
+                           g_rand_int_range(rnd, 0, 10),
+                           g_rand_int_range(rnd, 0, 10000));
+    finish_line(s, start);
+
+    start = s->len;
+    g_string_append_printf(s, "2 %05d %8.4f %8.4f %07d %8.4f %8.4f "
+                           "%11.8f%5d", catnum,
+                           g_rand_double_range(rnd, 0.0, 180.0),
+                           g_rand_double_range(rnd, 0.0, 360.0),
+                           g_rand_int_range(rnd, 0, 10000000),
+                           g_rand_double_range(rnd, 0.0, 360.0),
+                           g_rand_double_range(rnd, 0.0, 360.0),
+                           g_rand_double_range(rnd, 0.9, 17.0),
+                           g_rand_int_range(rnd, 0, 100000));
+    finish_line(s, start);
+}
+
+/** Create a satellite name, sometimes with an operational status. */
+static gchar   *gen_name(GRand * rnd, gint catnum)
+{
+    static const gchar *status[] = { "", " [+]", " [-]", " [P]", " [B]",
+        " [S]", " [X]", " [?]", "  [+]", "[+]"
+    };
+
+    return g_strdup_printf("%s %d%s%s",
+                           g_rand_boolean(rnd) ? "SAT" : "CUBE&SAT", catnum,
+                           g_rand_int_range(rnd, 0, 4) ? "" : "   ",
+                           status[g_rand_int_range(rnd, 0,
+                                                   G_N_ELEMENTS(status))]);
+}
+
+/** Create a junk line that the old reader may still use as a name. */
+static gchar   *gen_junk(GRand * rnd)
+{
+    gchar          *junk;
+    gint            len, i;
+
+    len = g_rand_int_range(rnd, 0, 25);
+    junk = g_malloc(len + 1);
+    for (i = 0; i < len; i++)
+        junk[i] = (gchar) g_rand_int_range(rnd, ' ' + 1, '~');
+    junk[len] = '\0';
+
+    /* the old reader does not handle a status at the start of a name */
+    if (len > 0 && junk[0] == '[')
+        junk[0] = '#';
+
+    return junk;
+}
+
+/** Generate a fuzz case as a list of lines without line ends. */
+static gchar  **gen_lines(GRand * rnd)
+{
+    GString        *s = g_string_new(NULL);
+    gchar          *text;
+    gchar         **lines;
+    gint            n, i, catnum;
+
+    n = g_rand_int_range(rnd, 1, 7);
+    for (i = 0; i < n; i++)
+    {
+        if (!g_rand_int_range(rnd, 0, 4))
+        {
+            text = gen_junk(rnd);
+            g_string_append_printf(s, "%s\n", text);
+            g_free(text);
+        }
+
+        catnum = g_rand_int_range(rnd, 1, 100000);
+        if (g_rand_int_range(rnd, 0, 3))
+        {
+            text = gen_name(rnd, catnum);
+            gen_set(rnd, s, catnum, text);
+            g_free(text);
+        }
+        else
+        {
+            gen_set(rnd, s, catnum, NULL);
+        }
+    }
+
+    /* drop the last line end, the lines are joined again later */
+    g_string_truncate(s, s->len - 1);
+    lines = g_strsplit(s->str, "\n", -1);
+    g_string_free(s, TRUE);
+
+    return lines;
+}
+
+/** Replace a character in an element line, keeping it printable. */
+static void flip_char(GRand * rnd, gchar ** lines)
+{
+    guint           n = g_strv_length(lines);
+    guint           i, tries;
+    gsize           len;
+
+    for (tries = 0; tries < 10; tries++)
+    {
+        i = g_rand_int_range(rnd, 0, n);
+        len = strlen(lines[i]);
+        if (len >= 69 && (lines[i][0] == '1' || lines[i][0] == '2'))
+        {
+            lines[i][g_rand_int_range(rnd, 0, 69)] =
+                flipchars[g_rand_int_range(rnd, 0, sizeof(flipchars) - 1)];
+            return;
+        }
+    }
+}
+
+/** Apply the damage of a fuzz case and join the lines. */
+static GString *damage(GRand * rnd, gchar ** lines)
+{
+    GString        *s = g_string_new(NULL);
+    GPtrArray      *out = g_ptr_array_new_with_free_func(g_free);
+    gboolean        crlf;
+    guint           n, i;
+    gint            k;
+
+    /* replace characters; a replacement that changes the value of a
+       digit breaks the checksum, the others pass it */
+    for (k = g_rand_int_range(rnd, 0, 4); k > 0; k--)
+        flip_char(rnd, lines);
+
+    n = g_strv_length(lines);
+    crlf = !g_rand_int_range(rnd, 0, 4);
+
+    for (i = 0; i < n; i++)
+    {
+        switch (g_rand_int_range(rnd, 0, 24))
+        {
+        case 0:
+            /* delete the line */
+            continue;
+        case 1:
+            /* duplicate it */
+            g_ptr_array_add(out, g_strdup(lines[i]));
+            break;
+        case 2:
+            /* blank or whitespace line in front of it */
+            g_ptr_array_add(out, g_strdup(g_rand_boolean(rnd) ? "" : " \t "));
+            break;
+        case 3:
+            /* whitespace around it */
+            g_ptr_array_add(out, g_strdup_printf("%.*s%s%.*s",
+                                                 g_rand_int_range(rnd, 0, 3),
+                                                 " \t ", lines[i],
+                                                 g_rand_int_range(rnd, 0, 3),
+                                                 "\t  "));
+            continue;
+        default:
+            break;
+        }
+        g_ptr_array_add(out, g_strdup(lines[i]));
+    }
+
+    for (i = 0; i < out->len; i++)
+    {
+        g_string_append(s, g_ptr_array_index(out, i));
+        if (i + 1 < out->len || g_rand_boolean(rnd))
+            g_string_append(s, (crlf || !g_rand_int_range(rnd, 0, 20)) ?
+                            "\r\n" : "\n");
+    }
+    g_ptr_array_free(out, TRUE);
+
+    /* truncated download */
+    if (s->len > 0 && !g_rand_int_range(rnd, 0, 5))
+        g_string_truncate(s, g_rand_int_range(rnd, 0, s->len));
+
+    return s;
+}
+
+/** Run one fuzz case; the input is kept if the readers disagree. */
+static gboolean fuzz_case(GRand * rnd, gint idx, const gchar * path,
+                          guint * sets)
+{
+    GArray         *old = g_array_new(FALSE, FALSE, sizeof(result_t));
+    GArray         *new = g_array_new(FALSE, FALSE, sizeof(result_t));
+    gchar         **lines;
+    GString        *s;
+    gchar          *what;
+    gchar          *fail;
+    gboolean        ok;
+
+    lines = gen_lines(rnd);
+    s = damage(rnd, lines);
+    g_strfreev(lines);
+
+    ok = g_file_set_contents(path, s->str, s->len, NULL);
+    if (ok)
+    {
+        old_read(path, old);
+        new_read(s->str, s->len, new);
+
+        what = g_strdup_printf("fuzz case %d", idx);
+        ok = compare(old, new, what);
+        g_free(what);
+
+        if (!ok)
+        {
+            fail = g_strdup_printf("tle-scan-fail-%d.txt", idx);
+            g_file_set_contents(fail, s->str, s->len, NULL);
+            g_printerr("  input written to %s\n", fail);
+            g_free(fail);
+        }
+        *sets += old->len;
+    }
+
+    g_string_free(s, TRUE);
+    g_array_free(old, TRUE);
+    g_array_free(new, TRUE);
+
+    return ok;
+}
+
+/** Write a file with count valid three line sets. */
+static gboolean generate(const gchar * path)
+{
+    GRand          *rnd = g_rand_new_with_seed(seed);
+    GString        *s = g_string_sized_new(count * 170);
+    gchar          *name;
+    gboolean        ok;
+    gint            i;
+
+    for (i = 0; i < count; i++)
+    {
+        name = gen_name(rnd, i % 99999 + 1);
+        gen_set(rnd, s, i % 99999 + 1, name);
+        g_free(name);
+    }
+
+    ok = g_file_set_contents(path, s->str, s->len, NULL);
+    g_string_free(s, TRUE);
+    g_rand_free(rnd);
+
+    return ok;
+}
+
+static void report(const gchar * what, gint64 usec, gsize bytes, guint sets)
+{
+    gdouble         sec = MAX(usec, 1) / 1.0e6;
+
+    g_print("%-5s %8.1f ms %8.1f MB/s %12.0f sets/s\n", what, sec * 1.0e3,
+            bytes / sec / 1.0e6, sets / sec);
+}
+
+/** Read the throughput file with both readers and compare the results. */
+static gboolean throughput(const gchar * path)
+{
+    GArray         *old = g_array_new(FALSE, FALSE, sizeof(result_t));
+    GArray         *new = g_array_new(FALSE, FALSE, sizeof(result_t));
+    GMappedFile    *mf;
+    gint64          t, best_old, best_new;
+    gboolean        ok;
+    gint            i;
+
+    mf = g_mapped_file_new(path, FALSE, NULL);
+    if (mf == NULL)
+    {
+        g_printerr("Could not map %s\n", path);
+        return FALSE;
+    }
+
+    best_old = best_new = G_MAXINT64;
+    for (i = 0; i < MAX(repeat, 1); i++)
+    {
+        g_array_set_size(old, 0);
+        t = g_get_monotonic_time();
+        old_read(path, old);
+        best_old = MIN(best_old, g_get_monotonic_time() - t);
+
+        g_array_set_size(new, 0);
+        t = g_get_monotonic_time();
+        new_read(g_mapped_file_get_contents(mf),
+                 g_mapped_file_get_length(mf), new);
+        best_new = MIN(best_new, g_get_monotonic_time() - t);
+    }
+
+    report("old", best_old, g_mapped_file_get_length(mf), old->len);
+    report("new", best_new, g_mapped_file_get_length(mf), new->len);
+    g_print("%u element sets\n", new->len);
+
+    ok = compare(old, new, path);
+    if (ok && tlefile == NULL && new->len != (guint) count)
+    {
+        g_printerr("%u sets found, generated %d\n", new->len, count);
+        ok = FALSE;
+    }
+
+    g_mapped_file_unref(mf);
+    g_array_free(old, TRUE);
+    g_array_free(new, TRUE);
+
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    GOptionContext *context;
+    GError         *err = NULL;
+    GRand          *rnd;
+    gchar          *fuzzfile = NULL;
+    gchar          *benchfile = NULL;
+    guint           sets = 0;
+    guint           failed = 0;
+    gint            fd, i;
+    gboolean        ok = TRUE;
+
+    context = g_option_context_new(NULL);
+    g_option_context_set_summary(context,
+                                 "Fuzz test and throughput benchmark for "
+                                 "the TLE scanner.");
+    g_option_context_add_main_entries(context, options, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &err))
+    {
+        g_printerr("%s\n", err->message);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(context);
+
+    fd = g_file_open_tmp("tle-scan-XXXXXX.txt", &fuzzfile, &err);
+    if (fd < 0)
+    {
+        g_printerr("Could not create a temporary file: %s\n", err->message);
+        return EXIT_FAILURE;
+    }
+    g_close(fd, NULL);
+
+    /* fuzz cases */
+    rnd = g_rand_new_with_seed(seed);
+    for (i = 0; i < fuzz; i++)
+        if (!fuzz_case(rnd, i, fuzzfile, &sets))
+            failed++;
+    g_rand_free(rnd);
+    g_unlink(fuzzfile);
+    g_free(fuzzfile);
+
+    g_print("%d fuzz cases with %u element sets, %u failed\n", MAX(fuzz, 0),
+            sets, failed);
+    ok = (failed == 0);
+
+    /* throughput */
+    if (tlefile == NULL && count > 0)
+    {
+        fd = g_file_open_tmp("tle-scan-XXXXXX.txt", &benchfile, &err);
+        if (fd < 0)
+        {
+            g_printerr("Could not create a temporary file: %s\n",
+                       err->message);
+            return EXIT_FAILURE;
+        }
+        g_close(fd, NULL);
+
+        if (generate(benchfile))
+            ok = throughput(benchfile) && ok;
+        else
+        {
+            g_printerr("Could not write %s\n", benchfile);
+            ok = FALSE;
+        }
+        g_unlink(benchfile);
+        g_free(benchfile);
+    }
+    else if (tlefile != NULL)
+    {
+        ok = throughput(tlefile) && ok;
+    }
+
+    g_free(tlefile);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
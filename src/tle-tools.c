@@ -29,6 +29,8 @@
 */
 
 #include <glib.h>
+#include <stdlib.h>
+#include <string.h>
 #include <glib/gi18n.h>
 #include "sgpsdp/sgp4sdp4.h"
 #include "sat-log.h"
@@ -113,3 +115,517 @@ tle2twoline (tle_t *tle, gchar *line1, gchar *line2, gchar *line3)
 
 
 
+
+
+/* Powers of ten that can be represented exactly in a double. */
+static const gdouble pow10_tab[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+/** \brief Convert a fixed width TLE field to a number.
+ *  \param s Pointer to the first character of the field.
+ *  \param n The width of the field.
+ *  \param exp10 Decimal exponent applied to the value, e.g. -5 for 1e-5.
+ *  \param zeropad Treat spaces at offsets 2 and 3 as zeros (epoch day).
+ *  \return The value of the field.
+ *
+ * The field may have leading spaces, a sign, digits and a decimal point.
+ * Conversion stops at the first character that does not belong to the
+ * number, as g_ascii_strtod() would on a copy of the field.
+ *
+ * The digits are accumulated into an integer and scaled by a single exact
+ * power of ten. For the field widths used in TLE data the integer is exact
+ * and the result is correctly rounded, i.e. identical to what
+ * g_ascii_strtod() returns. This matters because epochs are compared for
+ * equality against values parsed by Convert_Satellite_Data().
+ */
+static gdouble
+tle_field_to_double (const gchar *s, gsize n, gint exp10, gboolean zeropad)
+{
+    guint64         mant = 0;
+    gboolean        neg = FALSE;
+    gboolean        point = FALSE;
+    gsize           i = 0;
+    gdouble         val;
+
+    while (i < n && s[i] == ' ')
+        i++;
+
+    if (i < n && (s[i] == '-' || s[i] == '+'))
+    {
+        neg = (s[i] == '-');
+        i++;
+    }
+
+    for (; i < n; i++)
+    {
+        if (s[i] >= '0' && s[i] <= '9')
+        {
+            mant = mant * 10 + (guint64) (s[i] - '0');
+        }
+        else if (zeropad && (i == 2 || i == 3) && s[i] == ' ')
+        {
+            mant = mant * 10;
+        }
+        else if (s[i] == '.' && !point)
+        {
+            point = TRUE;
+            continue;
+        }
+        else
+        {
+            break;
+        }
+
+        if (point)
+            exp10--;
+    }
+
+    exp10 = CLAMP (exp10, -22, 22);
+    if (exp10 >= 0)
+        val = (gdouble) mant * pow10_tab[exp10];
+    else
+        val = (gdouble) mant / pow10_tab[-exp10];
+
+    return neg ? -val : val;
+}
+
+
+/** \brief Check whether tle_field_to_double() converts a field exactly.
+ *
+ * This is the case when the field only contains spaces, signs, digits and
+ * decimal points. Anything else, e.g. an exponent or a tab, may be read
+ * differently by g_ascii_strtod() and atoi(), so such fields are converted
+ * the way Convert_Satellite_Data() does.
+ */
+static gboolean
+tle_field_is_plain (const gchar *s, gsize n)
+{
+    gsize           i;
+
+    for (i = 0; i < n; i++)
+        if (!g_ascii_isdigit (s[i]) && s[i] != ' ' && s[i] != '.' &&
+            s[i] != '-' && s[i] != '+')
+            return FALSE;
+
+    return TRUE;
+}
+
+
+/** \brief Check whether a field consists of n digits. */
+static gboolean
+tle_field_is_digits (const gchar *s, gsize n)
+{
+    gsize           i;
+
+    for (i = 0; i < n; i++)
+        if (!g_ascii_isdigit (s[i]))
+            return FALSE;
+
+    return TRUE;
+}
+
+
+/** \brief Convert a copy of a field with g_ascii_strtod().
+ *  \param pre Text put in front of the field, e.g. the implied "." of
+ *             the eccentricity.
+ *  \param s Pointer to the first character of the field.
+ *  \param n The width of the field, at most 12 characters.
+ */
+static gdouble
+tle_field_strtod (const gchar *pre, const gchar *s, gsize n)
+{
+    gchar           buff[16];
+    gsize           len;
+
+    len = g_strlcpy (buff, pre, 4);
+    memcpy (&buff[len], s, n);
+    buff[len + n] = '\0';
+
+    return g_ascii_strtod (buff, NULL);
+}
+
+
+/** \brief Convert a fixed width TLE field to a number like g_ascii_strtod(). */
+static gdouble
+tle_field_double (const gchar *s, gsize n)
+{
+    if (tle_field_is_plain (s, n))
+        return tle_field_to_double (s, n, 0, FALSE);
+
+    return tle_field_strtod ("", s, n);
+}
+
+
+/** \brief Convert a fixed width TLE field to an integer like atoi(). */
+static gint
+tle_field_to_int (const gchar *s, gsize n)
+{
+    gchar           buff[8];
+
+    if (tle_field_is_plain (s, n))
+        return (gint) tle_field_to_double (s, n, 0, FALSE);
+
+    memcpy (buff, s, n);
+    buff[n] = '\0';
+
+    return atoi (buff);
+}
+
+
+/** \brief Convert an exponential TLE field like " 12345-5" to a number.
+ *
+ * The field consists of a sign, five implied decimal digits and a signed
+ * one digit exponent. Fields that do not have this form are converted as
+ * in Convert_Satellite_Data(), by reading " .12345E-5" with
+ * g_ascii_strtod().
+ */
+static gdouble
+tle_exp_field_to_double (const gchar *s)
+{
+    gchar           buff[11];
+    gdouble         val;
+    gint            exp10;
+
+    if ((s[0] == ' ' || s[0] == '-' || s[0] == '+') &&
+        tle_field_is_digits (&s[1], 5) &&
+        (g_ascii_isdigit (s[6]) || s[6] == '-' || s[6] == '+') &&
+        g_ascii_isdigit (s[7]))
+    {
+        exp10 = (gint) tle_field_to_double (&s[6], 2, 0, FALSE) - 5;
+        if (exp10 >= -22 && exp10 <= 22)
+        {
+            val = tle_field_to_double (&s[1], 5, exp10, FALSE);
+            return (s[0] == '-') ? -val : val;
+        }
+    }
+
+    buff[0] = s[0];
+    buff[1] = '.';
+    memcpy (&buff[2], &s[1], 5);
+    buff[7] = 'E';
+    memcpy (&buff[8], &s[6], 2);
+    buff[10] = '\0';
+
+    return g_ascii_strtod (buff, NULL);
+}
+
+
+/** \brief Verify the checksum of a TLE line.
+ *  \param line Pointer to the line; it does not need to be terminated.
+ *  \param len The length of the line.
+ *  \return TRUE if the line is at least 69 characters and the checksum
+ *          in column 69 is correct.
+ *
+ * This is equivalent to Checksum_Good() but works directly on the buffer.
+ */
+gboolean
+tle_line_checksum_ok (const gchar *line, gsize len)
+{
+    gint            i;
+    gint            checksum = 0;
+
+    if (line == NULL || len < 69)
+        return FALSE;
+
+    for (i = 0; i < 68; i++)
+    {
+        if ((line[i] >= '0') && (line[i] <= '9'))
+            checksum += line[i] - '0';
+        else if (line[i] == '-')
+            checksum += 1;
+    }
+
+    return (checksum % 10 == line[68] - '0');
+}
+
+
+/** \brief Extract satellite name and operational status from a name line.
+ *
+ * Follows Get_Next_Tle_Set(): '&' is replaced by '/', a carriage return
+ * ends the name and trailing spaces are removed. An operational status like
+ * [+] ends the name together with the character in front of it, which is
+ * normally a space; no other spaces are removed in that case.
+ */
+static void
+tle_parse_name (const gchar *name, gsize len, tle_t *tle)
+{
+    gsize           i;
+    gsize           end = 0;
+
+    for (i = 0; i < len && i < sizeof (tle->sat_name) - 1; i++)
+    {
+        if (name[i] == '\r')
+            break;
+
+        if ((i < 23) && (i + 2 < len) && (name[i] == '[') &&
+            (name[i + 2] == ']'))
+        {
+            switch (name[i + 1])
+            {
+            case '+':
+                tle->status = OP_STAT_OPERATIONAL;
+                break;
+            case '-':
+                tle->status = OP_STAT_NONOP;
+                break;
+            case 'P':
+                tle->status = OP_STAT_PARTIAL;
+                break;
+            case 'B':
+                tle->status = OP_STAT_STDBY;
+                break;
+            case 'S':
+                tle->status = OP_STAT_SPARE;
+                break;
+            case 'X':
+                tle->status = OP_STAT_EXTENDED;
+                break;
+            default:
+                tle->sat_name[end++] = name[i];
+                continue;
+            }
+
+            tle->sat_name[(end > 0) ? end - 1 : 0] = '\0';
+            return;
+        }
+
+        tle->sat_name[end++] = (name[i] == '&') ? '/' : name[i];
+    }
+
+    while (end > 0 && tle->sat_name[end - 1] == ' ')
+        end--;
+
+    tle->sat_name[end] = '\0';
+}
+
+
+/** \brief Convert TLE lines found by tle_scan_buffer() to a tle_t structure.
+ *  \param lines The lines of the element set.
+ *  \param tle Pointer to a tle_t structure where the TLE data will be put.
+ *  \return TLE_CONV_SUCCESS if the data is valid, TLE_CONV_ERROR otherwise.
+ *
+ * This performs the same checks as Good_Elements() and the same conversion
+ * as Get_Next_Tle_Set() and Convert_Satellite_Data() without copying the
+ * lines into temporary strings. Fields are only copied for g_ascii_strtod()
+ * when they contain something other than digits, signs, spaces and decimal
+ * points. For bare two line data the name is generated from the
+ * international designator, e.g. 1998-067A.
+ */
+gint
+tle_lines_to_tle (const tle_lines_t *lines, tle_t *tle)
+{
+    const gchar    *l1 = lines->line1;
+    const gchar    *l2 = lines->line2;
+    gchar           idstr[7];
+    gchar           name[25];
+    gchar           buff[15];
+    gint            idyear;
+
+    tle->status = OP_STAT_UNKNOWN;
+
+    /* checks from Good_Elements() */
+    if (!tle_line_checksum_ok (l1, lines->len1) ||
+        !tle_line_checksum_ok (l2, lines->len2))
+        return TLE_CONV_ERROR;
+
+    if ((l1[0] != '1') || (l2[0] != '2') || (memcmp (&l1[2], &l2[2], 5) != 0))
+        return TLE_CONV_ERROR;
+
+    if ((l1[23] != '.') || (l1[34] != '.') || (l2[11] != '.') ||
+        (l2[20] != '.') || (l2[37] != '.') || (l2[46] != '.') ||
+        (l2[54] != '.') || (memcmp (&l1[61], " 0 ", 3) != 0))
+        return TLE_CONV_ERROR;
+
+    if (lines->name != NULL)
+    {
+        tle_parse_name (lines->name, lines->namelen, tle);
+    }
+    else
+    {
+        /* YYYY-NNNAAA from the international designator; the generated
+           name is parsed like a name line, as in the old reader */
+        memcpy (idstr, &l1[11], 6);
+        idstr[6] = '\0';
+        g_strstrip (idstr);
+
+        idyear = (gint) tle_field_double (&l1[9], 2);
+        idyear += (idyear >= 57) ? 1900 : 2000;
+        g_snprintf (name, sizeof (name), "%d-%s", idyear, idstr);
+        tle_parse_name (name, strlen (name), tle);
+    }
+
+    tle->catnr = tle_field_to_int (&l1[2], 5);
+
+    memcpy (tle->idesg, &l1[9], 8);
+    tle->idesg[8] = '\0';
+
+    /* YYDDD.FFFFFFFF; DDD may be padded with spaces */
+    if (tle_field_is_plain (&l1[18], 14))
+    {
+        tle->epoch = tle_field_to_double (&l1[18], 14, 0, TRUE);
+    }
+    else
+    {
+        memcpy (buff, &l1[18], 14);
+        if (buff[2] == ' ')
+            buff[2] = '0';
+        if (buff[3] == ' ')
+            buff[3] = '0';
+        buff[14] = '\0';
+        tle->epoch = g_ascii_strtod (buff, NULL);
+    }
+    tle->epoch_year = 2000 + tle_field_to_int (&l1[18], 2);
+    tle->epoch_day = tle_field_to_int (&l1[20], 3);
+    if (tle_field_is_plain (&l1[23], 9))
+        tle->epoch_fod = tle_field_to_double (&l1[23], 9, 0, FALSE);
+    else
+        tle->epoch_fod = tle_field_strtod ("0", &l1[23], 9);
+
+    tle->xndt2o = tle_field_double (&l1[33], 10);
+    tle->xndd6o = tle_exp_field_to_double (&l1[44]);
+    tle->bstar = tle_exp_field_to_double (&l1[53]);
+    tle->elset = tle_field_to_int (&l1[64], 4);
+
+    tle->xincl = tle_field_double (&l2[8], 8);
+    tle->xnodeo = tle_field_double (&l2[17], 8);
+    /* seven digits with an implied decimal point */
+    if (tle_field_is_digits (&l2[26], 7))
+        tle->eo = tle_field_to_double (&l2[26], 7, -7, FALSE);
+    else
+        tle->eo = tle_field_strtod (".", &l2[26], 7);
+    /* avoid division by 0 */
+    if (tle->eo < 1.0e-6)
+        tle->eo = 1.0e-6;
+    tle->omegao = tle_field_double (&l2[34], 8);
+    tle->xmo = tle_field_double (&l2[43], 8);
+    tle->xno = tle_field_double (&l2[52], 10);
+    tle->revnum = (gint) tle_field_double (&l2[63], 5);
+
+    return TLE_CONV_SUCCESS;
+}
+
+
+/** \brief Get the next line from a buffer with surrounding whitespace removed.
+ *  \return FALSE when the end of the buffer has been reached.
+ */
+static gboolean
+next_line (const gchar *buf, gsize len, gsize *pos,
+           const gchar **line, gsize *linelen)
+{
+    const gchar    *end;
+    gsize           start, stop;
+
+    if (*pos >= len)
+        return FALSE;
+
+    start = *pos;
+    end = memchr (buf + start, '\n', len - start);
+    stop = (end != NULL) ? (gsize) (end - buf) : len;
+    *pos = stop + 1;
+
+    while (start < stop && g_ascii_isspace (buf[start]))
+        start++;
+    while (stop > start && g_ascii_isspace (buf[stop - 1]))
+        stop--;
+
+    *line = buf + start;
+    *linelen = stop - start;
+
+    return TRUE;
+}
+
+
+/** \brief Check whether a line looks like line number num of a TLE. */
+static gboolean
+is_tle_line (const gchar *line, gsize len, gchar num)
+{
+    return (len >= 69) && (line[0] == num) && tle_line_checksum_ok (line, len);
+}
+
+
+/** \brief Find all TLE sets in a text buffer.
+ *  \param buf The text, e.g. a memory mapped TLE file. Need not be terminated.
+ *  \param len The length of the text.
+ *  \param func Function called for each element set found.
+ *  \param data User data passed to func.
+ *  \return The number of element sets found.
+ *
+ * The buffer may contain NASA three line data (name + two lines), bare two
+ * line data or a mix of both; anything else is skipped line by line. A set
+ * is reported when both lines start with the proper line number and have a
+ * correct checksum; the remaining checks are done by tle_lines_to_tle().
+ *
+ * The buffer is not modified and no memory is allocated; the lines passed
+ * to func point into the buffer.
+ */
+guint
+tle_scan_buffer (const gchar *buf, gsize len, tle_scan_func func,
+                 gpointer data)
+{
+    const gchar    *line[3];
+    gsize           linelen[3];
+    tle_lines_t     lines;
+    gsize           pos = 0;
+    guint           have = 0;
+    guint           used;
+    guint           num = 0;
+    guint           i;
+
+    for (;;)
+    {
+        /* fill the window with three lines */
+        while (have < 3 && next_line (buf, len, &pos, &line[have], &linelen[have]))
+            have++;
+
+        if (have < 2)
+            break;
+
+        if (have == 3 &&
+            is_tle_line (line[1], linelen[1], '1') &&
+            is_tle_line (line[2], linelen[2], '2'))
+        {
+            lines.name = line[0];
+            lines.namelen = linelen[0];
+            lines.line1 = line[1];
+            lines.len1 = linelen[1];
+            lines.line2 = line[2];
+            lines.len2 = linelen[2];
+            used = 3;
+        }
+        else if (is_tle_line (line[0], linelen[0], '1') &&
+                 is_tle_line (line[1], linelen[1], '2'))
+        {
+            lines.name = NULL;
+            lines.namelen = 0;
+            lines.line1 = line[0];
+            lines.len1 = linelen[0];
+            lines.line2 = line[1];
+            lines.len2 = linelen[1];
+            used = 2;
+        }
+        else
+        {
+            /* junk; skip one line */
+            used = 1;
+        }
+
+        if (used > 1)
+        {
+            func (&lines, data);
+            num++;
+        }
+
+        /* shift the remaining lines to the front of the window */
+        for (i = used; i < have; i++)
+        {
+            line[i - used] = line[i];
+            linelen[i - used] = linelen[i];
+        }
+        have -= used;
+    }
+
+    return num;
+}
@@ -46,4 +46,28 @@ gint twoline2tle (gchar *line1, gchar *line2, gchar *line3,
 gint tle2twoline (tle_t *tle, gchar *line1, gchar *line2, gchar *line3);
 
 
+/** \brief The lines of an element set found in a text buffer.
+ *
+ * The pointers refer to the scanned buffer and are not terminated.
+ */
+typedef struct {
+    const gchar *name;    /*!< Name line or NULL for bare two line data. */
+    gsize        namelen; /*!< Length of the name line. */
+    const gchar *line1;   /*!< First line of the element set. */
+    gsize        len1;    /*!< Length of the first line. */
+    const gchar *line2;   /*!< Second line of the element set. */
+    gsize        len2;    /*!< Length of the second line. */
+} tle_lines_t;
+
+/** \brief Function called by tle_scan_buffer() for each element set. */
+typedef void (*tle_scan_func) (const tle_lines_t *lines, gpointer data);
+
+gboolean tle_line_checksum_ok (const gchar *line, gsize len);
+
+gint tle_lines_to_tle (const tle_lines_t *lines, tle_t *tle);
+
+guint tle_scan_buffer (const gchar *buf, gsize len,
+                       tle_scan_func func, gpointer data);
+
+
 #endif
@@ -27,15 +27,19 @@
 #include <glib/gi18n.h>
 #include <glib/gstdio.h>
 #include <gtk/gtk.h>
+#include <fcntl.h>
 #include <string.h>
+#ifdef G_OS_WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #ifdef HAVE_CONFIG_H
 #include <build-config.h>
 #endif
 #ifdef WIN32
 #include "win32-fetch.h"
-#else
-#include <curl/curl.h>
 #endif
 
 #include "compat.h"
@@ -43,30 +47,64 @@
 #include "sat-cfg.h"
 #include "sat-log.h"
 #include "sgpsdp/sgp4sdp4.h"
+#ifndef WIN32
+#include "tle-fetch.h"
+#endif
+#include "tle-tools.h"
 #include "tle-update.h"
 
 
 /* private function prototypes */
-#ifndef WIN32
-static size_t   my_write_func(void *ptr, size_t size, size_t nmemb,
-                              FILE * stream);
-#endif
-static gint     read_fresh_tle(const gchar * dir, const gchar * fnam,
-                               GHashTable * data);
+static guint    fetch_tle_files(gchar ** files, guint numfiles,
+                                const gchar * proxy, GKeyFile * srcdata,
+                                gboolean silent, GtkWidget * progress,
+                                GtkWidget * label1, guint * unchanged);
+static void     read_fresh_tle_files(GPtrArray * jobs, gboolean silent,
+                                     GtkWidget * label1);
+static void     sync_category_file(const gchar * fnam, GArray * catnums);
 static gboolean is_tle_file(const gchar * dir, const gchar * fnam);
 
 
 static void     update_tle_in_file(const gchar * ldname,
                                    const gchar * fname,
                                    GHashTable * data,
+                                   GPtrArray * staged,
                                    guint * sat_upd,
                                    guint * sat_ski,
                                    guint * sat_nod, guint * sat_tot);
 
-static guint    add_new_sats(GHashTable * data);
+static guint    add_new_sats(GHashTable * data, GPtrArray * staged);
+static guint    commit_staged_sats(GPtrArray * staged, guint * newfailed);
 static gboolean is_computer_generated_name(gchar * satname);
 
 
+/** Fresh TLE data read from one file by a worker thread. */
+typedef struct {
+    gchar          *path;       /*!< Full path of the file. */
+    gchar          *fnam;       /*!< File name. */
+    GHashTable     *data;       /*!< The TLE data read from the file. */
+    GArray         *catnums;    /*!< Catalog numbers in file order; NULL if not read. */
+} tle_file_job_t;
+
+/** A .sat file waiting to be written in the commit phase. */
+typedef struct {
+    gchar          *path;       /*!< Full path of the .sat file. */
+    gint            catnum;     /*!< Catalog number of the satellite. */
+    gboolean        isnew;      /*!< Whether the satellite is new. */
+    gchar          *data;       /*!< New contents of the file. */
+    gsize           len;        /*!< Length of the contents. */
+} staged_sat_t;
+
+/** Journal listing the .sat files of a commit that is in progress. */
+#define TLE_UPDATE_JOURNAL "tle-update.journal"
+
+/** Suffix of the .sat files written during the commit phase. */
+#define TLE_UPDATE_NEW_SUFFIX ".new"
+
+static guint    merge_fresh_tle_file(GHashTable * data, tle_file_job_t * job);
+static void     free_tle_file_job(tle_file_job_t * job);
+
+
 /** Free a new_tle_t structure. */
 static void free_new_tle(gpointer data)
 {
@@ -103,6 +141,8 @@ void tle_update_from_files(const gchar * dir, const gchar * filter,
     static GMutex   tle_file_in_progress;
 
     GHashTable     *data;       /* hash table with fresh TLE data */
+    GPtrArray      *jobs;       /* TLE files to read */
+    tle_file_job_t *job;
     GDir           *cache_dir;  /* directory to scan fresh TLE */
     GDir           *loc_dir;    /* directory for gpredict TLE files */
     GError         *err = NULL;
@@ -111,13 +151,17 @@ void tle_update_from_files(const gchar * dir, const gchar * filter,
     gchar          *userconfdir;
     const gchar    *fnam;
     guint           num = 0;
+    guint           i;
     guint           updated, updated_tmp;
     guint           skipped, skipped_tmp;
     guint           nodata, nodata_tmp;
     guint           newsats = 0;
+    guint           failed, newfailed;
     guint           total, total_tmp;
     gdouble         fraction = 0.0;
     gdouble         start = 0.0;
+    GPtrArray      *staged;     /* .sat files to be written */
+    gint64          t_read, t_diff, t_commit;   /* phase timestamps */
 
     (void)filter;
 
@@ -130,9 +174,13 @@ void tle_update_from_files(const gchar * dir, const gchar * filter,
         return;
     }
 
-    /* create hash table */
-    data = g_hash_table_new_full(g_int_hash, g_int_equal, g_free,
-                                 free_new_tle);
+    /* finish a commit interrupted by a crash before doing anything else */
+    tle_update_recover();
+
+    t_read = g_get_monotonic_time();
+
+    /* create hash table; the keys point to the catalog number in the data */
+    data = g_hash_table_new_full(g_int_hash, g_int_equal, NULL, free_new_tle);
 
     /* open directory and read files one by one */
     cache_dir = g_dir_open(dir, 0, &err);
@@ -160,54 +208,62 @@ void tle_update_from_files(const gchar * dir, const gchar * filter,
     else
     {
         /* scan directory for tle files */
+        jobs = g_ptr_array_new();
         while ((fnam = g_dir_read_name(cache_dir)) != NULL)
         {
             /* check that we got a TLE file */
             if (is_tle_file(dir, fnam))
             {
-                /* status message */
-                if (!silent && (label1 != NULL))
-                {
-                    text = g_strdup_printf(_("Reading data from %s"), fnam);
-                    gtk_label_set_text(GTK_LABEL(label1), text);
-                    g_free(text);
-
-                    /* Force the drawing queue to be processed otherwise there will
-                       not be any visual feedback, ie. frozen GUI
-                       - see Gtk+ FAQ http://www.gtk.org/faq/#AEN602
-                     */
-                    while (g_main_context_iteration(NULL, FALSE));
-
-                    /* give user a chance to follow progress */
-                    g_usleep(G_USEC_PER_SEC / 100);
-                }
-
-                /* now, do read the fresh data */
-                num = read_fresh_tle(dir, fnam, data);
+                job = g_new0(tle_file_job_t, 1);
+                job->path = g_strconcat(dir, G_DIR_SEPARATOR_S, fnam, NULL);
+                job->fnam = g_strdup(fnam);
+                g_ptr_array_add(jobs, job);
             }
             else
             {
-                num = 0;
+                sat_log_log(SAT_LOG_LEVEL_ERROR,
+                            _("%s: No valid TLE data found in %s"),
+                            __func__, fnam);
             }
+        }
+
+        /* close directory since we don't need it anymore */
+        g_dir_close(cache_dir);
+
+        /* now, do read the fresh data */
+        read_fresh_tle_files(jobs, silent, label1);
+
+        /* merge in directory order to resolve duplicates as before */
+        for (i = 0; i < jobs->len; i++)
+        {
+            job = g_ptr_array_index(jobs, i);
+
+            /* NB: not effective since 1.4 */
+            if (job->catnums != NULL)
+                sync_category_file(job->fnam, job->catnums);
 
+            num = merge_fresh_tle_file(data, job);
             if (num < 1)
             {
                 sat_log_log(SAT_LOG_LEVEL_ERROR,
                             _("%s: No valid TLE data found in %s"),
-                            __func__, fnam);
+                            __func__, job->fnam);
             }
             else
             {
                 sat_log_log(SAT_LOG_LEVEL_INFO,
                             _("%s: Read %d sats from %s into memory"),
-                            __func__, num, fnam);
+                            __func__, num, job->fnam);
             }
+
+            free_tle_file_job(job);
         }
+        g_ptr_array_free(jobs, TRUE);
 
-        /* close directory since we don't need it anymore */
-        g_dir_close(cache_dir);
+        t_diff = g_get_monotonic_time();
+        t_read = t_diff - t_read;
 
-        /* now we load each .sat file and update if we have new data */
+        /* now we load each .sat file and stage it if we have new data */
         userconfdir = get_user_conf_dir();
         ldname = g_strconcat(userconfdir, G_DIR_SEPARATOR_S, "satdata", NULL);
         g_free(userconfdir);
@@ -239,6 +295,7 @@ void tle_update_from_files(const gchar * dir, const gchar * filter,
         else
         {
             /* clear statistics */
+            staged = g_ptr_array_new();
             updated = 0;
             skipped = 0;
             nodata = 0;
@@ -275,7 +332,7 @@ void tle_update_from_files(const gchar * dir, const gchar * filter,
                     total_tmp = 0;
 
                     /* update TLE data in this file */
-                    update_tle_in_file(ldname, fnam, data,
+                    update_tle_in_file(ldname, fnam, data, staged,
                                        &updated_tmp,
                                        &skipped_tmp, &nodata_tmp, &total_tmp);
 
@@ -374,25 +431,48 @@ void tle_update_from_files(const gchar * dir, const gchar * filter,
 
             /* see if we have any new sats that need to be added */
             if (sat_cfg_get_bool(SAT_CFG_BOOL_TLE_ADD_NEW))
+                newsats = add_new_sats(data, staged);
+
+            t_commit = g_get_monotonic_time();
+            t_diff = t_commit - t_diff;
+
+            /* write all changes in one go */
+            if (!silent && (label1 != NULL))
+                gtk_label_set_text(GTK_LABEL(label1), _("Saving data..."));
+
+            failed = commit_staged_sats(staged, &newfailed);
+            if (failed > 0)
             {
-                newsats = add_new_sats(data);
+                /* count the satellites that have not been written */
+                skipped += failed - newfailed;
+                updated -= failed - newfailed;
+                newsats -= newfailed;
 
-                if (!silent && (label2 != NULL))
-                {
-                    text = g_strdup_printf(_("Satellites updated:\t %d\n"
-                                             "Satellites skipped:\t %d\n"
-                                             "Missing Satellites:\t %d\n"
-                                             "New Satellites:\t\t %d"),
-                                           updated, skipped, nodata, newsats);
-                    gtk_label_set_text(GTK_LABEL(label2), text);
-                    g_free(text);
-                }
+                if (!silent && (label1 != NULL))
+                    gtk_label_set_markup(GTK_LABEL(label1),
+                                         _("<b>ERROR</b> saving TLE data"));
+            }
+            g_ptr_array_free(staged, TRUE);
 
-                sat_log_log(SAT_LOG_LEVEL_INFO,
-                            _("%s: Added %d new satellites to local database"),
-                            __func__, newsats);
+            t_commit = g_get_monotonic_time() - t_commit;
+
+            if (!silent && (label2 != NULL))
+            {
+                text = g_strdup_printf(_("Satellites updated:\t %d\n"
+                                         "Satellites skipped:\t %d\n"
+                                         "Missing Satellites:\t %d\n"
+                                         "New Satellites:\t\t %d"),
+                                       updated, skipped, nodata, newsats);
+                gtk_label_set_text(GTK_LABEL(label2), text);
+                g_free(text);
             }
 
+            sat_log_log(SAT_LOG_LEVEL_INFO,
+                        _("%s: %d changed, %d skipped, %d obsolete, %d new; "
+                          "read %.1f ms, diff %.1f ms, commit %.1f ms"),
+                        __func__, updated, skipped, nodata, newsats,
+                        t_read / 1000.0, t_diff / 1000.0, t_commit / 1000.0);
+
             /* store time of update if we have updated something */
             if ((updated > 0) || (newsats > 0))
             {
@@ -414,322 +494,874 @@ void tle_update_from_files(const gchar * dir, const gchar * filter,
 }
 
 
-/** Check if satellite is new, if so, add it to local database */
-static void check_and_add_sat(gpointer key, gpointer value, gpointer user_data)
+/**
+ * Stage a .sat file for writing in the commit phase.
+ *
+ * @param staged Array of staged_sat_t.
+ * @param path Full path of the .sat file. Ownership is taken.
+ * @param catnum Catalog number of the satellite.
+ * @param isnew Whether the satellite is new.
+ * @param satdata The new contents.
+ */
+static void stage_sat_file(GPtrArray * staged, gchar * path, gint catnum,
+                           gboolean isnew, GKeyFile * satdata)
 {
-    new_tle_t      *ntle = (new_tle_t *) value;
-    guint          *num = user_data;
-    GKeyFile       *satdata;
-    gchar          *cfgfile;
-
-    (void)key;
-
-    /* check if sat is new */
-    if (!ntle->isnew)
-        return;
+    staged_sat_t   *sat;
+
+    sat = g_new(staged_sat_t, 1);
+    sat->path = path;
+    sat->catnum = catnum;
+    sat->isnew = isnew;
+    sat->data = g_key_file_to_data(satdata, &sat->len, NULL);
+    g_ptr_array_add(staged, sat);
+}
 
-    /* create config data */
-    satdata = g_key_file_new();
+/** Free a staged_sat_t structure. */
+static void free_staged_sat(gpointer data)
+{
+    staged_sat_t   *sat = (staged_sat_t *) data;
 
-    /* store data */
-    g_key_file_set_string(satdata, "Satellite", "VERSION", "1.1");
-    g_key_file_set_string(satdata, "Satellite", "NAME", ntle->satname);
-    g_key_file_set_string(satdata, "Satellite", "NICKNAME", ntle->satname);
-    g_key_file_set_string(satdata, "Satellite", "TLE1", ntle->line1);
-    g_key_file_set_string(satdata, "Satellite", "TLE2", ntle->line2);
-    g_key_file_set_integer(satdata, "Satellite", "STATUS", ntle->status);
+    g_free(sat->path);
+    g_free(sat->data);
+    g_free(sat);
+}
 
-    /* create an I/O channel and store data */
-    cfgfile = sat_file_name_from_catnum(ntle->catnum);
-    if (!gpredict_save_key_file(satdata, cfgfile))
-        *num += 1;
+/** Remove the temporary files of the first num staged .sat files. */
+static void remove_staged_sats(GPtrArray * staged, guint num)
+{
+    staged_sat_t   *sat;
+    gchar          *tmp;
+    guint           i;
 
-    /* clean up memory */
-    g_free(cfgfile);
-    g_key_file_free(satdata);
+    for (i = 0; i < num; i++)
+    {
+        sat = g_ptr_array_index(staged, i);
+        tmp = g_strconcat(sat->path, TLE_UPDATE_NEW_SUFFIX, NULL);
+        g_remove(tmp);
+        g_free(tmp);
+    }
 }
 
-/** Add new satellites to local database */
-static guint add_new_sats(GHashTable * data)
+/**
+ * Log the satellites whose .sat files could not be committed.
+ *
+ * @param staged Array of staged_sat_t.
+ * @param failed Flags of the failed files; NULL if all of them failed.
+ * @param newfailed OUT: number of failed files that belong to new satellites.
+ * @return The number of failed files.
+ */
+static guint log_failed_sats(GPtrArray * staged, const gboolean * failed,
+                             guint * newfailed)
 {
+    staged_sat_t   *sat;
+    GString        *catnums;
     guint           num = 0;
+    guint           i;
 
-    g_hash_table_foreach(data, check_and_add_sat, &num);
+    *newfailed = 0;
+    catnums = g_string_new(NULL);
+
+    for (i = 0; i < staged->len; i++)
+    {
+        if (failed != NULL && !failed[i])
+            continue;
+
+        sat = g_ptr_array_index(staged, i);
+        g_string_append_printf(catnums, " %d", sat->catnum);
+        if (sat->isnew)
+            (*newfailed)++;
+        num++;
+    }
+
+    if (num > 0)
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: %d of %d satellites have not been updated:%s"),
+                    __func__, num, staged->len, catnums->str);
+    g_string_free(catnums, TRUE);
 
     return num;
 }
 
 /**
- * Update TLE files from network.
+ * Flush a file or directory to disk.
  *
- * @param silent TRUE if function should execute without graphical status indicator.
- * @param progress Pointer to a GtkProgressBar progress indicator (can be NULL)
- * @param label1 GtkLabel for activity string.
- * @param label2 GtkLabel for statistics string.
+ * Directories cannot be opened on Windows; a rename there is written
+ * through once the file itself has been flushed.
  */
-void tle_update_from_network(gboolean silent,
-                             GtkWidget * progress,
-                             GtkWidget * label1, GtkWidget * label2)
+static gboolean sync_path(const gchar * path, gboolean isdir)
 {
-    static GMutex   tle_in_progress;
+    gboolean        ok;
+    int             fd;
 
-    gchar          *proxy = NULL;
-    gchar          *files_tmp;
-    gchar         **files;
-    guint           numfiles, i;
-    gchar          *curfile;
-    gchar          *locfile;
-    gchar          *userconfdir;
-#ifdef WIN32
-    int             res;
+#ifdef G_OS_WIN32
+    if (isdir)
+        return TRUE;
+
+    fd = g_open(path, O_RDWR | O_BINARY, 0);
+    if (fd < 0)
+        return FALSE;
+    ok = (_commit(fd) == 0);
 #else
-    CURL           *curl;
-    CURLcode        res;
-#endif
-    gdouble         fraction, start = 0;
-    FILE           *outfile;
-    GDir           *dir;
-    gchar          *cache;
-    const gchar    *fname;
-    gchar          *text;
-    GError         *err = NULL;
-    guint           success = 0;        /* no. of successfull downloads */
+    (void)isdir;
 
-    /* bail out if we are already in an update process */
-    if (g_mutex_trylock(&tle_in_progress) == FALSE)
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: TLE update is already running. Aborting."),
-                    __func__);
+    fd = g_open(path, O_RDONLY, 0);
+    if (fd < 0)
+        return FALSE;
+    ok = (fsync(fd) == 0);
+#endif
+    close(fd);
 
-        return;
-    }
+    return ok;
+}
 
-    /* get server, proxy, and list of files */
-    proxy = sat_cfg_get_str(SAT_CFG_STR_TLE_PROXY);
+/** Write a file and flush it to disk. */
+static gboolean write_synced(const gchar * path, const gchar * data,
+                             gsize len)
+{
+    GError         *err = NULL;
 
-    /* avoid empty proxy string (bug in <2.2) */
-    if (proxy != NULL && strlen(proxy) == 0)
+    if (!g_file_set_contents(path, data, len, &err))
     {
-        sat_cfg_reset_str(SAT_CFG_STR_TLE_PROXY);
-        g_free(proxy);
-        proxy = NULL;
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Error writing %s (%s)"),
+                    __func__, path, err->message);
+        g_clear_error(&err);
+        return FALSE;
     }
 
-    files_tmp = sat_cfg_get_str(SAT_CFG_STR_TLE_URLS);
-    files = g_strsplit(files_tmp, ";", 0);
-    numfiles = g_strv_length(files);
-
-    if (numfiles < 1)
+    if (!sync_path(path, FALSE))
     {
         sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: No files to fetch from network."), __func__);
-
-        /* set activity string, so user knows why nothing happens */
-        if (!silent && (label1 != NULL))
-        {
-            gtk_label_set_text(GTK_LABEL(label1),
-                               _("No files to fetch from network"));
-        }
+                    _("%s: Error flushing %s"), __func__, path);
+        return FALSE;
     }
-    else
-    {
-        /* initialise progress bar */
-        if (!silent && (progress != NULL))
-            start = gtk_progress_bar_get_fraction(GTK_PROGRESS_BAR(progress));
-
-#ifndef WIN32
-        /* initialise curl */
-        curl = curl_easy_init();
-        if (proxy != NULL)
-            curl_easy_setopt(curl, CURLOPT_PROXY, proxy);
-
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, "gpredict/curl");
-        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10);
-#endif
-
-        /* get files */
-        for (i = 0; i < numfiles; i++)
-        {
-            /* set URL */
-            curfile = g_strdup(files[i]);
-#ifndef WIN32
-            curl_easy_setopt(curl, CURLOPT_URL, curfile);
-#endif
-
-            /* set activity message */
-            if (!silent && (label1 != NULL))
-            {
 
-                text = g_strdup_printf(_("Fetching %s"), files[i]);
-                gtk_label_set_text(GTK_LABEL(label1), text);
-                g_free(text);
+    return TRUE;
+}
 
-                /* Force the drawing queue to be processed otherwise there will
-                   not be any visual feedback, ie. frozen GUI
-                   - see Gtk+ FAQ http://www.gtk.org/faq/#AEN602
-                 */
-                while (g_main_context_iteration(NULL, FALSE));
-            }
+/** Flush the directory of the .sat files, so that renames are on disk. */
+static gboolean sync_satdata_dir(void)
+{
+    gchar          *dirname;
+    gboolean        ok;
 
-            /* create local cache file ~/.config/Gpredict/satdata/cache/file-%d.tle */
-            userconfdir = get_user_conf_dir();
-            locfile = g_strdup_printf("%s%ssatdata%scache%sfile-%d.tle",
-                                      userconfdir, G_DIR_SEPARATOR_S,
-                                      G_DIR_SEPARATOR_S, G_DIR_SEPARATOR_S, i);
-            outfile = g_fopen(locfile, "wb");
-            if (outfile != NULL)
-            {
-#ifdef WIN32
-                res = win32_fetch(curfile, outfile, proxy, "gpredict/win32");
-                if (res != 0)
-                {
-                    sat_log_log(SAT_LOG_LEVEL_ERROR,
-                                _("%s: Error fetching %s (%x)"),
-                                __func__, curfile, res);
-                }
-                else
-                {
-                    sat_log_log(SAT_LOG_LEVEL_INFO,
-                                _("%s: Successfully fetched %s"),
-                                __func__, curfile);
-                    success++;
-                }
-#else
-                curl_easy_setopt(curl, CURLOPT_WRITEDATA, outfile);
-                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, my_write_func);
+    dirname = get_satdata_dir();
+    ok = sync_path(dirname, TRUE);
+    if (!ok)
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Error flushing %s"), __func__, dirname);
+    g_free(dirname);
 
-                /* get file */
-                res = curl_easy_perform(curl);
+    return ok;
+}
 
-                if (res != CURLE_OK)
-                {
-                    sat_log_log(SAT_LOG_LEVEL_ERROR,
-                                _("%s: Error fetching %s (%s)"),
-                                __func__, curfile, curl_easy_strerror(res));
-                }
-                else
-                {
-                    sat_log_log(SAT_LOG_LEVEL_INFO,
-                                _("%s: Successfully fetched %s"),
-                                __func__, curfile);
-                    success++;
-                }
-#endif
-                fclose(outfile);
-            }
-            else
-            {
-                sat_log_log(SAT_LOG_LEVEL_INFO,
-                            _("%s: Failed to open %s preventing update"),
-                            __func__, locfile);
-            }
-            /* update progress indicator */
-            if (!silent && (progress != NULL))
-            {
+/**
+ * Write the staged .sat files.
+ *
+ * @param staged Array of staged_sat_t. The elements are freed.
+ * @param newfailed OUT: number of new satellites that have not been written.
+ * @return The number of .sat files that have not been written; 0 if all
+ *         changes have been committed.
+ *
+ * The new contents are first written next to the .sat files and flushed to
+ * disk together with their directory. Only then a journal listing the files
+ * is written and flushed, the files are renamed into place and the journal
+ * is removed. If gpredict is interrupted before the journal exists the old
+ * data is kept; otherwise tle_update_recover() completes the renames on the
+ * next start, and every file it renames is complete. If a rename fails the
+ * journal is kept, so that it is retried on the next start.
+ */
+static guint commit_staged_sats(GPtrArray * staged, guint * newfailed)
+{
+    staged_sat_t   *sat;
+    GString        *journal;
+    gboolean       *failed;
+    gchar          *jpath;
+    gchar          *tmp;
+    guint           i;
+    guint           num;
+    gboolean        ok;
 
-                /* complete download corresponds to 50% */
-                fraction = start + (0.5 - start) * i / (1.0 * numfiles);
-                gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(progress),
-                                              fraction);
+    g_ptr_array_set_free_func(staged, free_staged_sat);
 
-                /* Force the drawing queue to be processed otherwise there will
-                   not be any visual feedback, ie. frozen GUI
-                   - see Gtk+ FAQ http://www.gtk.org/faq/#AEN602
-                 */
-                while (g_main_context_iteration(NULL, FALSE));
-            }
+    *newfailed = 0;
+    if (staged->len == 0)
+        return 0;
 
-            g_free(userconfdir);
-            g_free(curfile);
-            g_free(locfile);
-        }
+    journal = g_string_new(NULL);
 
-#ifndef WIN32
-        curl_easy_cleanup(curl);
-#endif
+    /* write the new files */
+    for (i = 0; i < staged->len; i++)
+    {
+        sat = g_ptr_array_index(staged, i);
+        tmp = g_strconcat(sat->path, TLE_UPDATE_NEW_SUFFIX, NULL);
+        ok = write_synced(tmp, sat->data, sat->len);
+        g_free(tmp);
 
-        /* continue update if we have fetched at least one file */
-        if (success > 0)
-        {
-            sat_log_log(SAT_LOG_LEVEL_INFO,
-                        _("%s: Fetched %d files from network; updating..."),
-                        __func__, success);
-            /* call update_from_files */
-            cache = sat_file_name("cache");
-            tle_update_from_files(cache, NULL, silent, progress, label1,
-                                  label2);
-            g_free(cache);
-        }
-        else
+        if (!ok)
         {
-            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _
-                        ("%s: Could not fetch TLE files from network. Aborting."),
-                        __func__);
+            remove_staged_sats(staged, i + 1);
+            g_string_free(journal, TRUE);
+            return log_failed_sats(staged, NULL, newfailed);
         }
 
+        g_string_append_printf(journal, "%s\n", sat->path);
     }
 
-    /* clear cache and memory */
-    g_strfreev(files);
-    g_free(files_tmp);
-    if (proxy != NULL)
-        g_free(proxy);
-
-    /* open cache */
-    cache = sat_file_name("cache");
-    dir = g_dir_open(cache, 0, &err);
-
-    if (err != NULL)
+    /* the journal may only refer to files that are on disk */
+    jpath = sat_file_name(TLE_UPDATE_JOURNAL);
+    if (!sync_satdata_dir() ||
+        !write_synced(jpath, journal->str, journal->len) ||
+        !sync_satdata_dir())
     {
-        /* send an error message */
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: Error opening %s (%s)"),
-                    __func__, dir, err->message);
-        g_clear_error(&err);
+        g_remove(jpath);
+        remove_staged_sats(staged, staged->len);
+        g_string_free(journal, TRUE);
+        g_free(jpath);
+        return log_failed_sats(staged, NULL, newfailed);
     }
-    else
+    g_string_free(journal, TRUE);
+
+    /* from here on the update will be completed */
+    failed = g_new0(gboolean, staged->len);
+    for (i = 0; i < staged->len; i++)
     {
-        /* delete files in cache one by one */
-        while ((fname = g_dir_read_name(dir)) != NULL)
+        sat = g_ptr_array_index(staged, i);
+        tmp = g_strconcat(sat->path, TLE_UPDATE_NEW_SUFFIX, NULL);
+        if (g_rename(tmp, sat->path) != 0)
         {
-
-            locfile = g_strconcat(cache, G_DIR_SEPARATOR_S, fname, NULL);
-            if (g_remove(locfile))
-                    sat_log_log(SAT_LOG_LEVEL_ERROR,
-                                _("%s: Failed to remove %s"), __func__, locfile);
-            g_free(locfile);
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s: Error renaming %s"), __func__, tmp);
+            failed[i] = TRUE;
         }
-        /* close cache */
-        g_dir_close(dir);
+        g_free(tmp);
     }
 
-    g_free(cache);
-    g_mutex_unlock(&tle_in_progress);
+    num = log_failed_sats(staged, failed, newfailed);
+    g_free(failed);
+
+    /* keep the journal until the renames are on disk, and so that failed
+       renames are retried */
+    if (num == 0 && sync_satdata_dir())
+        g_remove(jpath);
+    g_free(jpath);
+
+    return num;
 }
 
-#ifndef WIN32
 /**
- * Write TLE data block to file.
+ * Complete or roll back an interrupted TLE update.
  *
- * @param ptr Pointer to the data block to be written.
- * @param size Size of data block.
- * @param nmemb Size multiplier?
- * @param stream Pointer to the file handle.
- * @return The number of bytes actually written.
- *
- * This function writes the received data to the file pointed to by stream.
- * It is used as write callback by to curl exec function.
+ * If a journal exists the .sat files listed in it are renamed into place.
+ * Left over new files without a journal belong to an incomplete commit
+ * and are removed.
  */
-static size_t my_write_func(void *ptr, size_t size, size_t nmemb,
-                            FILE * stream)
+void tle_update_recover(void)
 {
-    /*** FIXME: TBC whether this works in wintendo */
-    return fwrite(ptr, size, nmemb, stream);
-}
-#endif
-
+    GDir           *dir;
+    gchar          *dirname;
+    gchar          *jpath;
+    gchar          *contents;
+    gchar         **paths;
+    gchar          *tmp;
+    const gchar    *fnam;
+    guint           i;
+    gboolean        ok = TRUE;
+
+    jpath = sat_file_name(TLE_UPDATE_JOURNAL);
+    if (g_file_get_contents(jpath, &contents, NULL, NULL))
+    {
+        sat_log_log(SAT_LOG_LEVEL_WARN,
+                    _("%s: Completing interrupted TLE update"), __func__);
+
+        paths = g_strsplit(contents, "\n", 0);
+        g_free(contents);
+
+        for (i = 0; paths[i] != NULL; i++)
+        {
+            if (paths[i][0] == '\0')
+                continue;
+
+            tmp = g_strconcat(paths[i], TLE_UPDATE_NEW_SUFFIX, NULL);
+            if (g_file_test(tmp, G_FILE_TEST_EXISTS) &&
+                g_rename(tmp, paths[i]) != 0)
+            {
+                sat_log_log(SAT_LOG_LEVEL_ERROR,
+                            _("%s: Error renaming %s"), __func__, tmp);
+                ok = FALSE;
+            }
+            g_free(tmp);
+        }
+        g_strfreev(paths);
+
+        if (!ok || !sync_satdata_dir())
+        {
+            g_free(jpath);
+            return;
+        }
+
+        g_remove(jpath);
+    }
+    g_free(jpath);
+
+    /* remove files from an incomplete commit */
+    dirname = get_satdata_dir();
+    dir = g_dir_open(dirname, 0, NULL);
+    if (dir != NULL)
+    {
+        while ((fnam = g_dir_read_name(dir)) != NULL)
+        {
+            if (g_str_has_suffix(fnam, ".sat" TLE_UPDATE_NEW_SUFFIX))
+            {
+                tmp = sat_file_name(fnam);
+                g_remove(tmp);
+                g_free(tmp);
+            }
+        }
+        g_dir_close(dir);
+    }
+    g_free(dirname);
+}
+
+/** Check if satellite is new, if so, stage it for the local database */
+static void check_and_add_sat(gpointer key, gpointer value, gpointer user_data)
+{
+    new_tle_t      *ntle = (new_tle_t *) value;
+    GPtrArray      *staged = user_data;
+    GKeyFile       *satdata;
+
+    (void)key;
+
+    /* check if sat is new */
+    if (!ntle->isnew)
+        return;
+
+    /* create config data */
+    satdata = g_key_file_new();
+
+    /* store data */
+    g_key_file_set_string(satdata, "Satellite", "VERSION", "1.1");
+    g_key_file_set_string(satdata, "Satellite", "NAME", ntle->satname);
+    g_key_file_set_string(satdata, "Satellite", "NICKNAME", ntle->satname);
+    g_key_file_set_string(satdata, "Satellite", "TLE1", ntle->line1);
+    g_key_file_set_string(satdata, "Satellite", "TLE2", ntle->line2);
+    g_key_file_set_integer(satdata, "Satellite", "STATUS", ntle->status);
+
+    stage_sat_file(staged, sat_file_name_from_catnum(ntle->catnum),
+                   ntle->catnum, TRUE, satdata);
+
+    /* clean up memory */
+    g_key_file_free(satdata);
+}
+
+/** Stage new satellites for the local database */
+static guint add_new_sats(GHashTable * data, GPtrArray * staged)
+{
+    guint           num = staged->len;
+
+    g_hash_table_foreach(data, check_and_add_sat, staged);
+
+    return staged->len - num;
+}
+
+/** Name of the file storing the HTTP cache validators of the TLE sources. */
+static gchar   *source_data_file_name(void)
+{
+    return sat_file_name("tle-sources.cfg");
+}
+
+/**
+ * Load the download history of the TLE sources.
+ *
+ * The key file has one group per source URL holding the ETag and
+ * Last-Modified time from the last successful download, which are used
+ * to make conditional requests, as well as the size and duration of the
+ * last transfer.
+ */
+static GKeyFile *load_source_data(void)
+{
+    GKeyFile       *srcdata;
+    gchar          *path;
+
+    srcdata = g_key_file_new();
+    path = source_data_file_name();
+
+    /* the file does not exist before the first update */
+    if (g_file_test(path, G_FILE_TEST_EXISTS))
+        g_key_file_load_from_file(srcdata, path, G_KEY_FILE_NONE, NULL);
+
+    g_free(path);
+
+    return srcdata;
+}
+
+/** Save the download history of the TLE sources. */
+static void save_source_data(GKeyFile * srcdata)
+{
+    gchar          *path;
+
+    path = source_data_file_name();
+    gpredict_save_key_file(srcdata, path);
+    g_free(path);
+}
+
+/** Create the name of the local cache file for source number idx. */
+static gchar   *cache_file_name(guint idx)
+{
+    gchar          *userconfdir;
+    gchar          *locfile;
+
+    /* ~/.config/Gpredict/satdata/cache/file-%d.tle */
+    userconfdir = get_user_conf_dir();
+    locfile = g_strdup_printf("%s%ssatdata%scache%sfile-%d.tle",
+                              userconfdir, G_DIR_SEPARATOR_S,
+                              G_DIR_SEPARATOR_S, G_DIR_SEPARATOR_S, idx);
+    g_free(userconfdir);
+
+    return locfile;
+}
+
+/** Create the name of the file keeping the last download of a source. */
+static gchar   *source_file_name(const gchar * url)
+{
+    gchar          *hash;
+    gchar          *fnam;
+    gchar          *path;
+
+    /* ~/.config/Gpredict/satdata/sources/<sha1 of url>.tle */
+    hash = g_compute_checksum_for_string(G_CHECKSUM_SHA1, url, -1);
+    fnam = g_strdup_printf("sources%s%s.tle", G_DIR_SEPARATOR_S, hash);
+    path = sat_file_name(fnam);
+    g_free(fnam);
+    g_free(hash);
+
+    return path;
+}
+
+/**
+ * Forget the cache validators of sources whose last download is gone.
+ *
+ * A conditional request would be answered with 304 Not Modified, leaving
+ * nothing to read the satellites of the source from.
+ */
+static void check_source_validators(gchar ** files, guint numfiles,
+                                    GKeyFile * srcdata)
+{
+    gchar          *path;
+    guint           i;
+
+    for (i = 0; i < numfiles; i++)
+    {
+        path = source_file_name(files[i]);
+        if (!g_file_test(path, G_FILE_TEST_IS_REGULAR))
+        {
+            g_key_file_remove_key(srcdata, files[i], "ETAG", NULL);
+            g_key_file_remove_key(srcdata, files[i], "LAST_MODIFIED", NULL);
+        }
+        g_free(path);
+    }
+}
+
+/**
+ * Keep the downloaded sources and read the others from their last download.
+ *
+ * A source that has not been modified, or could not be fetched, has no
+ * file in the cache. Its last download is put there instead, so that its
+ * satellites are found in the fresh data rather than reported as obsolete.
+ * The downloads of sources that are no longer used are removed.
+ */
+static void retain_source_files(gchar ** files, guint numfiles)
+{
+    GHashTable     *used;
+    GDir           *dir;
+    const gchar    *fnam;
+    gchar          *dirname;
+    gchar          *locfile;
+    gchar          *srcfile;
+    guint           i;
+
+    dirname = sat_file_name("sources");
+    if (g_mkdir_with_parents(dirname, 0755) != 0)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Could not create %s"), __func__, dirname);
+        g_free(dirname);
+        return;
+    }
+
+    used = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    for (i = 0; i < numfiles; i++)
+    {
+        locfile = cache_file_name(i);
+        srcfile = source_file_name(files[i]);
+
+        if (g_file_test(locfile, G_FILE_TEST_IS_REGULAR))
+            gpredict_file_copy(locfile, srcfile);
+        else if (g_file_test(srcfile, G_FILE_TEST_IS_REGULAR))
+            gpredict_file_copy(srcfile, locfile);
+
+        g_hash_table_add(used, g_path_get_basename(srcfile));
+        g_free(srcfile);
+        g_free(locfile);
+    }
+
+    dir = g_dir_open(dirname, 0, NULL);
+    if (dir != NULL)
+    {
+        while ((fnam = g_dir_read_name(dir)) != NULL)
+        {
+            if (!g_hash_table_contains(used, fnam))
+            {
+                srcfile = g_build_filename(dirname, fnam, NULL);
+                g_remove(srcfile);
+                g_free(srcfile);
+            }
+        }
+        g_dir_close(dir);
+    }
+
+    g_hash_table_destroy(used);
+    g_free(dirname);
+}
+
+/** Update the progress indicator; downloading corresponds to 50%. */
+static void update_fetch_progress(GtkWidget * progress, gdouble start,
+                                  guint done, guint numfiles)
+{
+    gdouble         fraction;
+
+    fraction = start + (0.5 - start) * done / (1.0 * numfiles);
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(progress), fraction);
+
+    /* Force the drawing queue to be processed otherwise there will
+       not be any visual feedback, ie. frozen GUI
+       - see Gtk+ FAQ http://www.gtk.org/faq/#AEN602
+     */
+    while (g_main_context_iteration(NULL, FALSE));
+}
+
+#ifdef WIN32
+/**
+ * Download TLE files into the cache directory.
+ *
+ * @param files NULL terminated list of URLs.
+ * @param numfiles The number of URLs in files.
+ * @param proxy Proxy server or NULL.
+ * @param srcdata Download history of the sources.
+ * @param silent TRUE if function should execute without graphical status indicator.
+ * @param progress Pointer to a GtkProgressBar progress indicator (can be NULL)
+ * @param label1 GtkLabel for activity string.
+ * @param unchanged OUT: number of sources not modified since last download.
+ * @return The number of files downloaded.
+ *
+ * The win32 fetcher does not support conditional requests, so the files are
+ * downloaded one by one and unchanged is always 0.
+ */
+static guint fetch_tle_files(gchar ** files, guint numfiles,
+                             const gchar * proxy, GKeyFile * srcdata,
+                             gboolean silent, GtkWidget * progress,
+                             GtkWidget * label1, guint * unchanged)
+{
+    gchar          *locfile;
+    gchar          *text;
+    FILE           *outfile;
+    gdouble         start = 0.0;
+    gint64          t0;
+    guint           success = 0;
+    guint           i;
+    int             res;
+
+    (void)srcdata;
+
+    *unchanged = 0;
+
+    if (!silent && (progress != NULL))
+        start = gtk_progress_bar_get_fraction(GTK_PROGRESS_BAR(progress));
+
+    for (i = 0; i < numfiles; i++)
+    {
+        /* set activity message */
+        if (!silent && (label1 != NULL))
+        {
+            text = g_strdup_printf(_("Fetching %s"), files[i]);
+            gtk_label_set_text(GTK_LABEL(label1), text);
+            g_free(text);
+
+            while (g_main_context_iteration(NULL, FALSE));
+        }
+
+        locfile = cache_file_name(i);
+        outfile = g_fopen(locfile, "wb");
+        if (outfile != NULL)
+        {
+            t0 = g_get_monotonic_time();
+            res = win32_fetch(files[i], outfile, (gchar *) proxy,
+                              "gpredict/win32");
+            if (res != 0)
+            {
+                sat_log_log(SAT_LOG_LEVEL_ERROR,
+                            _("%s: Error fetching %s (%x)"),
+                            __func__, files[i], res);
+                fclose(outfile);
+                outfile = NULL;
+                g_remove(locfile);
+            }
+            else
+            {
+                sat_log_log(SAT_LOG_LEVEL_INFO,
+                            _("%s: Successfully fetched %s (%ld bytes in %.2f s)"),
+                            __func__, files[i], ftell(outfile),
+                            (g_get_monotonic_time() - t0) / 1.0e6);
+                success++;
+            }
+            if (outfile != NULL)
+                fclose(outfile);
+        }
+        else
+        {
+            sat_log_log(SAT_LOG_LEVEL_INFO,
+                        _("%s: Failed to open %s preventing update"),
+                        __func__, locfile);
+        }
+
+        if (!silent && (progress != NULL))
+            update_fetch_progress(progress, start, i, numfiles);
+
+        g_free(locfile);
+    }
+
+    return success;
+}
+#else
+/** State of the progress indicator while downloading. */
+typedef struct {
+    GtkWidget      *progress;   /*!< GtkProgressBar or NULL */
+    gdouble         start;      /*!< Fraction when the download started */
+} fetch_progress_t;
+
+/** Progress callback of tle_fetch_files; keeps the GUI alive. */
+static void fetch_progress_cb(guint done, guint numfiles, gpointer data)
+{
+    fetch_progress_t *fp = (fetch_progress_t *) data;
+
+    if (fp->progress != NULL)
+        update_fetch_progress(fp->progress, fp->start, done, numfiles);
+    else
+        while (g_main_context_iteration(NULL, FALSE));
+}
+
+/**
+ * Download TLE files into the cache directory.
+ *
+ * @param files NULL terminated list of URLs.
+ * @param numfiles The number of URLs in files.
+ * @param proxy Proxy server or NULL.
+ * @param srcdata Download history of the sources, updated with the results.
+ * @param silent TRUE if function should execute without graphical status indicator.
+ * @param progress Pointer to a GtkProgressBar progress indicator (can be NULL)
+ * @param label1 GtkLabel for activity string.
+ * @param unchanged OUT: number of sources not modified since last download.
+ * @return The number of files downloaded.
+ *
+ * The files are downloaded concurrently and conditionally by
+ * tle_fetch_files.
+ */
+static guint fetch_tle_files(gchar ** files, guint numfiles,
+                             const gchar * proxy, GKeyFile * srcdata,
+                             gboolean silent, GtkWidget * progress,
+                             GtkWidget * label1, guint * unchanged)
+{
+    fetch_progress_t fp;
+    gchar         **locfiles;
+    gchar          *text;
+    guint           success;
+    guint           i;
+
+    fp.progress = silent ? NULL : progress;
+    fp.start = 0.0;
+
+    if (fp.progress != NULL)
+        fp.start = gtk_progress_bar_get_fraction(GTK_PROGRESS_BAR(progress));
+
+    if (!silent && (label1 != NULL))
+    {
+        text = g_strdup_printf(_("Fetching %d files"), numfiles);
+        gtk_label_set_text(GTK_LABEL(label1), text);
+        g_free(text);
+
+        while (g_main_context_iteration(NULL, FALSE));
+    }
+
+    locfiles = g_new0(gchar *, numfiles + 1);
+    for (i = 0; i < numfiles; i++)
+        locfiles[i] = cache_file_name(i);
+
+    success = tle_fetch_files(files, locfiles, numfiles, proxy, srcdata,
+                              silent ? NULL : fetch_progress_cb, &fp,
+                              unchanged);
+    g_strfreev(locfiles);
+
+    return success;
+}
+#endif
+
+/**
+ * Update TLE files from network.
+ *
+ * @param silent TRUE if function should execute without graphical status indicator.
+ * @param progress Pointer to a GtkProgressBar progress indicator (can be NULL)
+ * @param label1 GtkLabel for activity string.
+ * @param label2 GtkLabel for statistics string.
+ */
+void tle_update_from_network(gboolean silent,
+                             GtkWidget * progress,
+                             GtkWidget * label1, GtkWidget * label2)
+{
+    static GMutex   tle_in_progress;
+
+    gchar          *proxy = NULL;
+    gchar          *files_tmp;
+    gchar         **files;
+    guint           numfiles;
+    gchar          *locfile;
+    GKeyFile       *srcdata;
+    GDir           *dir;
+    gchar          *cache;
+    const gchar    *fname;
+    GError         *err = NULL;
+    guint           success = 0;        /* no. of successfull downloads */
+    guint           unchanged = 0;      /* no. of sources not modified */
+
+    /* bail out if we are already in an update process */
+    if (g_mutex_trylock(&tle_in_progress) == FALSE)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: TLE update is already running. Aborting."),
+                    __func__);
+
+        return;
+    }
+
+    /* get server, proxy, and list of files */
+    proxy = sat_cfg_get_str(SAT_CFG_STR_TLE_PROXY);
+
+    /* avoid empty proxy string (bug in <2.2) */
+    if (proxy != NULL && strlen(proxy) == 0)
+    {
+        sat_cfg_reset_str(SAT_CFG_STR_TLE_PROXY);
+        g_free(proxy);
+        proxy = NULL;
+    }
+
+    files_tmp = sat_cfg_get_str(SAT_CFG_STR_TLE_URLS);
+    files = g_strsplit(files_tmp, ";", 0);
+    numfiles = g_strv_length(files);
+
+    if (numfiles < 1)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: No files to fetch from network."), __func__);
+
+        /* set activity string, so user knows why nothing happens */
+        if (!silent && (label1 != NULL))
+        {
+            gtk_label_set_text(GTK_LABEL(label1),
+                               _("No files to fetch from network"));
+        }
+    }
+    else
+    {
+        /* download the files; sources that have not changed since the
+           last update are skipped */
+        srcdata = load_source_data();
+        check_source_validators(files, numfiles, srcdata);
+        success = fetch_tle_files(files, numfiles, proxy, srcdata,
+                                  silent, progress, label1, &unchanged);
+
+        /* continue update if we have fetched at least one file */
+        if (success > 0)
+        {
+            sat_log_log(SAT_LOG_LEVEL_INFO,
+                        _("%s: Fetched %d files from network; updating..."),
+                        __func__, success);
+            retain_source_files(files, numfiles);
+
+            /* call update_from_files */
+            cache = sat_file_name("cache");
+            tle_update_from_files(cache, NULL, silent, progress, label1,
+                                  label2);
+            g_free(cache);
+
+            /* the cache validators are only valid once the data is stored */
+            save_source_data(srcdata);
+        }
+        else if (unchanged > 0)
+        {
+            sat_log_log(SAT_LOG_LEVEL_INFO,
+                        _("%s: TLE sources have not changed since last update"),
+                        __func__);
+
+            if (!silent && (label1 != NULL))
+            {
+                gtk_label_set_text(GTK_LABEL(label1),
+                                   _("TLE data is already up to date"));
+            }
+
+            sat_cfg_set_int(SAT_CFG_INT_TLE_LAST_UPDATE,
+                            g_get_real_time() / G_USEC_PER_SEC);
+            save_source_data(srcdata);
+        }
+        else
+        {
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _
+                        ("%s: Could not fetch TLE files from network. Aborting."),
+                        __func__);
+        }
+
+        g_key_file_free(srcdata);
+    }
+
+    /* clear cache and memory */
+    g_strfreev(files);
+    g_free(files_tmp);
+    if (proxy != NULL)
+        g_free(proxy);
+
+    /* open cache */
+    cache = sat_file_name("cache");
+    dir = g_dir_open(cache, 0, &err);
+
+    if (err != NULL)
+    {
+        /* send an error message */
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Error opening %s (%s)"),
+                    __func__, dir, err->message);
+        g_clear_error(&err);
+    }
+    else
+    {
+        /* delete files in cache one by one */
+        while ((fname = g_dir_read_name(dir)) != NULL)
+        {
+
+            locfile = g_strconcat(cache, G_DIR_SEPARATOR_S, fname, NULL);
+            if (g_remove(locfile))
+                    sat_log_log(SAT_LOG_LEVEL_ERROR,
+                                _("%s: Failed to remove %s"), __func__, locfile);
+            g_free(locfile);
+        }
+        /* close cache */
+        g_dir_close(dir);
+    }
+
+    g_free(cache);
+    g_mutex_unlock(&tle_in_progress);
+}
+
+
 /**
  * Check whether file is TLE file.
  * @param dir The directory.
@@ -762,364 +1394,321 @@ static gboolean is_tle_file(const gchar * dir, const gchar * fnam)
 }
 
 /**
- * Read fresh TLE data into hash table.
+ * Merge a freshly read TLE into a hash table.
  *
- * @param dir The directory to read from.
- * @param fnam The name of the file to read from.
- * @param fresh_data Hash table where the data should be stored.
- * @return The number of satellites successfully read.
- * 
- * This function will read fresh TLE data from local files into memory.
- * If there is a saetllite category (.cat file) with the same name as the
- * input file it will also update the satellites in that category.
+ * @param data Hash table with the fresh data.
+ * @param ntle The new TLE. Ownership is taken.
+ * @return TRUE if the satellite was not in the hash table before.
+ *
+ * If the satellite is already in the hash table the data is merged:
+ *   - if the epochs are equal the operational status is merged
+ *   - if the new epoch is more recent the elements are replaced
+ *   - a computer generated name is replaced by a real name
+ *
+ * The key of the hash table is the catalog number stored in the value.
  */
-static gint read_fresh_tle(const gchar * dir, const gchar * fnam,
-                           GHashTable * data)
+static gboolean merge_fresh_tle(GHashTable * data, new_tle_t * ntle)
 {
-    new_tle_t      *ntle;
-    tle_t           tle;
-    gchar          *path;
-    gchar           tle_str[3][80];
-    gchar           tle_working[3][80];
-    gchar           linetmp[80];
-    guint           linesneeded = 3;
-    gchar           catstr[6];
-    gchar           idstr[7] = "\0\0\0\0\0\0\0", idyearstr[3];
-    gchar          *b;
-    FILE           *fp;
-    gint            retcode = 0;
-    guint           catnr, i, idyear;
-    guint          *key = NULL;
+    new_tle_t      *otle;
+    gchar          *tmp;
 
-    /* category sync related */
-    gchar          *catname, *catpath, *buff, **buffv;
-    FILE           *catfile;
-    gchar           category[80];
-    gboolean        catsync = FALSE;    /* whether .cat file should be synced. NB: not effective since 1.4 */
-
-    /* 
-       Normal cases to check
-       1. 3 line tle file as in amatuer.txt from celestrak
-       2. 2 line tle file as in .... from celestrak
-
-       corner cases to check 
-       1. 3 line tle with something at the end. (nasa.all from amsat)
-       2. 2 line tle with only one in the file
-       3. 2 line tle file reading the last one.
-     */
+    otle = g_hash_table_lookup(data, &ntle->catnum);
 
-    path = g_strconcat(dir, G_DIR_SEPARATOR_S, fnam, NULL);
-    fp = g_fopen(path, "r");
-    if (fp != NULL)
+    /* check if satellite already in hash table */
+    if (otle == NULL)
     {
-        /* Prepare .cat file for sync while we read data */
-        buffv = g_strsplit(fnam, ".", 0);
-        catname = g_strconcat(buffv[0], ".cat", NULL);
-        g_strfreev(buffv);
-        catpath = sat_file_name(catname);
-        g_free(catname);
-
-        /* read category name for catfile */
-        catfile = g_fopen(catpath, "r");
-        if (catfile != NULL)
-        {
-            b = fgets(category, 80, catfile);
-            if (b == NULL)
-            {
-                sat_log_log(SAT_LOG_LEVEL_ERROR,
-                            _("%s:%s: There is no category in %s"),
-                            __FILE__, __func__, catpath);
-            }
-            fclose(catfile);
-            catsync = TRUE;
-        }
-        else
+        g_hash_table_insert(data, &ntle->catnum, ntle);
+        return TRUE;
+    }
+
+    /* time merge */
+    if (otle->epoch == ntle->epoch)
+    {
+        /* if satellite epoch has the same time,  merge status as appropriate */
+        if (otle->status != ntle->status)
         {
-            /* There is no category with this name (could be update from custom file) */
-            sat_log_log(SAT_LOG_LEVEL_INFO,
-                        _("%s:%s: There is no category called %s"),
-                        __FILE__, __func__, fnam);
+            /* log if there is something funny about the data coming in */
+            sat_log_log(SAT_LOG_LEVEL_WARN,
+                        _
+                        ("%s:%s: Two different statuses for %d (%s) at the same time."),
+                        __FILE__, __func__, otle->catnum, otle->satname);
+            if (ntle->status != OP_STAT_UNKNOWN)
+                otle->status = ntle->status;
         }
+    }
+    else if (otle->epoch < ntle->epoch)
+    {
+        /* if the satellite in the hash is older than 
+           the one just loaded, swap the values over. */
+        otle->epoch = ntle->epoch;
+        otle->status = ntle->status;
+        tmp = otle->line1;
+        otle->line1 = ntle->line1;
+        ntle->line1 = tmp;
+        tmp = otle->line2;
+        otle->line2 = ntle->line2;
+        ntle->line2 = tmp;
+        tmp = otle->srcfile;
+        otle->srcfile = ntle->srcfile;
+        ntle->srcfile = tmp;
+        otle->isnew = TRUE;     /* flag will be reset when using data */
+    }
 
-        /* reopen a new catfile and write category name */
-        if (catsync)
-        {
-            catfile = g_fopen(catpath, "w");
-            if (catfile != NULL)
-            {
-                fputs(category, catfile);
-            }
-            else
-            {
-                catsync = FALSE;
-                sat_log_log(SAT_LOG_LEVEL_ERROR,
-                            _
-                            ("%s:%s: Could not reopen .cat file while reading TLE from %s"),
-                            __FILE__, __func__, fnam);
-            }
+    /* merge based on name */
+    if (is_computer_generated_name(otle->satname) &&
+        !is_computer_generated_name(ntle->satname))
+    {
+        tmp = otle->satname;
+        otle->satname = ntle->satname;
+        ntle->satname = tmp;
+    }
 
-            /* .cat file now contains the category name;
-               satellite catnums will be added during update in the while loop */
-        }
+    free_new_tle(ntle);
 
-        /* set b to non-null as a flag */
-        b = path;
+    return FALSE;
+}
 
-        /* read lines from tle file */
-        while (fgets(linetmp, 80, fp))
-        {
-            /*read in the number of lines needed to potentially get to a new tle */
-            switch (linesneeded)
-            {
-            case 3:
-                strncpy(tle_working[0], linetmp, 80);
-                tle_working[0][79] = 0;         // make coverity happy
-                /* b is being used a flag here
-                   if b==NULL then we only have one line read in 
-                   and there is no way we have a full tle as there 
-                   is only one line in the buffer.
-                   A TLE must be two or three lines.
-                 */
-                b = fgets(tle_working[1], 80, fp);
-                if (b == NULL)
-                {
-                    /* make sure there is no junk in tle_working[1] */
-                    tle_working[1][0] = '\0';
-                    break;
-                }
-                /* make sure there is no junk in tle_working[2] */
-                if (fgets(tle_working[2], 80, fp) == NULL)
-                {
-                    tle_working[2][0] = '\0';
-                }
+/**
+ * Store one TLE found by tle_scan_buffer().
+ *
+ * @param lines The lines of the TLE within the mapped file.
+ * @param data Pointer to the tle_file_job_t.
+ */
+static void add_fresh_tle(const tle_lines_t * lines, gpointer data)
+{
+    tle_file_job_t *job = (tle_file_job_t *) data;
+    new_tle_t      *ntle;
+    tle_t           tle;
 
-                break;
-            case 2:
-                strncpy(tle_working[0], tle_working[2], 80);
-                strncpy(tle_working[1], linetmp, 80);
-                /* make sure there is no junk in tle_working[2] */
-                if (fgets(tle_working[2], 80, fp) == NULL)
-                {
-                    tle_working[2][0] = '\0';
-                }
-                break;
-            case 1:
-                strncpy(tle_working[0], tle_working[1], 80);
-                strncpy(tle_working[1], tle_working[2], 80);
-                strncpy(tle_working[2], linetmp, 80);
-                tle_working[2][79] = 0;         // make coverity happy
-                break;
-            default:
-                sat_log_log(SAT_LOG_LEVEL_ERROR,
-                            _
-                            ("%s:%s: Something wrote linesneeded to an illegal value %d"),
-                            __FILE__, __func__, linesneeded);
-                break;
-            }
-            /* b can only be null if there is only one line in the buffer */
-            /* a tle must be two or three */
-            if (b == NULL)
-            {
-                break;
-            }
-            /* remove leading and trailing whitespace to be more forgiving */
-            g_strstrip(tle_working[0]);
-            g_strstrip(tle_working[1]);
-            g_strstrip(tle_working[2]);
-
-            /* there are three possibilities at this point */
-            /* first is that line 0 is a name and normal text for three line element and that lines 1 and 2 
-               are the corresponding tle */
-            /* second is that line 0 and line 1 are a tle for a bare tle */
-            /* third is that neither of these is true and we are consuming either text at the top of the 
-               file or a text file that happens to be in the update directory 
-             */
-            if ((tle_working[1][0] == '1') &&
-                (tle_working[2][0] == '2') &&
-                Checksum_Good(tle_working[1]) && Checksum_Good(tle_working[2]))
-            {
-                sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                            _("%s:%s: Processing a three line TLE"),
-                            __FILE__, __func__);
-
-                /* it appears that the first line may be a name followed by a tle */
-                strncpy(tle_str[0], tle_working[0], 80);
-                tle_str[0][79] = 0;         // make coverity happy
-                strncpy(tle_str[1], tle_working[1], 80);
-                strncpy(tle_str[2], tle_working[2], 80);
-                /* we consumed three lines so we need three lines */
-                linesneeded = 3;
+    if (tle_lines_to_tle(lines, &tle) != TLE_CONV_SUCCESS)
+    {
+        /* TLE data not good */
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s:%s: Invalid data for %.5s"),
+                    __FILE__, __func__, lines->line1 + 2);
+        return;
+    }
 
-            }
-            else if ((tle_working[0][0] == '1') &&
-                     (tle_working[1][0] == '2') &&
-                     Checksum_Good(tle_working[0]) &&
-                     Checksum_Good(tle_working[1]))
-            {
-                sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                            _("%s:%s: Processing a bare two line TLE"),
-                            __FILE__, __func__);
-
-                /* first line appears to belong to the start of bare TLE */
-                /* put in a dummy name of form yyyy-nnaa base on international id */
-                /* this special form will be overwritten if a three line tle ever has another name */
-
-                strncpy(idstr, &tle_working[0][11], 6);
-                g_strstrip(idstr);
-                strncpy(idyearstr, &tle_working[0][9], 2);
-                idstr[6] = '\0';
-                idyearstr[2] = '\0';
-                idyear = g_ascii_strtod(idyearstr, NULL);
-
-                /* there is a two digit year field that started around sputnik */
-                if (idyear >= 57)
-                    idyear += 1900;
-                else
-                    idyear += 2000;
-
-                snprintf(tle_str[0], 79, "%d-%s", idyear, idstr);
-                strncpy(tle_str[1], tle_working[0], 80);
-                strncpy(tle_str[2], tle_working[1], 80);
-
-                /* we consumed two lines so we need two lines */
-                linesneeded = 2;
-            }
-            else
-            {
-                /* we appear to have junk 
-                   read another line in and do nothing else */
-                linesneeded = 1;
-                /* skip back to beginning of loop */
-                continue;
-            }
+    /* remember the catalog number for the .cat file */
+    g_array_append_val(job->catnums, tle.catnr);
 
+    ntle = g_new(new_tle_t, 1);
+    ntle->catnum = tle.catnr;
+    ntle->epoch = tle.epoch;
+    ntle->status = tle.status;
+    ntle->satname = g_strdup(tle.sat_name);
+    ntle->line1 = g_strndup(lines->line1, 69);
+    ntle->line2 = g_strndup(lines->line2, 69);
+    ntle->srcfile = g_strdup(job->fnam);
+    ntle->isnew = TRUE;         /* flag will be reset when using data */
 
-            tle_str[1][69] = '\0';
-            tle_str[2][69] = '\0';
+    merge_fresh_tle(job->data, ntle);
+}
 
-            /* copy catnum and convert to integer */
-            for (i = 2; i < 7; i++)
-            {
-                catstr[i - 2] = tle_str[1][i];
-            }
-            catstr[5] = '\0';
-            catnr = (guint) g_ascii_strtod(catstr, NULL);
+/**
+ * Read fresh TLE data from a file.
+ *
+ * @param job The file to read. The data is stored in job->data and the
+ *            catalog numbers of the valid TLE sets in job->catnums.
+ * 
+ * The file is memory mapped and parsed in place; both NASA three line and
+ * bare two line data is accepted. Bare TLEs get a name of the form
+ * yyyy-nnnaa based on the international designator, which will be
+ * overwritten if a three line TLE ever has another name.
+ *
+ * This function does not touch any shared data and is called from the
+ * worker threads in read_fresh_tle_files().
+ */
+static void read_fresh_tle(tle_file_job_t * job)
+{
+    GMappedFile    *mf;
+    GError         *err = NULL;
 
+    job->data = g_hash_table_new_full(g_int_hash, g_int_equal, NULL,
+                                      free_new_tle);
 
-            if (Get_Next_Tle_Set(tle_str, &tle) != 1)
-            {
-                /* TLE data not good */
-                sat_log_log(SAT_LOG_LEVEL_ERROR,
-                            _("%s:%s: Invalid data for %d"),
-                            __FILE__, __func__, catnr);
-            }
-            else
-            {
-                if (catsync)
-                {
-                    /* store catalog number in catfile */
-                    buff = g_strdup_printf("%d\n", catnr);
-                    fputs(buff, catfile);
-                    g_free(buff);
-                }
+    mf = g_mapped_file_new(job->path, FALSE, &err);
+    if (mf == NULL)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s:%s: Failed to open %s (%s)"),
+                    __FILE__, __func__, job->path, err->message);
+        g_clear_error(&err);
+        return;
+    }
 
-                /* add data to hash table */
-                key = g_try_new0(guint, 1);
-                *key = catnr;
+    job->catnums = g_array_new(FALSE, FALSE, sizeof(gint));
 
-                ntle = g_hash_table_lookup(data, key);
+    /* empty files have no contents */
+    if (g_mapped_file_get_length(mf) > 0)
+        tle_scan_buffer(g_mapped_file_get_contents(mf),
+                        g_mapped_file_get_length(mf), add_fresh_tle, job);
 
-                /* check if satellite already in hash table */
-                if (ntle == NULL)
-                {
+    g_mapped_file_unref(mf);
+}
 
-                    /* create new_tle structure */
-                    ntle = g_try_new(new_tle_t, 1);
-                    ntle->catnum = catnr;
-                    ntle->epoch = tle.epoch;
-                    ntle->status = tle.status;
-                    ntle->satname = g_strdup(tle.sat_name);
-                    ntle->line1 = g_strdup(tle_str[1]);
-                    ntle->line2 = g_strdup(tle_str[2]);
-                    ntle->srcfile = g_strdup(fnam);
-                    ntle->isnew = TRUE; /* flag will be reset when using data */
-
-                    g_hash_table_insert(data, key, ntle);
-                    retcode++;
-                }
-                else
-                {
-                    /* satellite is already in hash */
-                    /* apply various merge routines */
+/** Thread pool function reading one TLE file. */
+static void read_fresh_tle_worker(gpointer data, gpointer user_data)
+{
+    read_fresh_tle((tle_file_job_t *) data);
+    g_async_queue_push((GAsyncQueue *) user_data, data);
+}
 
-                    /* time merge */
-                    if (ntle->epoch == tle.epoch)
-                    {
-                        /* if satellite epoch has the same time,  merge status as appropriate */
-                        if (ntle->status != tle.status)
-                        {
-                            /* log if there is something funny about the data coming in */
-                            sat_log_log(SAT_LOG_LEVEL_WARN,
-                                        _
-                                        ("%s:%s: Two different statuses for %d (%s) at the same time."),
-                                        __FILE__, __func__, ntle->catnum,
-                                        ntle->satname);
-                            if (tle.status != OP_STAT_UNKNOWN)
-                                ntle->status = tle.status;
-                        }
-                    }
-                    else if (ntle->epoch < tle.epoch)
-                    {
-                        /* if the satellite in the hash is older than 
-                           the one just loaded, copy the values over. */
-
-                        ntle->catnum = catnr;
-                        ntle->epoch = tle.epoch;
-                        ntle->status = tle.status;
-                        g_free(ntle->line1);
-                        ntle->line1 = g_strdup(tle_str[1]);
-                        g_free(ntle->line2);
-                        ntle->line2 = g_strdup(tle_str[2]);
-                        g_free(ntle->srcfile);
-                        ntle->srcfile = g_strdup(fnam);
-                        ntle->isnew = TRUE;     /* flag will be reset when using data */
-                    }
+/**
+ * Read TLE files in parallel.
+ *
+ * @param jobs Array of tle_file_job_t, one for each file.
+ * @param silent TRUE if function should execute without graphical status indicator.
+ * @param label1 Activity label (can be NULL)
+ *
+ * The files are read by a pool of worker threads. The GUI is kept alive
+ * while waiting for the workers to finish.
+ */
+static void read_fresh_tle_files(GPtrArray * jobs, gboolean silent,
+                                 GtkWidget * label1)
+{
+    GThreadPool    *pool;
+    GAsyncQueue    *done;
+    tle_file_job_t *job;
+    gchar          *text;
+    guint           i;
+    guint           n = 0;
 
-                    /* merge based on name */
-                    if (is_computer_generated_name(ntle->satname) &&
-                        !is_computer_generated_name(tle_str[0]))
-                    {
-                        g_free(ntle->satname);
-                        ntle->satname = g_strdup(tle.sat_name);
-                    }
+    if (jobs->len == 0)
+        return;
 
-                    /* free the key since we do not commit it to the cache */
-                    g_free(key);
-                }
-            }
+    done = g_async_queue_new();
+    pool = g_thread_pool_new(read_fresh_tle_worker, done,
+                             MAX(1, MIN(g_get_num_processors(),
+                                        (gint) jobs->len)), FALSE, NULL);
 
-        }
+    for (i = 0; i < jobs->len; i++)
+        g_thread_pool_push(pool, g_ptr_array_index(jobs, i), NULL);
 
-        if (catsync)
+    while (n < jobs->len)
+    {
+        job = g_async_queue_timeout_pop(done, G_USEC_PER_SEC / 20);
+        if (job != NULL)
         {
-            /* close category file */
-            fclose(catfile);
+            n++;
+
+            /* status message */
+            if (!silent && (label1 != NULL))
+            {
+                text = g_strdup_printf(_("Reading data from %s"), job->fnam);
+                gtk_label_set_text(GTK_LABEL(label1), text);
+                g_free(text);
+            }
         }
 
+        /* Force the drawing queue to be processed otherwise there will
+           not be any visual feedback, ie. frozen GUI
+           - see Gtk+ FAQ http://www.gtk.org/faq/#AEN602
+         */
+        if (!silent)
+            while (g_main_context_iteration(NULL, FALSE));
+    }
+
+    g_thread_pool_free(pool, FALSE, TRUE);
+    g_async_queue_unref(done);
+}
+
+/**
+ * Synchronise the category file belonging to a TLE file.
+ *
+ * @param fnam The name of the TLE file.
+ * @param catnums The catalog numbers read from the file.
+ *
+ * If there is a satellite category (.cat file) with the same name as the
+ * TLE file, its satellites are replaced with the ones read from the file.
+ */
+static void sync_category_file(const gchar * fnam, GArray * catnums)
+{
+    gchar          *catname, *catpath, **buffv;
+    gchar          *contents;
+    gchar          *eol;
+    GString        *text;
+    GError         *err = NULL;
+    guint           i;
+
+    buffv = g_strsplit(fnam, ".", 0);
+    catname = g_strconcat(buffv[0], ".cat", NULL);
+    g_strfreev(buffv);
+    catpath = sat_file_name(catname);
+    g_free(catname);
+
+    if (!g_file_get_contents(catpath, &contents, NULL, NULL))
+    {
+        /* There is no category with this name (could be update from custom file) */
+        sat_log_log(SAT_LOG_LEVEL_INFO,
+                    _("%s:%s: There is no category called %s"),
+                    __FILE__, __func__, fnam);
         g_free(catpath);
+        return;
+    }
 
-        /* close input TLE file */
-        fclose(fp);
+    if (contents[0] == '\0')
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s:%s: There is no category in %s"),
+                    __FILE__, __func__, catpath);
     }
 
-    else
+    /* keep the category name on the first line */
+    eol = strchr(contents, '\n');
+    text = g_string_new_len(contents, (eol != NULL) ? eol - contents + 1 :
+                            (gssize) strlen(contents));
+    g_free(contents);
+
+    for (i = 0; i < catnums->len; i++)
+        g_string_append_printf(text, "%d\n", g_array_index(catnums, gint, i));
+
+    if (!g_file_set_contents(catpath, text->str, text->len, &err))
     {
         sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s:%s: Failed to open %s"), __FILE__, __func__, path);
+                    _("%s:%s: Could not write .cat file for %s (%s)"),
+                    __FILE__, __func__, fnam, err->message);
+        g_clear_error(&err);
     }
-    g_free(path);
 
-    return retcode;
+    g_string_free(text, TRUE);
+    g_free(catpath);
+}
+
+/**
+ * Merge the data read from one file into the fresh data.
+ *
+ * @param data Hash table with the fresh data.
+ * @param job The file that has been read.
+ * @return The number of satellites added to the hash table.
+ */
+static guint merge_fresh_tle_file(GHashTable * data, tle_file_job_t * job)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+    guint           num = 0;
+
+    g_hash_table_iter_init(&iter, job->data);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        g_hash_table_iter_steal(&iter);
+        if (merge_fresh_tle(data, (new_tle_t *) value))
+            num++;
+    }
+
+    return num;
+}
+
+/** Free a tle_file_job_t structure. */
+static void free_tle_file_job(tle_file_job_t * job)
+{
+    if (job->data != NULL)
+        g_hash_table_destroy(job->data);
+    if (job->catnums != NULL)
+        g_array_free(job->catnums, TRUE);
+    g_free(job->path);
+    g_free(job->fnam);
+    g_free(job);
 }
 
 /**
@@ -1128,21 +1717,20 @@ static gint read_fresh_tle(const gchar * dir, const gchar * fnam,
  * @param ldname Directory name for gpredict tle files.
  * @param fname The name of the TLE file.
  * @param data The hash table containing the fresh data.
+ * @param staged Array where the updated file is staged for the commit phase.
  * @param sat_upd OUT: number of sats updated.
  * @param sat_ski OUT: number of sats skipped.
  * @param sat_nod OUT: number of sats for which no data found
  * @param sat_tot OUT: total number of sats
  *
- * For each satellite in the TLE file ldname/fnam, this function
- * checks whether there is any newer data available in the hash table.
- * If yes, the function writes the fresh data to temp_file, if no, the
- * old data is copied to temp_file.
- * When all sats have been copied ldname/fnam is deleted and temp_file
- * is renamed to ldname/fnam.
+ * For the satellite in the file ldname/fnam, this function checks
+ * whether there is any newer data available in the hash table. If yes,
+ * the updated file is staged; it is written by commit_staged_sats().
  */
 static void update_tle_in_file(const gchar * ldname,
                                const gchar * fname,
                                GHashTable * data,
+                               GPtrArray * staged,
                                guint * sat_upd,
                                guint * sat_ski,
                                guint * sat_nod, guint * sat_tot)
@@ -1333,10 +1921,8 @@ static void update_tle_in_file(const gchar * ldname,
 
             if (updateddata == TRUE)
             {
-                if (gpredict_save_key_file(satdata, path))
-                    skipped++;
-                else
-                    updated++;
+                stage_sat_file(staged, g_strdup(path), catnr, FALSE, satdata);
+                updated++;
             }
             else
             {
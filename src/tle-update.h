@@ -86,4 +86,6 @@ void            tle_update_from_network(gboolean silent,
 
 const gchar    *tle_update_freq_to_str(tle_auto_upd_freq_t freq);
 
+void            tle_update_recover(void);
+
 #endif
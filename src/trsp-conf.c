@@ -128,7 +128,7 @@ GSList *read_transponders(guint catnum)
         trsp->uplow = g_key_file_get_int64(cfg, groups[i], KEY_UP_LOW, &error);
         if (error != NULL)
         {
-            sat_log_log(SAT_LOG_LEVEL_INFO, INFO_MSG, __func__, KEY_UP_LOW,
+            sat_log_log(SAT_LOG_LEVEL_DEBUG, INFO_MSG, __func__, KEY_UP_LOW,
                         name, groups[i]);
             g_clear_error(&error);
         }
@@ -137,7 +137,7 @@ GSList *read_transponders(guint catnum)
                                             &error);
         if (error != NULL)
         {
-            sat_log_log(SAT_LOG_LEVEL_INFO, INFO_MSG, __func__, KEY_UP_HIGH,
+            sat_log_log(SAT_LOG_LEVEL_DEBUG, INFO_MSG, __func__, KEY_UP_HIGH,
                         name, groups[i]);
             g_clear_error(&error);
         }
@@ -146,7 +146,7 @@ GSList *read_transponders(guint catnum)
                                              &error);
         if (error != NULL)
         {
-            sat_log_log(SAT_LOG_LEVEL_INFO, INFO_MSG, __func__, KEY_DOWN_LOW,
+            sat_log_log(SAT_LOG_LEVEL_DEBUG, INFO_MSG, __func__, KEY_DOWN_LOW,
                         name, groups[i]);
             g_clear_error(&error);
         }
@@ -155,7 +155,7 @@ GSList *read_transponders(guint catnum)
                                               &error);
         if (error != NULL)
         {
-            sat_log_log(SAT_LOG_LEVEL_INFO, INFO_MSG, __func__, KEY_DOWN_HIGH,
+            sat_log_log(SAT_LOG_LEVEL_DEBUG, INFO_MSG, __func__, KEY_DOWN_HIGH,
                         name, groups[i]);
             g_clear_error(&error);
         }
@@ -167,7 +167,7 @@ GSList *read_transponders(guint catnum)
                                               KEY_INVERT, &error);
         if (error != NULL)
         {
-            sat_log_log(SAT_LOG_LEVEL_INFO, INFO_MSG, __func__, KEY_INVERT,
+            sat_log_log(SAT_LOG_LEVEL_DEBUG, INFO_MSG, __func__, KEY_INVERT,
                         name, groups[i]);
             g_clear_error(&error);
             trsp->invert = FALSE;
@@ -176,7 +176,7 @@ GSList *read_transponders(guint catnum)
         trsp->mode = g_key_file_get_string(cfg, groups[i], KEY_MODE, &error);
         if (error != NULL)
         {
-            sat_log_log(SAT_LOG_LEVEL_INFO, INFO_MSG, __func__, KEY_MODE,
+            sat_log_log(SAT_LOG_LEVEL_DEBUG, INFO_MSG, __func__, KEY_MODE,
                         name, groups[i]);
             g_clear_error(&error);
         }
@@ -184,7 +184,7 @@ GSList *read_transponders(guint catnum)
         trsp->baud = g_key_file_get_double(cfg, groups[i], KEY_BAUD, &error);
         if (error != NULL)
         {
-            sat_log_log(SAT_LOG_LEVEL_INFO, INFO_MSG, __func__, KEY_BAUD,
+            sat_log_log(SAT_LOG_LEVEL_DEBUG, INFO_MSG, __func__, KEY_BAUD,
                         name, groups[i]);
             g_clear_error(&error);
         }
@@ -253,7 +253,8 @@ void write_transponders(guint catnum, GSList * trsp_list)
         if (trsp->invert)
             g_key_file_set_boolean(trsp_data, trsp->name, KEY_INVERT, TRUE);
         if (trsp->mode)
-            g_key_file_set_string(trsp_data, trsp->name, KEY_MODE, trsp->name);
+            g_key_file_set_string(trsp_data, trsp->name, KEY_MODE, trsp->mode);
+        trsp_written++;
     }
 
     if (gpredict_save_key_file(trsp_data, trsp_file))
@@ -264,9 +265,9 @@ void write_transponders(guint catnum, GSList * trsp_list)
     }
     else
     {
-        sat_log_log(SAT_LOG_LEVEL_INFO,
-                    _("Wrote %d transmponders to %s"),
-                    trsp_written, trsp_file_name);
+        sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                    _("%s: Wrote %d transponders to %s"),
+                    __func__, trsp_written, trsp_file);
     }
 
     g_key_file_free(trsp_data);
@@ -0,0 +1,331 @@
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Transponder database.
+ *
+ * All .trsp files are read once at startup into a table indexed by
+ * catalogue number. The uplink and downlink ranges are also kept in
+ * arrays sorted by their lower frequency, which answer frequency range
+ * queries with a binary search. The index is rebuilt on the next query
+ * after the database has changed. Transponder updates from the network
+ * replace the entries of the updated satellites in place.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <stdlib.h>
+
+#include "compat.h"
+#include "sat-log.h"
+#include "trsp-db.h"
+
+/* A frequency range of a transponder */
+typedef struct {
+    gint64          low;
+    gint64          high;
+    guint           catnum;
+} trsp_range_t;
+
+/* Ranges sorted by their lower frequency */
+typedef struct {
+    GArray         *ranges;     /*!< trsp_range_t */
+    gint64          span;       /*!< Widest range */
+} trsp_index_t;
+
+static GMutex   db_lock;
+static GHashTable *db = NULL;   /* catnum -> GSList of trsp_t */
+static trsp_index_t downlinks;
+static trsp_index_t uplinks;
+static gboolean dirty = TRUE;   /* index must be rebuilt */
+
+
+static void free_entry(gpointer data)
+{
+    free_transponders((GSList *) data);
+}
+
+static GHashTable *get_db(void)
+{
+    if (db == NULL)
+        db = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                   free_entry);
+
+    return db;
+}
+
+static gint range_compare(gconstpointer a, gconstpointer b)
+{
+    const trsp_range_t *ra = a, *rb = b;
+
+    if (ra->low != rb->low)
+        return ra->low < rb->low ? -1 : 1;
+
+    return (ra->catnum > rb->catnum) - (ra->catnum < rb->catnum);
+}
+
+static void index_add(trsp_index_t * index, gint64 low, gint64 high,
+                      guint catnum)
+{
+    trsp_range_t    range;
+
+    /* skip missing links, e.g. the uplink of a beacon */
+    if (low <= 0 && high <= 0)
+        return;
+
+    range.low = low;
+    range.high = MAX(low, high);
+    range.catnum = catnum;
+    g_array_append_val(index->ranges, range);
+    index->span = MAX(index->span, range.high - range.low);
+}
+
+static void index_reset(trsp_index_t * index)
+{
+    if (index->ranges != NULL)
+        g_array_free(index->ranges, TRUE);
+    index->ranges = g_array_new(FALSE, FALSE, sizeof(trsp_range_t));
+    index->span = 0;
+}
+
+/* Rebuild the frequency index; called with db_lock held */
+static void index_build(void)
+{
+    GHashTableIter  iter;
+    gpointer        key, value;
+    GSList         *node;
+    trsp_t         *trsp;
+    guint           catnum;
+
+    index_reset(&downlinks);
+    index_reset(&uplinks);
+
+    g_hash_table_iter_init(&iter, get_db());
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        catnum = GPOINTER_TO_UINT(key);
+        for (node = value; node != NULL; node = node->next)
+        {
+            trsp = node->data;
+            index_add(&downlinks, trsp->downlow, trsp->downhigh, catnum);
+            index_add(&uplinks, trsp->uplow, trsp->uphigh, catnum);
+        }
+    }
+
+    g_array_sort(downlinks.ranges, range_compare);
+    g_array_sort(uplinks.ranges, range_compare);
+    dirty = FALSE;
+}
+
+/**
+ * Load all transponder files.
+ *
+ * Called once at startup; the files are not read again afterwards.
+ */
+void trsp_db_load(void)
+{
+    GDir           *dir;
+    gchar          *dirname;
+    const gchar    *filename;
+    gchar          *end;
+    guint           catnum, num = 0;
+    GSList         *trsplist;
+
+    dirname = get_trsp_dir();
+    dir = g_dir_open(dirname, 0, NULL);
+    if (dir == NULL)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Failed to open %s"), __func__, dirname);
+        g_free(dirname);
+        return;
+    }
+
+    g_mutex_lock(&db_lock);
+    while ((filename = g_dir_read_name(dir)))
+    {
+        if (!g_str_has_suffix(filename, ".trsp"))
+            continue;
+
+        catnum = (guint) strtoul(filename, &end, 10);
+        if (end == filename || g_strcmp0(end, ".trsp") != 0)
+            continue;
+
+        trsplist = read_transponders(catnum);
+        if (trsplist != NULL)
+        {
+            g_hash_table_replace(get_db(), GUINT_TO_POINTER(catnum),
+                                 trsplist);
+            num++;
+        }
+    }
+    dirty = TRUE;
+    g_mutex_unlock(&db_lock);
+
+    sat_log_log(SAT_LOG_LEVEL_INFO,
+                _("%s: Loaded transponders for %d satellites from %s"),
+                __func__, num, dirname);
+
+    g_dir_close(dir);
+    g_free(dirname);
+}
+
+/** Free the transponder database. */
+void trsp_db_close(void)
+{
+    g_mutex_lock(&db_lock);
+    if (db != NULL)
+    {
+        g_hash_table_destroy(db);
+        db = NULL;
+    }
+    dirty = TRUE;
+    g_mutex_unlock(&db_lock);
+}
+
+/**
+ * Get the transponders of a satellite.
+ *
+ * @param catnum The catalogue number of the satellite.
+ * @return A copy of the transponder list, which must be freed with
+ *         free_transponders(), or NULL if the satellite has none.
+ */
+GSList         *trsp_db_get(guint catnum)
+{
+    GSList         *node, *copy = NULL;
+    trsp_t         *trsp, *dup;
+
+    g_mutex_lock(&db_lock);
+    for (node = g_hash_table_lookup(get_db(), GUINT_TO_POINTER(catnum));
+         node != NULL; node = node->next)
+    {
+        trsp = node->data;
+        dup = g_new(trsp_t, 1);
+        *dup = *trsp;
+        dup->name = g_strdup(trsp->name);
+        dup->mode = g_strdup(trsp->mode);
+        copy = g_slist_prepend(copy, dup);
+    }
+    g_mutex_unlock(&db_lock);
+
+    return g_slist_reverse(copy);
+}
+
+/**
+ * Replace the transponders of a satellite.
+ *
+ * @param catnum The catalogue number of the satellite.
+ * @param trsplist The new transponder list; the database takes ownership.
+ *                 NULL removes the satellite.
+ */
+void trsp_db_set(guint catnum, GSList * trsplist)
+{
+    g_mutex_lock(&db_lock);
+    if (trsplist != NULL)
+        g_hash_table_replace(get_db(), GUINT_TO_POINTER(catnum), trsplist);
+    else
+        g_hash_table_remove(get_db(), GUINT_TO_POINTER(catnum));
+    dirty = TRUE;
+    g_mutex_unlock(&db_lock);
+}
+
+static gint uint_compare(gconstpointer a, gconstpointer b)
+{
+    guint           ua = *(const guint *)a, ub = *(const guint *)b;
+
+    return (ua > ub) - (ua < ub);
+}
+
+/**
+ * Find the satellites with a transponder in a frequency range.
+ *
+ * @param low Lower end of the range in Hz.
+ * @param high Upper end of the range in Hz.
+ * @param uplink Search the uplinks instead of the downlinks.
+ * @param sats Hash table of satellites keyed by catalogue number, e.g. the
+ *             satellites of a module, to restrict the search to. May be
+ *             NULL to search all satellites.
+ * @return Sorted array of the catalogue numbers (guint) of the satellites
+ *         with a transponder overlapping the range. Free it with
+ *         g_array_free().
+ */
+GArray         *trsp_db_find(gint64 low, gint64 high, gboolean uplink,
+                             GHashTable * sats)
+{
+    trsp_index_t   *index = uplink ? &uplinks : &downlinks;
+    trsp_range_t   *r;
+    GArray         *result;
+    guint           lo, hi, mid, i, prev;
+    gint            catnum;
+
+    result = g_array_new(FALSE, FALSE, sizeof(guint));
+
+    g_mutex_lock(&db_lock);
+    if (dirty)
+        index_build();
+
+    /* first range starting above the upper end of the query */
+    lo = 0;
+    hi = index->ranges->len;
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (g_array_index(index->ranges, trsp_range_t, mid).low <= high)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    /* ranges starting more than the widest span below cannot overlap */
+    for (i = lo; i-- > 0;)
+    {
+        r = &g_array_index(index->ranges, trsp_range_t, i);
+        if (r->low < low - index->span)
+            break;
+        if (r->high < low)
+            continue;
+
+        catnum = (gint) r->catnum;
+        if (sats == NULL || g_hash_table_lookup(sats, &catnum) != NULL)
+            g_array_append_val(result, r->catnum);
+    }
+    g_mutex_unlock(&db_lock);
+
+    /* a satellite may have several matching transponders */
+    g_array_sort(result, uint_compare);
+    for (i = 0, prev = 0, mid = 0; i < result->len; i++)
+    {
+        if (i == 0 || g_array_index(result, guint, i) != prev)
+        {
+            prev = g_array_index(result, guint, i);
+            g_array_index(result, guint, mid++) = prev;
+        }
+    }
+    g_array_set_size(result, mid);
+
+    return result;
+}
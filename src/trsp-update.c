@@ -33,14 +33,14 @@
 #include <glib/gi18n.h>
 #include <glib/gstdio.h>
 #include <gtk/gtk.h>
-#include <locale.h>
 
 #include "compat.h"
 #include "trsp-update.h"
 #include "gpredict-utils.h"
 #include "sat-cfg.h"
 #include "sat-log.h"
-#include "nxjson/nxjson.h"
+#include "json-stream.h"
+#include "trsp-db.h"
 
 #ifdef HAVE_CONFIG_H
 #include <build-config.h>
@@ -61,330 +61,162 @@ typedef enum {
     TRSP_AUTO_UPDATE_NUM
 } trsp_auto_upd_freq_t;
 
-/* Data structure to hold a TRSP set. */
-struct transponder {
-    char            uuid[30];   /* uuid */
-    int             catnum;     /* Catalog number. */
-    char            description[80];    /* Transponder descriptoion */
-    long long       uplink_low; /* Uplink starting frequency */
-    long long       uplink_high;        /* uplink end frequency  */
-    long long       downlink_low;       /* downlink starting frequency */
-    long long       downlink_high;      /* downlink end frequency */
-    char            mode[20];   /* mode (from modes files) */
-    int             invert;     /* inverting / noninverting */
-    double          baud;       /* baudrate */
-    int             alive;      /* alive or dead */
-};
-
-/* Data structure to hold a MODES set. */
-struct modes {
-    int             id;         /* id */
-    char            name[80];   /* Mode name */
-};
-
-/* Data structure to hold a MODE set. */
-typedef struct {
-    guint           modnum;     /* Mode number. */
-    gchar          *modname;    /* Mode description. */
-} new_mode_t;
-
-/* Data structure to hold a TRSP list. */
-typedef struct {
-    guint           catnum;     /* Catalog number. */
-    guint           numtrsp;    /* Number of transponders. */
-} new_trsp_t;
-
 #ifndef WIN32
 /* private function prototypes */
 static size_t   my_write_func(void *ptr, size_t size, size_t nmemb,
                               FILE * stream);
 #endif
 
-//int getMODElist_intoHashMap();
+/* State of a transponder update */
+typedef struct {
+    GHashTable     *modes;      /* mode id -> mode name */
+    GHashTable     *sats;       /* catnum -> GSList of trsp_t, newest first */
+    guint           count;      /* number of transmitters read */
+} trsp_update_t;
 
-//static void check_and_print_mode(gpointer key, gpointer value, gpointer user_data)
-//{
-//    new_mode_t  *nmode = (new_mode_t *) value;
-//    guint      *num = user_data;
-//
-//    *num += 1;
-//
-//    (void) key; /* avoid unused parameter compiler warning */
-//
-//    printf("MODES LIST : %d %s \n", nmode->modnum, nmode->modname);
-//
-//}
+/** Read an integer member of a JSON object; missing members read as 0. */
+static gint64 field_int(GHashTable * fields, const gchar * name)
+{
+    const gchar    *val = g_hash_table_lookup(fields, name);
 
+    return (val != NULL) ? g_ascii_strtoll(val, NULL, 10) : 0;
+}
 
-/** Free a new_mode_t structure. */
-static void free_new_mode(gpointer data)
+/** Add an entry of modes.json to the mode table. */
+static gboolean add_mode(GHashTable * fields, gpointer data)
 {
-    //TODO: remove this.
-    new_mode_t     *mmode;
+    trsp_update_t  *upd = (trsp_update_t *) data;
+    const gchar    *name = g_hash_table_lookup(fields, "name");
+    gpointer        id = GUINT_TO_POINTER(field_int(fields, "id"));
 
-    mmode = (new_mode_t *) data;
+    if (name != NULL && !g_hash_table_contains(upd->modes, id))
+        g_hash_table_insert(upd->modes, id, g_strdup(name));
+
+    return TRUE;
+}
 
-    g_free(mmode->modname);
-    g_free(mmode);
+/** Add an entry of the transmitter list to its satellite. */
+static gboolean add_transmitter(GHashTable * fields, gpointer data)
+{
+    trsp_update_t  *upd = (trsp_update_t *) data;
+    trsp_t         *trsp;
+    const gchar    *val;
+    gpointer        key;
+    gint64          catnum;
+
+    catnum = field_int(fields, "norad_cat_id");
+    if (catnum <= 0)
+        return TRUE;
+
+    trsp = g_new0(trsp_t, 1);
+
+    val = g_hash_table_lookup(fields, "description");
+    if (val == NULL)
+        val = g_hash_table_lookup(fields, "uuid");
+    trsp->name = g_strdup((val != NULL) ? val : _("Unknown"));
+    /* the name becomes a key file group name */
+    g_strdelimit(trsp->name, "[", '(');
+    g_strdelimit(trsp->name, "]", ')');
+    g_strdelimit(trsp->name, "\r\n", ' ');
+
+    trsp->uplow = field_int(fields, "uplink_low");
+    trsp->uphigh = field_int(fields, "uplink_high");
+    trsp->downlow = field_int(fields, "downlink_low");
+    trsp->downhigh = field_int(fields, "downlink_high");
+
+    val = g_hash_table_lookup(upd->modes,
+                              GUINT_TO_POINTER(field_int(fields, "mode_id")));
+    if (val == NULL)
+        val = g_hash_table_lookup(fields, "mode_id");
+    trsp->mode = g_strdup(val);
+
+    val = g_hash_table_lookup(fields, "invert");
+    trsp->invert = (val != NULL && !g_strcmp0(val, "true"));
+
+    val = g_hash_table_lookup(fields, "baud");
+    trsp->baud = (val != NULL) ? g_ascii_strtod(val, NULL) : 0.0;
+
+    key = GUINT_TO_POINTER((guint) catnum);
+    g_hash_table_insert(upd->sats, key,
+                        g_slist_prepend(g_hash_table_lookup(upd->sats, key),
+                                        trsp));
+    upd->count++;
+
+    return TRUE;
 }
 
-/** Free a new_trsp_t structure. */
-static void free_new_trsp(gpointer data)
+/**
+ * Write the transponders of one satellite and reload them into the
+ * transponder database. Nothing is written if data points to FALSE.
+ */
+static void write_sat(gpointer key, gpointer value, gpointer data)
 {
-    //TODO: remove this.
-    new_trsp_t     *mtrsp;
+    guint           catnum = GPOINTER_TO_UINT(key);
+    GSList         *trsplist = g_slist_reverse((GSList *) value);
 
-    mtrsp = (new_trsp_t *) data;
+    if (*(gboolean *) data)
+    {
+        write_transponders(catnum, trsplist);
+        trsp_db_set(catnum, read_transponders(catnum));
+    }
 
-    g_free(mtrsp);
+    free_transponders(trsplist);
 }
 
+/**
+ * Update the transponder files from a SatNOGS transmitter list.
+ *
+ * @param input_file The downloaded transmitter list.
+ *
+ * The mode list and the transmitter list are parsed as streams, collecting
+ * the transponders of each satellite in one pass over the input. The
+ * transponder file of each satellite in the list is then replaced and the
+ * satellite is reloaded into the transponder database. No file is changed
+ * if the transmitter list can not be parsed.
+ */
 void trsp_update_files(gchar * input_file)
 {
-
-    FILE           *mfp;        /* transmitter information json file */
-    size_t          mfplen;     /* size of transmitter information json file */
-    long            flen;       /* holds the file size returned by ftell or -1 on error */
-    int             result;
-    FILE           *ffile;      /* transponder output file in gpredict format */
-    char           *jsn_object; /* json array will be in this buffer before parsing */
-    unsigned int    idx;        /* object index in JSON-Array */
-    new_mode_t     *nmode;
-    new_trsp_t     *ntrsp;
-    GHashTable     *modes_hash; /* hash table to store modes */
-    GHashTable     *trsp_hash;  /* hash table to store satellite list to generate trsp files */
-    guint          *key = NULL;
-
+    trsp_update_t   upd;
     gchar          *userconfdir;
-    gchar          *trspfile;
     gchar          *modesfile;
-    gchar          *trspfolder;
+    gboolean        ok;
+    gint            nummodes;
+    guint           numsats;
 
-    /* force decimal mark to dot when parsing JSON file */
-    setlocale(LC_NUMERIC, "C");
-
-    modes_hash =
-        g_hash_table_new_full(g_int_hash, g_int_equal, g_free, free_new_mode);
-    trsp_hash =
-        g_hash_table_new_full(g_int_hash, g_int_equal, g_free, free_new_trsp);
+    upd.modes = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                      NULL, g_free);
+    upd.sats = g_hash_table_new(g_direct_hash, g_direct_equal);
+    upd.count = 0;
 
     userconfdir = get_user_conf_dir();
-    trspfolder = g_strconcat(userconfdir, G_DIR_SEPARATOR_S, "trsp", NULL);
-    modesfile = g_strconcat(trspfolder, "/modes.json", NULL);
+    modesfile = g_strconcat(userconfdir, G_DIR_SEPARATOR_S, "trsp",
+                            G_DIR_SEPARATOR_S, "modes.json", NULL);
 
-    mfp = fopen(modesfile, "r");
+    /* without modes the mode ids are used as mode names */
+    nummodes = json_stream_objects(modesfile, add_mode, &upd);
+    if (nummodes < 0)
+        sat_log_log(SAT_LOG_LEVEL_WARN, _("%s: Could not read modes from %s"),
+                    __func__, modesfile);
 
-    if (mfp != NULL)
-    {
-        mfplen = 0;
-        fseek(mfp, 0, SEEK_END);
-        flen = ftell(mfp);
+    ok = (json_stream_objects(input_file, add_transmitter, &upd) >= 0);
+    numsats = g_hash_table_size(upd.sats);
 
-        if (flen > 1)
-        {
-            mfplen = flen;
-            rewind(mfp);
-            jsn_object = g_malloc(mfplen);
-            result = fread(jsn_object, mfplen, 1, mfp);
-
-            if (result == 1)
-            {
-                const nx_json  *json = nx_json_parse(jsn_object, 0);
-
-                if (json)
-                {
-                    idx = 0;
-                    while (1)
-                    {
-                        const nx_json  *json_obj = nx_json_item(json, idx++);
-                        struct modes    m_modes;
-
-                        if (json_obj->type == NX_JSON_NULL)
-                            break;
-
-                        m_modes.id = nx_json_get(json_obj, "id")->int_value;
-                        strncpy(m_modes.name,
-                                nx_json_get(json_obj, "name")->text_value, 79);
-                        m_modes.name[79] = 0;
-
-                        /* add data to hash table */
-                        key = g_try_new0(guint, 1);
-                        *key = m_modes.id;
-
-                        nmode = g_hash_table_lookup(modes_hash, key);
-
-                        if (nmode == NULL)
-                        {
-                            /* create new_mode structure */
-                            nmode = g_try_new(new_mode_t, 1);
-                            nmode->modnum = m_modes.id;
-                            nmode->modname = g_strdup(m_modes.name);
-
-                            g_hash_table_insert(modes_hash, key, nmode);
-
-                        }
-
-                        sat_log_log(SAT_LOG_LEVEL_INFO, _("MODE %d %s"),
-                                    m_modes.id, m_modes.name);
-                    }           // while(1)
-                    nx_json_free(json);
-                }               // if(json)
-            }                   // if(result == 1)
-            g_free(jsn_object);
-        }                       // if(flen > 1)
-        fclose(mfp);
-    }                           // if(mfp)
-
-//    guint num = 0;
-//    printf("---------- PRINTING MODES LIST ------- \n");
-//    g_hash_table_foreach (modes_hash, check_and_print_mode, &num);
-
-    mfp = fopen(input_file, "r");
-    if (mfp != NULL)
-    {
-        mfplen = 0;
-        fseek(mfp, 0, SEEK_END);
-        flen = ftell(mfp);
+    g_hash_table_foreach(upd.sats, write_sat, &ok);
 
-        if (flen > 1)
-        {
-            mfplen = flen;
-            rewind(mfp);
-            jsn_object = g_malloc(mfplen);
-            result = fread(jsn_object, mfplen, 1, mfp);
-
-            if (result == 1)
-            {
-                const nx_json  *json = nx_json_parse(jsn_object, 0);
-
-                if (json)
-                {
-                    idx = 0;
-                    while (1)
-                    {
-                        const nx_json  *json_obj = nx_json_item(json, idx++);
-                        struct transponder m_trsp;
-
-                        if (json_obj->type == NX_JSON_NULL)
-                            break;
-
-                        strncpy(m_trsp.description,
-                                nx_json_get(json_obj,
-                                            "description")->text_value, 79);
-                        m_trsp.description[79] = 0;
-                        m_trsp.catnum =
-                            nx_json_get(json_obj, "norad_cat_id")->int_value;
-                        m_trsp.uplink_low =
-                            nx_json_get(json_obj, "uplink_low")->int_value;
-                        m_trsp.uplink_high =
-                            nx_json_get(json_obj, "uplink_high")->int_value;
-                        m_trsp.downlink_low =
-                            nx_json_get(json_obj, "downlink_low")->int_value;
-                        m_trsp.downlink_high =
-                            nx_json_get(json_obj, "downlink_high")->int_value;
-
-                        key = g_try_new0(guint, 1);
-                        *key = nx_json_get(json_obj, "mode_id")->int_value;
-                        nmode = g_hash_table_lookup(modes_hash, key);
-                        if (nmode != NULL)
-                            sprintf(m_trsp.mode, "%s", nmode->modname);
-                        else
-                            sprintf(m_trsp.mode, "%lli",
-                                    nx_json_get(json_obj,
-                                                "mode_id")->int_value);
-
-                        m_trsp.invert =
-                            nx_json_get(json_obj, "invert")->int_value;
-                        m_trsp.baud = nx_json_get(json_obj, "baud")->dbl_value;
-                        m_trsp.alive =
-                            nx_json_get(json_obj, "alive")->int_value;
-
-                        //strcpy(m_trsp.uuid,nx_json_get(json_obj,          "uuid")->text_value);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _(">>> Preparing information for transponders of cat_id %d <<<"), m_trsp.catnum, __func__);
-                        ////sat_log_log (SAT_LOG_LEVEL_INFO, _("         uuid : %s"), m_trsp.uuid, __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _("  description : %s"), m_trsp.description, __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _("        alive : %s"), m_trsp.alive ? "true" : "false", __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _("   uplink_low : %Ld"),m_trsp.uplink_low, __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _("  uplink_high : %Ld"),m_trsp.uplink_high, __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _(" downink_low  : %Ld"),m_trsp.downlink_low, __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _("downlink_high : %Ld"),m_trsp.downlink_high, __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _("         Mode : %s"), m_trsp.mode, __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _("       Invert : %s"), m_trsp.invert ? "true" : "false", __func__);
-                        // sat_log_log(SAT_LOG_LEVEL_DEBUG, _("         Baud : %lf"),m_trsp.baud, __func__);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _(" norad_cat_id : %Ld"),m_trsp.catnum, __func__);
-                        char            m_catnum[20];
-
-                        sprintf(m_catnum, "%d", m_trsp.catnum);
-                        trspfile = g_strconcat(trspfolder, G_DIR_SEPARATOR_S,
-                                               m_catnum, ".trsp", NULL);
-                        //sat_log_log(SAT_LOG_LEVEL_DEBUG, _("%s: Writing to file : %s "), __func__, trspfile);
-
-                        //first lets delete the file we already have, to make space for the new version
-                        /* check existence and add data to hash table for future check */
-                        key = g_try_new0(guint, 1);
-                        *key = m_trsp.catnum;
-                        ntrsp = g_hash_table_lookup(trsp_hash, key);
-
-                        if (ntrsp == NULL)
-                        {
-                            /* create new_trsp structure */
-                            ntrsp = g_try_new(new_trsp_t, 1);
-                            ntrsp->catnum = m_trsp.catnum;
-                            ntrsp->numtrsp = 1; //our first insertion of transponder to this file
-                            g_hash_table_insert(trsp_hash, key, ntrsp);
-                            if (g_remove(trspfile))
-                                sat_log_log(SAT_LOG_LEVEL_ERROR,
-                                            _("%s: Failed to remove %s"),
-                                            __func__, trspfile);
-                        }
-                        else
-                        {
-                            //TODO: increase number of transponders here
-                            //ntrsp->numtrsp += 1; //number of transponder info in this file
-                            //g_hash_table_replace(trsp_hash, key, ntrsp);
-                        }
-
-                        //now lets write the new version
-                        ffile = g_fopen(trspfile, "a");
-                        if (ffile != NULL)
-                        {
-                            fprintf(ffile, "\n[%s]\n", m_trsp.description);
-                            if (m_trsp.uplink_low > 0)
-                                fprintf(ffile, "UP_LOW=%lld\n",
-                                        m_trsp.uplink_low);
-                            if (m_trsp.uplink_high > 0)
-                                fprintf(ffile, "UP_HIGH=%lld\n",
-                                        m_trsp.uplink_high);
-                            if (m_trsp.downlink_low > 0)
-                                fprintf(ffile, "DOWN_LOW=%lld\n",
-                                        m_trsp.downlink_low);
-                            if (m_trsp.downlink_high > 0)
-                                fprintf(ffile, "DOWN_HIGH=%lld\n",
-                                        m_trsp.downlink_high);
-                            fprintf(ffile, "MODE=%s\n", m_trsp.mode);
-                            if (m_trsp.baud > 0.0)
-                                fprintf(ffile, "BAUD=%.0f\n", m_trsp.baud);
-                            if (m_trsp.invert)
-                                fprintf(ffile, "INVERT=%s\n", "true");
-                            fclose(ffile);
-                        }
-                        else
-                        {
-                            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                                        _
-                                        ("%s: Could not open trsp file for write"),
-                                        __func__);
-                        }
-                    }           // while(1)
-                    nx_json_free(json);
-                }               // if(json)
-            }                   // if(result == 1)
-            g_free(jsn_object);
-        }                       // if(flen > 1)
-        fclose(mfp);
-    }                           // if(mfp)
-
-    g_hash_table_destroy(modes_hash);
+    if (ok)
+        sat_log_log(SAT_LOG_LEVEL_INFO,
+                    _("%s: Updated %u transponders of %u satellites "
+                      "(%u modes)"), __func__, upd.count, numsats,
+                    g_hash_table_size(upd.modes));
+    else
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Could not read transponders from %s"),
+                    __func__, input_file);
+
+    g_hash_table_destroy(upd.sats);
+    g_hash_table_destroy(upd.modes);
+    g_free(modesfile);
+    g_free(userconfdir);
 }
 
 /** Update MODES files from network. */